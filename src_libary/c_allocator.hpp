@@ -0,0 +1,143 @@
+/*
+ * Allocation of the grid sized arrays of the operators and solvers.
+ *
+ * allocate() returns arrays of at least HUGE_PAGE_SIZE bytes aligned to and
+ * rounded up to HUGE_PAGE_SIZE and advises the kernel to back them with
+ * transparent huge pages (madvise MADV_HUGEPAGE): the LL/LU neighbours are
+ * a plane (up to 32 MiB) apart, with 4 KiB pages every plane stride is a
+ * TLB miss, and the first touch of a 64 GB grid costs 16M page faults
+ * instead of 32K. If THP is disabled or the advice fails the array is kept
+ * with normal pages. Smaller arrays are cache line aligned.
+ * ALLOCATOR_HUGE_PAGES=0 switches the advice off (everything cache line
+ * aligned), so that both can be measured with the same code. hugetlbfs
+ * (MAP_HUGETLB) is not used, it needs a reserved page pool on every node.
+ *
+ * Nothing is initialized by allocate(). firstTouch() writes an array level
+ * by level with the static level distribution of the apply kernels
+ * (#pragma omp for over the levels), so that every page is placed on the
+ * NUMA node of the thread that works on it. It is an orphaned worksharing
+ * loop: inside a parallel region the levels are distributed over the
+ * threads, outside of one the calling thread touches everything.
+ *
+ * Arrays of allocate() have to be released with deallocate(). reserve()
+ * keeps an array of allocate() if the requested size fits into it and
+ * reallocates it otherwise, so that owners can be rebound to another grid
+ * without allocating in steady state.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <omp.h>
+#include <sys/mman.h>
+
+#ifndef ALLOCATOR_HUGE_PAGES
+#define ALLOCATOR_HUGE_PAGES 1
+#endif
+
+class CAllocator
+{
+   public:
+      static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+      static constexpr std::size_t CACHE_LINE_SIZE = 64;
+      static constexpr bool HUGE_PAGES = ALLOCATOR_HUGE_PAGES;
+
+      template <typename ValueType>
+      static ValueType * allocate(const std::size_t p_size);
+
+      template <typename ValueType>
+      static void deallocate(ValueType * p_ptr);
+
+      //
+      // true if p_ptr was (re)allocated, the values are undefined then,
+      // otherwise p_ptr and its values are kept
+      //
+      template <typename ValueType>
+      static bool reserve(ValueType *& p_ptr, std::size_t & p_capacity, const std::size_t p_size);
+
+      //
+      // p_size values, levels of p_sizeLevel values (the last one may be
+      // shorter)
+      //
+      template <typename ValueType>
+      static void firstTouch(ValueType * p_ptr, const std::size_t p_size, const std::size_t p_sizeLevel, const ValueType p_value = ValueType(0));
+};
+
+template <typename ValueType>
+ValueType * CAllocator::allocate(const std::size_t p_size)
+{
+   std::size_t l_bytes = p_size * sizeof(ValueType);
+   void * l_ptr = nullptr;
+
+   if (HUGE_PAGES && l_bytes >= HUGE_PAGE_SIZE)
+   {
+      l_bytes = ((l_bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+      l_ptr = std::aligned_alloc(HUGE_PAGE_SIZE, l_bytes);
+
+#ifdef MADV_HUGEPAGE
+      if (l_ptr != nullptr)
+      {
+         //
+         // NOTE a failed advice is no error, the pages are 4 KiB then
+         //
+         madvise(l_ptr, l_bytes, MADV_HUGEPAGE);
+      }
+#endif
+   }
+
+   if (l_ptr == nullptr)
+   {
+      l_bytes = ((l_bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE;
+      l_ptr = std::aligned_alloc(CACHE_LINE_SIZE, l_bytes > 0 ? l_bytes : CACHE_LINE_SIZE);
+   }
+
+   if (l_ptr == nullptr)
+   {
+      throw std::bad_alloc();
+   }
+
+   return static_cast<ValueType *>(l_ptr);
+}
+
+template <typename ValueType>
+void CAllocator::deallocate(ValueType * p_ptr)
+{
+   std::free(p_ptr);
+}
+
+template <typename ValueType>
+bool CAllocator::reserve(ValueType *& p_ptr, std::size_t & p_capacity, const std::size_t p_size)
+{
+   if (p_ptr != nullptr && p_size <= p_capacity)
+   {
+      return false;
+   }
+
+   deallocate(p_ptr);
+   p_ptr = nullptr;
+   p_capacity = 0;
+
+   p_ptr = allocate<ValueType>(p_size);
+   p_capacity = p_size;
+
+   return true;
+}
+
+template <typename ValueType>
+void CAllocator::firstTouch(ValueType * p_ptr, const std::size_t p_size, const std::size_t p_sizeLevel, const ValueType p_value)
+{
+   std::size_t l_levels = (p_size + p_sizeLevel - 1) / p_sizeLevel;
+
+   #pragma omp for schedule(static)
+   for (std::size_t l_pos_L = 0; l_pos_L < l_levels; ++l_pos_L)
+   {
+      std::size_t l_end = l_pos_L * p_sizeLevel + p_sizeLevel < p_size ? l_pos_L * p_sizeLevel + p_sizeLevel : p_size;
+      for (std::size_t i = l_pos_L * p_sizeLevel; i < l_end; ++i)
+      {
+         p_ptr[i] = p_value;
+      }
+   }
+}
@@ -0,0 +1,267 @@
+/*
+ * Brick layout of a cols x rows x levels grid: the grid is split into cubic
+ * bricks of BrickSize^3 cells, the bricks are stored one after the other in
+ * Morton (Z-) order of their brick coordinates, the cells of a brick
+ * row-major (column fastest). The face neighbours of a cell are in the same
+ * brick or in one of its six face neighbour bricks, which are close to it in
+ * Morton order, instead of one level (m_objSize2d values) apart.
+ *
+ * Bricks at the upper faces of the grid are padded. Padding cells are zero
+ * in bricked vectors (toBricks) and the bricked operators write zero to
+ * them, so that they do not change dot products and norms.
+ *
+ * Bricked vectors have size() cells and, like the row-major vectors, a zero
+ * halo of bufferSize() (= one brick) cells in front and behind. Neighbour
+ * bricks outside of the grid are the halo brick in front. CCG works
+ * unchanged on bricked vectors with p_size = size() and
+ * p_bufferSize = bufferSize().
+ *
+ * toBricks/fromBricks convert from/to the row-major layout, both open their
+ * own parallel region and distribute the bricks like the bricked operators
+ * (first touch). The halo is not touched.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <omp.h>
+
+template <std::size_t BrickSize>
+class CBrickLayout
+{
+   private:
+      std::size_t m_objCols;
+      std::size_t m_objRows;
+      std::size_t m_objLevels;
+      std::size_t m_bricksCols;
+      std::size_t m_bricksRows;
+      std::size_t m_bricksLevels;
+      std::size_t m_bricks;
+
+      //
+      // NOTE per brick: first column, row and level of the brick / cell
+      //      offsets of the six neighbour bricks
+      //
+      std::size_t * m_origin;
+      std::ptrdiff_t * m_neighbours;
+
+      static std::uint64_t mortonKey(const std::size_t p_C, const std::size_t p_R, const std::size_t p_L);
+      static std::size_t mortonDecode(const std::uint64_t p_key, const std::size_t p_dim);
+
+   public:
+      static constexpr std::size_t BRICK_CELLS = BrickSize * BrickSize * BrickSize;
+
+      static constexpr std::size_t NB_CL = 0;
+      static constexpr std::size_t NB_CU = 1;
+      static constexpr std::size_t NB_RL = 2;
+      static constexpr std::size_t NB_RU = 3;
+      static constexpr std::size_t NB_LL = 4;
+      static constexpr std::size_t NB_LU = 5;
+
+      CBrickLayout(
+         const std::size_t p_objCols,
+         const std::size_t p_objRows,
+         const std::size_t p_objLevels
+         );
+      CBrickLayout(const CBrickLayout &) = delete;
+      CBrickLayout & operator=(const CBrickLayout &) = delete;
+      static_assert(BrickSize >= 2, "BrickSize has to be >= 2");
+      inline static const std::string IDENTIFER = "_brick_" + std::to_string(BrickSize);
+
+      std::size_t objCols() const { return m_objCols; }
+      std::size_t objRows() const { return m_objRows; }
+      std::size_t objLevels() const { return m_objLevels; }
+      std::size_t bricks() const { return m_bricks; }
+      std::size_t size() const { return m_bricks * BRICK_CELLS; }
+      std::size_t bufferSize() const { return BRICK_CELLS; }
+
+      //
+      // first column / row / level of brick p_brick (p_dim 0 / 1 / 2)
+      //
+      std::size_t origin(const std::size_t p_brick, const std::size_t p_dim) const { return m_origin[3*p_brick+p_dim]; }
+
+      //
+      // offset of the first cell of neighbour brick p_nb (NB_*) of brick
+      // p_brick, -BRICK_CELLS (halo) outside of the grid
+      //
+      std::ptrdiff_t neighbour(const std::size_t p_brick, const std::size_t p_nb) const { return m_neighbours[6*p_brick+p_nb]; }
+
+      template <typename ValueType>
+      void toBricks(const ValueType * __restrict__ p_src, ValueType * __restrict__ p_dst) const;
+      template <typename ValueType>
+      void fromBricks(const ValueType * __restrict__ p_src, ValueType * __restrict__ p_dst) const;
+
+      ~CBrickLayout();
+};
+
+template <std::size_t BrickSize>
+CBrickLayout<BrickSize>::CBrickLayout(
+   const std::size_t p_objCols,
+   const std::size_t p_objRows,
+   const std::size_t p_objLevels
+   ):
+m_objCols(p_objCols),
+m_objRows(p_objRows),
+m_objLevels(p_objLevels),
+m_bricksCols((p_objCols + BrickSize - 1) / BrickSize),
+m_bricksRows((p_objRows + BrickSize - 1) / BrickSize),
+m_bricksLevels((p_objLevels + BrickSize - 1) / BrickSize),
+m_bricks(m_bricksCols * m_bricksRows * m_bricksLevels)
+{
+   m_origin = new std::size_t[3*m_bricks];
+   m_neighbours = new std::ptrdiff_t[6*m_bricks];
+
+   //
+   // NOTE the brick counts are no powers of two in general, the Morton keys
+   //      of the existing bricks are sorted and numbered consecutively
+   //
+   std::uint64_t * l_keys = new std::uint64_t[m_bricks];
+   std::size_t * l_ordinal = new std::size_t[m_bricks];
+
+   for (std::size_t l_L=0; l_L<m_bricksLevels; ++l_L)
+   {
+      for (std::size_t l_R=0; l_R<m_bricksRows; ++l_R)
+      {
+         for (std::size_t l_C=0; l_C<m_bricksCols; ++l_C)
+         {
+            l_keys[(l_L*m_bricksRows + l_R)*m_bricksCols + l_C] = mortonKey(l_C, l_R, l_L);
+         }
+      }
+   }
+   std::sort(l_keys, l_keys + m_bricks);
+
+   for (std::size_t l_brick=0; l_brick<m_bricks; ++l_brick)
+   {
+      std::size_t l_C = mortonDecode(l_keys[l_brick], 0);
+      std::size_t l_R = mortonDecode(l_keys[l_brick], 1);
+      std::size_t l_L = mortonDecode(l_keys[l_brick], 2);
+
+      l_ordinal[(l_L*m_bricksRows + l_R)*m_bricksCols + l_C] = l_brick;
+
+      m_origin[3*l_brick+0] = l_C * BrickSize;
+      m_origin[3*l_brick+1] = l_R * BrickSize;
+      m_origin[3*l_brick+2] = l_L * BrickSize;
+   }
+
+   for (std::size_t l_brick=0; l_brick<m_bricks; ++l_brick)
+   {
+      std::size_t l_C = m_origin[3*l_brick+0] / BrickSize;
+      std::size_t l_R = m_origin[3*l_brick+1] / BrickSize;
+      std::size_t l_L = m_origin[3*l_brick+2] / BrickSize;
+
+      auto l_offset = [&](const bool p_inside, const std::size_t p_C, const std::size_t p_R, const std::size_t p_L)
+      {
+         return p_inside
+            ? std::ptrdiff_t(l_ordinal[(p_L*m_bricksRows + p_R)*m_bricksCols + p_C] * BRICK_CELLS)
+            : -std::ptrdiff_t(BRICK_CELLS);
+      };
+
+      m_neighbours[6*l_brick+NB_CL] = l_offset(l_C > 0,                l_C-1, l_R,   l_L);
+      m_neighbours[6*l_brick+NB_CU] = l_offset(l_C < m_bricksCols-1,   l_C+1, l_R,   l_L);
+      m_neighbours[6*l_brick+NB_RL] = l_offset(l_R > 0,                l_C,   l_R-1, l_L);
+      m_neighbours[6*l_brick+NB_RU] = l_offset(l_R < m_bricksRows-1,   l_C,   l_R+1, l_L);
+      m_neighbours[6*l_brick+NB_LL] = l_offset(l_L > 0,                l_C,   l_R,   l_L-1);
+      m_neighbours[6*l_brick+NB_LU] = l_offset(l_L < m_bricksLevels-1, l_C,   l_R,   l_L+1);
+   }
+
+   delete [] l_keys;
+   delete [] l_ordinal;
+}
+
+template <std::size_t BrickSize>
+std::uint64_t CBrickLayout<BrickSize>::mortonKey(const std::size_t p_C, const std::size_t p_R, const std::size_t p_L)
+{
+   //
+   // NOTE bit b of the column / row / level is bit 3b / 3b+1 / 3b+2
+   //
+   std::uint64_t l_key = 0;
+   for (std::size_t b=0; b<21; ++b)
+   {
+      l_key |= std::uint64_t((p_C >> b) & 1) << (3*b+0);
+      l_key |= std::uint64_t((p_R >> b) & 1) << (3*b+1);
+      l_key |= std::uint64_t((p_L >> b) & 1) << (3*b+2);
+   }
+   return l_key;
+}
+
+template <std::size_t BrickSize>
+std::size_t CBrickLayout<BrickSize>::mortonDecode(const std::uint64_t p_key, const std::size_t p_dim)
+{
+   std::size_t l_value = 0;
+   for (std::size_t b=0; b<21; ++b)
+   {
+      l_value |= std::size_t((p_key >> (3*b+p_dim)) & 1) << b;
+   }
+   return l_value;
+}
+
+template <std::size_t BrickSize>
+template <typename ValueType>
+void CBrickLayout<BrickSize>::toBricks(const ValueType * __restrict__ p_src, ValueType * __restrict__ p_dst) const
+{
+   #pragma omp parallel for schedule(static)
+   for (std::size_t l_brick=0; l_brick<m_bricks; ++l_brick)
+   {
+      ValueType * l_dst = p_dst + l_brick * BRICK_CELLS;
+
+      for (std::size_t l=0; l<BrickSize; ++l)
+      {
+         for (std::size_t r=0; r<BrickSize; ++r)
+         {
+            std::size_t l_pos_C = origin(l_brick, 0);
+            std::size_t l_pos_R = origin(l_brick, 1) + r;
+            std::size_t l_pos_L = origin(l_brick, 2) + l;
+            std::size_t l_n = (l_pos_R < m_objRows && l_pos_L < m_objLevels) ? std::min(BrickSize, m_objCols - l_pos_C) : 0;
+
+            const ValueType * l_src = p_src + (l_pos_L * m_objRows + l_pos_R) * m_objCols + l_pos_C;
+            for (std::size_t c=0; c<BrickSize; ++c)
+            {
+               l_dst[(l*BrickSize + r)*BrickSize + c] = c < l_n ? l_src[c] : ValueType(0);
+            }
+         }
+      }
+   }
+}
+
+template <std::size_t BrickSize>
+template <typename ValueType>
+void CBrickLayout<BrickSize>::fromBricks(const ValueType * __restrict__ p_src, ValueType * __restrict__ p_dst) const
+{
+   #pragma omp parallel for schedule(static)
+   for (std::size_t l_brick=0; l_brick<m_bricks; ++l_brick)
+   {
+      const ValueType * l_src = p_src + l_brick * BRICK_CELLS;
+
+      for (std::size_t l=0; l<BrickSize; ++l)
+      {
+         for (std::size_t r=0; r<BrickSize; ++r)
+         {
+            std::size_t l_pos_C = origin(l_brick, 0);
+            std::size_t l_pos_R = origin(l_brick, 1) + r;
+            std::size_t l_pos_L = origin(l_brick, 2) + l;
+
+            if (l_pos_R >= m_objRows || l_pos_L >= m_objLevels)
+            {
+               continue;
+            }
+
+            ValueType * l_dst = p_dst + (l_pos_L * m_objRows + l_pos_R) * m_objCols + l_pos_C;
+            for (std::size_t c=0; c<std::min(BrickSize, m_objCols - l_pos_C); ++c)
+            {
+               l_dst[c] = l_src[(l*BrickSize + r)*BrickSize + c];
+            }
+         }
+      }
+   }
+}
+
+template <std::size_t BrickSize>
+CBrickLayout<BrickSize>::~CBrickLayout()
+{
+   delete [] m_origin;
+   delete [] m_neighbours;
+}
@@ -4,6 +4,12 @@
 *
 *  l_alpha_init commented out
 *
+*  dot products are accumulated in AccumulatorType (double by default), so
+*  the float path does not lose the small contributions on large grids
+*
+*  p, r and upsilon are kept in a CWorkspace between the calls, they are
+*  allocated and first touched only when p_size or p_bufferSize changes
+*
 */
 
 #pragma once
@@ -12,10 +18,14 @@
 #include <string>
 #include "i_linear_operator.hpp"
 #include "i_solver.hpp"
+#include "c_workspace.hpp"
 
-template <typename ValueType>
+template <typename ValueType, typename AccumulatorType = double>
 class CCG: public ISolver<ValueType>
 {
+    private:
+        mutable CWorkspace<ValueType, 3> m_workspace;
+
     public:
         inline static const std::string IDENTIFER = "cg";
         std::size_t operator()(
@@ -28,10 +38,11 @@ class CCG: public ISolver<ValueType>
             const std::size_t p_iterMax,
             const std::size_t p_bufferSize
         ) const;
+        const CWorkspace<ValueType, 3> & workspace() const { return m_workspace; }
 };
 
-template <typename ValueType>
-std::size_t CCG<ValueType>::operator()(
+template <typename ValueType, typename AccumulatorType>
+std::size_t CCG<ValueType, AccumulatorType>::operator()(
     const std::size_t p_size,
     const ILinearOperator<ValueType> & p_A,
     const ValueType * __restrict__ p_x_0,
@@ -43,21 +54,28 @@ std::size_t CCG<ValueType>::operator()(
 ) const
 {
     std::size_t l_iter;
-    ValueType l_lambda = 0.;
-    ValueType l_alpha_0 = 0.;
-    ValueType l_alpha_1 = 0.;
-
-    ValueType * l_p_raw = new ValueType[p_size+2*p_bufferSize];
-    ValueType * l_p = &(l_p_raw[p_bufferSize]);
-    ValueType * l_r = new ValueType[p_size];
-    ValueType * l_upsilon = new ValueType[p_size];
+    AccumulatorType l_lambda = 0.;
+    AccumulatorType l_alpha_0 = 0.;
+    AccumulatorType l_alpha_1 = 0.;
+
+    //
+    // NOTE first touch with the level distribution of p_A.apply on the first
+    //      call (a level is p_bufferSize values), the halos of p and the
+    //      padding cells of a padded grid (CGridLayout) stay zero: p_A.apply
+    //      does not write them and the updates keep them zero
+    //
+    m_workspace.reserve(p_size, p_bufferSize);
+
+    ValueType * l_p = m_workspace.vector(0);
+    ValueType * l_r = m_workspace.vector(1);
+    ValueType * l_upsilon = m_workspace.vector(2);
 
     #pragma omp parallel
     {
         std::size_t l_thread_id = omp_get_thread_num();
         std::size_t l_iter_t = 0;
-        ValueType l_alpha_init_t;
-        ValueType l_alpha_0_t;
+        AccumulatorType l_alpha_init_t;
+        AccumulatorType l_alpha_0_t;
         ValueType l_lambda_t;
         ValueType l_beta_t;
 
@@ -74,21 +92,13 @@ std::size_t CCG<ValueType>::operator()(
         }
         // --------------------------------------------------------------------
 
-        #pragma omp for
-        for (std::size_t i = 0; i < p_bufferSize; ++i)
-        {
-            l_p_raw[i] = 0;
-            l_p_raw[p_size+p_bufferSize+i] = 0;
-        }
-        // --------------------------------------------------------------------
-
         //
         // NOTE: norm2 operation
         //
         #pragma omp for reduction(+: l_alpha_0)
         for(std::size_t i = 0; i < p_size; ++i)
         {
-            l_alpha_0 += l_r[i] * l_r[i];
+            l_alpha_0 += AccumulatorType(l_r[i]) * l_r[i];
         }
         // --------------------------------------------------------------------
         l_alpha_init_t = l_alpha_0;
@@ -119,20 +129,29 @@ std::size_t CCG<ValueType>::operator()(
             #pragma omp barrier
             // --------------------------------------------------------------------
 
+            //
+            // NOTE l_alpha_1 is reset before the lambda reduction: behind it
+            //      the other threads can combine into l_alpha_1 (nowait
+            //      update) before the master arrives
+            //
+            #pragma omp master
+            {
+                l_alpha_1 = 0.;
+            }
+
             //
             // Note: dot prod
             //
             #pragma omp for reduction(+: l_lambda)
             for(std::size_t i = 0; i < p_size; ++i)
             {
-                l_lambda += l_upsilon[i] * l_p[i];
+                l_lambda += AccumulatorType(l_upsilon[i]) * l_p[i];
             }
             // --------------------------------------------------------------------
-            l_lambda_t = l_alpha_0_t / l_lambda;
+            l_lambda_t = ValueType(l_alpha_0_t / l_lambda);
 
             #pragma omp master
             {
-                l_alpha_1 = 0.;
                 // std::cout << "----------------------" << std::endl;
                 // std::cout << "l_iter_t: " << l_iter_t << std::endl;
                 // std::cout << "l_alpha_0_t: " << l_alpha_0_t << std::endl;
@@ -153,7 +172,7 @@ std::size_t CCG<ValueType>::operator()(
             #pragma omp for reduction(+: l_alpha_1)
             for(std::size_t i = 0; i < p_size; ++i)
             {
-                l_alpha_1 += l_r[i] * l_r[i];
+                l_alpha_1 += AccumulatorType(l_r[i]) * l_r[i];
             }
             // --------------------------------------------------------------------
 
@@ -162,7 +181,7 @@ std::size_t CCG<ValueType>::operator()(
                 l_lambda = 0.;
             }
 
-            l_beta_t = l_alpha_1/l_alpha_0_t;
+            l_beta_t = ValueType(l_alpha_1/l_alpha_0_t);
 
             // #pragma omp for nowait
             #pragma omp for
@@ -188,9 +207,5 @@ std::size_t CCG<ValueType>::operator()(
         }
     }
 
-    delete [] l_p_raw;
-    delete [] l_r;
-    delete [] l_upsilon;
-
     return(l_iter);
 }
@@ -0,0 +1,538 @@
+/*
+*
+*  Chebyshev iteration (Saad, Iterative Methods, Alg. 12.1)
+*
+*  x = x + d, r = r - A d, d = rho_1 * rho_0 * d + 2 * rho_1 / delta * r
+*  with theta, delta the center and the half width of the spectral interval
+*  [lambda_min, lambda_max] of A. An iteration is one apply and one fused
+*  loop without any dot product: the only waits are the barrier of apply and
+*  the one after the fused loop (2 barriers, 4 barriers and 2 reductions in
+*  CCG). The norm2 of r (stopping criterion, as in CCG) is only computed
+*  every m_checkPeriod iterations (and after 1, 2, 4, ... iterations of a
+*  start), fused into the loop
+*
+*  the bounds are estimated by m_estimateSteps CG steps: the step lengths
+*  alpha_j and the betas of CG are the entries of the Lanczos tridiagonal
+*  matrix T (Saad, 6.7.3), the smallest and the largest eigenvalue of T
+*  (Sturm bisection) are the extremal Ritz values of A. They lie inside the
+*  spectrum, lambda_max is widened by LAMBDA_MAX_SAFETY (an eigenvalue above
+*  the interval is amplified), lambda_min is narrowed by LAMBDA_MIN_SAFETY.
+*  The CG steps are not lost, the Chebyshev iteration continues from their
+*  x and r
+*
+*  the bounds are cached between the calls: a timestep calculator calls the
+*  solver with operators of slowly changing states, only the first call
+*  pays for the estimate. A new estimate is done
+*   - on the first call and after invalidate()
+*   - every m_refresh calls (0: never)
+*   - when the norm2 of r of a check is above the one of the start of the
+*     iteration (lambda_max too small, the iteration diverges), the
+*     iteration restarts from the current x and r = b - A x with the new
+*     bounds
+*  setBounds() sets known bounds (no estimate until invalidate())
+*
+*  the reductions (start, checks, CG steps) are not omp reductions, see
+*  CPipelinedCG: every thread writes its partial sum to a padded slot of
+*  m_partial, the slots are used alternately by consecutive reductions
+*
+*  r, d and upsilon are kept in a CWorkspace between the calls, see CCG
+*
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <omp.h>
+#include <string>
+#include <vector>
+#include "i_linear_operator.hpp"
+#include "i_solver.hpp"
+#include "c_workspace.hpp"
+#include "c_allocator.hpp"
+
+template <typename ValueType, typename AccumulatorType = double>
+class CChebyshev: public ISolver<ValueType>
+{
+    private:
+        //
+        // NOTE partial sum of a thread, padded to 64 bytes, m_partial is
+        //      cache line aligned (CAllocator)
+        //
+        static constexpr std::size_t PARTIAL_STRIDE = 64 / sizeof(AccumulatorType) < 1 ? 1 : 64 / sizeof(AccumulatorType);
+
+        //
+        // NOTE the Ritz values of 100 CG steps underestimate lambda_max by
+        //      some percent, they overestimate lambda_min by up to a factor
+        //      of 2 (slower convergence of the low modes, no divergence)
+        //
+        static constexpr AccumulatorType LAMBDA_MAX_SAFETY = 1.1;
+        static constexpr AccumulatorType LAMBDA_MIN_SAFETY = 0.5;
+
+        static constexpr std::size_t BISECTION_STEPS = 100;
+
+        mutable CWorkspace<ValueType, 3> m_workspace;
+        mutable AccumulatorType * m_partial;
+        mutable std::size_t m_partialThreads;
+        mutable std::vector<AccumulatorType> m_alpha;
+        mutable std::vector<AccumulatorType> m_beta;
+        mutable AccumulatorType m_lambdaMin;
+        mutable AccumulatorType m_lambdaMax;
+        mutable bool m_valid;
+        mutable std::size_t m_calls;
+        mutable std::size_t m_estimates;
+        const std::size_t m_estimateSteps;
+        const std::size_t m_checkPeriod;
+        const std::size_t m_refresh;
+
+        AccumulatorType sum(const AccumulatorType p_value, std::size_t & p_slot) const;
+        std::size_t sturmCount(const std::size_t p_steps, const AccumulatorType p_lambda) const;
+        void ritzBounds(const std::size_t p_steps) const;
+        std::size_t estimate(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            ValueType * __restrict__ p_x,
+            ValueType * __restrict__ p_r,
+            ValueType * __restrict__ p_p,
+            ValueType * __restrict__ p_upsilon,
+            AccumulatorType & p_rr,
+            std::size_t & p_slot,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax
+        ) const;
+
+    public:
+        inline static const std::string IDENTIFER = "chebyshev";
+
+        CChebyshev(const std::size_t p_estimateSteps = 100, const std::size_t p_checkPeriod = 16, const std::size_t p_refresh = 0):
+            m_partial(nullptr),
+            m_partialThreads(0),
+            m_alpha(p_estimateSteps > 1 ? p_estimateSteps : 2),
+            m_beta(p_estimateSteps > 1 ? p_estimateSteps : 2),
+            m_lambdaMin(0.),
+            m_lambdaMax(0.),
+            m_valid(false),
+            m_calls(0),
+            m_estimates(0),
+            m_estimateSteps(p_estimateSteps > 1 ? p_estimateSteps : 2),
+            m_checkPeriod(p_checkPeriod > 0 ? p_checkPeriod : 1),
+            m_refresh(p_refresh)
+        {}
+        CChebyshev(const CChebyshev &) = delete;
+        CChebyshev & operator=(const CChebyshev &) = delete;
+
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const;
+
+        void setBounds(const AccumulatorType p_lambdaMin, const AccumulatorType p_lambdaMax) { m_lambdaMin = p_lambdaMin; m_lambdaMax = p_lambdaMax; m_valid = true; m_calls = 0; }
+        void invalidate() { m_valid = false; }
+        AccumulatorType lambdaMin() const { return m_lambdaMin; }
+        AccumulatorType lambdaMax() const { return m_lambdaMax; }
+        std::size_t estimates() const { return m_estimates; }
+        const CWorkspace<ValueType, 3> & workspace() const { return m_workspace; }
+
+        ~CChebyshev() { CAllocator::deallocate(m_partial); }
+};
+
+template <typename ValueType, typename AccumulatorType>
+AccumulatorType CChebyshev<ValueType, AccumulatorType>::sum(const AccumulatorType p_value, std::size_t & p_slot) const
+{
+    //
+    // NOTE a slot is written again two reductions later, behind the barrier
+    //      of the reduction in between, when every thread has read it
+    //
+    std::size_t l_thread_id = omp_get_thread_num();
+    std::size_t l_threads = omp_get_num_threads();
+    AccumulatorType l_sum = 0.;
+
+    m_partial[(p_slot * l_threads + l_thread_id) * PARTIAL_STRIDE] = p_value;
+
+    #pragma omp barrier
+
+    for(std::size_t t = 0; t < l_threads; ++t)
+    {
+        l_sum += m_partial[(p_slot * l_threads + t) * PARTIAL_STRIDE];
+    }
+    p_slot = 1 - p_slot;
+
+    return(l_sum);
+}
+
+template <typename ValueType, typename AccumulatorType>
+std::size_t CChebyshev<ValueType, AccumulatorType>::sturmCount(const std::size_t p_steps, const AccumulatorType p_lambda) const
+{
+    //
+    // NOTE number of eigenvalues of T below p_lambda (signs of the pivots
+    //      of the LDL^T factorization of T - p_lambda I)
+    //
+    std::size_t l_count = 0;
+    AccumulatorType l_q = 1.;
+
+    for(std::size_t j = 0; j < p_steps; ++j)
+    {
+        AccumulatorType l_diag = 1. / m_alpha[j] + (j > 0 ? m_beta[j - 1] / m_alpha[j - 1] : 0.);
+        AccumulatorType l_off2 = j > 0 ? m_beta[j - 1] / (m_alpha[j - 1] * m_alpha[j - 1]) : 0.;
+
+        l_q = l_diag - p_lambda - (j > 0 ? l_off2 / l_q : 0.);
+
+        if(l_q == 0)
+        {
+            l_q = -1e-300;
+        }
+        if(l_q < 0)
+        {
+            l_count++;
+        }
+    }
+
+    return(l_count);
+}
+
+template <typename ValueType, typename AccumulatorType>
+void CChebyshev<ValueType, AccumulatorType>::ritzBounds(const std::size_t p_steps) const
+{
+    //
+    // NOTE T: diagonal 1 / alpha_j + beta_j-1 / alpha_j-1, off diagonal
+    //      sqrt(beta_j) / alpha_j, the Gershgorin interval of T encloses
+    //      both Ritz values
+    //
+    AccumulatorType l_lower = 0.;
+    AccumulatorType l_upper = 0.;
+
+    for(std::size_t j = 0; j < p_steps; ++j)
+    {
+        AccumulatorType l_diag = 1. / m_alpha[j] + (j > 0 ? m_beta[j - 1] / m_alpha[j - 1] : 0.);
+        AccumulatorType l_radius =
+              (j > 0 ? std::sqrt(m_beta[j - 1]) / m_alpha[j - 1] : 0.)
+            + (j + 1 < p_steps ? std::sqrt(m_beta[j]) / m_alpha[j] : 0.);
+
+        if(j == 0 || l_diag + l_radius > l_upper)
+        {
+            l_upper = l_diag + l_radius;
+        }
+        if(j == 0 || l_diag - l_radius < l_lower)
+        {
+            l_lower = l_diag - l_radius;
+        }
+    }
+
+    AccumulatorType l_min_lo = l_lower;
+    AccumulatorType l_min_hi = l_upper;
+    AccumulatorType l_max_lo = l_lower;
+    AccumulatorType l_max_hi = l_upper;
+
+    for(std::size_t i = 0; i < BISECTION_STEPS; ++i)
+    {
+        AccumulatorType l_min_mid = (l_min_lo + l_min_hi) / 2;
+        AccumulatorType l_max_mid = (l_max_lo + l_max_hi) / 2;
+
+        if(sturmCount(p_steps, l_min_mid) >= 1)
+        {
+            l_min_hi = l_min_mid;
+        }
+        else
+        {
+            l_min_lo = l_min_mid;
+        }
+
+        if(sturmCount(p_steps, l_max_mid) >= p_steps)
+        {
+            l_max_hi = l_max_mid;
+        }
+        else
+        {
+            l_max_lo = l_max_mid;
+        }
+    }
+
+    m_lambdaMin = l_min_lo * LAMBDA_MIN_SAFETY;
+    m_lambdaMax = l_max_hi * LAMBDA_MAX_SAFETY;
+}
+
+template <typename ValueType, typename AccumulatorType>
+std::size_t CChebyshev<ValueType, AccumulatorType>::estimate(
+    const std::size_t p_size,
+    const ILinearOperator<ValueType> & p_A,
+    ValueType * __restrict__ p_x,
+    ValueType * __restrict__ p_r,
+    ValueType * __restrict__ p_p,
+    ValueType * __restrict__ p_upsilon,
+    AccumulatorType & p_rr,
+    std::size_t & p_slot,
+    const ValueType p_epsilon,
+    const std::size_t p_iterMax
+) const
+{
+    //
+    // NOTE called by all threads of the parallel region, CG steps from x
+    //      and r, alpha_j and beta_j are recorded by the master. The bounds
+    //      are kept if CG converges before 2 steps
+    //
+    std::size_t l_steps = 0;
+
+    #pragma omp for
+    for(std::size_t i = 0; i < p_size; ++i)
+    {
+        p_p[i] = p_r[i];
+    }
+    // --------------------------------------------------------------------
+
+    while(l_steps < m_estimateSteps && l_steps < p_iterMax && !(p_rr < p_epsilon))
+    {
+        p_A.apply(p_p,p_upsilon);
+        // --------------------------------------------------------------------
+
+        AccumulatorType l_pu_t = 0.;
+
+        #pragma omp for nowait
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            l_pu_t += AccumulatorType(p_upsilon[i]) * p_p[i];
+        }
+        AccumulatorType l_alpha = p_rr / sum(l_pu_t, p_slot);
+        ValueType l_alpha_t = ValueType(l_alpha);
+        // --------------------------------------------------------------------
+
+        AccumulatorType l_rr_t = 0.;
+
+        #pragma omp for nowait
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            p_x[i] = p_x[i] + l_alpha_t * p_p[i];
+            p_r[i] = p_r[i] - l_alpha_t * p_upsilon[i];
+
+            l_rr_t += AccumulatorType(p_r[i]) * p_r[i];
+        }
+        AccumulatorType l_rr = sum(l_rr_t, p_slot);
+        AccumulatorType l_beta = l_rr / p_rr;
+        ValueType l_beta_t = ValueType(l_beta);
+        // --------------------------------------------------------------------
+
+        #pragma omp master
+        {
+            m_alpha[l_steps] = l_alpha;
+            m_beta[l_steps] = l_beta;
+        }
+
+        #pragma omp for
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            p_p[i] = p_r[i] + l_beta_t * p_p[i];
+        }
+        // --------------------------------------------------------------------
+
+        p_rr = l_rr;
+        l_steps++;
+    }
+
+    if(l_steps > 1)
+    {
+        #pragma omp master
+        {
+            ritzBounds(l_steps);
+            m_valid = true;
+            m_calls = 0;
+            m_estimates++;
+        }
+
+        #pragma omp barrier
+        // --------------------------------------------------------------------
+    }
+
+    return(l_steps);
+}
+
+template <typename ValueType, typename AccumulatorType>
+std::size_t CChebyshev<ValueType, AccumulatorType>::operator()(
+    const std::size_t p_size,
+    const ILinearOperator<ValueType> & p_A,
+    const ValueType * __restrict__ p_x_0,
+    const ValueType * __restrict__ p_b,
+    ValueType * __restrict__ p_x_1,
+    const ValueType p_epsilon,
+    const std::size_t p_iterMax,
+    const std::size_t p_bufferSize
+) const
+{
+    std::size_t l_iter;
+
+    m_workspace.reserve(p_size, p_bufferSize);
+
+    //
+    // NOTE 2 slots (consecutive reductions) per thread
+    //
+    std::size_t l_threads = omp_get_max_threads();
+
+    if (l_threads > m_partialThreads)
+    {
+        CAllocator::deallocate(m_partial);
+        m_partial = CAllocator::allocate<AccumulatorType>(2 * l_threads * PARTIAL_STRIDE);
+        m_partialThreads = l_threads;
+    }
+
+    //
+    // NOTE m_calls: calls with the current bounds, reset by an estimate
+    //
+    bool l_estimate = !m_valid || (m_refresh > 0 && m_calls >= m_refresh);
+
+    ValueType * l_r = m_workspace.vector(0);
+    ValueType * l_d = m_workspace.vector(1);
+    ValueType * l_upsilon = m_workspace.vector(2);
+
+    #pragma omp parallel
+    {
+        std::size_t l_iter_t = 0;
+        std::size_t l_slot_t = 0;
+        std::size_t l_cheb_t = 0;
+        AccumulatorType l_rr_t = 0.;
+        AccumulatorType l_rr_0_t;
+        AccumulatorType l_sigma_t = 0.;
+        AccumulatorType l_delta_t = 0.;
+        AccumulatorType l_rho_t = 0.;
+        bool l_estimate_t = l_estimate;
+
+        p_A.apply(p_x_0,l_r);
+        // --------------------------------------------------------------------
+
+        #pragma omp for nowait
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            p_x_1[i] = p_x_0[i];
+            l_r[i] = p_b[i] - l_r[i];
+
+            l_rr_t += AccumulatorType(l_r[i]) * l_r[i];
+        }
+        l_rr_t = sum(l_rr_t, l_slot_t);
+        // --------------------------------------------------------------------
+
+        while(l_iter_t < p_iterMax)
+        {
+            if(l_rr_t < p_epsilon)
+            {
+                break;
+            }
+
+            if(l_cheb_t == 0)
+            {
+                //
+                // NOTE (re)start: estimate if requested, d = r / theta
+                //      (all threads take the same branches)
+                //
+                if(l_estimate_t)
+                {
+                    l_iter_t += estimate(p_size, p_A, p_x_1, l_r, l_d, l_upsilon, l_rr_t, l_slot_t, p_epsilon, p_iterMax - l_iter_t);
+                    l_estimate_t = false;
+
+                    if(l_rr_t < p_epsilon || !(l_iter_t < p_iterMax) || !m_valid)
+                    {
+                        break;
+                    }
+                }
+
+                AccumulatorType l_theta = (m_lambdaMax + m_lambdaMin) / 2;
+                l_delta_t = (m_lambdaMax - m_lambdaMin) / 2;
+                l_sigma_t = l_theta / l_delta_t;
+                l_rho_t = 1. / l_sigma_t;
+                l_rr_0_t = l_rr_t;
+
+                ValueType l_theta_inv_t = ValueType(1. / l_theta);
+
+                #pragma omp for
+                for(std::size_t i = 0; i < p_size; ++i)
+                {
+                    l_d[i] = l_theta_inv_t * l_r[i];
+                }
+                // --------------------------------------------------------------------
+            }
+
+            p_A.apply(l_d,l_upsilon);
+            // --------------------------------------------------------------------
+
+            AccumulatorType l_rho_1 = 1. / (2. * l_sigma_t - l_rho_t);
+            ValueType l_c_d_t = ValueType(l_rho_1 * l_rho_t);
+            ValueType l_c_r_t = ValueType(2. * l_rho_1 / l_delta_t);
+            l_rho_t = l_rho_1;
+            l_cheb_t++;
+            l_iter_t++;
+
+            //
+            // NOTE checks after 1, 2, 4, ... iterations of a (re)start as
+            //      well, bounds that are too small (cached from another
+            //      state, setBounds) are found before x has grown by orders
+            //      of magnitude and has lost its accuracy
+            //
+            bool l_check_t = l_cheb_t % m_checkPeriod == 0 || (l_cheb_t < m_checkPeriod && (l_cheb_t & (l_cheb_t - 1)) == 0);
+
+            if(!l_check_t)
+            {
+                #pragma omp for
+                for(std::size_t i = 0; i < p_size; ++i)
+                {
+                    p_x_1[i] = p_x_1[i] + l_d[i];
+                    l_r[i] = l_r[i] - l_upsilon[i];
+                    l_d[i] = l_c_d_t * l_d[i] + l_c_r_t * l_r[i];
+                }
+                // --------------------------------------------------------------------
+            }
+            else
+            {
+                l_rr_t = 0.;
+
+                #pragma omp for nowait
+                for(std::size_t i = 0; i < p_size; ++i)
+                {
+                    p_x_1[i] = p_x_1[i] + l_d[i];
+                    l_r[i] = l_r[i] - l_upsilon[i];
+                    l_d[i] = l_c_d_t * l_d[i] + l_c_r_t * l_r[i];
+
+                    l_rr_t += AccumulatorType(l_r[i]) * l_r[i];
+                }
+                l_rr_t = sum(l_rr_t, l_slot_t);
+                // --------------------------------------------------------------------
+
+                //
+                // NOTE with valid bounds |r| <= |r_0| / T_k(sigma) < |r_0|,
+                //      a larger |r| means an eigenvalue above lambda_max. The
+                //      recursive r of the diverged iteration has lost its
+                //      accuracy, it is replaced by b - A x before the restart
+                //
+                if(l_rr_t > l_rr_0_t)
+                {
+                    p_A.apply(p_x_1,l_upsilon);
+                    // --------------------------------------------------------------------
+
+                    l_rr_t = 0.;
+
+                    #pragma omp for nowait
+                    for(std::size_t i = 0; i < p_size; ++i)
+                    {
+                        l_r[i] = p_b[i] - l_upsilon[i];
+
+                        l_rr_t += AccumulatorType(l_r[i]) * l_r[i];
+                    }
+                    l_rr_t = sum(l_rr_t, l_slot_t);
+                    // --------------------------------------------------------------------
+
+                    l_estimate_t = true;
+                    l_cheb_t = 0;
+                }
+            }
+        }
+        #pragma omp master
+        {
+            l_iter = l_iter_t;
+        }
+    }
+
+    m_calls++;
+
+    return(l_iter);
+}
@@ -0,0 +1,143 @@
+/*
+*
+* explicit euler for u_t = c * laplace(u) with the boundary handling of
+* CLinearStencilConstCoeff:
+*
+*    u_{n+1} = u_n + f * L * u_n = 2 * u_n - A * u_n ,  f = c*tau/h^2
+*
+* => stable for f <= 1/6
+* => p_sweepsPerPass timesteps are done within one pass over the memory
+* => the two work vectors are kept between the calls (CWorkspace), their
+*    halos and the padding cells of a padded grid (CGridLayout) stay zero:
+*    m_Op.apply does not write them
+*
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <omp.h>
+#include <string>
+#include "c_linear_stencil_const_coeff_temporal.hpp"
+#include "c_grid.hpp"
+#include "c_workspace.hpp"
+
+#define SWAP_PTR(p_x_new,p_x_old,p_x_tmp) (p_x_tmp=p_x_new, p_x_new=p_x_old, p_x_old=p_x_tmp)
+
+template <typename ValueType, typename VecType>
+class CExplicitEuler
+{
+    private:
+        CLinearStencilConstCoeffTemporal<ValueType, VecType> m_Op;
+        mutable CWorkspace<ValueType, 2> m_workspace;
+
+    public:
+        CExplicitEuler(
+            const std::size_t p_objCols,
+            const std::size_t p_objRows,
+            const std::size_t p_objLevels,
+            const std::size_t p_sweepsPerPass,
+            const ValueType p_c = ValueType(1.0),
+            const ValueType p_h = ValueType(1.0),
+            const ValueType p_tau = ValueType(1.0)
+        );
+        CExplicitEuler(
+            const CGridLayout & p_layout,
+            const std::size_t p_sweepsPerPass,
+            const ValueType p_c = ValueType(1.0),
+            const ValueType p_h = ValueType(1.0),
+            const ValueType p_tau = ValueType(1.0)
+        );
+        inline static const std::string IDENTIFER = "explicit_euler";
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ValueType * __restrict__ p_u_0,
+            ValueType * __restrict__ p_u_1,
+            const std::size_t p_steps,
+            const std::size_t p_bufferSize
+        ) const;
+        const CWorkspace<ValueType, 2> & workspace() const { return m_workspace; }
+};
+
+template <typename ValueType, typename VecType>
+CExplicitEuler<ValueType, VecType>::CExplicitEuler(
+    const std::size_t p_objCols,
+    const std::size_t p_objRows,
+    const std::size_t p_objLevels,
+    const std::size_t p_sweepsPerPass,
+    const ValueType p_c,
+    const ValueType p_h,
+    const ValueType p_tau
+):
+CExplicitEuler(CGridLayout(p_objCols, p_objRows, p_objLevels), p_sweepsPerPass, p_c, p_h, p_tau)
+{
+
+}
+
+template <typename ValueType, typename VecType>
+CExplicitEuler<ValueType, VecType>::CExplicitEuler(
+    const CGridLayout & p_layout,
+    const std::size_t p_sweepsPerPass,
+    const ValueType p_c,
+    const ValueType p_h,
+    const ValueType p_tau
+):
+m_Op(p_layout, p_sweepsPerPass, p_c, p_h, p_tau, ValueType(2.0), ValueType(-1.0))
+{
+
+}
+
+template <typename ValueType, typename VecType>
+std::size_t CExplicitEuler<ValueType, VecType>::operator()(
+    const std::size_t p_size,
+    const ValueType * __restrict__ p_u_0,
+    ValueType * __restrict__ p_u_1,
+    const std::size_t p_steps,
+    const std::size_t p_bufferSize
+) const
+{
+    //
+    // NOTE first touch with the level distribution of m_Op.apply on the
+    //      first call (a level is p_bufferSize values)
+    //
+    m_workspace.reserve(p_size, p_bufferSize);
+
+    ValueType * l_u_k0 = m_workspace.vector(0);
+    ValueType * l_u_k1 = m_workspace.vector(1);
+
+    #pragma omp parallel
+    {
+        ValueType * l_u_k0_t = l_u_k0;
+        ValueType * l_u_k1_t = l_u_k1;
+        ValueType * l_u_tmp_t;
+        std::size_t l_steps_t = 0;
+        std::size_t l_sweeps_t;
+
+        #pragma omp for
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            l_u_k0[i] = p_u_0[i];
+        }
+
+        while (l_steps_t < p_steps)
+        {
+            l_sweeps_t = std::min(m_Op.sweeps(), p_steps - l_steps_t);
+
+            m_Op.apply(l_u_k0_t, l_u_k1_t, l_sweeps_t);
+            SWAP_PTR(l_u_k0_t, l_u_k1_t, l_u_tmp_t);
+
+            l_steps_t += l_sweeps_t;
+        }
+
+        //
+        // NOTE: after the last swap the result is in l_u_k0_t
+        //
+        #pragma omp for
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            p_u_1[i] = l_u_k0_t[i];
+        }
+    }
+
+    return(p_steps);
+}
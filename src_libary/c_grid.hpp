@@ -0,0 +1,232 @@
+/*
+ * Row-major grid with padded pitches and ghost levels.
+ *
+ * CGridLayout describes the indexing l_pos = L*size2d + R*size1d + C of a
+ * cols x rows x levels grid. The row pitch size1d and the plane pitch size2d
+ * default to cols and size1d*rows (the layout of all drivers so far), they
+ * can be padded by p_padRow / p_padPlane values, so that power-of-two strides
+ * (e.g. 2048 columns: 16 KiB rows, 32 MiB planes) do not map the LL/RL/LU/RU
+ * neighbours to the same cache sets and do not 4K-alias. padded() pads a row
+ * to whole cache lines and adds a cache line to the pitches that are
+ * multiples of 4 KiB. Padding cells are never written by the operators.
+ *
+ * All operators take a CGridLayout, the (cols, rows, levels) constructors
+ * are the unpadded layout. The solvers work on the padded vectors with
+ * p_size = objSize3d() and p_bufferSize = bufferSize(), padding cells of b
+ * and x_0 have to be zero and stay zero.
+ *
+ * CGridBox is a sub-box of cells of a layout (half-open ranges), e.g. the
+ * region of a field that changed.
+ *
+ * CGrid owns the values of a CGridLayout (CAllocator, huge pages), the
+ * first cell and every ghost level start on a cache line, a ghost level of
+ * bufferSize() >= size2d zero values in front of and behind the grid.
+ * Everything is zeroed with the level distribution of the operators
+ * (CAllocator::firstTouch).
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <omp.h>
+#include "c_allocator.hpp"
+
+class CGridLayout
+{
+   protected:
+      std::size_t m_objCols;
+      std::size_t m_objRows;
+      std::size_t m_objLevels;
+      std::size_t m_objSize1d;
+      std::size_t m_objSize2d;
+
+   public:
+      CGridLayout(
+         const std::size_t p_objCols,
+         const std::size_t p_objRows,
+         const std::size_t p_objLevels,
+         const std::size_t p_padRow = 0,
+         const std::size_t p_padPlane = 0
+         ):
+      m_objCols(p_objCols),
+      m_objRows(p_objRows),
+      m_objLevels(p_objLevels),
+      m_objSize1d(p_objCols + p_padRow),
+      m_objSize2d((p_objCols + p_padRow) * p_objRows + p_padPlane)
+      {
+
+      }
+
+      //
+      // NOTE rows of whole cache lines, one cache line more on pitches that
+      //      are multiples of 4 KiB
+      //
+      static CGridLayout padded(
+         const std::size_t p_objCols,
+         const std::size_t p_objRows,
+         const std::size_t p_objLevels,
+         const std::size_t p_valueSize
+         )
+      {
+         std::size_t l_line = 64 / p_valueSize;
+         std::size_t l_page = 4096 / p_valueSize;
+
+         std::size_t l_size1d = ((p_objCols + l_line - 1) / l_line) * l_line;
+         if (l_size1d % l_page == 0)
+         {
+            l_size1d += l_line;
+         }
+         std::size_t l_size2d = l_size1d * p_objRows;
+         if (l_size2d % l_page == 0)
+         {
+            l_size2d += l_line;
+         }
+
+         return CGridLayout(p_objCols, p_objRows, p_objLevels, l_size1d - p_objCols, l_size2d - l_size1d * p_objRows);
+      }
+
+      std::size_t objCols() const { return m_objCols; }
+      std::size_t objRows() const { return m_objRows; }
+      std::size_t objLevels() const { return m_objLevels; }
+      std::size_t objSize1d() const { return m_objSize1d; }
+      std::size_t objSize2d() const { return m_objSize2d; }
+      std::size_t objSize3d() const { return m_objSize2d * m_objLevels; }
+      std::size_t objCells() const { return m_objCols * m_objRows * m_objLevels; }
+
+      //
+      // ghost level, a plane rounded up to a multiple of 16 values (whole
+      // cache lines for float and double)
+      //
+      std::size_t bufferSize() const { return ((m_objSize2d + 15) / 16) * 16; }
+
+      bool isPadded() const { return m_objSize1d != m_objCols || m_objSize2d != m_objSize1d * m_objRows; }
+
+      std::size_t pos(const std::size_t p_pos_C, const std::size_t p_pos_R, const std::size_t p_pos_L) const
+      {
+         return p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + p_pos_C;
+      }
+};
+
+class CGridBox
+{
+   private:
+      std::size_t m_colBegin;
+      std::size_t m_colEnd;
+      std::size_t m_rowBegin;
+      std::size_t m_rowEnd;
+      std::size_t m_levelBegin;
+      std::size_t m_levelEnd;
+
+   public:
+      //
+      // cells [p_colBegin, p_colEnd) x [p_rowBegin, p_rowEnd) x
+      // [p_levelBegin, p_levelEnd)
+      //
+      CGridBox(
+         const std::size_t p_colBegin,
+         const std::size_t p_colEnd,
+         const std::size_t p_rowBegin,
+         const std::size_t p_rowEnd,
+         const std::size_t p_levelBegin,
+         const std::size_t p_levelEnd
+         ):
+      m_colBegin(p_colBegin),
+      m_colEnd(p_colEnd),
+      m_rowBegin(p_rowBegin),
+      m_rowEnd(p_rowEnd),
+      m_levelBegin(p_levelBegin),
+      m_levelEnd(p_levelEnd)
+      {
+
+      }
+
+      //
+      // all cells of p_layout
+      //
+      CGridBox(const CGridLayout & p_layout):
+      CGridBox(0, p_layout.objCols(), 0, p_layout.objRows(), 0, p_layout.objLevels())
+      {
+
+      }
+
+      //
+      // NOTE p_cells more cells on every side, clipped to p_layout
+      //
+      CGridBox grown(const std::size_t p_cells, const CGridLayout & p_layout) const
+      {
+         return CGridBox(
+            m_colBegin > p_cells ? m_colBegin - p_cells : 0,
+            m_colEnd + p_cells < p_layout.objCols() ? m_colEnd + p_cells : p_layout.objCols(),
+            m_rowBegin > p_cells ? m_rowBegin - p_cells : 0,
+            m_rowEnd + p_cells < p_layout.objRows() ? m_rowEnd + p_cells : p_layout.objRows(),
+            m_levelBegin > p_cells ? m_levelBegin - p_cells : 0,
+            m_levelEnd + p_cells < p_layout.objLevels() ? m_levelEnd + p_cells : p_layout.objLevels()
+            );
+      }
+
+      std::size_t colBegin() const { return m_colBegin; }
+      std::size_t colEnd() const { return m_colEnd; }
+      std::size_t rowBegin() const { return m_rowBegin; }
+      std::size_t rowEnd() const { return m_rowEnd; }
+      std::size_t levelBegin() const { return m_levelBegin; }
+      std::size_t levelEnd() const { return m_levelEnd; }
+
+      bool empty() const { return m_colBegin >= m_colEnd || m_rowBegin >= m_rowEnd || m_levelBegin >= m_levelEnd; }
+};
+
+template <typename ValueType>
+class CGrid : public CGridLayout
+{
+   private:
+      ValueType * m_raw;
+      ValueType * m_data;
+
+   public:
+      CGrid(const CGridLayout & p_layout);
+      CGrid(const CGrid &) = delete;
+      CGrid & operator=(const CGrid &) = delete;
+
+      //
+      // first cell, the ghost levels are data()-bufferSize() and
+      // data()+objSize3d()
+      //
+      ValueType * data() { return m_data; }
+      const ValueType * data() const { return m_data; }
+
+      ValueType & operator()(const std::size_t p_pos_C, const std::size_t p_pos_R, const std::size_t p_pos_L) { return m_data[pos(p_pos_C, p_pos_R, p_pos_L)]; }
+      const ValueType & operator()(const std::size_t p_pos_C, const std::size_t p_pos_R, const std::size_t p_pos_L) const { return m_data[pos(p_pos_C, p_pos_R, p_pos_L)]; }
+
+      ~CGrid();
+};
+
+template <typename ValueType>
+CGrid<ValueType>::CGrid(const CGridLayout & p_layout):
+CGridLayout(p_layout)
+{
+   std::size_t l_buffer = bufferSize();
+
+   m_raw = CAllocator::allocate<ValueType>(objSize3d()+2*l_buffer);
+   m_data = &(m_raw[l_buffer]);
+
+   //
+   // first touch
+   //
+   #pragma omp parallel
+   {
+      CAllocator::firstTouch(m_data, objSize3d(), m_objSize2d);
+
+      #pragma omp for
+      for (std::size_t i = 0; i < l_buffer; ++i)
+      {
+         m_raw[i] = ValueType(0);
+         m_raw[objSize3d()+l_buffer+i] = ValueType(0);
+      }
+   }
+}
+
+template <typename ValueType>
+CGrid<ValueType>::~CGrid()
+{
+   CAllocator::deallocate(m_raw);
+}
@@ -20,6 +20,18 @@
  * S4: E1-E6-E9-E4
  * S5: E8-E10-E11-E9
  *
+ * RowBlock > 1: unroll-and-jam over rows, RowBlock rows are computed per
+ * column vector and share the loaded x vectors of the rows in between (the
+ * RU neighbour of row r is x of row r+1 and the RL neighbour of row r+2):
+ * RowBlock+2 + 4*RowBlock instead of 7*RowBlock loads. Remaining rows of a
+ * level are computed one by one. Results are bit-identical.
+ *
+ * MemoryPolicy: streaming stores of y and prefetch of the LL/LU planes of
+ * x, see CMemoryPolicy.
+ *
+ * applyLevels computes a range of levels with the kernels of apply on the
+ * calling thread only (matrix powers kernel of CSStepCG).
+ *
  */
 
 #pragma once
@@ -27,11 +39,16 @@
 #include <string>
 #include <omp.h>
 #include "i_linear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_memory_policy.hpp"
+#include "c_grid.hpp"
 
-template <typename ValueType, typename VecType>
+template <typename ValueType, typename VecType, std::size_t RowBlock = 1, typename MemoryPolicy = CMemoryPolicy<>>
 class CLinearStencilConstCoeff : public ILinearOperator<ValueType>
 {
  private:
+    using VecUtils = CVecUtils<ValueType, VecType>;
+
     std::size_t m_objCols;
     std::size_t m_objRows;
     std::size_t m_objLevels;
@@ -40,6 +57,9 @@ class CLinearStencilConstCoeff : public ILinearOperator<ValueType>
     std::size_t m_objSize3d;
     const ValueType m_factor;
 
+    template <std::size_t Rows>
+    void applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const;
+
  public:
     CLinearStencilConstCoeff(
       const std::size_t p_objCols,
@@ -49,13 +69,26 @@ class CLinearStencilConstCoeff : public ILinearOperator<ValueType>
       const ValueType p_h = ValueType(1.0),
       const ValueType p_tau = ValueType(1.0)
       );
-      inline static const std::string IDENTIFER = "linear_stencil_const_coeff";
+    CLinearStencilConstCoeff(
+      const CGridLayout & p_layout,
+      const ValueType p_c = ValueType(1.0),
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0)
+      );
+      static_assert(RowBlock >= 1, "RowBlock has to be >= 1");
+      inline static const std::string IDENTIFER =
+         std::string("linear_stencil_const_coeff")
+         + (RowBlock > 1 ? "_rows_" + std::to_string(RowBlock) : "")
+         + MemoryPolicy::IDENTIFER;
     void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    bool diagonal(ValueType * __restrict__ p_d) const;
+    std::size_t levels() const { return m_objLevels; }
+    void applyLevels(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_levelBegin, const std::size_t p_levelEnd) const;
     ~CLinearStencilConstCoeff();
 };
 
-template <typename ValueType, typename VecType>
-CLinearStencilConstCoeff<ValueType, VecType>::CLinearStencilConstCoeff(
+template <typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+CLinearStencilConstCoeff<ValueType, VecType, RowBlock, MemoryPolicy>::CLinearStencilConstCoeff(
    const std::size_t p_objCols,
    const std::size_t p_objRows,
    const std::size_t p_objLevels,
@@ -63,24 +96,84 @@ CLinearStencilConstCoeff<ValueType, VecType>::CLinearStencilConstCoeff(
    const ValueType p_h,
    const ValueType p_tau
    ):
-m_objCols(p_objCols),
-m_objRows(p_objRows),
-m_objLevels(p_objLevels),
-m_objSize1d(p_objCols),
-m_objSize2d(p_objCols * p_objRows),
-m_objSize3d(p_objCols * p_objRows * p_objLevels),
+CLinearStencilConstCoeff(CGridLayout(p_objCols, p_objRows, p_objLevels), p_c, p_h, p_tau)
+{
+
+}
+
+template <typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+CLinearStencilConstCoeff<ValueType, VecType, RowBlock, MemoryPolicy>::CLinearStencilConstCoeff(
+   const CGridLayout & p_layout,
+   const ValueType p_c,
+   const ValueType p_h,
+   const ValueType p_tau
+   ):
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_objSize1d(p_layout.objSize1d()),
+m_objSize2d(p_layout.objSize2d()),
+m_objSize3d(p_layout.objSize3d()),
 m_factor(p_c*p_tau/(p_h*p_h))
 {
 
 }
 
-template <typename ValueType, typename VecType>
-void CLinearStencilConstCoeff<ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+template <typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+void CLinearStencilConstCoeff<ValueType, VecType, RowBlock, MemoryPolicy>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   std::size_t l_pos_R;
+
+   #pragma omp for nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (l_pos_R=0; l_pos_R+RowBlock<=m_objRows; l_pos_R+=RowBlock)
+      {
+         applyRows<RowBlock>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+      for (; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         applyRows<1>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+   }
+
+   MemoryPolicy::fence();
+   #pragma omp barrier
+}
+
+template <typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+void CLinearStencilConstCoeff<ValueType, VecType, RowBlock, MemoryPolicy>::applyLevels(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_levelBegin, const std::size_t p_levelEnd) const
+{
+   std::size_t l_pos_R;
+
+   for (std::size_t l_pos_L=p_levelBegin; l_pos_L<p_levelEnd; ++l_pos_L)
+   {
+      for (l_pos_R=0; l_pos_R+RowBlock<=m_objRows; l_pos_R+=RowBlock)
+      {
+         applyRows<RowBlock>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+      for (; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         applyRows<1>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+   }
+
+   MemoryPolicy::fence();
+}
+
+template <typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+bool CLinearStencilConstCoeff<ValueType, VecType, RowBlock, MemoryPolicy>::diagonal(ValueType * __restrict__ p_d) const
 {
+   //
+   // NOTE computed on the fly with the factors of applyRows
+   //
    std::size_t l_pos;
+   std::size_t l_n;
 
    VecType l_pos_C_Vec;
 
+   VecType l_lane_Vec = VecUtils::lanes();
+
    ValueType l_factor_LL;
    ValueType l_factor_RL;
    ValueType l_factor_RU;
@@ -89,69 +182,125 @@ void CLinearStencilConstCoeff<ValueType, VecType>::apply(const ValueType * __res
    VecType l_factor_CL_Vec;
    VecType l_factor_CU_Vec;
 
-   VecType l_x_LL_Vec;
-   VecType l_x_RL_Vec;
-   VecType l_x_CL_Vec;
-   VecType l_x_Vec;
-   VecType l_x_CU_Vec;
-   VecType l_x_RU_Vec;
-   VecType l_x_LU_Vec;
-
-   VecType l_y_Vec;
+   VecType l_d_Vec;
 
    #pragma omp for
    for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
    {
+      l_factor_LL = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor;
+      l_factor_LU = (1-(l_pos_L                /(m_objLevels-1))) * m_factor;
+
       for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
       {
+         l_factor_RL = (1-((m_objRows-1-l_pos_R)/(m_objRows-1))) * m_factor;
+         l_factor_RU = (1-(l_pos_R              /(m_objRows-1))) * m_factor;
+
          for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
          {
             l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+            l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
 
-            //
-            // WORKAROUND hardcoded vector size of 4
-            //
-            l_pos_C_Vec = VecType(l_pos_C, l_pos_C+1, l_pos_C+2, l_pos_C+3);
-
-            l_x_LL_Vec.load(p_x + l_pos - m_objSize2d);
-            l_x_RL_Vec.load(p_x + l_pos - m_objSize1d);
-            l_x_CL_Vec.load(p_x + l_pos - 1          );
-            l_x_Vec.load(   p_x + l_pos              );
-            l_x_CU_Vec.load(p_x + l_pos + 1          );
-            l_x_RU_Vec.load(p_x + l_pos + m_objSize1d);
-            l_x_LU_Vec.load(p_x + l_pos + m_objSize2d);
-
-            l_factor_CL_Vec = select(l_pos_C_Vec>0,           m_factor, 0.0);
-            l_factor_CU_Vec = select(l_pos_C_Vec<m_objCols-1,   m_factor, 0.0);
-
-            l_factor_LL = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor;
-            l_factor_RL = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor;
-            l_factor_RU = (1-(l_pos_R                /(m_objRows-1)))   * m_factor;
-            l_factor_LU = (1-(l_pos_L                /(m_objLevels-1))) * m_factor;
-
-            l_y_Vec =
-                     ( 1               +
-                        l_factor_LL     +
-                        l_factor_RL     +
-                        l_factor_CL_Vec +
-                        l_factor_CU_Vec +
-                        l_factor_RU     +
-                        l_factor_LU
-                     )                 * l_x_Vec
-                  - l_factor_LL       * l_x_LL_Vec
-                  - l_factor_RL       * l_x_RL_Vec
-                  - l_factor_CL_Vec   * l_x_CL_Vec
-                  - l_factor_CU_Vec   * l_x_CU_Vec
-                  - l_factor_RU       * l_x_RU_Vec
-                  - l_factor_LU       * l_x_LU_Vec;
-            l_y_Vec.store(p_y + l_pos);
+            l_d_Vec = 1 + l_factor_LL + l_factor_RL + l_factor_CL_Vec + l_factor_CU_Vec + l_factor_RU + l_factor_LU;
+            VecUtils::store(l_d_Vec, p_d + l_pos, l_n);
          }
       }
    }
+
+   return true;
+}
+
+template <typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+template <std::size_t Rows>
+inline void CLinearStencilConstCoeff<ValueType, VecType, RowBlock, MemoryPolicy>::applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const
+{
+   std::size_t l_pos;
+   std::size_t l_pos_0;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   ValueType l_factor_LL;
+   ValueType l_factor_RL;
+   ValueType l_factor_RU;
+   ValueType l_factor_LU;
+
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+
+   //
+   // NOTE x of the rows p_pos_R-1, ..., p_pos_R+Rows
+   //
+   VecType l_x_R_Vec[Rows+2];
+
+   VecType l_x_LL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   l_factor_LL = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor;
+   l_factor_LU = (1-(p_pos_L                /(m_objLevels-1))) * m_factor;
+
+   for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+   {
+      l_pos_0 = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + l_pos_C;
+      l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+      l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+      l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+      for (std::size_t k=0; k<Rows+2; ++k)
+      {
+         VecUtils::load(l_x_R_Vec[k], p_x + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+      }
+
+      for (std::size_t b=0; b<Rows; ++b)
+      {
+         l_pos = l_pos_0 + b * m_objSize1d;
+
+         MemoryPolicy::prefetch(p_x + l_pos - m_objSize2d);
+         MemoryPolicy::prefetch(p_x + l_pos + m_objSize2d);
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         l_factor_RL = (1-((m_objRows-1-p_pos_R-b)/(m_objRows-1))) * m_factor;
+         l_factor_RU = (1-((p_pos_R+b)            /(m_objRows-1))) * m_factor;
+
+         l_y_Vec =
+                  ( 1               +
+                     l_factor_LL     +
+                     l_factor_RL     +
+                     l_factor_CL_Vec +
+                     l_factor_CU_Vec +
+                     l_factor_RU     +
+                     l_factor_LU
+                  )                 * l_x_R_Vec[b+1]
+               - l_factor_LL       * l_x_LL_Vec
+               - l_factor_RL       * l_x_R_Vec[b]
+               - l_factor_CL_Vec   * l_x_CL_Vec
+               - l_factor_CU_Vec   * l_x_CU_Vec
+               - l_factor_RU       * l_x_R_Vec[b+2]
+               - l_factor_LU       * l_x_LU_Vec;
+         MemoryPolicy::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+   }
 }
 
-template <typename ValueType, typename VecType>
-CLinearStencilConstCoeff<ValueType, VecType>::~CLinearStencilConstCoeff()
+template <typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+CLinearStencilConstCoeff<ValueType, VecType, RowBlock, MemoryPolicy>::~CLinearStencilConstCoeff()
 {
 
 }
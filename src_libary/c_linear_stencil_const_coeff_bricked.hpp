@@ -0,0 +1,300 @@
+/*
+ * CLinearStencilConstCoeff on bricked vectors, see CBrickLayout.
+ *
+ * The bricks are distributed over the threads, a brick row of BrickSize
+ * cells is BrickSize / VecType::size() vectors. The rows below/above and
+ * the levels below/above are loaded from the same brick or, on the faces of
+ * the brick, from the neighbour brick, the -1/+1 column neighbours are
+ * blended from the current and the neighbouring vector of the row
+ * (CVecUtils::shiftLow/shiftHigh). Outside of the grid the zero halo brick
+ * in front of p_x is read (with zero factors, like the halo of the row-major
+ * layout). Padding cells of y are written as zero.
+ *
+ * The boundary factors are computed from the global position of the cell
+ * as in CLinearStencilConstCoeff, the results are bit-identical to it.
+ * diagonal() writes the bricked diagonal, zero for the padding cells.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <omp.h>
+#include "i_linear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_brick_layout.hpp"
+
+template <typename ValueType, typename VecType, std::size_t BrickSize>
+class CLinearStencilConstCoeffBricked : public ILinearOperator<ValueType>
+{
+ private:
+    using VecUtils = CVecUtils<ValueType, VecType>;
+    using Layout = CBrickLayout<BrickSize>;
+
+    const Layout & m_layout;
+    std::size_t m_objCols;
+    std::size_t m_objRows;
+    std::size_t m_objLevels;
+    const ValueType m_factor;
+
+    void applyBrick(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_brick) const;
+
+ public:
+    CLinearStencilConstCoeffBricked(
+      const Layout & p_layout,
+      const ValueType p_c = ValueType(1.0),
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0)
+      );
+      static_assert(BrickSize % VecType::size() == 0, "BrickSize has to be a multiple of the vector width");
+      inline static const std::string IDENTIFER =
+         std::string("linear_stencil_const_coeff")
+         + Layout::IDENTIFER;
+    void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    bool diagonal(ValueType * __restrict__ p_d) const;
+    ~CLinearStencilConstCoeffBricked();
+};
+
+template <typename ValueType, typename VecType, std::size_t BrickSize>
+CLinearStencilConstCoeffBricked<ValueType, VecType, BrickSize>::CLinearStencilConstCoeffBricked(
+   const Layout & p_layout,
+   const ValueType p_c,
+   const ValueType p_h,
+   const ValueType p_tau
+   ):
+m_layout(p_layout),
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_factor(p_c*p_tau/(p_h*p_h))
+{
+
+}
+
+template <typename ValueType, typename VecType, std::size_t BrickSize>
+void CLinearStencilConstCoeffBricked<ValueType, VecType, BrickSize>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   #pragma omp for nowait schedule(static)
+   for (std::size_t l_brick=0; l_brick<m_layout.bricks(); ++l_brick)
+   {
+      applyBrick(p_x, p_y, l_brick);
+   }
+
+   #pragma omp barrier
+}
+
+template <typename ValueType, typename VecType, std::size_t BrickSize>
+bool CLinearStencilConstCoeffBricked<ValueType, VecType, BrickSize>::diagonal(ValueType * __restrict__ p_d) const
+{
+   constexpr std::size_t B = BrickSize;
+   constexpr std::size_t V = VecType::size();
+
+   std::size_t l_pos_R;
+   std::size_t l_pos_L;
+   std::size_t l_row;
+
+   ValueType * l_d;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   ValueType l_factor_LL;
+   ValueType l_factor_RL;
+   ValueType l_factor_RU;
+   ValueType l_factor_LU;
+
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+
+   VecType l_d_Vec;
+
+   #pragma omp for schedule(static)
+   for (std::size_t l_brick=0; l_brick<m_layout.bricks(); ++l_brick)
+   {
+      l_d = p_d + l_brick * Layout::BRICK_CELLS;
+
+      for (std::size_t l=0; l<B; ++l)
+      {
+         l_pos_L = m_layout.origin(l_brick, 2) + l;
+
+         for (std::size_t r=0; r<B; ++r)
+         {
+            l_pos_R = m_layout.origin(l_brick, 1) + r;
+            l_row = (l*B + r)*B;
+
+            if (l_pos_L >= m_objLevels || l_pos_R >= m_objRows)
+            {
+               for (std::size_t j=0; j<B; j+=V)
+               {
+                  VecUtils::store(VecType(0), l_d + l_row + j, V);
+               }
+               continue;
+            }
+
+            l_factor_LL = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor;
+            l_factor_LU = (1-(l_pos_L                /(m_objLevels-1))) * m_factor;
+            l_factor_RL = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor;
+            l_factor_RU = (1-(l_pos_R                /(m_objRows-1)))   * m_factor;
+
+            for (std::size_t j=0; j<B; j+=V)
+            {
+               l_pos_C_Vec = l_lane_Vec + ValueType(m_layout.origin(l_brick, 0) + j);
+
+               l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+               l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+               l_d_Vec = 1 + l_factor_LL + l_factor_RL + l_factor_CL_Vec + l_factor_CU_Vec + l_factor_RU + l_factor_LU;
+               l_d_Vec = select(l_pos_C_Vec<ValueType(m_objCols), l_d_Vec, VecType(0));
+               VecUtils::store(l_d_Vec, l_d + l_row + j, V);
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
+template <typename ValueType, typename VecType, std::size_t BrickSize>
+inline void CLinearStencilConstCoeffBricked<ValueType, VecType, BrickSize>::applyBrick(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_brick) const
+{
+   constexpr std::size_t B = BrickSize;
+   constexpr std::size_t V = VecType::size();
+
+   const ValueType * l_x = p_x + p_brick * Layout::BRICK_CELLS;
+   ValueType * l_y = p_y + p_brick * Layout::BRICK_CELLS;
+
+   const ValueType * l_x_nb_CL = p_x + m_layout.neighbour(p_brick, Layout::NB_CL);
+   const ValueType * l_x_nb_CU = p_x + m_layout.neighbour(p_brick, Layout::NB_CU);
+   const ValueType * l_x_nb_RL = p_x + m_layout.neighbour(p_brick, Layout::NB_RL);
+   const ValueType * l_x_nb_RU = p_x + m_layout.neighbour(p_brick, Layout::NB_RU);
+   const ValueType * l_x_nb_LL = p_x + m_layout.neighbour(p_brick, Layout::NB_LL);
+   const ValueType * l_x_nb_LU = p_x + m_layout.neighbour(p_brick, Layout::NB_LU);
+
+   std::size_t l_origin_C = m_layout.origin(p_brick, 0);
+   std::size_t l_origin_R = m_layout.origin(p_brick, 1);
+   std::size_t l_origin_L = m_layout.origin(p_brick, 2);
+
+   //
+   // NOTE the last brick of a row of bricks has padding columns
+   //
+   bool l_padded_C = l_origin_C + B > m_objCols;
+
+   std::size_t l_pos_R;
+   std::size_t l_pos_L;
+   std::size_t l_row;
+
+   const ValueType * l_x_row;
+   const ValueType * l_x_RL_row;
+   const ValueType * l_x_RU_row;
+   const ValueType * l_x_LL_row;
+   const ValueType * l_x_LU_row;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   ValueType l_factor_LL;
+   ValueType l_factor_RL;
+   ValueType l_factor_RU;
+   ValueType l_factor_LU;
+
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_x_prev_Vec;
+   VecType l_x_next_Vec;
+
+   VecType l_y_Vec;
+
+   for (std::size_t l=0; l<B; ++l)
+   {
+      l_pos_L = l_origin_L + l;
+
+      for (std::size_t r=0; r<B; ++r)
+      {
+         l_pos_R = l_origin_R + r;
+         l_row = (l*B + r)*B;
+
+         if (l_pos_L >= m_objLevels || l_pos_R >= m_objRows)
+         {
+            for (std::size_t j=0; j<B; j+=V)
+            {
+               VecUtils::store(VecType(0), l_y + l_row + j, V);
+            }
+            continue;
+         }
+
+         l_factor_LL = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor;
+         l_factor_LU = (1-(l_pos_L                /(m_objLevels-1))) * m_factor;
+         l_factor_RL = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor;
+         l_factor_RU = (1-(l_pos_R                /(m_objRows-1)))   * m_factor;
+
+         l_x_row    = l_x + l_row;
+         l_x_RL_row = r > 0   ? l_x_row - B     : l_x_nb_RL + l_row + (B-1)*B;
+         l_x_RU_row = r < B-1 ? l_x_row + B     : l_x_nb_RU + l_row - (B-1)*B;
+         l_x_LL_row = l > 0   ? l_x_row - B*B   : l_x_nb_LL + l_row + (B-1)*B*B;
+         l_x_LU_row = l < B-1 ? l_x_row + B*B   : l_x_nb_LU + l_row - (B-1)*B*B;
+
+         VecUtils::load(l_x_prev_Vec, l_x_nb_CL + l_row + B - V, V);
+         VecUtils::load(l_x_Vec,      l_x_row,                   V);
+
+         for (std::size_t j=0; j<B; j+=V)
+         {
+            VecUtils::load(l_x_next_Vec, j+V < B ? l_x_row + j + V : l_x_nb_CU + l_row, V);
+
+            l_x_CL_Vec = VecUtils::shiftLow(l_x_prev_Vec, l_x_Vec);
+            l_x_CU_Vec = VecUtils::shiftHigh(l_x_Vec, l_x_next_Vec);
+
+            VecUtils::load(l_x_LL_Vec, l_x_LL_row + j, V);
+            VecUtils::load(l_x_RL_Vec, l_x_RL_row + j, V);
+            VecUtils::load(l_x_RU_Vec, l_x_RU_row + j, V);
+            VecUtils::load(l_x_LU_Vec, l_x_LU_row + j, V);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_origin_C + j);
+
+            l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+            l_y_Vec =
+                     ( 1               +
+                        l_factor_LL     +
+                        l_factor_RL     +
+                        l_factor_CL_Vec +
+                        l_factor_CU_Vec +
+                        l_factor_RU     +
+                        l_factor_LU
+                     )                 * l_x_Vec
+                  - l_factor_LL       * l_x_LL_Vec
+                  - l_factor_RL       * l_x_RL_Vec
+                  - l_factor_CL_Vec   * l_x_CL_Vec
+                  - l_factor_CU_Vec   * l_x_CU_Vec
+                  - l_factor_RU       * l_x_RU_Vec
+                  - l_factor_LU       * l_x_LU_Vec;
+
+            if (l_padded_C)
+            {
+               l_y_Vec = select(l_pos_C_Vec<ValueType(m_objCols), l_y_Vec, VecType(0));
+            }
+            VecUtils::store(l_y_Vec, l_y + l_row + j, V);
+
+            l_x_prev_Vec = l_x_Vec;
+            l_x_Vec      = l_x_next_Vec;
+         }
+      }
+   }
+}
+
+template <typename ValueType, typename VecType, std::size_t BrickSize>
+CLinearStencilConstCoeffBricked<ValueType, VecType, BrickSize>::~CLinearStencilConstCoeffBricked()
+{
+
+}
@@ -0,0 +1,529 @@
+/*
+ * Temporally blocked version of CLinearStencilConstCoeff.
+ *
+ * One call of apply performs p_sweeps sweeps
+ *
+ *    x_{t+1} = alpha * x_t + beta * A * x_t
+ *
+ * with a single pass over the main memory arrays. The grid is split into
+ * tiles of m_tileRows x m_tileCols cells of a level (all levels), the tiles
+ * are distributed over the threads (static schedule) and are independent.
+ * Within a tile the sweeps are executed as a wavefront over the levels: in
+ * front w the sweep t updates level w-t+1, so every sweep only needs the
+ * levels l-1, l and l+1 of the previous sweep. These are kept in a ring of 3
+ * tile planes per intermediate sweep. Only p_x is read and only p_y is
+ * written to main memory.
+ *
+ * The intermediate sweeps are computed on the tile widened by a ghost zone
+ * of k-1 rows and columns (columns rounded up to whole vectors), the values
+ * at distance d from the edge of the ghost zone are valid after d+1 sweeps,
+ * so the last sweep reads only valid values. The ghost zones are computed
+ * redundantly by the neighbouring tiles (overlapped tiling), there is no
+ * barrier between the fronts. The ring of a thread holds 3*(k-1) tile
+ * planes, with the defaults (32 x 256 cells) and k = 4 about 0.8 MB for
+ * double, independent of the grid size, so that the intermediate sweeps stay
+ * in the cache.
+ *
+ *    alpha = 0, beta =  1: x_{t+1} = A x_t           (repeated apply)
+ *    alpha = 2, beta = -1: x_{t+1} = x_t + f*L*x_t    (explicit euler step)
+ *
+ * p_x has to provide a halo of m_objSize2d on both sides (as for apply).
+ *
+ * The rings of all threads are one array of CAllocator, reserved and first
+ * touched (owner thread) in the constructor for omp_get_max_threads()
+ * threads, apply grows it only if it is called by a larger team. A tile
+ * plane has a halo of one row and one vector on every side, the halo and the
+ * zero plane (levels outside of the grid) are zeroed once at allocation and
+ * never written.
+ *
+ * The constructor throws std::invalid_argument for p_sweeps = 0 or empty
+ * tiles.
+ *
+ * diagonal() is only provided for p_sweeps = 1 (alpha + beta * diagonal of
+ * A), the diagonal of a polynomial of A is not computed.
+ *
+ */
+
+#pragma once
+
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <omp.h>
+#include "i_linear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
+
+template <typename ValueType, typename VecType>
+class CLinearStencilConstCoeffTemporal : public ILinearOperator<ValueType>
+{
+ private:
+    using VecUtils = CVecUtils<ValueType, VecType>;
+
+    std::size_t m_objCols;
+    std::size_t m_objRows;
+    std::size_t m_objLevels;
+    std::size_t m_objSize1d;
+    std::size_t m_objSize2d;
+    std::size_t m_objSize3d;
+    const ValueType m_factor;
+    const std::size_t m_sweeps;
+    const ValueType m_alpha;
+    const ValueType m_beta;
+    std::size_t m_tileRows;
+    std::size_t m_tileCols;
+    std::size_t m_ghostRows;
+    std::size_t m_ghostCols;
+    std::size_t m_tilePitch;
+    std::size_t m_tilePlaneSize;
+    std::size_t m_ringSize;
+    mutable ValueType * m_rings;
+    mutable std::size_t m_ringsCapacity;
+    mutable std::size_t m_ringThreads;
+    ValueType * m_tileZero;
+    std::size_t m_tileZeroCapacity;
+
+    void reserveRings(const std::size_t p_threads) const;
+    ValueType * tilePlane(ValueType * p_plane, const std::size_t p_pos_R, const std::size_t p_pos_C, const std::size_t p_tile_R, const std::size_t p_tile_C) const;
+    void applyTile(
+      const ValueType * __restrict__ p_x_LL,
+      const ValueType * __restrict__ p_x,
+      const ValueType * __restrict__ p_x_LU,
+      const std::size_t p_pitchX,
+      ValueType * __restrict__ p_y,
+      const std::size_t p_pitchY,
+      const std::size_t p_pos_L,
+      const std::size_t p_rowBegin,
+      const std::size_t p_rowEnd,
+      const std::size_t p_colBegin,
+      const std::size_t p_colEnd
+      ) const;
+
+ public:
+    CLinearStencilConstCoeffTemporal(
+      const std::size_t p_objCols,
+      const std::size_t p_objRows,
+      const std::size_t p_objLevels,
+      const std::size_t p_sweeps,
+      const ValueType p_c = ValueType(1.0),
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_alpha = ValueType(0.0),
+      const ValueType p_beta = ValueType(1.0),
+      const std::size_t p_tileRows = 32,
+      const std::size_t p_tileCols = 256
+      );
+    CLinearStencilConstCoeffTemporal(
+      const CGridLayout & p_layout,
+      const std::size_t p_sweeps,
+      const ValueType p_c = ValueType(1.0),
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_alpha = ValueType(0.0),
+      const ValueType p_beta = ValueType(1.0),
+      const std::size_t p_tileRows = 32,
+      const std::size_t p_tileCols = 256
+      );
+    CLinearStencilConstCoeffTemporal(const CLinearStencilConstCoeffTemporal &) = delete;
+    CLinearStencilConstCoeffTemporal & operator=(const CLinearStencilConstCoeffTemporal &) = delete;
+      inline static const std::string IDENTIFER = "linear_stencil_const_coeff_temporal";
+    void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_sweeps) const;
+    bool diagonal(ValueType * __restrict__ p_d) const;
+    std::size_t sweeps() const;
+    ~CLinearStencilConstCoeffTemporal();
+};
+
+template <typename ValueType, typename VecType>
+CLinearStencilConstCoeffTemporal<ValueType, VecType>::CLinearStencilConstCoeffTemporal(
+   const std::size_t p_objCols,
+   const std::size_t p_objRows,
+   const std::size_t p_objLevels,
+   const std::size_t p_sweeps,
+   const ValueType p_c,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_alpha,
+   const ValueType p_beta,
+   const std::size_t p_tileRows,
+   const std::size_t p_tileCols
+   ):
+CLinearStencilConstCoeffTemporal(CGridLayout(p_objCols, p_objRows, p_objLevels), p_sweeps, p_c, p_h, p_tau, p_alpha, p_beta, p_tileRows, p_tileCols)
+{
+
+}
+
+template <typename ValueType, typename VecType>
+CLinearStencilConstCoeffTemporal<ValueType, VecType>::CLinearStencilConstCoeffTemporal(
+   const CGridLayout & p_layout,
+   const std::size_t p_sweeps,
+   const ValueType p_c,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_alpha,
+   const ValueType p_beta,
+   const std::size_t p_tileRows,
+   const std::size_t p_tileCols
+   ):
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_objSize1d(p_layout.objSize1d()),
+m_objSize2d(p_layout.objSize2d()),
+m_objSize3d(p_layout.objSize3d()),
+m_factor(p_c*p_tau/(p_h*p_h)),
+m_sweeps(p_sweeps),
+m_alpha(p_alpha),
+m_beta(p_beta),
+m_rings(nullptr),
+m_ringsCapacity(0),
+m_ringThreads(0),
+m_tileZero(nullptr),
+m_tileZeroCapacity(0)
+{
+   //
+   // NOTE p_sweeps = 0 has no meaning (the ring would have 3*(0-1) planes),
+   //      empty tiles would never advance
+   //
+   if (p_sweeps < 1)
+   {
+      throw std::invalid_argument("CLinearStencilConstCoeffTemporal: p_sweeps has to be >= 1");
+   }
+   if (p_tileRows < 1 || p_tileCols < 1)
+   {
+      throw std::invalid_argument("CLinearStencilConstCoeffTemporal: p_tileRows and p_tileCols have to be >= 1");
+   }
+
+   //
+   // NOTE tile columns and column ghosts are whole vectors, so that the
+   //      tiles of a row start at the same lane
+   //
+   m_tileRows = p_tileRows;
+   m_tileCols = ((p_tileCols + VecType::size() - 1) / VecType::size()) * VecType::size();
+   m_ghostRows = m_sweeps > 1 ? m_sweeps - 1 : 0;
+   m_ghostCols = ((m_ghostRows + VecType::size() - 1) / VecType::size()) * VecType::size();
+
+   //
+   // NOTE halo of one row and one vector so that RL/RU/CL/CU of the first
+   //      and the last row / vector can be loaded without a case distinction
+   //
+   m_tilePitch = VecType::size() + m_ghostCols + m_tileCols + m_ghostCols + VecType::size();
+   m_tilePlaneSize = (1 + m_ghostRows + m_tileRows + m_ghostRows + 1) * m_tilePitch;
+
+   //
+   // NOTE 3 tile planes for each intermediate sweep
+   //
+   m_ringSize = m_sweeps > 1 ? 3*(m_sweeps-1)*m_tilePlaneSize : 0;
+
+   CAllocator::reserve(m_tileZero, m_tileZeroCapacity, m_tilePlaneSize);
+
+   for (std::size_t i = 0; i < m_tilePlaneSize; ++i)
+   {
+      m_tileZero[i] = ValueType(0);
+   }
+
+   #pragma omp parallel
+   {
+      reserveRings(omp_get_num_threads());
+   }
+}
+
+template <typename ValueType, typename VecType>
+void CLinearStencilConstCoeffTemporal<ValueType, VecType>::reserveRings(const std::size_t p_threads) const
+{
+   //
+   // NOTE called by all threads of a team, the ring of thread t is touched
+   //      by thread t (static schedule, one ring per iteration)
+   //
+   if (m_ringSize == 0)
+   {
+      return;
+   }
+
+   #pragma omp single
+   {
+      CAllocator::reserve(m_rings, m_ringsCapacity, p_threads*m_ringSize);
+      m_ringThreads = p_threads;
+   }
+
+   CAllocator::firstTouch(m_rings, p_threads*m_ringSize, m_ringSize);
+}
+
+template <typename ValueType, typename VecType>
+std::size_t CLinearStencilConstCoeffTemporal<ValueType, VecType>::sweeps() const
+{
+   return m_sweeps;
+}
+
+template <typename ValueType, typename VecType>
+ValueType * CLinearStencilConstCoeffTemporal<ValueType, VecType>::tilePlane(ValueType * p_plane, const std::size_t p_pos_R, const std::size_t p_pos_C, const std::size_t p_tile_R, const std::size_t p_tile_C) const
+{
+   //
+   // NOTE cell (p_pos_R, p_pos_C) of the tile starting at (p_tile_R,
+   //      p_tile_C), p_pos_R >= p_tile_R - m_ghostRows and
+   //      p_pos_C >= p_tile_C - m_ghostCols
+   //
+   return p_plane + (1 + p_pos_R + m_ghostRows - p_tile_R) * m_tilePitch + VecType::size() + p_pos_C + m_ghostCols - p_tile_C;
+}
+
+template <typename ValueType, typename VecType>
+void CLinearStencilConstCoeffTemporal<ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   apply(p_x, p_y, m_sweeps);
+}
+
+template <typename ValueType, typename VecType>
+void CLinearStencilConstCoeffTemporal<ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_sweeps) const
+{
+   assert(p_sweeps >= 1 && p_sweeps <= m_sweeps);
+
+   //
+   // NOTE every thread reads m_ringThreads before one of them can grow the
+   //      rings behind the barrier (all threads take the same branch)
+   //
+   std::size_t l_threads = omp_get_num_threads();
+
+   if (m_ringSize > 0 && l_threads > m_ringThreads)
+   {
+      #pragma omp barrier
+      reserveRings(l_threads);
+   }
+
+   std::size_t l_tilesR = (m_objRows + m_tileRows - 1) / m_tileRows;
+   std::size_t l_tilesC = (m_objCols + m_tileCols - 1) / m_tileCols;
+
+   ValueType * l_ring = m_rings + omp_get_thread_num() * m_ringSize;
+
+   #pragma omp for schedule(static)
+   for (std::size_t l_tile=0; l_tile<l_tilesR*l_tilesC; ++l_tile)
+   {
+      //
+      // NOTE tile [R0, R1) x [C0, C1), intermediate sweeps on the ghost
+      //      zone [G_R0, G_R1) x [G_C0, G_C1)
+      //
+      std::size_t l_R0 = (l_tile / l_tilesC) * m_tileRows;
+      std::size_t l_C0 = (l_tile % l_tilesC) * m_tileCols;
+      std::size_t l_R1 = l_R0 + m_tileRows < m_objRows ? l_R0 + m_tileRows : m_objRows;
+      std::size_t l_C1 = l_C0 + m_tileCols < m_objCols ? l_C0 + m_tileCols : m_objCols;
+      std::size_t l_G_R0 = l_R0 > m_ghostRows ? l_R0 - m_ghostRows : 0;
+      std::size_t l_G_C0 = l_C0 > m_ghostCols ? l_C0 - m_ghostCols : 0;
+      std::size_t l_G_R1 = l_R1 + m_ghostRows < m_objRows ? l_R1 + m_ghostRows : m_objRows;
+      std::size_t l_G_C1 = l_C1 + m_ghostCols < m_objCols ? l_C1 + m_ghostCols : m_objCols;
+
+      for (std::size_t l_front=0; l_front<m_objLevels+p_sweeps-1; ++l_front)
+      {
+         for (std::size_t l_sweep=1; l_sweep<=p_sweeps; ++l_sweep)
+         {
+            long l_pos_L = long(l_front) - long(l_sweep-1);
+            if (l_pos_L < 0 || l_pos_L >= long(m_objLevels))
+            {
+               continue;
+            }
+
+            bool l_last = l_sweep == p_sweeps;
+            std::size_t l_rowBegin = l_last ? l_R0 : l_G_R0;
+            std::size_t l_rowEnd =   l_last ? l_R1 : l_G_R1;
+            std::size_t l_colBegin = l_last ? l_C0 : l_G_C0;
+            std::size_t l_colEnd =   l_last ? l_C1 : l_G_C1;
+
+            const ValueType * l_x[3];
+            std::size_t l_pitchX;
+
+            for (long l_d=-1; l_d<=1; ++l_d)
+            {
+               long l_pos_LX = l_pos_L + l_d;
+
+               if (l_sweep == 1)
+               {
+                  //
+                  // NOTE level -1 and m_objLevels are part of the halo of p_x
+                  //
+                  l_x[l_d+1] = p_x + l_pos_LX * long(m_objSize2d) + long(l_rowBegin * m_objSize1d + l_colBegin);
+               }
+               else if (l_pos_LX < 0 || l_pos_LX >= long(m_objLevels))
+               {
+                  l_x[l_d+1] = tilePlane(m_tileZero, l_rowBegin, l_colBegin, l_R0, l_C0);
+               }
+               else
+               {
+                  l_x[l_d+1] = tilePlane(l_ring + (3*(l_sweep-2) + l_pos_LX%3)*m_tilePlaneSize, l_rowBegin, l_colBegin, l_R0, l_C0);
+               }
+            }
+            l_pitchX = l_sweep == 1 ? m_objSize1d : m_tilePitch;
+
+            ValueType * l_y = l_last
+               ? p_y + l_pos_L * m_objSize2d + l_rowBegin * m_objSize1d + l_colBegin
+               : tilePlane(l_ring + (3*(l_sweep-1) + l_pos_L%3)*m_tilePlaneSize, l_rowBegin, l_colBegin, l_R0, l_C0);
+
+            applyTile(
+               l_x[0],
+               l_x[1],
+               l_x[2],
+               l_pitchX,
+               l_y,
+               l_last ? m_objSize1d : m_tilePitch,
+               l_pos_L,
+               l_rowBegin,
+               l_rowEnd,
+               l_colBegin,
+               l_colEnd
+            );
+         }
+      }
+   }
+}
+
+template <typename ValueType, typename VecType>
+bool CLinearStencilConstCoeffTemporal<ValueType, VecType>::diagonal(ValueType * __restrict__ p_d) const
+{
+   if (m_sweeps != 1)
+   {
+      return false;
+   }
+
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   ValueType l_factor_LL;
+   ValueType l_factor_RL;
+   ValueType l_factor_RU;
+   ValueType l_factor_LU;
+
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+
+   VecType l_d_Vec;
+
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      l_factor_LL = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor;
+      l_factor_LU = (1-(l_pos_L                /(m_objLevels-1))) * m_factor;
+
+      for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         l_factor_RL = (1-((m_objRows-1-l_pos_R)/(m_objRows-1))) * m_factor;
+         l_factor_RU = (1-(l_pos_R              /(m_objRows-1))) * m_factor;
+
+         for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+         {
+            l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+            l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+            l_d_Vec = 1 + l_factor_LL + l_factor_RL + l_factor_CL_Vec + l_factor_CU_Vec + l_factor_RU + l_factor_LU;
+            l_d_Vec = m_alpha + m_beta * l_d_Vec;
+            VecUtils::store(l_d_Vec, p_d + l_pos, l_n);
+         }
+      }
+   }
+
+   return true;
+}
+
+template <typename ValueType, typename VecType>
+void CLinearStencilConstCoeffTemporal<ValueType, VecType>::applyTile(
+   const ValueType * __restrict__ p_x_LL,
+   const ValueType * __restrict__ p_x,
+   const ValueType * __restrict__ p_x_LU,
+   const std::size_t p_pitchX,
+   ValueType * __restrict__ p_y,
+   const std::size_t p_pitchY,
+   const std::size_t p_pos_L,
+   const std::size_t p_rowBegin,
+   const std::size_t p_rowEnd,
+   const std::size_t p_colBegin,
+   const std::size_t p_colEnd
+   ) const
+{
+   //
+   // NOTE p_x_LL, p_x, p_x_LU and p_y point to cell (p_rowBegin,
+   //      p_colBegin), rows are p_pitchX / p_pitchY values apart
+   //
+   std::size_t l_posX;
+   std::size_t l_posY;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   ValueType l_factor_LL = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor;
+   ValueType l_factor_RL;
+   ValueType l_factor_RU;
+   ValueType l_factor_LU = (1-(p_pos_L                /(m_objLevels-1))) * m_factor;
+
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   for (std::size_t l_pos_R=p_rowBegin; l_pos_R<p_rowEnd; ++l_pos_R)
+   {
+      l_factor_RL = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor;
+      l_factor_RU = (1-(l_pos_R                /(m_objRows-1)))   * m_factor;
+
+      for (std::size_t l_pos_C=p_colBegin; l_pos_C<p_colEnd; l_pos_C+=VecType::size())
+      {
+         l_posX = (l_pos_R - p_rowBegin) * p_pitchX + l_pos_C - p_colBegin;
+         l_posY = (l_pos_R - p_rowBegin) * p_pitchY + l_pos_C - p_colBegin;
+         l_n = VecUtils::lanesValid(l_pos_C, p_colEnd);
+
+         l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+         VecUtils::load(l_x_LL_Vec, p_x_LL + l_posX           , l_n);
+         VecUtils::load(l_x_RL_Vec, p_x    + l_posX - p_pitchX, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x    + l_posX - 1       , l_n);
+         VecUtils::load(l_x_Vec,    p_x    + l_posX           , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x    + l_posX + 1       , l_n);
+         VecUtils::load(l_x_RU_Vec, p_x    + l_posX + p_pitchX, l_n);
+         VecUtils::load(l_x_LU_Vec, p_x_LU + l_posX           , l_n);
+
+         l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+         l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+         l_y_Vec =
+                  ( 1               +
+                     l_factor_LL     +
+                     l_factor_RL     +
+                     l_factor_CL_Vec +
+                     l_factor_CU_Vec +
+                     l_factor_RU     +
+                     l_factor_LU
+                  )                 * l_x_Vec
+               - l_factor_LL       * l_x_LL_Vec
+               - l_factor_RL       * l_x_RL_Vec
+               - l_factor_CL_Vec   * l_x_CL_Vec
+               - l_factor_CU_Vec   * l_x_CU_Vec
+               - l_factor_RU       * l_x_RU_Vec
+               - l_factor_LU       * l_x_LU_Vec;
+
+         l_y_Vec = m_alpha * l_x_Vec + m_beta * l_y_Vec;
+         VecUtils::store(l_y_Vec, p_y + l_posY, l_n);
+      }
+   }
+}
+
+template <typename ValueType, typename VecType>
+CLinearStencilConstCoeffTemporal<ValueType, VecType>::~CLinearStencilConstCoeffTemporal()
+{
+   CAllocator::deallocate(m_rings);
+   CAllocator::deallocate(m_tileZero);
+}
@@ -1,14 +1,80 @@
+/*
+ *                   C6 --------E11-------- C7
+ *                 / |                     / |
+ *               E9  |                   E10 |
+ *              /    |                  /    |
+ *             C4 ---------E8--------- C5    E7
+ *             |     E6                |     |
+ *             |     |                 |     |
+ *             |     |                 E5    |
+ *             E4    C2 -------E3------|---- C3
+ *             |    /                  |    /
+ *             |  E1                   |   E2
+ *             | /                     | /
+ *             C0 ---------E0--------- C1
+ *
+ * S0: E0-E2-E3-E1
+ * S1: E0-E5-E8-E4
+ * S2: E2-E7-E10-E5
+ * S3: E3-E7-E11-E6
+ * S4: E1-E6-E9-E4
+ * S5: E8-E10-E11-E9
+ *
+ * SplitRegions = false: one kernel for all cells, the boundary is handled by
+ *                       integer factors (levels, rows) and select masks (cols)
+ *
+ * SplitRegions = true:  the interior is computed without any boundary handling,
+ *                       faces, edges and corners by kernels specialized at
+ *                       compile time (applyVec<HasLL,HasRL,HasRU,HasLU,ColBoundary>)
+ *
+ *                       levels: S0 (l = 0) | interior | S5 (l = m_objLevels-1)
+ *                       rows:   S1 (r = 0) | interior | S3 (r = m_objRows-1)
+ *                       cols:   first and last vector of a row carry S4/S2
+ *
+ *                       => results are bit-identical to SplitRegions = false
+ *                       => m_objRows and m_objLevels have to be >= 2
+ *
+ * FaceCentric = true:   every face coefficient is computed once instead of
+ *                       once from each adjacent cell (3 instead of 6
+ *                       divisions per cell): a first pass over a row computes
+ *                       the upper faces (CU, RU, LU), the lower faces are the
+ *                       stored upper faces of the previous col, row and level
+ *
+ *                       => the LL and RL faces are rounded differently from
+ *                          SplitRegions = false (product order), results
+ *                          agree to a few ulp
+ *                       => every thread walks its levels in bands of
+ *                          BAND_ROWS rows and keeps the LL/LU faces of a
+ *                          band and three rows of faces, kept by the
+ *                          operator (it can not be copied)
+ *
+ * RowBlock > 1:         unroll-and-jam over rows in the SplitRegions = false
+ *                       kernel, RowBlock rows are computed per column vector
+ *                       and share the loaded x and c vectors of the rows in
+ *                       between: 2*(RowBlock+2) + 8*RowBlock instead of
+ *                       14*RowBlock loads. Remaining rows of a level are
+ *                       computed one by one. Results are bit-identical.
+ *                       Not combined with SplitRegions (a kernel per row
+ *                       type) and FaceCentric (faces are already shared
+ *                       between the rows)
+ *
+ */
 
 #pragma once
 
 #include <string>
 #include <omp.h>
 #include "i_linear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
 
-template <typename ValueType, typename VecType>
+template <typename ValueType, typename VecType, bool SplitRegions = false, bool FaceCentric = false, std::size_t RowBlock = 1>
 class CLinearStencilNonconstCoeff : public ILinearOperator<ValueType>
 {
  private:
+    using VecUtils = CVecUtils<ValueType, VecType>;
+
     std::size_t m_objCols;
     std::size_t m_objRows;
     std::size_t m_objLevels;
@@ -18,6 +84,31 @@ class CLinearStencilNonconstCoeff : public ILinearOperator<ValueType>
     ValueType * m_c;
     const ValueType m_factor;
     const ValueType m_epsilon;
+    std::size_t m_bandRows;
+    std::size_t m_sizeFaces;
+    mutable ValueType * m_faces;
+    mutable std::size_t m_facesCapacity;
+    mutable std::size_t m_facesThreads;
+
+    //
+    // NOTE rows of a band of applyFaceCentric
+    //
+    inline static constexpr std::size_t BAND_ROWS = 32;
+
+    void applyMasked(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    template <std::size_t Rows>
+    void applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const;
+    void applySplit(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    template <bool HasLL, bool HasLU>
+    void applyLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L) const;
+    template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+    void applyRow(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const;
+    template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+    void applyVec(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos, const std::size_t p_pos_C) const;
+    void reserveFaces(const std::size_t p_threads) const;
+    void applyFaceCentric(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    void facesLL(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, ValueType * __restrict__ p_f_LL, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const;
+    void applyFaceCentricLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const ValueType * __restrict__ p_f_LL, ValueType * __restrict__ p_f_LU, ValueType * __restrict__ p_f_R, ValueType * __restrict__ p_f_C, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const;
 
  public:
     CLinearStencilNonconstCoeff(
@@ -29,13 +120,30 @@ class CLinearStencilNonconstCoeff : public ILinearOperator<ValueType>
       const ValueType p_tau = ValueType(1.0),
       const ValueType p_epsilon = ValueType(1e-15)
       );
-      inline static const std::string IDENTIFER = "linear_stencil_nonconst_coeff";
+    CLinearStencilNonconstCoeff(
+      const CGridLayout & p_layout,
+      ValueType * p_c,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    CLinearStencilNonconstCoeff(const CLinearStencilNonconstCoeff &) = delete;
+    CLinearStencilNonconstCoeff & operator=(const CLinearStencilNonconstCoeff &) = delete;
+      static_assert(!(SplitRegions && FaceCentric), "SplitRegions and FaceCentric are exclusive");
+      static_assert(RowBlock >= 1, "RowBlock has to be >= 1");
+      static_assert(RowBlock == 1 || !(SplitRegions || FaceCentric), "RowBlock is only implemented for the masked kernel");
+      inline static const std::string IDENTIFER =
+         std::string("linear_stencil_nonconst_coeff")
+         + (SplitRegions ? "_split" : "")
+         + (FaceCentric ? "_face_centric" : "")
+         + (RowBlock > 1 ? "_rows_" + std::to_string(RowBlock) : "");
     void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    bool diagonal(ValueType * __restrict__ p_d) const;
     ~CLinearStencilNonconstCoeff();
 };
 
-template <typename ValueType, typename VecType>
-CLinearStencilNonconstCoeff<ValueType, VecType>::CLinearStencilNonconstCoeff(
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::CLinearStencilNonconstCoeff(
    const std::size_t p_objCols,
    const std::size_t p_objRows,
    const std::size_t p_objLevels,
@@ -44,26 +152,116 @@ CLinearStencilNonconstCoeff<ValueType, VecType>::CLinearStencilNonconstCoeff(
    const ValueType p_tau,
    const ValueType p_epsilon
    ):
-m_objCols(p_objCols),
-m_objRows(p_objRows),
-m_objLevels(p_objLevels),
-m_objSize1d(p_objCols),
-m_objSize2d(p_objCols * p_objRows),
-m_objSize3d(p_objCols * p_objRows * p_objLevels),
+CLinearStencilNonconstCoeff(CGridLayout(p_objCols, p_objRows, p_objLevels), p_c, p_h, p_tau, p_epsilon)
+{
+
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::CLinearStencilNonconstCoeff(
+   const CGridLayout & p_layout,
+   ValueType * p_c,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_objSize1d(p_layout.objSize1d()),
+m_objSize2d(p_layout.objSize2d()),
+m_objSize3d(p_layout.objSize3d()),
 m_c(p_c),
 m_factor(p_tau/(p_h*p_h)),
-m_epsilon(p_epsilon)
+m_epsilon(p_epsilon),
+m_bandRows(0),
+m_sizeFaces(0),
+m_faces(nullptr),
+m_facesCapacity(0),
+m_facesThreads(0)
+{
+   if constexpr (FaceCentric)
+   {
+      //
+      // NOTE LL/LU faces of a band, RL/RU faces of a row and CU faces of a
+      //      row, the latter padded so that the CL face of the first col is 0
+      //
+      m_bandRows = m_objRows < BAND_ROWS ? m_objRows : BAND_ROWS;
+      m_sizeFaces = 2*m_bandRows*m_objSize1d + 3*(m_objSize1d + 2*VecType::size());
+
+      #pragma omp parallel
+      {
+         reserveFaces(omp_get_num_threads());
+      }
+   }
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::reserveFaces(const std::size_t p_threads) const
+{
+   //
+   // NOTE called by all threads of a team, the faces of thread t are
+   //      touched by thread t (static schedule, one slice per iteration) and
+   //      only zeroed here, the pads are never written
+   //
+   #pragma omp single
+   {
+      CAllocator::reserve(m_faces, m_facesCapacity, p_threads*m_sizeFaces);
+      m_facesThreads = p_threads;
+   }
+
+   CAllocator::firstTouch(m_faces, p_threads*m_sizeFaces, m_sizeFaces);
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   if constexpr (FaceCentric)
+   {
+      applyFaceCentric(p_x, p_y);
+   }
+   else if constexpr (SplitRegions)
+   {
+      applySplit(p_x, p_y);
+   }
+   else
+   {
+      applyMasked(p_x, p_y);
+   }
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyMasked(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
 {
+   std::size_t l_pos_R;
 
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (l_pos_R=0; l_pos_R+RowBlock<=m_objRows; l_pos_R+=RowBlock)
+      {
+         applyRows<RowBlock>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+      for (; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         applyRows<1>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+   }
 }
 
-template <typename ValueType, typename VecType>
-void CLinearStencilNonconstCoeff<ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <std::size_t Rows>
+inline void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const
 {
    std::size_t l_pos;
+   std::size_t l_pos_0;
+   std::size_t l_pos_R;
+   std::size_t l_n;
 
    VecType l_pos_C_Vec;
 
+   VecType l_lane_Vec = VecUtils::lanes();
+
    VecType l_factor_LL_Vec;
    VecType l_factor_RL_Vec;
    VecType l_factor_CL_Vec;
@@ -71,6 +269,161 @@ void CLinearStencilNonconstCoeff<ValueType, VecType>::apply(const ValueType * __
    VecType l_factor_RU_Vec;
    VecType l_factor_LU_Vec;
 
+   VecType l_mask_CL_Vec;
+   VecType l_mask_CU_Vec;
+
+   //
+   // NOTE x and c of the rows p_pos_R-1, ..., p_pos_R+Rows
+   //
+   VecType l_x_R_Vec[Rows+2];
+   VecType l_c_R_Vec[Rows+2];
+
+   VecType l_x_LL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_LU_Vec;
+
+   for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+   {
+      l_pos_0 = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + l_pos_C;
+      l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+      l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+      l_mask_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_mask_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+      for (std::size_t k=0; k<Rows+2; ++k)
+      {
+         VecUtils::load(l_x_R_Vec[k], p_x + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+         VecUtils::load(l_c_R_Vec[k], m_c + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+      }
+
+      for (std::size_t b=0; b<Rows; ++b)
+      {
+         l_pos = l_pos_0 + b * m_objSize1d;
+         l_pos_R = p_pos_R + b;
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         VecUtils::load(l_c_LL_Vec, m_c + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_c_CL_Vec, m_c + l_pos - 1          , l_n);
+         VecUtils::load(l_c_CU_Vec, m_c + l_pos + 1          , l_n);
+         VecUtils::load(l_c_LU_Vec, m_c + l_pos + m_objSize2d, l_n);
+
+         l_factor_CL_Vec = l_mask_CL_Vec;
+         l_factor_CU_Vec = l_mask_CU_Vec;
+
+         l_factor_LL_Vec = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_R_Vec[b+1] * l_c_LL_Vec     / (l_c_R_Vec[b+1]+l_c_LL_Vec    +m_epsilon);
+         l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_R_Vec[b+1] * l_c_R_Vec[b]   / (l_c_R_Vec[b+1]+l_c_R_Vec[b]  +m_epsilon);
+         l_factor_CL_Vec *=                                                           2 * l_c_R_Vec[b+1] * l_c_CL_Vec     / (l_c_R_Vec[b+1]+l_c_CL_Vec    +m_epsilon);
+         l_factor_CU_Vec *=                                                           2 * l_c_R_Vec[b+1] * l_c_CU_Vec     / (l_c_R_Vec[b+1]+l_c_CU_Vec    +m_epsilon);
+         l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_R_Vec[b+1] * l_c_R_Vec[b+2] / (l_c_R_Vec[b+1]+l_c_R_Vec[b+2]+m_epsilon);
+         l_factor_LU_Vec = (1-(p_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_R_Vec[b+1] * l_c_LU_Vec     / (l_c_R_Vec[b+1]+l_c_LU_Vec    +m_epsilon);
+
+         l_y_Vec =
+                  ( 1                +
+                     l_factor_LL_Vec +
+                     l_factor_RL_Vec +
+                     l_factor_CL_Vec +
+                     l_factor_CU_Vec +
+                     l_factor_RU_Vec +
+                     l_factor_LU_Vec
+                  )                  * l_x_R_Vec[b+1]
+               - l_factor_LL_Vec     * l_x_LL_Vec
+               - l_factor_RL_Vec     * l_x_R_Vec[b]
+               - l_factor_CL_Vec     * l_x_CL_Vec
+               - l_factor_CU_Vec     * l_x_CU_Vec
+               - l_factor_RU_Vec     * l_x_R_Vec[b+2]
+               - l_factor_LU_Vec     * l_x_LU_Vec;
+         VecUtils::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+   }
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applySplit(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      if (l_pos_L == 0)
+      {
+         applyLevel<false, true>(p_x, p_y, l_pos_L);
+      }
+      else if (l_pos_L == m_objLevels-1)
+      {
+         applyLevel<true, false>(p_x, p_y, l_pos_L);
+      }
+      else
+      {
+         applyLevel<true, true>(p_x, p_y, l_pos_L);
+      }
+   }
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <bool HasLL, bool HasLU>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L) const
+{
+   applyRow<HasLL, false, true, HasLU>(p_x, p_y, p_pos_L, 0);
+   for (std::size_t l_pos_R=1; l_pos_R<m_objRows-1; ++l_pos_R)
+   {
+      applyRow<HasLL, true, true, HasLU>(p_x, p_y, p_pos_L, l_pos_R);
+   }
+   applyRow<HasLL, true, false, HasLU>(p_x, p_y, p_pos_L, m_objRows-1);
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyRow(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const
+{
+   std::size_t l_pos_row = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d;
+
+   //
+   // NOTE only the first and the last vector of a row touch the column
+   //      boundary, the last one may also be partial
+   //
+   std::size_t l_pos_C_last = ((m_objCols-1)/VecType::size())*VecType::size();
+
+   applyVec<HasLL, HasRL, HasRU, HasLU, true>(p_x, p_y, l_pos_row, 0);
+   for (std::size_t l_pos_C=VecType::size(); l_pos_C<l_pos_C_last; l_pos_C+=VecType::size())
+   {
+      applyVec<HasLL, HasRL, HasRU, HasLU, false>(p_x, p_y, l_pos_row + l_pos_C, l_pos_C);
+   }
+   if (l_pos_C_last > 0)
+   {
+      applyVec<HasLL, HasRL, HasRU, HasLU, true>(p_x, p_y, l_pos_row + l_pos_C_last, l_pos_C_last);
+   }
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+inline void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyVec(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos, const std::size_t p_pos_C) const
+{
+   //
+   // NOTE the factors are evaluated in the same order as in applyMasked,
+   //      a missing neighbour contributes an exact 0 there as well
+   //
+   std::size_t l_n = ColBoundary ? VecUtils::lanesValid(p_pos_C, m_objCols) : VecType::size();
+
+   VecType l_factor_LL_Vec(0);
+   VecType l_factor_RL_Vec(0);
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec(0);
+   VecType l_factor_LU_Vec(0);
+
    VecType l_x_LL_Vec;
    VecType l_x_RL_Vec;
    VecType l_x_CL_Vec;
@@ -89,6 +442,345 @@ void CLinearStencilNonconstCoeff<ValueType, VecType>::apply(const ValueType * __
    VecType l_c_RU_Vec;
    VecType l_c_LU_Vec;
 
+   VecUtils::load(l_x_LL_Vec, p_x + p_pos - m_objSize2d, l_n);
+   VecUtils::load(l_x_RL_Vec, p_x + p_pos - m_objSize1d, l_n);
+   VecUtils::load(l_x_CL_Vec, p_x + p_pos - 1          , l_n);
+   VecUtils::load(l_x_Vec,    p_x + p_pos              , l_n);
+   VecUtils::load(l_x_CU_Vec, p_x + p_pos + 1          , l_n);
+   VecUtils::load(l_x_RU_Vec, p_x + p_pos + m_objSize1d, l_n);
+   VecUtils::load(l_x_LU_Vec, p_x + p_pos + m_objSize2d, l_n);
+
+   VecUtils::load(l_c_CL_Vec, m_c + p_pos - 1          , l_n);
+   VecUtils::load(l_c_Vec,    m_c + p_pos              , l_n);
+   VecUtils::load(l_c_CU_Vec, m_c + p_pos + 1          , l_n);
+
+   if constexpr (ColBoundary)
+   {
+      VecType l_pos_C_Vec = VecUtils::lanes() + ValueType(p_pos_C);
+
+      l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+   }
+   else
+   {
+      l_factor_CL_Vec = VecType(m_factor);
+      l_factor_CU_Vec = VecType(m_factor);
+   }
+
+   if constexpr (HasLL)
+   {
+      VecUtils::load(l_c_LL_Vec, m_c + p_pos - m_objSize2d, l_n);
+      l_factor_LL_Vec = m_factor * 2 * l_c_Vec * l_c_LL_Vec / (l_c_Vec+l_c_LL_Vec+m_epsilon);
+   }
+   if constexpr (HasRL)
+   {
+      VecUtils::load(l_c_RL_Vec, m_c + p_pos - m_objSize1d, l_n);
+      l_factor_RL_Vec = m_factor * 2 * l_c_Vec * l_c_RL_Vec / (l_c_Vec+l_c_RL_Vec+m_epsilon);
+   }
+   l_factor_CL_Vec *=              2 * l_c_Vec * l_c_CL_Vec / (l_c_Vec+l_c_CL_Vec+m_epsilon);
+   l_factor_CU_Vec *=              2 * l_c_Vec * l_c_CU_Vec / (l_c_Vec+l_c_CU_Vec+m_epsilon);
+   if constexpr (HasRU)
+   {
+      VecUtils::load(l_c_RU_Vec, m_c + p_pos + m_objSize1d, l_n);
+      l_factor_RU_Vec = m_factor * 2 * l_c_Vec * l_c_RU_Vec / (l_c_Vec+l_c_RU_Vec+m_epsilon);
+   }
+   if constexpr (HasLU)
+   {
+      VecUtils::load(l_c_LU_Vec, m_c + p_pos + m_objSize2d, l_n);
+      l_factor_LU_Vec = m_factor * 2 * l_c_Vec * l_c_LU_Vec / (l_c_Vec+l_c_LU_Vec+m_epsilon);
+   }
+
+   l_y_Vec =
+            ( 1                +
+               l_factor_LL_Vec +
+               l_factor_RL_Vec +
+               l_factor_CL_Vec +
+               l_factor_CU_Vec +
+               l_factor_RU_Vec +
+               l_factor_LU_Vec
+            )                  * l_x_Vec
+         - l_factor_LL_Vec     * l_x_LL_Vec
+         - l_factor_RL_Vec     * l_x_RL_Vec
+         - l_factor_CL_Vec     * l_x_CL_Vec
+         - l_factor_CU_Vec     * l_x_CU_Vec
+         - l_factor_RU_Vec     * l_x_RU_Vec
+         - l_factor_LU_Vec     * l_x_LU_Vec;
+   VecUtils::store(l_y_Vec, p_y + p_pos, l_n);
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyFaceCentric(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   //
+   // NOTE every thread reads m_facesThreads before one of them can grow the
+   //      faces behind the barrier (all threads take the same branch)
+   //
+   std::size_t l_threads = omp_get_num_threads();
+
+   if (l_threads > m_facesThreads)
+   {
+      #pragma omp barrier
+      reserveFaces(l_threads);
+   }
+
+   //
+   // NOTE every thread walks its contiguous chunk of levels (static level
+   //      distribution) band by band, the LL/LU faces of a band are rolled
+   //      along the levels and stay in cache
+   //
+   std::size_t l_sizeRow = m_objSize1d + 2*VecType::size();
+
+   ValueType * l_faces = m_faces + omp_get_thread_num() * m_sizeFaces;
+   ValueType * l_f_LL;
+   ValueType * l_f_LU;
+   ValueType * l_f_R  = l_faces + 2*m_bandRows*m_objSize1d;
+   ValueType * l_f_C  = l_f_R + 2*l_sizeRow + VecType::size();
+   ValueType * l_f_tmp;
+
+   std::size_t l_pos_L_begin = m_objLevels;
+   std::size_t l_pos_L_end = m_objLevels;
+
+   #pragma omp for schedule(static) nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      if (l_pos_L_begin == m_objLevels)
+      {
+         l_pos_L_begin = l_pos_L;
+      }
+      l_pos_L_end = l_pos_L+1;
+   }
+
+   for (std::size_t l_rowBegin=0; l_pos_L_begin<l_pos_L_end && l_rowBegin<m_objRows; l_rowBegin+=m_bandRows)
+   {
+      std::size_t l_rowEnd = l_rowBegin+m_bandRows < m_objRows ? l_rowBegin+m_bandRows : m_objRows;
+      const ValueType * l_c = m_c + l_rowBegin * m_objSize1d;
+
+      l_f_LL = l_faces;
+      l_f_LU = l_faces + m_bandRows*m_objSize1d;
+
+      for (std::size_t l_pos_L=l_pos_L_begin; l_pos_L<l_pos_L_end; ++l_pos_L)
+      {
+         if (l_pos_L > l_pos_L_begin)
+         {
+            l_f_tmp = l_f_LL;
+            l_f_LL  = l_f_LU;
+            l_f_LU  = l_f_tmp;
+         }
+         else
+         {
+            facesLL(l_c + l_pos_L * m_objSize2d - m_objSize2d, l_c + l_pos_L * m_objSize2d, l_f_LL, l_pos_L, l_rowBegin, l_rowEnd);
+         }
+
+         applyFaceCentricLevel(p_x, p_y, l_c + l_pos_L * m_objSize2d, l_c + l_pos_L * m_objSize2d + m_objSize2d, l_f_LL, l_f_LU, l_f_R, l_f_C, l_pos_L, l_rowBegin, l_rowEnd);
+      }
+   }
+
+   #pragma omp barrier
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::facesLL(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, ValueType * __restrict__ p_f_LL, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const
+{
+   //
+   // NOTE p_g_LL, p_g and p_f_LL start at the row p_rowBegin
+   //
+   std::size_t l_size = (p_rowEnd-p_rowBegin) * m_objSize1d;
+   std::size_t l_n;
+
+   VecType l_g_LL_Vec;
+   VecType l_g_Vec;
+   VecType l_f_LL_Vec;
+
+   for (std::size_t l_pos_2d=0; l_pos_2d<l_size; l_pos_2d+=VecType::size())
+   {
+      l_n = VecUtils::lanesValid(l_pos_2d, l_size);
+
+      VecUtils::load(l_g_LL_Vec, p_g_LL + l_pos_2d, l_n);
+      VecUtils::load(l_g_Vec,    p_g    + l_pos_2d, l_n);
+
+      l_f_LL_Vec = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LL_Vec / (l_g_Vec+l_g_LL_Vec+m_epsilon);
+
+      VecUtils::store(l_f_LL_Vec, p_f_LL + l_pos_2d, l_n);
+   }
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyFaceCentricLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const ValueType * __restrict__ p_f_LL, ValueType * __restrict__ p_f_LU, ValueType * __restrict__ p_f_R, ValueType * __restrict__ p_f_C, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const
+{
+   //
+   // NOTE p_g, p_g_LU, p_f_LL and p_f_LU start at the row p_rowBegin
+   //
+   std::size_t l_pos;
+   std::size_t l_pos_2d;
+   std::size_t l_n;
+
+   ValueType * l_f_RL = p_f_R + VecType::size();
+   ValueType * l_f_RU = p_f_R + m_objSize1d + 3*VecType::size();
+   ValueType * l_f_tmp;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_g_RL_Vec;
+   VecType l_g_Vec;
+   VecType l_g_CU_Vec;
+   VecType l_g_RU_Vec;
+   VecType l_g_LU_Vec;
+
+   VecType l_f_LL_Vec;
+   VecType l_f_RL_Vec;
+   VecType l_f_CL_Vec;
+   VecType l_f_CU_Vec;
+   VecType l_f_RU_Vec;
+   VecType l_f_LU_Vec;
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   if (p_rowBegin == 0)
+   {
+      //
+      // NOTE no RL faces in the first row
+      //
+      for (std::size_t i = 0; i < m_objSize1d; ++i)
+      {
+         l_f_RL[i] = ValueType(0);
+      }
+   }
+   else
+   {
+      //
+      // NOTE RL faces of the first row of a band are the RU faces of the
+      //      row above (same operand order)
+      //
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         VecUtils::load(l_g_RL_Vec, p_g + l_pos_C - m_objSize1d, l_n);
+         VecUtils::load(l_g_Vec,    p_g + l_pos_C              , l_n);
+
+         l_f_RL_Vec = (1-((p_rowBegin-1)/(m_objRows-1))) * m_factor * 2 * l_g_RL_Vec * l_g_Vec / (l_g_RL_Vec+l_g_Vec+m_epsilon);
+
+         VecUtils::store(l_f_RL_Vec, l_f_RL + l_pos_C, l_n);
+      }
+   }
+
+   for (std::size_t l_pos_R=p_rowBegin; l_pos_R<p_rowEnd; ++l_pos_R)
+   {
+      //
+      // NOTE upper faces of the row
+      //
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_pos_2d = (l_pos_R-p_rowBegin) * m_objSize1d + l_pos_C;
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+         VecUtils::load(l_g_Vec,    p_g    + l_pos_2d              , l_n);
+         VecUtils::load(l_g_CU_Vec, p_g    + l_pos_2d + 1          , l_n);
+         VecUtils::load(l_g_RU_Vec, p_g    + l_pos_2d + m_objSize1d, l_n);
+         VecUtils::load(l_g_LU_Vec, p_g_LU + l_pos_2d              , l_n);
+
+         l_f_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+         l_f_CU_Vec *=                                                      2 * l_g_Vec * l_g_CU_Vec / (l_g_Vec+l_g_CU_Vec+m_epsilon);
+         l_f_RU_Vec = (1-(l_pos_R/(m_objRows-1)))   * m_factor * 2 * l_g_Vec * l_g_RU_Vec / (l_g_Vec+l_g_RU_Vec+m_epsilon);
+         l_f_LU_Vec = (1-(p_pos_L/(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LU_Vec / (l_g_Vec+l_g_LU_Vec+m_epsilon);
+
+         VecUtils::store(l_f_CU_Vec, p_f_C  + l_pos_C , l_n);
+         VecUtils::store(l_f_RU_Vec, l_f_RU + l_pos_C , l_n);
+         VecUtils::store(l_f_LU_Vec, p_f_LU + l_pos_2d, l_n);
+      }
+
+      //
+      // NOTE lower faces are the upper faces of the previous col, row, level
+      //
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_pos_2d = (l_pos_R-p_rowBegin) * m_objSize1d + l_pos_C;
+         l_pos = p_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_RL_Vec, p_x + l_pos - m_objSize1d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_Vec,    p_x + l_pos              , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_RU_Vec, p_x + l_pos + m_objSize1d, l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         VecUtils::load(l_f_LL_Vec, p_f_LL + l_pos_2d   , l_n);
+         VecUtils::load(l_f_RL_Vec, l_f_RL + l_pos_C    , l_n);
+         VecUtils::load(l_f_CL_Vec, p_f_C  + l_pos_C - 1, l_n);
+         VecUtils::load(l_f_CU_Vec, p_f_C  + l_pos_C    , l_n);
+         VecUtils::load(l_f_RU_Vec, l_f_RU + l_pos_C    , l_n);
+         VecUtils::load(l_f_LU_Vec, p_f_LU + l_pos_2d   , l_n);
+
+         l_y_Vec =
+                  ( 1             +
+                     l_f_LL_Vec   +
+                     l_f_RL_Vec   +
+                     l_f_CL_Vec   +
+                     l_f_CU_Vec   +
+                     l_f_RU_Vec   +
+                     l_f_LU_Vec
+                  )               * l_x_Vec
+               - l_f_LL_Vec       * l_x_LL_Vec
+               - l_f_RL_Vec       * l_x_RL_Vec
+               - l_f_CL_Vec       * l_x_CL_Vec
+               - l_f_CU_Vec       * l_x_CU_Vec
+               - l_f_RU_Vec       * l_x_RU_Vec
+               - l_f_LU_Vec       * l_x_LU_Vec;
+         VecUtils::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+
+      l_f_tmp = l_f_RL;
+      l_f_RL  = l_f_RU;
+      l_f_RU  = l_f_tmp;
+   }
+}
+
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+bool CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::diagonal(ValueType * __restrict__ p_d) const
+{
+   //
+   // NOTE computed on the fly with the factors of applyMasked (for all
+   //      variants, FaceCentric rounds the LL and RL faces differently)
+   //
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_factor_LL_Vec;
+   VecType l_factor_RL_Vec;
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec;
+   VecType l_factor_LU_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_RL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_RU_Vec;
+   VecType l_c_LU_Vec;
+
+   VecType l_d_Vec;
+
    #pragma omp for
    for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
    {
@@ -97,30 +789,20 @@ void CLinearStencilNonconstCoeff<ValueType, VecType>::apply(const ValueType * __
          for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
          {
             l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
 
-            //
-            // WORKAROUND hardcoded vector size of 4
-            //
-            l_pos_C_Vec = VecType(l_pos_C, l_pos_C+1, l_pos_C+2, l_pos_C+3);
-
-            l_x_LL_Vec.load(p_x + l_pos - m_objSize2d);
-            l_x_RL_Vec.load(p_x + l_pos - m_objSize1d);
-            l_x_CL_Vec.load(p_x + l_pos - 1          );
-            l_x_Vec.load(   p_x + l_pos              );
-            l_x_CU_Vec.load(p_x + l_pos + 1          );
-            l_x_RU_Vec.load(p_x + l_pos + m_objSize1d);
-            l_x_LU_Vec.load(p_x + l_pos + m_objSize2d);
-
-            l_c_LL_Vec.load(m_c + l_pos - m_objSize2d);
-            l_c_RL_Vec.load(m_c + l_pos - m_objSize1d);
-            l_c_CL_Vec.load(m_c + l_pos - 1          );
-            l_c_Vec.load(   m_c + l_pos              );
-            l_c_CU_Vec.load(m_c + l_pos + 1          );
-            l_c_RU_Vec.load(m_c + l_pos + m_objSize1d);
-            l_c_LU_Vec.load(m_c + l_pos + m_objSize2d);
-
-            l_factor_CL_Vec = select(l_pos_C_Vec>0,           m_factor, 0.0);
-            l_factor_CU_Vec = select(l_pos_C_Vec<m_objCols-1,   m_factor, 0.0);
+            VecUtils::load(l_c_LL_Vec, m_c + l_pos - m_objSize2d, l_n);
+            VecUtils::load(l_c_RL_Vec, m_c + l_pos - m_objSize1d, l_n);
+            VecUtils::load(l_c_CL_Vec, m_c + l_pos - 1          , l_n);
+            VecUtils::load(l_c_Vec,    m_c + l_pos              , l_n);
+            VecUtils::load(l_c_CU_Vec, m_c + l_pos + 1          , l_n);
+            VecUtils::load(l_c_RU_Vec, m_c + l_pos + m_objSize1d, l_n);
+            VecUtils::load(l_c_LU_Vec, m_c + l_pos + m_objSize2d, l_n);
+
+            l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
 
             l_factor_LL_Vec = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LL_Vec / (l_c_Vec+l_c_LL_Vec+m_epsilon);
             l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RL_Vec / (l_c_Vec+l_c_RL_Vec+m_epsilon);
@@ -129,29 +811,17 @@ void CLinearStencilNonconstCoeff<ValueType, VecType>::apply(const ValueType * __
             l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RU_Vec / (l_c_Vec+l_c_RU_Vec+m_epsilon);
             l_factor_LU_Vec = (1-(l_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LU_Vec / (l_c_Vec+l_c_LU_Vec+m_epsilon);
 
-            l_y_Vec =
-                     ( 1                +
-                        l_factor_LL_Vec +
-                        l_factor_RL_Vec +
-                        l_factor_CL_Vec +
-                        l_factor_CU_Vec +
-                        l_factor_RU_Vec +
-                        l_factor_LU_Vec
-                     )                  * l_x_Vec
-                  - l_factor_LL_Vec     * l_x_LL_Vec
-                  - l_factor_RL_Vec     * l_x_RL_Vec
-                  - l_factor_CL_Vec     * l_x_CL_Vec
-                  - l_factor_CU_Vec     * l_x_CU_Vec
-                  - l_factor_RU_Vec     * l_x_RU_Vec
-                  - l_factor_LU_Vec     * l_x_LU_Vec;
-            l_y_Vec.store(p_y + l_pos);
+            l_d_Vec = 1 + l_factor_LL_Vec + l_factor_RL_Vec + l_factor_CL_Vec + l_factor_CU_Vec + l_factor_RU_Vec + l_factor_LU_Vec;
+            VecUtils::store(l_d_Vec, p_d + l_pos, l_n);
          }
       }
    }
+
+   return true;
 }
 
-template <typename ValueType, typename VecType>
-CLinearStencilNonconstCoeff<ValueType, VecType>::~CLinearStencilNonconstCoeff()
+template <typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+CLinearStencilNonconstCoeff<ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::~CLinearStencilNonconstCoeff()
 {
-
+   CAllocator::deallocate(m_faces);
 }
@@ -1,29 +1,102 @@
+/*
+ * StorageType = float (with ValueType = double): the coefficients are
+ * computed in double, stored in float and widened in registers by apply,
+ * see CVecStorage. x and y stay double.
+ *
+ * MemoryPolicy: streaming stores of y and prefetch of the LL/LU planes of
+ * x, see CMemoryPolicy.
+ *
+ * Interleaved = true: the coefficients are stored in blocks of
+ * VecType::size() cells, [CU, RU, LU, v] per block, the lower coefficients
+ * are read from the blocks one row/level below, see
+ * CNonlinearStencilPrecalc. The coefficients are computed directly into
+ * the blocks, the separate arrays are not allocated.
+ *
+ * The coefficients are computed by one vectorized kernel per column vector
+ * (masked loads/stores at the row ends, the lower neighbour coefficients
+ * are computed in the order of the upper ones of the neighbour, so that the
+ * operator stays exactly symmetric) in parallel over the levels, the
+ * diagonal is summed from the coefficients rounded to StorageType in the
+ * same pass. updateCoefficients(p_c, p_box) recomputes the coefficients of
+ * the cells of p_box and of the cells next to it (their faces and
+ * diagonals depend on p_c of p_box) only, e.g. after p_c changed in a small
+ * region. Results are bit-identical to the former scalar loops.
+ *
+ * apply and applyLevels (a range of levels on the calling thread only,
+ * matrix powers kernel of CSStepCG) share the kernel of a level.
+ *
+ * The operator owns its coefficient arrays, it can be moved but not
+ * copied. rebind() computes the coefficients of another grid and
+ * coefficient field: the arrays are kept if the new grid fits into them
+ * (CAllocator::reserve), see CNonlinearStencilPrecalc.
+ *
+ */
 
 #pragma once
 
 #include <string>
+#include <utility>
 #include <omp.h>
 #include "i_linear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_memory_policy.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
 
-template <typename ValueType, typename VecType>
+template <typename ValueType, typename VecType, typename StorageType = ValueType, typename MemoryPolicy = CMemoryPolicy<>, bool Interleaved = false>
 class CLinearStencilNonconstCoeffPrecalc : public ILinearOperator<ValueType>
 {
  private:
+   using VecUtils = CVecUtils<ValueType, VecType>;
+   using StorageUtils = CVecStorage<StorageType, ValueType, VecType>;
+
    std::size_t m_objCols;
    std::size_t m_objRows;
    std::size_t m_objLevels;
    std::size_t m_objSize1d;
    std::size_t m_objSize2d;
    std::size_t m_objSize3d;
-   const ValueType m_factor;
-   const ValueType m_epsilon;
-   ValueType * m_v_LL;
-   ValueType * m_v_RL;
-   ValueType * m_v_CL;
-   ValueType * m_v;
-   ValueType * m_v_CU;
-   ValueType * m_v_RU;
-   ValueType * m_v_LU;
+   ValueType m_factor;
+   ValueType m_epsilon;
+   StorageType * m_v_LL;
+   StorageType * m_v_RL;
+   StorageType * m_v_CL;
+   StorageType * m_v;
+   StorageType * m_v_CU;
+   StorageType * m_v_RU;
+   StorageType * m_v_LU;
+
+   //
+   // NOTE Interleaved layout
+   //
+   std::size_t m_vecsPerRow;
+   std::size_t m_blockSize;
+   std::size_t m_blocksPerLevel;
+   StorageType * m_v_blocks_raw;
+   StorageType * m_v_blocks;
+
+   //
+   // NOTE allocated values of the arrays above
+   //
+   std::size_t m_capacity_LL;
+   std::size_t m_capacity_RL;
+   std::size_t m_capacity_CL;
+   std::size_t m_capacity_v;
+   std::size_t m_capacity_blocks;
+
+   inline static constexpr std::size_t SLOT_CU = 0;
+   inline static constexpr std::size_t SLOT_RU = 1;
+   inline static constexpr std::size_t SLOT_LU = 2;
+   inline static constexpr std::size_t SLOT_V  = 3;
+
+   void zeroCoefficients();
+   void setCoefficients(const ValueType * __restrict__ p_c, const CGridBox & p_box);
+   void setCoefficientsVec(const ValueType * __restrict__ p_c, const std::size_t p_pos_L, const std::size_t p_pos_R, const std::size_t p_pos_C, const std::size_t p_n);
+   void storeCoefficients(const std::size_t p_pos_L, const std::size_t p_pos_R, const std::size_t p_pos_C, const std::size_t p_n, const VecType & p_v_Vec, const VecType & p_v_CU_Vec, const VecType & p_v_RU_Vec, const VecType & p_v_LU_Vec);
+   void applyLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L) const;
+   void swap(CLinearStencilNonconstCoeffPrecalc & p_other);
+   void release();
+   CLinearStencilNonconstCoeffPrecalc();
 
  public:
     CLinearStencilNonconstCoeffPrecalc(
@@ -35,13 +108,53 @@ class CLinearStencilNonconstCoeffPrecalc : public ILinearOperator<ValueType>
       const ValueType p_tau = ValueType(1.0),
       const ValueType p_epsilon = ValueType(1e-15)
       );
-      inline static const std::string IDENTIFER = "linear_stencil_nonconst_coeff_precalc";
+    CLinearStencilNonconstCoeffPrecalc(
+      const CGridLayout & p_layout,
+      ValueType * p_c,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    CLinearStencilNonconstCoeffPrecalc(CLinearStencilNonconstCoeffPrecalc && p_other);
+    CLinearStencilNonconstCoeffPrecalc & operator=(CLinearStencilNonconstCoeffPrecalc && p_other);
+    CLinearStencilNonconstCoeffPrecalc(const CLinearStencilNonconstCoeffPrecalc &) = delete;
+    CLinearStencilNonconstCoeffPrecalc & operator=(const CLinearStencilNonconstCoeffPrecalc &) = delete;
+      inline static const std::string IDENTIFER =
+         std::string("linear_stencil_nonconst_coeff_precalc")
+         + (std::is_same<StorageType, ValueType>::value ? "" : "_float_coeff")
+         + (Interleaved ? "_interleaved" : "")
+         + MemoryPolicy::IDENTIFER;
     void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    bool diagonal(ValueType * __restrict__ p_d) const;
+    std::size_t levels() const { return m_objLevels; }
+    void applyLevels(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_levelBegin, const std::size_t p_levelEnd) const;
+
+    //
+    // NOTE p_c changed in p_box only (same layout as the operator)
+    //
+    void updateCoefficients(const ValueType * __restrict__ p_c, const CGridBox & p_box);
+    void updateCoefficients(const ValueType * __restrict__ p_c);
+    void rebind(
+      const std::size_t p_objCols,
+      const std::size_t p_objRows,
+      const std::size_t p_objLevels,
+      ValueType * p_c,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    void rebind(
+      const CGridLayout & p_layout,
+      ValueType * p_c,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
     ~CLinearStencilNonconstCoeffPrecalc();
 };
 
-template <typename ValueType, typename VecType>
-CLinearStencilNonconstCoeffPrecalc<ValueType, VecType>::CLinearStencilNonconstCoeffPrecalc(
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::CLinearStencilNonconstCoeffPrecalc(
    const std::size_t p_objCols,
    const std::size_t p_objRows,
    const std::size_t p_objLevels,
@@ -50,99 +163,391 @@ CLinearStencilNonconstCoeffPrecalc<ValueType, VecType>::CLinearStencilNonconstCo
    const ValueType p_tau,
    const ValueType p_epsilon
    ):
-m_objCols(p_objCols),
-m_objRows(p_objRows),
-m_objLevels(p_objLevels),
-m_objSize1d(p_objCols),
-m_objSize2d(p_objCols * p_objRows),
-m_objSize3d(p_objCols * p_objRows * p_objLevels),
-m_factor(p_tau/(p_h*p_h)),
-m_epsilon(p_epsilon)
+CLinearStencilNonconstCoeffPrecalc(CGridLayout(p_objCols, p_objRows, p_objLevels), p_c, p_h, p_tau, p_epsilon)
+{
+
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::CLinearStencilNonconstCoeffPrecalc():
+m_objCols(0),
+m_objRows(0),
+m_objLevels(0),
+m_objSize1d(0),
+m_objSize2d(0),
+m_objSize3d(0),
+m_factor(0),
+m_epsilon(0),
+m_v_LL(nullptr),
+m_v_RL(nullptr),
+m_v_CL(nullptr),
+m_v(nullptr),
+m_v_CU(nullptr),
+m_v_RU(nullptr),
+m_v_LU(nullptr),
+m_vecsPerRow(0),
+m_blockSize(4 * VecType::size()),
+m_blocksPerLevel(0),
+m_v_blocks_raw(nullptr),
+m_v_blocks(nullptr),
+m_capacity_LL(0),
+m_capacity_RL(0),
+m_capacity_CL(0),
+m_capacity_v(0),
+m_capacity_blocks(0)
+{
+
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::CLinearStencilNonconstCoeffPrecalc(
+   const CGridLayout & p_layout,
+   ValueType * p_c,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+CLinearStencilNonconstCoeffPrecalc()
+{
+   rebind(p_layout, p_c, p_h, p_tau, p_epsilon);
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::CLinearStencilNonconstCoeffPrecalc(CLinearStencilNonconstCoeffPrecalc && p_other):
+CLinearStencilNonconstCoeffPrecalc()
+{
+   swap(p_other);
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved> & CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::operator=(CLinearStencilNonconstCoeffPrecalc && p_other)
 {
    //
-   // NOTE "+1" so that upper vectors can be referenced in a shifted way
+   // NOTE the arrays of this operator are released by p_other
    //
-   m_v_LL = new ValueType[m_objSize3d+m_objSize2d];
-   m_v_RL = new ValueType[m_objSize3d+m_objSize1d];
-   m_v_CL = new ValueType[m_objSize3d+1];
-   m_v    = new ValueType[m_objSize3d];
+   swap(p_other);
+   return *this;
+}
 
-   m_v_CU = &(m_v_CL[1]);
-   m_v_RU = &(m_v_RL[m_objSize1d]);
-   m_v_LU = &(m_v_LL[m_objSize2d]);
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::swap(CLinearStencilNonconstCoeffPrecalc & p_other)
+{
+   std::swap(m_objCols, p_other.m_objCols);
+   std::swap(m_objRows, p_other.m_objRows);
+   std::swap(m_objLevels, p_other.m_objLevels);
+   std::swap(m_objSize1d, p_other.m_objSize1d);
+   std::swap(m_objSize2d, p_other.m_objSize2d);
+   std::swap(m_objSize3d, p_other.m_objSize3d);
+   std::swap(m_factor, p_other.m_factor);
+   std::swap(m_epsilon, p_other.m_epsilon);
+   std::swap(m_v_LL, p_other.m_v_LL);
+   std::swap(m_v_RL, p_other.m_v_RL);
+   std::swap(m_v_CL, p_other.m_v_CL);
+   std::swap(m_v, p_other.m_v);
+   std::swap(m_v_CU, p_other.m_v_CU);
+   std::swap(m_v_RU, p_other.m_v_RU);
+   std::swap(m_v_LU, p_other.m_v_LU);
+   std::swap(m_vecsPerRow, p_other.m_vecsPerRow);
+   std::swap(m_blocksPerLevel, p_other.m_blocksPerLevel);
+   std::swap(m_v_blocks_raw, p_other.m_v_blocks_raw);
+   std::swap(m_v_blocks, p_other.m_v_blocks);
+   std::swap(m_capacity_LL, p_other.m_capacity_LL);
+   std::swap(m_capacity_RL, p_other.m_capacity_RL);
+   std::swap(m_capacity_CL, p_other.m_capacity_CL);
+   std::swap(m_capacity_v, p_other.m_capacity_v);
+   std::swap(m_capacity_blocks, p_other.m_capacity_blocks);
+}
 
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::rebind(
+   const std::size_t p_objCols,
+   const std::size_t p_objRows,
+   const std::size_t p_objLevels,
+   ValueType * p_c,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   )
+{
+   rebind(CGridLayout(p_objCols, p_objRows, p_objLevels), p_c, p_h, p_tau, p_epsilon);
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::rebind(
+   const CGridLayout & p_layout,
+   ValueType * p_c,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   )
+{
    //
-   // first touch
+   // NOTE with the same layout the halos and the padding cells of the kept
+   //      arrays are still zero
    //
-   #pragma omp parallel for
-   for (size_t i = 0; i < m_objSize3d; ++i)
+   bool l_sameLayout =
+         m_objCols   == p_layout.objCols()
+      && m_objRows   == p_layout.objRows()
+      && m_objLevels == p_layout.objLevels()
+      && m_objSize1d == p_layout.objSize1d()
+      && m_objSize2d == p_layout.objSize2d()
+      && m_objSize3d == p_layout.objSize3d();
+
+   m_objCols = p_layout.objCols();
+   m_objRows = p_layout.objRows();
+   m_objLevels = p_layout.objLevels();
+   m_objSize1d = p_layout.objSize1d();
+   m_objSize2d = p_layout.objSize2d();
+   m_objSize3d = p_layout.objSize3d();
+   m_factor = p_tau/(p_h*p_h);
+   m_epsilon = p_epsilon;
+   m_vecsPerRow = (m_objCols + VecType::size() - 1) / VecType::size();
+   m_blocksPerLevel = m_vecsPerRow * m_objRows;
+
+   bool l_allocated = false;
+
+   if constexpr (Interleaved)
    {
-      m_v_LU[i] = ValueType(0);
-      m_v_RU[i] = ValueType(0);
-      m_v_CU[i] = ValueType(0);
-      m_v[i]    = ValueType(0);
+      std::size_t l_sizeHalo = m_blocksPerLevel * m_blockSize;
+
+      l_allocated |= CAllocator::reserve(m_v_blocks_raw, m_capacity_blocks, l_sizeHalo+m_objLevels*l_sizeHalo);
+      m_v_blocks = &(m_v_blocks_raw[l_sizeHalo]);
    }
-   m_v_CL[0] = ValueType(0);
-   #pragma omp parallel for
-   for (size_t i = 0; i < m_objSize1d; ++i)
+   else
    {
-      m_v_RL[i] = ValueType(0);
+      //
+      // NOTE "+1" so that upper vectors can be referenced in a shifted way
+      //
+      l_allocated |= CAllocator::reserve(m_v_LL, m_capacity_LL, m_objSize3d+m_objSize2d);
+      l_allocated |= CAllocator::reserve(m_v_RL, m_capacity_RL, m_objSize3d+m_objSize1d);
+      l_allocated |= CAllocator::reserve(m_v_CL, m_capacity_CL, m_objSize3d+1);
+      l_allocated |= CAllocator::reserve(m_v,    m_capacity_v,  m_objSize3d);
+
+      m_v_CU = &(m_v_CL[1]);
+      m_v_RU = &(m_v_RL[m_objSize1d]);
+      m_v_LU = &(m_v_LL[m_objSize2d]);
    }
-   #pragma omp parallel for
-   for (size_t i = 0; i < m_objSize2d; ++i)
+
+   if (l_allocated || !l_sameLayout)
    {
-      m_v_LL[i] = ValueType(0);
+      zeroCoefficients();
    }
 
-   #pragma omp parallel for
-   for(size_t i=0; i<m_objLevels; ++i)
+   updateCoefficients(p_c);
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::zeroCoefficients()
+{
+   //
+   // first touch
+   //
+   if constexpr (Interleaved)
    {
-      for(size_t j=0; j<m_objRows; ++j)
+      //
+      // NOTE padded lanes and the halo level in front stay zero
+      //
+      std::size_t l_sizeHalo = m_blocksPerLevel * m_blockSize;
+
+      #pragma omp parallel
       {
-         for(size_t k=0; k<m_objCols; ++k)
+         CAllocator::firstTouch(m_v_blocks, m_objLevels*l_sizeHalo, l_sizeHalo);
+         #pragma omp for
+         for (std::size_t i = 0; i < l_sizeHalo; ++i)
          {
-            size_t l_pos = i*m_objSize2d + j*m_objSize1d + k;
-            if(i==m_objLevels-1)
-            {
-               m_v_LU[l_pos] = 0;
-            }
-            else
-            {
-               m_v_LU[l_pos] = 2*m_factor*p_c[l_pos]*p_c[l_pos+m_objSize2d]/(p_c[l_pos]+p_c[l_pos+m_objSize2d]+m_epsilon);
-            }
+            m_v_blocks_raw[i] = StorageType(0);
+         }
+      }
+   }
+   else
+   {
+      #pragma omp parallel
+      {
+         CAllocator::firstTouch(m_v_LU, m_objSize3d, m_objSize2d);
+         CAllocator::firstTouch(m_v_RU, m_objSize3d, m_objSize2d);
+         CAllocator::firstTouch(m_v_CU, m_objSize3d, m_objSize2d);
+         CAllocator::firstTouch(m_v,    m_objSize3d, m_objSize2d);
+         #pragma omp for
+         for (std::size_t i = 0; i < m_objSize1d; ++i)
+         {
+            m_v_RL[i] = StorageType(0);
+         }
+         #pragma omp for
+         for (std::size_t i = 0; i < m_objSize2d; ++i)
+         {
+            m_v_LL[i] = StorageType(0);
+         }
+      }
+      m_v_CL[0] = StorageType(0);
+   }
+}
 
-            if(j==m_objRows-1)
-            {
-               m_v_RU[l_pos] = 0;
-            }
-            else
-            {
-               m_v_RU[l_pos] = 2*m_factor*p_c[l_pos]*p_c[l_pos+m_objSize1d]/(p_c[l_pos]+p_c[l_pos+m_objSize1d]+m_epsilon);
-            }
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::updateCoefficients(const ValueType * __restrict__ p_c)
+{
+   setCoefficients(p_c, CGridBox(0, m_objCols, 0, m_objRows, 0, m_objLevels));
+}
 
-            if(k==m_objCols-1)
-            {
-               m_v_CU[l_pos] = 0;
-            }
-            else
-            {
-               m_v_CU[l_pos] = 2*m_factor*p_c[l_pos]*p_c[l_pos+1]/(p_c[l_pos]+p_c[l_pos+1]+m_epsilon);
-            }
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::updateCoefficients(const ValueType * __restrict__ p_c, const CGridBox & p_box)
+{
+   if (p_box.empty())
+   {
+      return;
+   }
+
+   //
+   // NOTE the upper coefficients of the cells below/left of p_box and the
+   //      diagonals of all neighbours depend on p_c of p_box
+   //
+   setCoefficients(p_c, p_box.grown(1, CGridLayout(m_objCols, m_objRows, m_objLevels)));
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::setCoefficients(const ValueType * __restrict__ p_c, const CGridBox & p_box)
+{
+   //
+   // NOTE the columns start on a whole vector, so that the interleaved
+   //      blocks are written as a whole (the additional cells are
+   //      recomputed with the same values)
+   //
+   std::size_t l_colBegin = (p_box.colBegin() / VecType::size()) * VecType::size();
+
+   #pragma omp parallel for schedule(static)
+   for (std::size_t l_pos_L=p_box.levelBegin(); l_pos_L<p_box.levelEnd(); ++l_pos_L)
+   {
+      for (std::size_t l_pos_R=p_box.rowBegin(); l_pos_R<p_box.rowEnd(); ++l_pos_R)
+      {
+         for (std::size_t l_pos_C=l_colBegin; l_pos_C<p_box.colEnd(); l_pos_C+=VecType::size())
+         {
+            setCoefficientsVec(p_c, l_pos_L, l_pos_R, l_pos_C, VecUtils::lanesValid(l_pos_C, p_box.colEnd()));
          }
       }
    }
-   #pragma omp parallel for
-   for (size_t i = 0; i < m_objSize3d; ++i)
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+inline void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::setCoefficientsVec(const ValueType * __restrict__ p_c, const std::size_t p_pos_L, const std::size_t p_pos_R, const std::size_t p_pos_C, const std::size_t p_n)
+{
+   std::size_t l_pos = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + p_pos_C;
+
+   VecType l_pos_C_Vec = VecUtils::lanes() + ValueType(p_pos_C);
+
+   VecType l_c_LL_Vec;
+   VecType l_c_RL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_RU_Vec;
+   VecType l_c_LU_Vec;
+
+   VecType l_v_LL_Vec(0);
+   VecType l_v_RL_Vec(0);
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec(0);
+   VecType l_v_LU_Vec(0);
+
+   VecUtils::load(l_c_Vec, p_c + l_pos, p_n);
+
+   //
+   // NOTE p_c is read inside of the grid only: the CU lane of the last
+   //      column and the CL lane of the first column are masked
+   //
+   VecUtils::load(l_c_CU_Vec, p_c + l_pos + 1, VecUtils::lanesValid(p_pos_C + 1, m_objCols));
+   if (p_pos_C > 0)
+   {
+      VecUtils::load(l_c_CL_Vec, p_c + l_pos - 1, p_n);
+   }
+   else
+   {
+      l_c_CL_Vec = VecUtils::shiftLow(VecType(0), l_c_Vec);
+   }
+
+   l_v_CL_Vec = select(l_pos_C_Vec>ValueType(0),           StorageUtils::roundToStorage(2*m_factor*l_c_CL_Vec*l_c_Vec/(l_c_CL_Vec+l_c_Vec+m_epsilon)), VecType(0));
+   l_v_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), StorageUtils::roundToStorage(2*m_factor*l_c_Vec*l_c_CU_Vec/(l_c_Vec+l_c_CU_Vec+m_epsilon)), VecType(0));
+
+   if (p_pos_L > 0)
+   {
+      VecUtils::load(l_c_LL_Vec, p_c + l_pos - m_objSize2d, p_n);
+      l_v_LL_Vec = StorageUtils::roundToStorage(2*m_factor*l_c_LL_Vec*l_c_Vec/(l_c_LL_Vec+l_c_Vec+m_epsilon));
+   }
+   if (p_pos_R > 0)
+   {
+      VecUtils::load(l_c_RL_Vec, p_c + l_pos - m_objSize1d, p_n);
+      l_v_RL_Vec = StorageUtils::roundToStorage(2*m_factor*l_c_RL_Vec*l_c_Vec/(l_c_RL_Vec+l_c_Vec+m_epsilon));
+   }
+   if (p_pos_R < m_objRows-1)
+   {
+      VecUtils::load(l_c_RU_Vec, p_c + l_pos + m_objSize1d, p_n);
+      l_v_RU_Vec = StorageUtils::roundToStorage(2*m_factor*l_c_Vec*l_c_RU_Vec/(l_c_Vec+l_c_RU_Vec+m_epsilon));
+   }
+   if (p_pos_L < m_objLevels-1)
+   {
+      VecUtils::load(l_c_LU_Vec, p_c + l_pos + m_objSize2d, p_n);
+      l_v_LU_Vec = StorageUtils::roundToStorage(2*m_factor*l_c_Vec*l_c_LU_Vec/(l_c_Vec+l_c_LU_Vec+m_epsilon));
+   }
+
+   l_v_Vec = ValueType(1) + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+
+   storeCoefficients(p_pos_L, p_pos_R, p_pos_C, p_n, l_v_Vec, l_v_CU_Vec, l_v_RU_Vec, l_v_LU_Vec);
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+inline void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::storeCoefficients(const std::size_t p_pos_L, const std::size_t p_pos_R, const std::size_t p_pos_C, const std::size_t p_n, const VecType & p_v_Vec, const VecType & p_v_CU_Vec, const VecType & p_v_RU_Vec, const VecType & p_v_LU_Vec)
+{
+   if constexpr (Interleaved)
+   {
+      StorageType * l_block = m_v_blocks + (p_pos_L * m_blocksPerLevel + p_pos_R * m_vecsPerRow + p_pos_C / VecType::size()) * m_blockSize;
+
+      StorageUtils::store(p_v_CU_Vec, l_block + SLOT_CU * VecType::size(), p_n);
+      StorageUtils::store(p_v_RU_Vec, l_block + SLOT_RU * VecType::size(), p_n);
+      StorageUtils::store(p_v_LU_Vec, l_block + SLOT_LU * VecType::size(), p_n);
+      StorageUtils::store(p_v_Vec,    l_block + SLOT_V  * VecType::size(), p_n);
+   }
+   else
+   {
+      std::size_t l_pos = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + p_pos_C;
+
+      StorageUtils::store(p_v_Vec,    m_v    + l_pos, p_n);
+      StorageUtils::store(p_v_CU_Vec, m_v_CU + l_pos, p_n);
+      StorageUtils::store(p_v_RU_Vec, m_v_RU + l_pos, p_n);
+      StorageUtils::store(p_v_LU_Vec, m_v_LU + l_pos, p_n);
+   }
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   #pragma omp for nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      applyLevel(p_x, p_y, l_pos_L);
+   }
+
+   MemoryPolicy::fence();
+   #pragma omp barrier
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::applyLevels(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_levelBegin, const std::size_t p_levelEnd) const
+{
+   for (std::size_t l_pos_L=p_levelBegin; l_pos_L<p_levelEnd; ++l_pos_L)
    {
-      m_v[i]=1+m_v_LL[i]+m_v_RL[i]+m_v_CL[i]+m_v_CU[i]+m_v_RU[i]+m_v_LU[i];
+      applyLevel(p_x, p_y, l_pos_L);
    }
 
+   MemoryPolicy::fence();
 }
 
-template <typename ValueType, typename VecType>
-void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+inline void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::applyLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L) const
 {
    std::size_t l_pos;
+   std::size_t l_n;
+
+   const StorageType * l_block = nullptr;
 
    VecType l_x_LL_Vec;
    VecType l_x_RL_Vec;
@@ -162,48 +567,153 @@ void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType>::apply(const ValueTy
    VecType l_v_RU_Vec;
    VecType l_v_LU_Vec;
 
+   VecType l_v_CU_prev_Vec;
+
+   for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+   {
+      if constexpr (Interleaved)
+      {
+         l_block = m_v_blocks + (p_pos_L * m_blocksPerLevel + l_pos_R * m_vecsPerRow) * m_blockSize;
+
+         //
+         // NOTE CL of the first column is zero
+         //
+         l_v_CU_prev_Vec = VecType(0);
+      }
+
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_pos = p_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         MemoryPolicy::prefetch(p_x + l_pos - m_objSize2d);
+         MemoryPolicy::prefetch(p_x + l_pos + m_objSize2d);
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_RL_Vec, p_x + l_pos - m_objSize1d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_Vec,    p_x + l_pos              , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_RU_Vec, p_x + l_pos + m_objSize1d, l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         if constexpr (Interleaved)
+         {
+            //
+            // NOTE blocks are padded, whole vectors are loaded
+            //
+            StorageUtils::load(l_v_CU_Vec, l_block + SLOT_CU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_RU_Vec, l_block + SLOT_RU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_LU_Vec, l_block + SLOT_LU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_RL_Vec, l_block - m_vecsPerRow * m_blockSize + SLOT_RU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_LL_Vec, l_block - m_blocksPerLevel * m_blockSize + SLOT_LU * VecType::size(), VecType::size());
+
+            l_v_CL_Vec = VecUtils::shiftLow(l_v_CU_prev_Vec, l_v_CU_Vec);
+
+            StorageUtils::load(l_v_Vec, l_block + SLOT_V * VecType::size(), VecType::size());
+
+            l_v_CU_prev_Vec = l_v_CU_Vec;
+            l_block += m_blockSize;
+         }
+         else
+         {
+            StorageUtils::load(l_v_LL_Vec, m_v_LL + l_pos, l_n);
+            StorageUtils::load(l_v_RL_Vec, m_v_RL + l_pos, l_n);
+            StorageUtils::load(l_v_CL_Vec, m_v_CL + l_pos, l_n);
+            StorageUtils::load(l_v_Vec,    m_v    + l_pos, l_n);
+            StorageUtils::load(l_v_CU_Vec, m_v_CU + l_pos, l_n);
+            StorageUtils::load(l_v_RU_Vec, m_v_RU + l_pos, l_n);
+            StorageUtils::load(l_v_LU_Vec, m_v_LU + l_pos, l_n);
+         }
+
+         l_y_Vec =
+            l_v_Vec    * l_x_Vec
+         -  l_v_LL_Vec * l_x_LL_Vec
+         -  l_v_RL_Vec * l_x_RL_Vec
+         -  l_v_CL_Vec * l_x_CL_Vec
+         -  l_v_CU_Vec * l_x_CU_Vec
+         -  l_v_RU_Vec * l_x_RU_Vec
+         -  l_v_LU_Vec * l_x_LU_Vec
+         ;
+         MemoryPolicy::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+   }
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+bool CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::diagonal(ValueType * __restrict__ p_d) const
+{
+   //
+   // NOTE the stored diagonal widened to ValueType
+   //
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   const StorageType * l_block = nullptr;
+
+   VecType l_v_Vec;
+
    #pragma omp for
    for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
    {
       for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
       {
+         if constexpr (Interleaved)
+         {
+            l_block = m_v_blocks + (l_pos_L * m_blocksPerLevel + l_pos_R * m_vecsPerRow) * m_blockSize;
+         }
+
          for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
          {
             l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
 
-            l_x_LL_Vec.load(p_x + l_pos - m_objSize2d);
-            l_x_RL_Vec.load(p_x + l_pos - m_objSize1d);
-            l_x_CL_Vec.load(p_x + l_pos - 1          );
-            l_x_Vec.load(   p_x + l_pos              );
-            l_x_CU_Vec.load(p_x + l_pos + 1          );
-            l_x_RU_Vec.load(p_x + l_pos + m_objSize1d);
-            l_x_LU_Vec.load(p_x + l_pos + m_objSize2d);
-
-            l_v_LL_Vec.load(m_v_LL + l_pos);
-            l_v_RL_Vec.load(m_v_RL + l_pos);
-            l_v_CL_Vec.load(m_v_CL + l_pos);
-            l_v_Vec.load(   m_v    + l_pos);
-            l_v_CU_Vec.load(m_v_CU + l_pos);
-            l_v_RU_Vec.load(m_v_RU + l_pos);
-            l_v_LU_Vec.load(m_v_LU + l_pos);
-
-            l_y_Vec =
-               l_v_Vec    * l_x_Vec
-            -  l_v_LL_Vec * l_x_LL_Vec
-            -  l_v_RL_Vec * l_x_RL_Vec
-            -  l_v_CL_Vec * l_x_CL_Vec
-            -  l_v_CU_Vec * l_x_CU_Vec
-            -  l_v_RU_Vec * l_x_RU_Vec
-            -  l_v_LU_Vec * l_x_LU_Vec
-            ;
-            l_y_Vec.store(p_y + l_pos);
+            if constexpr (Interleaved)
+            {
+               StorageUtils::load(l_v_Vec, l_block + SLOT_V * VecType::size(), VecType::size());
+               l_block += m_blockSize;
+            }
+            else
+            {
+               StorageUtils::load(l_v_Vec, m_v + l_pos, l_n);
+            }
+
+            VecUtils::store(l_v_Vec, p_d + l_pos, l_n);
          }
       }
    }
+
+   return true;
 }
 
-template <typename ValueType, typename VecType>
-CLinearStencilNonconstCoeffPrecalc<ValueType, VecType>::~CLinearStencilNonconstCoeffPrecalc()
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+void CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::release()
 {
+   CAllocator::deallocate(m_v_LL);
+   CAllocator::deallocate(m_v_RL);
+   CAllocator::deallocate(m_v_CL);
+   CAllocator::deallocate(m_v);
+   CAllocator::deallocate(m_v_blocks_raw);
+
+   m_v_LL = nullptr;
+   m_v_RL = nullptr;
+   m_v_CL = nullptr;
+   m_v = nullptr;
+   m_v_CU = nullptr;
+   m_v_RU = nullptr;
+   m_v_LU = nullptr;
+   m_v_blocks_raw = nullptr;
+   m_v_blocks = nullptr;
 
+   m_capacity_LL = 0;
+   m_capacity_RL = 0;
+   m_capacity_CL = 0;
+   m_capacity_v = 0;
+   m_capacity_blocks = 0;
+}
+
+template <typename ValueType, typename VecType, typename StorageType, typename MemoryPolicy, bool Interleaved>
+CLinearStencilNonconstCoeffPrecalc<ValueType, VecType, StorageType, MemoryPolicy, Interleaved>::~CLinearStencilNonconstCoeffPrecalc()
+{
+   release();
 }
@@ -0,0 +1,83 @@
+/*
+ * Memory policy of the apply kernels, passed as MemoryPolicy template
+ * parameter to the bandwidth bound operators.
+ *
+ * StreamingStores = true: y is written with non-temporal stores (store_nt),
+ * the output cache lines are not read before they are written
+ * (write-allocate), one stream less per apply. Only full vectors aligned to
+ * the vector width are streamed, the last partial vector of a row and
+ * unaligned addresses fall back to normal stores. Every thread calls
+ * fence() after its last store and before the barrier of apply.
+ *
+ * PrefetchDistance > 0: the LL and LU planes of x are prefetched
+ * PrefetchDistance values ahead of the current position (software
+ * prefetch, no fault on addresses outside the grid).
+ *
+ * CMemoryPolicy<> is a normal store without prefetch, the kernels are the
+ * same as without policy.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <immintrin.h>
+#include "c_vec_utils.hpp"
+
+template <bool StreamingStores = false, std::size_t PrefetchDistance = 0>
+class CMemoryPolicy
+{
+   public:
+      inline static const std::string IDENTIFER =
+         std::string(StreamingStores ? "_nt" : "")
+         + (PrefetchDistance > 0 ? "_prefetch_" + std::to_string(PrefetchDistance) : "");
+
+      template <typename ValueType, typename VecType>
+      static inline void store(const VecType & p_v, ValueType * p_ptr, const std::size_t p_n)
+      {
+         if constexpr (StreamingStores)
+         {
+            if (p_n == VecType::size() && reinterpret_cast<std::uintptr_t>(p_ptr) % sizeof(VecType) == 0)
+            {
+               p_v.store_nt(p_ptr);
+               return;
+            }
+         }
+         CVecUtils<ValueType, VecType>::store(p_v, p_ptr, p_n);
+      }
+
+      //
+      // NOTE p_ptr has to be aligned to the vector width
+      //
+      template <typename ValueType, typename VecType>
+      static inline void storeAligned(const VecType & p_v, ValueType * p_ptr)
+      {
+         if constexpr (StreamingStores)
+         {
+            p_v.store_nt(p_ptr);
+         }
+         else
+         {
+            CVecUtils<ValueType, VecType>::storeAligned(p_v, p_ptr);
+         }
+      }
+
+      template <typename ValueType>
+      static inline void prefetch(const ValueType * p_ptr)
+      {
+         if constexpr (PrefetchDistance > 0)
+         {
+            __builtin_prefetch(p_ptr + PrefetchDistance, 0, 3);
+         }
+      }
+
+      static inline void fence()
+      {
+         if constexpr (StreamingStores)
+         {
+            _mm_sfence();
+         }
+      }
+};
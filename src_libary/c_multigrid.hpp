@@ -0,0 +1,647 @@
+/*
+*
+*  Geometric multigrid V-cycle for the 7-point stencils of a coefficient
+*  field p_c (CLinearStencilNonconstCoeffPrecalc, CNonlinearStencil* with
+*  p_c = f(s)), as IPreconditioner of CPCG and as ISolver
+*
+*  cell-centred: a coarse cell is the 2x2x2 block of fine cells
+*  (2C..2C+1, 2R..2R+1, 2L..2L+1), odd sizes give coarse cells with fewer
+*  children at the upper ends. The grid is coarsened while all dimensions
+*  are >= COARSEN_MIN, at most p_levelsMax grids
+*
+*  coarse operators are CLinearStencilNonconstCoeffPrecalc with the same
+*  harmonic face coefficients on the coarse grid: p_c averaged over the
+*  children, h doubled per level (rediscretization, no Galerkin product)
+*
+*  the finest level is p_A itself (residual and smoother), the hierarchy
+*  only approximates it: p_c, p_h and p_tau have to be those of p_A
+*
+*  restriction is the sum over the children / 8 (1/8 P^T), prolongation
+*  adds the coarse value to all children (piecewise constant), so that the
+*  cycle is symmetric (with the same number of pre- and post-smoothing
+*  sweeps) and can precondition CG
+*
+*  smoother: damped Jacobi z += omega D^-1 (r - A z) with the diagonal of
+*  the operators (diagonal(), omega D^-1 is stored), the first sweep of
+*  a level starts from z = 0 without apply. The coarsest grid is smoothed
+*  with p_sweepsCoarsest sweeps. An operator without diagonal() is smoothed
+*  with D = I (only sensible for a diagonal close to 1)
+*
+*  all kernels are vectorized with VecType (partial loads/stores at the row
+*  ends) and are orphaned worksharing loops (omp for over the levels of a
+*  grid or over the flat vectors) called by all threads of the parallel
+*  region of the solver, like apply. The coarse grids are CGrid (first
+*  touch with the level distribution), the fine level work vectors are
+*  kept in a CWorkspace
+*
+*  as ISolver every cycle z = M^-1 r is applied with the step length
+*  (r * z) / (z * A z) (preconditioned steepest descent) and r is updated
+*  with A z, same number of applies as x += z with r = b - A x. The plain
+*  iteration x += z over-corrects with the piecewise constant prolongation
+*  (the rediscretized coarse operators are weaker than the Galerkin ones)
+*  and diverges on deep hierarchies with coefficient jumps, the step length
+*  keeps it convergent. As preconditioner of CPCG this does not matter:
+*  the iteration counts of CPCG(&multigrid) are nearly independent of the
+*  grid size
+*
+*  updateCoefficients(p_c) recomputes the coarse coefficient fields and
+*  operators after p_c changed
+*
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <omp.h>
+#include <string>
+#include "i_linear_operator.hpp"
+#include "i_preconditioner.hpp"
+#include "i_solver.hpp"
+#include "c_grid.hpp"
+#include "c_vec_utils.hpp"
+#include "c_workspace.hpp"
+#include "c_linear_stencil_nonconst_coeff_precalc.hpp"
+
+template <typename ValueType, typename VecType, typename AccumulatorType = double>
+class CMultigrid: public ISolver<ValueType>, public IPreconditioner<ValueType>
+{
+    private:
+        using VecUtils = CVecUtils<ValueType, VecType>;
+        using COperator = CLinearStencilNonconstCoeffPrecalc<ValueType, VecType>;
+
+        inline static constexpr std::size_t LEVELS_MAX = 16;
+        inline static constexpr std::size_t COARSEN_MIN = 4;
+
+        CGridLayout m_layout;
+        std::size_t m_levels;
+        std::size_t m_sweeps;
+        std::size_t m_sweepsCoarsest;
+        ValueType m_omega;
+
+        //
+        // NOTE grid 0 is the fine grid of p_A, the arrays below are empty
+        //      there: its vectors are those of the caller and m_workspace
+        //
+        std::unique_ptr<CGrid<ValueType>> m_c[LEVELS_MAX];
+        std::unique_ptr<CGrid<ValueType>> m_x[LEVELS_MAX];
+        std::unique_ptr<CGrid<ValueType>> m_b[LEVELS_MAX];
+        std::unique_ptr<CGrid<ValueType>> m_t[LEVELS_MAX];
+        std::unique_ptr<CGrid<ValueType>> m_dinv[LEVELS_MAX];
+        std::unique_ptr<COperator> m_A[LEVELS_MAX];
+
+        //
+        // NOTE fine level: A z and omega D^-1 (preconditioner), r, the
+        //      correction z and A z (solver)
+        //
+        mutable CWorkspace<ValueType, 2> m_workspace;
+        mutable CWorkspace<ValueType, 3> m_workspaceSolver;
+
+        const CGridLayout & layout(const std::size_t p_level) const { return p_level == 0 ? m_layout : *m_x[p_level]; }
+
+        void restrictCoefficients(const CGridLayout & p_fine, const ValueType * __restrict__ p_c_fine, CGrid<ValueType> & p_c) const;
+        void invertDiagonal(const std::size_t p_size, const bool p_diagonal, ValueType * __restrict__ p_dinv) const;
+        void smooth(
+            const ILinearOperator<ValueType> & p_A,
+            const std::size_t p_size,
+            const ValueType * __restrict__ p_dinv,
+            const ValueType * __restrict__ p_r,
+            ValueType * __restrict__ p_t,
+            ValueType * __restrict__ p_z,
+            const std::size_t p_sweeps,
+            const bool p_zero
+        ) const;
+        void restrictResidual(
+            const CGridLayout & p_fine,
+            const CGridLayout & p_coarse,
+            const ValueType * __restrict__ p_r,
+            const ValueType * __restrict__ p_t,
+            ValueType * __restrict__ p_b
+        ) const;
+        void prolongate(
+            const CGridLayout & p_coarse,
+            const CGridLayout & p_fine,
+            const ValueType * __restrict__ p_x,
+            ValueType * __restrict__ p_z
+        ) const;
+
+    public:
+        inline static const std::string IDENTIFER = "multigrid";
+
+        CMultigrid(
+            const CGridLayout & p_layout,
+            const ValueType * p_c,
+            const ValueType p_h = ValueType(1.0),
+            const ValueType p_tau = ValueType(1.0),
+            const ValueType p_epsilon = ValueType(1e-15),
+            const std::size_t p_sweeps = 2,
+            const std::size_t p_sweepsCoarsest = 16,
+            const ValueType p_omega = ValueType(0.8),
+            const std::size_t p_levelsMax = LEVELS_MAX
+        );
+        CMultigrid(const CMultigrid &) = delete;
+        CMultigrid & operator=(const CMultigrid &) = delete;
+
+        //
+        // NOTE p_c changed (same layout as the fine grid)
+        //
+        void updateCoefficients(const ValueType * p_c);
+
+        //
+        // NOTE number of grids including the fine grid
+        //
+        std::size_t levels() const { return m_levels; }
+
+        void reserve(const std::size_t p_size, const std::size_t p_bufferSize) const;
+        void setup(const ILinearOperator<ValueType> & p_A) const;
+
+        //
+        // NOTE one V-cycle with zero initial guess
+        //
+        void apply(const ILinearOperator<ValueType> & p_A, const ValueType * __restrict__ p_r, ValueType * __restrict__ p_z) const;
+
+        //
+        // NOTE V-cycles on the residual until norm2(r) < p_epsilon, returns
+        //      the number of cycles
+        //
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const;
+};
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+CMultigrid<ValueType, VecType, AccumulatorType>::CMultigrid(
+    const CGridLayout & p_layout,
+    const ValueType * p_c,
+    const ValueType p_h,
+    const ValueType p_tau,
+    const ValueType p_epsilon,
+    const std::size_t p_sweeps,
+    const std::size_t p_sweepsCoarsest,
+    const ValueType p_omega,
+    const std::size_t p_levelsMax
+):
+m_layout(p_layout),
+m_levels(1),
+m_sweeps(p_sweeps),
+m_sweepsCoarsest(p_sweepsCoarsest),
+m_omega(p_omega)
+{
+    std::size_t l_levelsMax = p_levelsMax < LEVELS_MAX ? p_levelsMax : LEVELS_MAX;
+    ValueType l_h = p_h;
+
+    while (m_levels < l_levelsMax)
+    {
+        const CGridLayout & l_fine = layout(m_levels-1);
+
+        if (l_fine.objCols() < COARSEN_MIN || l_fine.objRows() < COARSEN_MIN || l_fine.objLevels() < COARSEN_MIN)
+        {
+            break;
+        }
+
+        std::size_t l_objCols = (l_fine.objCols() + 1) / 2;
+        std::size_t l_objRows = (l_fine.objRows() + 1) / 2;
+        std::size_t l_objLevels = (l_fine.objLevels() + 1) / 2;
+
+        //
+        // NOTE coarse grids are padded like the fine grid
+        //
+        CGridLayout l_coarse = m_layout.isPadded()
+            ? CGridLayout::padded(l_objCols, l_objRows, l_objLevels, sizeof(ValueType))
+            : CGridLayout(l_objCols, l_objRows, l_objLevels);
+
+        l_h *= 2;
+
+        m_c[m_levels] = std::make_unique<CGrid<ValueType>>(l_coarse);
+        m_x[m_levels] = std::make_unique<CGrid<ValueType>>(l_coarse);
+        m_b[m_levels] = std::make_unique<CGrid<ValueType>>(l_coarse);
+        m_t[m_levels] = std::make_unique<CGrid<ValueType>>(l_coarse);
+        m_dinv[m_levels] = std::make_unique<CGrid<ValueType>>(l_coarse);
+
+        //
+        // NOTE the coefficients are computed by updateCoefficients below
+        //
+        m_A[m_levels] = std::make_unique<COperator>(l_coarse, m_c[m_levels]->data(), l_h, p_tau, p_epsilon);
+
+        ++m_levels;
+    }
+
+    updateCoefficients(p_c);
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::updateCoefficients(const ValueType * p_c)
+{
+    for (std::size_t l = 1; l < m_levels; ++l)
+    {
+        restrictCoefficients(layout(l-1), l == 1 ? p_c : m_c[l-1]->data(), *m_c[l]);
+
+        m_A[l]->updateCoefficients(m_c[l]->data());
+
+        ValueType * l_dinv = m_dinv[l]->data();
+        std::size_t l_size = m_dinv[l]->objSize3d();
+
+        #pragma omp parallel
+        {
+            bool l_diagonal_t = m_A[l]->diagonal(l_dinv);
+            invertDiagonal(l_size, l_diagonal_t, l_dinv);
+        }
+    }
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::restrictCoefficients(const CGridLayout & p_fine, const ValueType * __restrict__ p_c_fine, CGrid<ValueType> & p_c) const
+{
+    //
+    // NOTE mean over the existing children (setup only, not vectorized)
+    //
+    #pragma omp parallel for schedule(static)
+    for (std::size_t l_pos_L = 0; l_pos_L < p_c.objLevels(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_c.objRows(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_c.objCols(); ++l_pos_C)
+            {
+                ValueType l_sum = 0;
+                std::size_t l_children = 0;
+
+                for (std::size_t l_L = 2*l_pos_L; l_L < 2*l_pos_L+2 && l_L < p_fine.objLevels(); ++l_L)
+                {
+                    for (std::size_t l_R = 2*l_pos_R; l_R < 2*l_pos_R+2 && l_R < p_fine.objRows(); ++l_R)
+                    {
+                        for (std::size_t l_C = 2*l_pos_C; l_C < 2*l_pos_C+2 && l_C < p_fine.objCols(); ++l_C)
+                        {
+                            l_sum += p_c_fine[p_fine.pos(l_C, l_R, l_L)];
+                            ++l_children;
+                        }
+                    }
+                }
+
+                p_c(l_pos_C, l_pos_R, l_pos_L) = l_sum / ValueType(l_children);
+            }
+        }
+    }
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::invertDiagonal(const std::size_t p_size, const bool p_diagonal, ValueType * __restrict__ p_dinv) const
+{
+    //
+    // NOTE padding cells (not written by diagonal()) are zero and stay zero
+    //
+    #pragma omp for schedule(static)
+    for (std::size_t i = 0; i < p_size; ++i)
+    {
+        p_dinv[i] = p_diagonal ? (p_dinv[i] != ValueType(0) ? m_omega / p_dinv[i] : ValueType(0)) : m_omega;
+    }
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::reserve(const std::size_t p_size, const std::size_t p_bufferSize) const
+{
+    m_workspace.reserve(p_size, p_bufferSize);
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::setup(const ILinearOperator<ValueType> & p_A) const
+{
+    ValueType * l_dinv = m_workspace.vector(1);
+
+    bool l_diagonal_t = p_A.diagonal(l_dinv);
+    invertDiagonal(m_workspace.size(), l_diagonal_t, l_dinv);
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::smooth(
+    const ILinearOperator<ValueType> & p_A,
+    const std::size_t p_size,
+    const ValueType * __restrict__ p_dinv,
+    const ValueType * __restrict__ p_r,
+    ValueType * __restrict__ p_t,
+    ValueType * __restrict__ p_z,
+    const std::size_t p_sweeps,
+    const bool p_zero
+) const
+{
+    std::size_t l_n;
+
+    VecType l_dinv_Vec;
+    VecType l_r_Vec;
+    VecType l_t_Vec;
+    VecType l_z_Vec;
+
+    for (std::size_t l_sweep = 0; l_sweep < p_sweeps; ++l_sweep)
+    {
+        if (p_zero && l_sweep == 0)
+        {
+            //
+            // NOTE z = 0: A z = 0
+            //
+            #pragma omp for schedule(static)
+            for (std::size_t i = 0; i < p_size; i += VecType::size())
+            {
+                l_n = VecUtils::lanesValid(i, p_size);
+
+                VecUtils::load(l_dinv_Vec, p_dinv + i, l_n);
+                VecUtils::load(l_r_Vec,    p_r + i,    l_n);
+
+                VecUtils::store(l_dinv_Vec * l_r_Vec, p_z + i, l_n);
+            }
+            continue;
+        }
+
+        p_A.apply(p_z, p_t);
+        #pragma omp barrier
+
+        #pragma omp for schedule(static)
+        for (std::size_t i = 0; i < p_size; i += VecType::size())
+        {
+            l_n = VecUtils::lanesValid(i, p_size);
+
+            VecUtils::load(l_dinv_Vec, p_dinv + i, l_n);
+            VecUtils::load(l_r_Vec,    p_r + i,    l_n);
+            VecUtils::load(l_t_Vec,    p_t + i,    l_n);
+            VecUtils::load(l_z_Vec,    p_z + i,    l_n);
+
+            VecUtils::store(l_z_Vec + l_dinv_Vec * (l_r_Vec - l_t_Vec), p_z + i, l_n);
+        }
+    }
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::restrictResidual(
+    const CGridLayout & p_fine,
+    const CGridLayout & p_coarse,
+    const ValueType * __restrict__ p_r,
+    const ValueType * __restrict__ p_t,
+    ValueType * __restrict__ p_b
+) const
+{
+    //
+    // NOTE b = 1/8 sum over the children of (r - A z), t = A z. The V
+    //      coarse cells of a vector are the 2V fine cells of two vectors,
+    //      the pairs of columns are added by the even/odd lanes
+    //
+    std::size_t l_pos;
+    std::size_t l_n_lo;
+    std::size_t l_n_hi;
+    std::size_t l_pos_C;
+
+    VecType l_r_Vec;
+    VecType l_t_Vec;
+    VecType l_lo_Vec;
+    VecType l_hi_Vec;
+
+    #pragma omp for schedule(static)
+    for (std::size_t l_pos_Lc = 0; l_pos_Lc < p_coarse.objLevels(); ++l_pos_Lc)
+    {
+        for (std::size_t l_pos_Rc = 0; l_pos_Rc < p_coarse.objRows(); ++l_pos_Rc)
+        {
+            for (std::size_t l_pos_Cc = 0; l_pos_Cc < p_coarse.objCols(); l_pos_Cc += VecType::size())
+            {
+                l_pos_C = 2 * l_pos_Cc;
+                l_n_lo = VecUtils::lanesValid(l_pos_C, p_fine.objCols());
+                l_n_hi = l_pos_C + VecType::size() < p_fine.objCols() ? VecUtils::lanesValid(l_pos_C + VecType::size(), p_fine.objCols()) : 0;
+
+                l_lo_Vec = VecType(0);
+                l_hi_Vec = VecType(0);
+
+                for (std::size_t l_pos_L = 2*l_pos_Lc; l_pos_L < 2*l_pos_Lc+2 && l_pos_L < p_fine.objLevels(); ++l_pos_L)
+                {
+                    for (std::size_t l_pos_R = 2*l_pos_Rc; l_pos_R < 2*l_pos_Rc+2 && l_pos_R < p_fine.objRows(); ++l_pos_R)
+                    {
+                        l_pos = p_fine.pos(l_pos_C, l_pos_R, l_pos_L);
+
+                        VecUtils::load(l_r_Vec, p_r + l_pos, l_n_lo);
+                        VecUtils::load(l_t_Vec, p_t + l_pos, l_n_lo);
+                        l_lo_Vec += l_r_Vec - l_t_Vec;
+
+                        if (l_n_hi > 0)
+                        {
+                            VecUtils::load(l_r_Vec, p_r + l_pos + VecType::size(), l_n_hi);
+                            VecUtils::load(l_t_Vec, p_t + l_pos + VecType::size(), l_n_hi);
+                            l_hi_Vec += l_r_Vec - l_t_Vec;
+                        }
+                    }
+                }
+
+                VecUtils::store(
+                    ValueType(0.125) * (VecUtils::evenLanes(l_lo_Vec, l_hi_Vec) + VecUtils::oddLanes(l_lo_Vec, l_hi_Vec)),
+                    p_b + p_coarse.pos(l_pos_Cc, l_pos_Rc, l_pos_Lc),
+                    VecUtils::lanesValid(l_pos_Cc, p_coarse.objCols())
+                );
+            }
+        }
+    }
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::prolongate(
+    const CGridLayout & p_coarse,
+    const CGridLayout & p_fine,
+    const ValueType * __restrict__ p_x,
+    ValueType * __restrict__ p_z
+) const
+{
+    //
+    // NOTE z += x of the parent, one coarse vector gives two fine vectors
+    //
+    std::size_t l_pos;
+    std::size_t l_pos_Cc;
+
+    VecType l_x_Vec;
+    VecType l_z_Vec;
+
+    #pragma omp for schedule(static)
+    for (std::size_t l_pos_L = 0; l_pos_L < p_fine.objLevels(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_fine.objRows(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_fine.objCols(); l_pos_C += 2 * VecType::size())
+            {
+                l_pos = p_fine.pos(l_pos_C, l_pos_R, l_pos_L);
+                l_pos_Cc = l_pos_C / 2;
+
+                VecUtils::load(l_x_Vec, p_x + p_coarse.pos(l_pos_Cc, l_pos_R / 2, l_pos_L / 2), VecUtils::lanesValid(l_pos_Cc, p_coarse.objCols()));
+
+                VecUtils::load(l_z_Vec, p_z + l_pos, VecUtils::lanesValid(l_pos_C, p_fine.objCols()));
+                VecUtils::store(l_z_Vec + VecUtils::duplicateLow(l_x_Vec), p_z + l_pos, VecUtils::lanesValid(l_pos_C, p_fine.objCols()));
+
+                if (l_pos_C + VecType::size() < p_fine.objCols())
+                {
+                    std::size_t l_n_hi = VecUtils::lanesValid(l_pos_C + VecType::size(), p_fine.objCols());
+
+                    VecUtils::load(l_z_Vec, p_z + l_pos + VecType::size(), l_n_hi);
+                    VecUtils::store(l_z_Vec + VecUtils::duplicateHigh(l_x_Vec), p_z + l_pos + VecType::size(), l_n_hi);
+                }
+            }
+        }
+    }
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+void CMultigrid<ValueType, VecType, AccumulatorType>::apply(const ILinearOperator<ValueType> & p_A, const ValueType * __restrict__ p_r, ValueType * __restrict__ p_z) const
+{
+    ValueType * l_t_fine = m_workspace.vector(0);
+    ValueType * l_dinv_fine = m_workspace.vector(1);
+
+    //
+    // NOTE down: smooth, restrict the residual; coarsest: smooth; up:
+    //      prolongate, smooth
+    //
+    for (std::size_t l = 0; l + 1 < m_levels; ++l)
+    {
+        const ILinearOperator<ValueType> & l_A = l == 0 ? p_A : *m_A[l];
+        const ValueType * l_r = l == 0 ? p_r : m_b[l]->data();
+        ValueType * l_z = l == 0 ? p_z : m_x[l]->data();
+        ValueType * l_t = l == 0 ? l_t_fine : m_t[l]->data();
+
+        smooth(l_A, layout(l).objSize3d(), l == 0 ? l_dinv_fine : m_dinv[l]->data(), l_r, l_t, l_z, m_sweeps, true);
+
+        l_A.apply(l_z, l_t);
+        #pragma omp barrier
+
+        restrictResidual(layout(l), layout(l+1), l_r, l_t, m_b[l+1]->data());
+    }
+
+    std::size_t l_coarsest = m_levels - 1;
+
+    smooth(
+        l_coarsest == 0 ? p_A : *m_A[l_coarsest],
+        layout(l_coarsest).objSize3d(),
+        l_coarsest == 0 ? l_dinv_fine : m_dinv[l_coarsest]->data(),
+        l_coarsest == 0 ? p_r : m_b[l_coarsest]->data(),
+        l_coarsest == 0 ? l_t_fine : m_t[l_coarsest]->data(),
+        l_coarsest == 0 ? p_z : m_x[l_coarsest]->data(),
+        m_sweepsCoarsest,
+        true
+    );
+
+    for (std::size_t l = m_levels - 1; l-- > 0;)
+    {
+        const ILinearOperator<ValueType> & l_A = l == 0 ? p_A : *m_A[l];
+        const ValueType * l_r = l == 0 ? p_r : m_b[l]->data();
+        ValueType * l_z = l == 0 ? p_z : m_x[l]->data();
+        ValueType * l_t = l == 0 ? l_t_fine : m_t[l]->data();
+
+        prolongate(layout(l+1), layout(l), m_x[l+1]->data(), l_z);
+
+        smooth(l_A, layout(l).objSize3d(), l == 0 ? l_dinv_fine : m_dinv[l]->data(), l_r, l_t, l_z, m_sweeps, false);
+    }
+}
+
+template <typename ValueType, typename VecType, typename AccumulatorType>
+std::size_t CMultigrid<ValueType, VecType, AccumulatorType>::operator()(
+    const std::size_t p_size,
+    const ILinearOperator<ValueType> & p_A,
+    const ValueType * __restrict__ p_x_0,
+    const ValueType * __restrict__ p_b,
+    ValueType * __restrict__ p_x_1,
+    const ValueType p_epsilon,
+    const std::size_t p_iterMax,
+    const std::size_t p_bufferSize
+) const
+{
+    std::size_t l_iter;
+    AccumulatorType l_alpha = 0.;
+    AccumulatorType l_rho = 0.;
+    AccumulatorType l_lambda = 0.;
+
+    reserve(p_size, p_bufferSize);
+    m_workspaceSolver.reserve(p_size, p_bufferSize);
+
+    ValueType * l_r = m_workspaceSolver.vector(0);
+    ValueType * l_z = m_workspaceSolver.vector(1);
+    ValueType * l_upsilon = m_workspaceSolver.vector(2);
+
+    #pragma omp parallel
+    {
+        std::size_t l_iter_t = 0;
+        AccumulatorType l_alpha_t;
+        ValueType l_omega_t;
+
+        setup(p_A);
+
+        p_A.apply(p_x_0,l_r);
+        #pragma omp barrier
+        // --------------------------------------------------------------------
+
+        #pragma omp for reduction(+: l_alpha)
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            p_x_1[i] = p_x_0[i];
+            l_r[i] = p_b[i] - l_r[i];
+            l_alpha += AccumulatorType(l_r[i]) * l_r[i];
+        }
+        // --------------------------------------------------------------------
+        l_alpha_t = l_alpha;
+
+        while(l_iter_t < p_iterMax)
+        {
+            if(l_alpha_t < p_epsilon)
+            {
+                break;
+            }
+
+            apply(p_A, l_r, l_z);
+
+            p_A.apply(l_z,l_upsilon);
+            #pragma omp barrier
+            // --------------------------------------------------------------------
+
+            //
+            // NOTE all threads have read l_alpha before the barriers of the
+            //      cycle
+            //
+            #pragma omp master
+            {
+                l_alpha = 0.;
+            }
+
+            #pragma omp for reduction(+: l_rho, l_lambda)
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                l_rho += AccumulatorType(l_r[i]) * l_z[i];
+                l_lambda += AccumulatorType(l_upsilon[i]) * l_z[i];
+            }
+            // --------------------------------------------------------------------
+            l_omega_t = ValueType(l_rho / l_lambda);
+
+            #pragma omp for reduction(+: l_alpha)
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                p_x_1[i] = p_x_1[i] + l_omega_t * l_z[i];
+                l_r[i] = l_r[i] - l_omega_t * l_upsilon[i];
+                l_alpha += AccumulatorType(l_r[i]) * l_r[i];
+            }
+            // --------------------------------------------------------------------
+            l_alpha_t = l_alpha;
+
+            //
+            // NOTE all threads have read l_rho and l_lambda before the
+            //      barrier of the update
+            //
+            #pragma omp master
+            {
+                l_rho = 0.;
+                l_lambda = 0.;
+            }
+
+            l_iter_t++;
+        }
+
+        #pragma omp master
+        {
+            l_iter = l_iter_t;
+        }
+    }
+
+    return(l_iter);
+}
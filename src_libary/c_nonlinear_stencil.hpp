@@ -1,14 +1,40 @@
+/*
+ * SplitRegions = true: interior, faces, edges and corners are computed by
+ * separate kernels, see CLinearStencilNonconstCoeff. The state function is
+ * only evaluated for neighbours inside the grid.
+ *
+ * FaceCentric = true: every face coefficient is computed once (3 instead of
+ * 6 divisions per cell), see CLinearStencilNonconstCoeff. The faces are
+ * computed from g = f(s) of the current and the next level, kept in row
+ * band buffers rolled over the levels as in
+ * CNonlinearStencilPrecalc::setState, so the state function is evaluated
+ * about once per cell as well. The g and face buffers are kept by the
+ * operator, it can not be copied.
+ *
+ * RowBlock > 1: unroll-and-jam over rows in the SplitRegions = false kernel,
+ * RowBlock rows are computed per column vector and share x and f(s) of the
+ * rows in between: f is evaluated RowBlock+2 + 4*RowBlock instead of
+ * 7*RowBlock times. Remaining rows of a level are computed one by one.
+ * Results are bit-identical. Not combined with SplitRegions and
+ * FaceCentric, see CLinearStencilNonconstCoeff.
+ *
+ */
 
 #pragma once
 
 #include <string>
 #include <omp.h>
 #include "i_nonlinear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions = false, bool FaceCentric = false, std::size_t RowBlock = 1>
 class CNonlinearStencil : public INonlinearOperator<ValueType>
 {
  private:
+    using VecUtils = CVecUtils<ValueType, VecType>;
+
     std::size_t m_objCols;
     std::size_t m_objRows;
     std::size_t m_objLevels;
@@ -18,6 +44,33 @@ class CNonlinearStencil : public INonlinearOperator<ValueType>
     const ValueType * m_s;
     const ValueType m_factor;
     const ValueType m_epsilon;
+    std::size_t m_bandRows;
+    std::size_t m_sizeBand;
+    std::size_t m_sizeScratch;
+    mutable ValueType * m_scratch;
+    mutable std::size_t m_scratchCapacity;
+    mutable std::size_t m_scratchThreads;
+
+    //
+    // NOTE rows of a band of applyFaceCentric
+    //
+    inline static constexpr std::size_t BAND_ROWS = 32;
+
+    void applyMasked(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    template <std::size_t Rows>
+    void applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const;
+    void applySplit(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    template <bool HasLL, bool HasLU>
+    void applyLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L) const;
+    template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+    void applyRow(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const;
+    template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+    void applyVec(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos, const std::size_t p_pos_C) const;
+    void reserveScratch(const std::size_t p_threads) const;
+    void transformBand(const ValueType * __restrict__ p_s, ValueType * __restrict__ p_g, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const;
+    void applyFaceCentric(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    void facesLL(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, ValueType * __restrict__ p_f_LL, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const;
+    void applyFaceCentricLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const ValueType * __restrict__ p_f_LL, ValueType * __restrict__ p_f_LU, ValueType * __restrict__ p_f_R, ValueType * __restrict__ p_f_C, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const;
 
  public:
     CNonlinearStencil(
@@ -29,14 +82,31 @@ class CNonlinearStencil : public INonlinearOperator<ValueType>
       const ValueType p_tau = ValueType(1.0),
       const ValueType p_epsilon = ValueType(1e-15)
       );
-      inline static const std::string IDENTIFER = "nonlinear_stencil";
+    CNonlinearStencil(
+      const CGridLayout & p_layout,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    CNonlinearStencil(const CNonlinearStencil &) = delete;
+    CNonlinearStencil & operator=(const CNonlinearStencil &) = delete;
+      static_assert(!(SplitRegions && FaceCentric), "SplitRegions and FaceCentric are exclusive");
+      static_assert(RowBlock >= 1, "RowBlock has to be >= 1");
+      static_assert(RowBlock == 1 || !(SplitRegions || FaceCentric), "RowBlock is only implemented for the masked kernel");
+      inline static const std::string IDENTIFER =
+         std::string("nonlinear_stencil")
+         + (SplitRegions ? "_split" : "")
+         + (FaceCentric ? "_face_centric" : "")
+         + (RowBlock > 1 ? "_rows_" + std::to_string(RowBlock) : "");
     void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
     void setState(const ValueType * __restrict__ p_s);
+    bool diagonal(ValueType * __restrict__ p_d) const;
     ~CNonlinearStencil();
 };
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-CNonlinearStencil<StateFunc, ValueType, VecType>::CNonlinearStencil(
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::CNonlinearStencil(
    const std::size_t p_objCols,
    const std::size_t p_objRows,
    const std::size_t p_objLevels,
@@ -45,32 +115,126 @@ CNonlinearStencil<StateFunc, ValueType, VecType>::CNonlinearStencil(
    const ValueType p_tau,
    const ValueType p_epsilon
    ):
-m_objCols(p_objCols),
-m_objRows(p_objRows),
-m_objLevels(p_objLevels),
-m_objSize1d(p_objCols),
-m_objSize2d(p_objCols * p_objRows),
-m_objSize3d(p_objCols * p_objRows * p_objLevels),
+CNonlinearStencil(CGridLayout(p_objCols, p_objRows, p_objLevels), p_s, p_h, p_tau, p_epsilon)
+{
+
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::CNonlinearStencil(
+   const CGridLayout & p_layout,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_objSize1d(p_layout.objSize1d()),
+m_objSize2d(p_layout.objSize2d()),
+m_objSize3d(p_layout.objSize3d()),
 m_s(p_s),
 m_factor(p_tau/(p_h*p_h)),
-m_epsilon(p_epsilon)
+m_epsilon(p_epsilon),
+m_bandRows(0),
+m_sizeBand(0),
+m_sizeScratch(0),
+m_scratch(nullptr),
+m_scratchCapacity(0),
+m_scratchThreads(0)
 {
+   if constexpr (FaceCentric)
+   {
+      //
+      // NOTE per thread: g of three levels of a band plus one halo row on
+      //      both sides, the LL/LU faces of a band, RL/RU faces of a row
+      //      and CU faces of a row, the latter padded so that the CL face
+      //      of the first col is 0
+      //
+      m_bandRows = m_objRows < BAND_ROWS ? m_objRows : BAND_ROWS;
+      m_sizeBand = (m_bandRows+2) * m_objSize1d;
+      m_sizeScratch = 3*m_sizeBand + 2*m_bandRows*m_objSize1d + 3*(m_objSize1d + 2*VecType::size());
 
+      #pragma omp parallel
+      {
+         reserveScratch(omp_get_num_threads());
+      }
+   }
 }
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-void CNonlinearStencil<StateFunc, ValueType, VecType>::setState(const ValueType * __restrict__ p_s)
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::reserveScratch(const std::size_t p_threads) const
+{
+   //
+   // NOTE called by all threads of a team, the scratch of thread t is
+   //      touched by thread t (static schedule, one slice per iteration)
+   //      and only zeroed here, the pads are never written
+   //
+   #pragma omp single
+   {
+      CAllocator::reserve(m_scratch, m_scratchCapacity, p_threads*m_sizeScratch);
+      m_scratchThreads = p_threads;
+   }
+
+   CAllocator::firstTouch(m_scratch, p_threads*m_sizeScratch, m_sizeScratch);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::setState(const ValueType * __restrict__ p_s)
 {
    m_s = p_s;
 }
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-void CNonlinearStencil<StateFunc, ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   if constexpr (FaceCentric)
+   {
+      applyFaceCentric(p_x, p_y);
+   }
+   else if constexpr (SplitRegions)
+   {
+      applySplit(p_x, p_y);
+   }
+   else
+   {
+      applyMasked(p_x, p_y);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyMasked(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   std::size_t l_pos_R;
+
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (l_pos_R=0; l_pos_R+RowBlock<=m_objRows; l_pos_R+=RowBlock)
+      {
+         applyRows<RowBlock>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+      for (; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         applyRows<1>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <std::size_t Rows>
+inline void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const
 {
    std::size_t l_pos;
+   std::size_t l_pos_0;
+   std::size_t l_pos_R;
+   std::size_t l_n;
 
    VecType l_pos_C_Vec;
 
+   VecType l_lane_Vec = VecUtils::lanes();
+
    VecType l_factor_LL_Vec;
    VecType l_factor_RL_Vec;
    VecType l_factor_CL_Vec;
@@ -78,6 +242,463 @@ void CNonlinearStencil<StateFunc, ValueType, VecType>::apply(const ValueType * _
    VecType l_factor_RU_Vec;
    VecType l_factor_LU_Vec;
 
+   VecType l_mask_CL_Vec;
+   VecType l_mask_CU_Vec;
+
+   //
+   // NOTE x and s of the rows p_pos_R-1, ..., p_pos_R+Rows
+   //
+   VecType l_x_R_Vec[Rows+2];
+   VecType l_c_R_Vec[Rows+2];
+
+   VecType l_x_LL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_LU_Vec;
+
+   for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+   {
+      l_pos_0 = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + l_pos_C;
+      l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+      l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+      l_mask_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_mask_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+      for (std::size_t k=0; k<Rows+2; ++k)
+      {
+         VecUtils::load(l_x_R_Vec[k], p_x + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+         VecUtils::load(l_c_R_Vec[k], m_s + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+      }
+
+      for (std::size_t k=0; k<Rows+2; ++k)
+      {
+         StateFunc<VecType>::apply(l_c_R_Vec[k]);
+      }
+
+      for (std::size_t b=0; b<Rows; ++b)
+      {
+         l_pos = l_pos_0 + b * m_objSize1d;
+         l_pos_R = p_pos_R + b;
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         VecUtils::load(l_c_LL_Vec, m_s + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_c_CL_Vec, m_s + l_pos - 1          , l_n);
+         VecUtils::load(l_c_CU_Vec, m_s + l_pos + 1          , l_n);
+         VecUtils::load(l_c_LU_Vec, m_s + l_pos + m_objSize2d, l_n);
+
+         StateFunc<VecType>::apply(l_c_LL_Vec);
+         StateFunc<VecType>::apply(l_c_CL_Vec);
+         StateFunc<VecType>::apply(l_c_CU_Vec);
+         StateFunc<VecType>::apply(l_c_LU_Vec);
+
+         l_factor_CL_Vec = l_mask_CL_Vec;
+         l_factor_CU_Vec = l_mask_CU_Vec;
+
+         l_factor_LL_Vec = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_R_Vec[b+1] * l_c_LL_Vec     / (l_c_R_Vec[b+1]+l_c_LL_Vec    +m_epsilon);
+         l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_R_Vec[b+1] * l_c_R_Vec[b]   / (l_c_R_Vec[b+1]+l_c_R_Vec[b]  +m_epsilon);
+         l_factor_CL_Vec *=                                                           2 * l_c_R_Vec[b+1] * l_c_CL_Vec     / (l_c_R_Vec[b+1]+l_c_CL_Vec    +m_epsilon);
+         l_factor_CU_Vec *=                                                           2 * l_c_R_Vec[b+1] * l_c_CU_Vec     / (l_c_R_Vec[b+1]+l_c_CU_Vec    +m_epsilon);
+         l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_R_Vec[b+1] * l_c_R_Vec[b+2] / (l_c_R_Vec[b+1]+l_c_R_Vec[b+2]+m_epsilon);
+         l_factor_LU_Vec = (1-(p_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_R_Vec[b+1] * l_c_LU_Vec     / (l_c_R_Vec[b+1]+l_c_LU_Vec    +m_epsilon);
+
+         l_y_Vec =
+                  ( 1                +
+                     l_factor_LL_Vec +
+                     l_factor_RL_Vec +
+                     l_factor_CL_Vec +
+                     l_factor_CU_Vec +
+                     l_factor_RU_Vec +
+                     l_factor_LU_Vec
+                  )                  * l_x_R_Vec[b+1]
+               - l_factor_LL_Vec     * l_x_LL_Vec
+               - l_factor_RL_Vec     * l_x_R_Vec[b]
+               - l_factor_CL_Vec     * l_x_CL_Vec
+               - l_factor_CU_Vec     * l_x_CU_Vec
+               - l_factor_RU_Vec     * l_x_R_Vec[b+2]
+               - l_factor_LU_Vec     * l_x_LU_Vec;
+         VecUtils::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applySplit(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      if (l_pos_L == 0)
+      {
+         applyLevel<false, true>(p_x, p_y, l_pos_L);
+      }
+      else if (l_pos_L == m_objLevels-1)
+      {
+         applyLevel<true, false>(p_x, p_y, l_pos_L);
+      }
+      else
+      {
+         applyLevel<true, true>(p_x, p_y, l_pos_L);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <bool HasLL, bool HasLU>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L) const
+{
+   applyRow<HasLL, false, true, HasLU>(p_x, p_y, p_pos_L, 0);
+   for (std::size_t l_pos_R=1; l_pos_R<m_objRows-1; ++l_pos_R)
+   {
+      applyRow<HasLL, true, true, HasLU>(p_x, p_y, p_pos_L, l_pos_R);
+   }
+   applyRow<HasLL, true, false, HasLU>(p_x, p_y, p_pos_L, m_objRows-1);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyRow(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const
+{
+   std::size_t l_pos_row = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d;
+
+   //
+   // NOTE only the first and the last vector of a row touch the column
+   //      boundary, the last one may also be partial
+   //
+   std::size_t l_pos_C_last = ((m_objCols-1)/VecType::size())*VecType::size();
+
+   applyVec<HasLL, HasRL, HasRU, HasLU, true>(p_x, p_y, l_pos_row, 0);
+   for (std::size_t l_pos_C=VecType::size(); l_pos_C<l_pos_C_last; l_pos_C+=VecType::size())
+   {
+      applyVec<HasLL, HasRL, HasRU, HasLU, false>(p_x, p_y, l_pos_row + l_pos_C, l_pos_C);
+   }
+   if (l_pos_C_last > 0)
+   {
+      applyVec<HasLL, HasRL, HasRU, HasLU, true>(p_x, p_y, l_pos_row + l_pos_C_last, l_pos_C_last);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+inline void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyVec(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos, const std::size_t p_pos_C) const
+{
+   //
+   // NOTE the factors are evaluated in the same order as in applyMasked,
+   //      a missing neighbour contributes an exact 0 there as well
+   //
+   std::size_t l_n = ColBoundary ? VecUtils::lanesValid(p_pos_C, m_objCols) : VecType::size();
+
+   VecType l_factor_LL_Vec(0);
+   VecType l_factor_RL_Vec(0);
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec(0);
+   VecType l_factor_LU_Vec(0);
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_RL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_RU_Vec;
+   VecType l_c_LU_Vec;
+
+   VecUtils::load(l_x_LL_Vec, p_x + p_pos - m_objSize2d, l_n);
+   VecUtils::load(l_x_RL_Vec, p_x + p_pos - m_objSize1d, l_n);
+   VecUtils::load(l_x_CL_Vec, p_x + p_pos - 1          , l_n);
+   VecUtils::load(l_x_Vec,    p_x + p_pos              , l_n);
+   VecUtils::load(l_x_CU_Vec, p_x + p_pos + 1          , l_n);
+   VecUtils::load(l_x_RU_Vec, p_x + p_pos + m_objSize1d, l_n);
+   VecUtils::load(l_x_LU_Vec, p_x + p_pos + m_objSize2d, l_n);
+
+   VecUtils::load(l_c_CL_Vec, m_s + p_pos - 1          , l_n);
+   VecUtils::load(l_c_Vec,    m_s + p_pos              , l_n);
+   VecUtils::load(l_c_CU_Vec, m_s + p_pos + 1          , l_n);
+   StateFunc<VecType>::apply(l_c_CL_Vec);
+   StateFunc<VecType>::apply(l_c_Vec);
+   StateFunc<VecType>::apply(l_c_CU_Vec);
+
+   if constexpr (ColBoundary)
+   {
+      VecType l_pos_C_Vec = VecUtils::lanes() + ValueType(p_pos_C);
+
+      l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+   }
+   else
+   {
+      l_factor_CL_Vec = VecType(m_factor);
+      l_factor_CU_Vec = VecType(m_factor);
+   }
+
+   if constexpr (HasLL)
+   {
+      VecUtils::load(l_c_LL_Vec, m_s + p_pos - m_objSize2d, l_n);
+      StateFunc<VecType>::apply(l_c_LL_Vec);
+      l_factor_LL_Vec = m_factor * 2 * l_c_Vec * l_c_LL_Vec / (l_c_Vec+l_c_LL_Vec+m_epsilon);
+   }
+   if constexpr (HasRL)
+   {
+      VecUtils::load(l_c_RL_Vec, m_s + p_pos - m_objSize1d, l_n);
+      StateFunc<VecType>::apply(l_c_RL_Vec);
+      l_factor_RL_Vec = m_factor * 2 * l_c_Vec * l_c_RL_Vec / (l_c_Vec+l_c_RL_Vec+m_epsilon);
+   }
+   l_factor_CL_Vec *=              2 * l_c_Vec * l_c_CL_Vec / (l_c_Vec+l_c_CL_Vec+m_epsilon);
+   l_factor_CU_Vec *=              2 * l_c_Vec * l_c_CU_Vec / (l_c_Vec+l_c_CU_Vec+m_epsilon);
+   if constexpr (HasRU)
+   {
+      VecUtils::load(l_c_RU_Vec, m_s + p_pos + m_objSize1d, l_n);
+      StateFunc<VecType>::apply(l_c_RU_Vec);
+      l_factor_RU_Vec = m_factor * 2 * l_c_Vec * l_c_RU_Vec / (l_c_Vec+l_c_RU_Vec+m_epsilon);
+   }
+   if constexpr (HasLU)
+   {
+      VecUtils::load(l_c_LU_Vec, m_s + p_pos + m_objSize2d, l_n);
+      StateFunc<VecType>::apply(l_c_LU_Vec);
+      l_factor_LU_Vec = m_factor * 2 * l_c_Vec * l_c_LU_Vec / (l_c_Vec+l_c_LU_Vec+m_epsilon);
+   }
+
+   l_y_Vec =
+            ( 1                +
+               l_factor_LL_Vec +
+               l_factor_RL_Vec +
+               l_factor_CL_Vec +
+               l_factor_CU_Vec +
+               l_factor_RU_Vec +
+               l_factor_LU_Vec
+            )                  * l_x_Vec
+         - l_factor_LL_Vec     * l_x_LL_Vec
+         - l_factor_RL_Vec     * l_x_RL_Vec
+         - l_factor_CL_Vec     * l_x_CL_Vec
+         - l_factor_CU_Vec     * l_x_CU_Vec
+         - l_factor_RU_Vec     * l_x_RU_Vec
+         - l_factor_LU_Vec     * l_x_LU_Vec;
+   VecUtils::store(l_y_Vec, p_y + p_pos, l_n);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::transformBand(const ValueType * __restrict__ p_s, ValueType * __restrict__ p_g, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const
+{
+   //
+   // NOTE p_g is the band buffer, its first row is the halo row p_rowBegin-1,
+   //      halo rows outside of the grid are 0
+   //
+   std::size_t l_row_first = p_rowBegin > 0 ? p_rowBegin-1 : 0;
+   std::size_t l_row_last = p_rowEnd < m_objRows ? p_rowEnd+1 : m_objRows;
+   std::size_t l_size = (l_row_last-l_row_first) * m_objSize1d;
+   const ValueType * l_s = p_s + p_pos_L * m_objSize2d + l_row_first * m_objSize1d;
+   ValueType * l_g = p_g + (l_row_first+1-p_rowBegin) * m_objSize1d;
+   std::size_t l_n;
+
+   VecType l_s_Vec;
+
+   if (p_rowBegin == 0)
+   {
+      for (std::size_t i = 0; i < m_objSize1d; ++i)
+      {
+         p_g[i] = ValueType(0);
+      }
+   }
+   if (p_rowEnd == m_objRows)
+   {
+      for (std::size_t i = 0; i < m_objSize1d; ++i)
+      {
+         p_g[(p_rowEnd+1-p_rowBegin) * m_objSize1d + i] = ValueType(0);
+      }
+   }
+
+   for (std::size_t l_pos=0; l_pos<l_size; l_pos+=VecType::size())
+   {
+      l_n = VecUtils::lanesValid(l_pos, l_size);
+
+      VecUtils::load(l_s_Vec, l_s + l_pos, l_n);
+      StateFunc<VecType>::apply(l_s_Vec);
+      VecUtils::store(l_s_Vec, l_g + l_pos, l_n);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyFaceCentric(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   //
+   // NOTE every thread reads m_scratchThreads before one of them can grow
+   //      the scratch behind the barrier (all threads take the same branch)
+   //
+   std::size_t l_threads = omp_get_num_threads();
+
+   if (l_threads > m_scratchThreads)
+   {
+      #pragma omp barrier
+      reserveScratch(l_threads);
+   }
+
+   //
+   // NOTE every thread walks its contiguous chunk of levels (static level
+   //      distribution) band by band, g = f(s) of the levels l_pos_L-1,
+   //      l_pos_L and l_pos_L+1 and the LL/LU faces of the band are rolled
+   //      along the levels and stay in cache. g of a band has one halo row
+   //      on both sides (RL faces of the first row, zero weighted upper
+   //      neighbours of the last row)
+   //
+   std::size_t l_sizeRow = m_objSize1d + 2*VecType::size();
+
+   ValueType * l_scratch = m_scratch + omp_get_thread_num() * m_sizeScratch;
+   ValueType * l_g_LL;
+   ValueType * l_g;
+   ValueType * l_g_LU;
+   ValueType * l_g_tmp;
+   ValueType * l_f_LL;
+   ValueType * l_f_LU;
+   ValueType * l_f_R  = l_scratch + 3*m_sizeBand + 2*m_bandRows*m_objSize1d;
+   ValueType * l_f_C  = l_f_R + 2*l_sizeRow + VecType::size();
+   ValueType * l_f_tmp;
+
+   std::size_t l_pos_L_begin = m_objLevels;
+   std::size_t l_pos_L_end = m_objLevels;
+
+   #pragma omp for schedule(static) nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      if (l_pos_L_begin == m_objLevels)
+      {
+         l_pos_L_begin = l_pos_L;
+      }
+      l_pos_L_end = l_pos_L+1;
+   }
+
+   for (std::size_t l_rowBegin=0; l_pos_L_begin<l_pos_L_end && l_rowBegin<m_objRows; l_rowBegin+=m_bandRows)
+   {
+      std::size_t l_rowEnd = l_rowBegin+m_bandRows < m_objRows ? l_rowBegin+m_bandRows : m_objRows;
+
+      l_g_LL = l_scratch;
+      l_g    = l_scratch + m_sizeBand;
+      l_g_LU = l_scratch + 2*m_sizeBand;
+      l_f_LL = l_scratch + 3*m_sizeBand;
+      l_f_LU = l_scratch + 3*m_sizeBand + m_bandRows*m_objSize1d;
+
+      for (std::size_t l_pos_L=l_pos_L_begin; l_pos_L<l_pos_L_end; ++l_pos_L)
+      {
+         if (l_pos_L > l_pos_L_begin)
+         {
+            l_g_tmp = l_g_LL;
+            l_g_LL  = l_g;
+            l_g     = l_g_LU;
+            l_g_LU  = l_g_tmp;
+
+            l_f_tmp = l_f_LL;
+            l_f_LL  = l_f_LU;
+            l_f_LU  = l_f_tmp;
+         }
+         else
+         {
+            if (l_pos_L > 0)
+            {
+               transformBand(m_s, l_g_LL, l_pos_L-1, l_rowBegin, l_rowEnd);
+            }
+            else
+            {
+               //
+               // NOTE no level below the first one
+               //
+               for (std::size_t i = 0; i < m_sizeBand; ++i)
+               {
+                  l_g_LL[i] = ValueType(0);
+               }
+            }
+            transformBand(m_s, l_g, l_pos_L, l_rowBegin, l_rowEnd);
+            facesLL(l_g_LL + m_objSize1d, l_g + m_objSize1d, l_f_LL, l_pos_L, l_rowBegin, l_rowEnd);
+         }
+         if (l_pos_L < m_objLevels-1)
+         {
+            transformBand(m_s, l_g_LU, l_pos_L+1, l_rowBegin, l_rowEnd);
+         }
+
+         applyFaceCentricLevel(p_x, p_y, l_g + m_objSize1d, l_g_LU + m_objSize1d, l_f_LL, l_f_LU, l_f_R, l_f_C, l_pos_L, l_rowBegin, l_rowEnd);
+      }
+   }
+
+   #pragma omp barrier
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::facesLL(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, ValueType * __restrict__ p_f_LL, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const
+{
+   //
+   // NOTE p_g_LL, p_g and p_f_LL start at the row p_rowBegin
+   //
+   std::size_t l_size = (p_rowEnd-p_rowBegin) * m_objSize1d;
+   std::size_t l_n;
+
+   VecType l_g_LL_Vec;
+   VecType l_g_Vec;
+   VecType l_f_LL_Vec;
+
+   for (std::size_t l_pos_2d=0; l_pos_2d<l_size; l_pos_2d+=VecType::size())
+   {
+      l_n = VecUtils::lanesValid(l_pos_2d, l_size);
+
+      VecUtils::load(l_g_LL_Vec, p_g_LL + l_pos_2d, l_n);
+      VecUtils::load(l_g_Vec,    p_g    + l_pos_2d, l_n);
+
+      l_f_LL_Vec = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LL_Vec / (l_g_Vec+l_g_LL_Vec+m_epsilon);
+
+      VecUtils::store(l_f_LL_Vec, p_f_LL + l_pos_2d, l_n);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+void CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::applyFaceCentricLevel(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const ValueType * __restrict__ p_f_LL, ValueType * __restrict__ p_f_LU, ValueType * __restrict__ p_f_R, ValueType * __restrict__ p_f_C, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const
+{
+   //
+   // NOTE p_g, p_g_LU, p_f_LL and p_f_LU start at the row p_rowBegin
+   //
+   std::size_t l_pos;
+   std::size_t l_pos_2d;
+   std::size_t l_n;
+
+   ValueType * l_f_RL = p_f_R + VecType::size();
+   ValueType * l_f_RU = p_f_R + m_objSize1d + 3*VecType::size();
+   ValueType * l_f_tmp;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_g_RL_Vec;
+   VecType l_g_Vec;
+   VecType l_g_CU_Vec;
+   VecType l_g_RU_Vec;
+   VecType l_g_LU_Vec;
+
+   VecType l_f_LL_Vec;
+   VecType l_f_RL_Vec;
+   VecType l_f_CL_Vec;
+   VecType l_f_CU_Vec;
+   VecType l_f_RU_Vec;
+   VecType l_f_LU_Vec;
+
    VecType l_x_LL_Vec;
    VecType l_x_RL_Vec;
    VecType l_x_CL_Vec;
@@ -88,6 +709,132 @@ void CNonlinearStencil<StateFunc, ValueType, VecType>::apply(const ValueType * _
 
    VecType l_y_Vec;
 
+   if (p_rowBegin == 0)
+   {
+      //
+      // NOTE no RL faces in the first row
+      //
+      for (std::size_t i = 0; i < m_objSize1d; ++i)
+      {
+         l_f_RL[i] = ValueType(0);
+      }
+   }
+   else
+   {
+      //
+      // NOTE RL faces of the first row of a band are the RU faces of the
+      //      row above (same operand order)
+      //
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         VecUtils::load(l_g_RL_Vec, p_g + l_pos_C - m_objSize1d, l_n);
+         VecUtils::load(l_g_Vec,    p_g + l_pos_C              , l_n);
+
+         l_f_RL_Vec = (1-((p_rowBegin-1)/(m_objRows-1))) * m_factor * 2 * l_g_RL_Vec * l_g_Vec / (l_g_RL_Vec+l_g_Vec+m_epsilon);
+
+         VecUtils::store(l_f_RL_Vec, l_f_RL + l_pos_C, l_n);
+      }
+   }
+
+   for (std::size_t l_pos_R=p_rowBegin; l_pos_R<p_rowEnd; ++l_pos_R)
+   {
+      //
+      // NOTE upper faces of the row
+      //
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_pos_2d = (l_pos_R-p_rowBegin) * m_objSize1d + l_pos_C;
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+         VecUtils::load(l_g_Vec,    p_g    + l_pos_2d              , l_n);
+         VecUtils::load(l_g_CU_Vec, p_g    + l_pos_2d + 1          , l_n);
+         VecUtils::load(l_g_RU_Vec, p_g    + l_pos_2d + m_objSize1d, l_n);
+         VecUtils::load(l_g_LU_Vec, p_g_LU + l_pos_2d              , l_n);
+
+         l_f_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+         l_f_CU_Vec *=                                                      2 * l_g_Vec * l_g_CU_Vec / (l_g_Vec+l_g_CU_Vec+m_epsilon);
+         l_f_RU_Vec = (1-(l_pos_R/(m_objRows-1)))   * m_factor * 2 * l_g_Vec * l_g_RU_Vec / (l_g_Vec+l_g_RU_Vec+m_epsilon);
+         l_f_LU_Vec = (1-(p_pos_L/(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LU_Vec / (l_g_Vec+l_g_LU_Vec+m_epsilon);
+
+         VecUtils::store(l_f_CU_Vec, p_f_C  + l_pos_C , l_n);
+         VecUtils::store(l_f_RU_Vec, l_f_RU + l_pos_C , l_n);
+         VecUtils::store(l_f_LU_Vec, p_f_LU + l_pos_2d, l_n);
+      }
+
+      //
+      // NOTE lower faces are the upper faces of the previous col, row, level
+      //
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_pos_2d = (l_pos_R-p_rowBegin) * m_objSize1d + l_pos_C;
+         l_pos = p_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_RL_Vec, p_x + l_pos - m_objSize1d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_Vec,    p_x + l_pos              , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_RU_Vec, p_x + l_pos + m_objSize1d, l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         VecUtils::load(l_f_LL_Vec, p_f_LL + l_pos_2d   , l_n);
+         VecUtils::load(l_f_RL_Vec, l_f_RL + l_pos_C    , l_n);
+         VecUtils::load(l_f_CL_Vec, p_f_C  + l_pos_C - 1, l_n);
+         VecUtils::load(l_f_CU_Vec, p_f_C  + l_pos_C    , l_n);
+         VecUtils::load(l_f_RU_Vec, l_f_RU + l_pos_C    , l_n);
+         VecUtils::load(l_f_LU_Vec, p_f_LU + l_pos_2d   , l_n);
+
+         l_y_Vec =
+                  ( 1             +
+                     l_f_LL_Vec   +
+                     l_f_RL_Vec   +
+                     l_f_CL_Vec   +
+                     l_f_CU_Vec   +
+                     l_f_RU_Vec   +
+                     l_f_LU_Vec
+                  )               * l_x_Vec
+               - l_f_LL_Vec       * l_x_LL_Vec
+               - l_f_RL_Vec       * l_x_RL_Vec
+               - l_f_CL_Vec       * l_x_CL_Vec
+               - l_f_CU_Vec       * l_x_CU_Vec
+               - l_f_RU_Vec       * l_x_RU_Vec
+               - l_f_LU_Vec       * l_x_LU_Vec;
+         VecUtils::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+
+      l_f_tmp = l_f_RL;
+      l_f_RL  = l_f_RU;
+      l_f_RU  = l_f_tmp;
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+bool CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::diagonal(ValueType * __restrict__ p_d) const
+{
+   //
+   // NOTE computed on the fly with the factors of applyMasked (for all
+   //      variants), f is evaluated for all seven points as there
+   //
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_factor_LL_Vec;
+   VecType l_factor_RL_Vec;
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec;
+   VecType l_factor_LU_Vec;
+
    VecType l_c_LL_Vec;
    VecType l_c_RL_Vec;
    VecType l_c_CL_Vec;
@@ -96,6 +843,8 @@ void CNonlinearStencil<StateFunc, ValueType, VecType>::apply(const ValueType * _
    VecType l_c_RU_Vec;
    VecType l_c_LU_Vec;
 
+   VecType l_d_Vec;
+
    #pragma omp for
    for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
    {
@@ -104,27 +853,17 @@ void CNonlinearStencil<StateFunc, ValueType, VecType>::apply(const ValueType * _
          for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
          {
             l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
 
-            //
-            // WORKAROUND hardcoded vector size of 4
-            //
-            l_pos_C_Vec = VecType(l_pos_C, l_pos_C+1, l_pos_C+2, l_pos_C+3);
-
-            l_x_LL_Vec.load(p_x + l_pos - m_objSize2d);
-            l_x_RL_Vec.load(p_x + l_pos - m_objSize1d);
-            l_x_CL_Vec.load(p_x + l_pos - 1          );
-            l_x_Vec.load(   p_x + l_pos              );
-            l_x_CU_Vec.load(p_x + l_pos + 1          );
-            l_x_RU_Vec.load(p_x + l_pos + m_objSize1d);
-            l_x_LU_Vec.load(p_x + l_pos + m_objSize2d);
-
-            l_c_LL_Vec.load(m_s + l_pos - m_objSize2d);
-            l_c_RL_Vec.load(m_s + l_pos - m_objSize1d);
-            l_c_CL_Vec.load(m_s + l_pos - 1          );
-            l_c_Vec.load(   m_s + l_pos              );
-            l_c_CU_Vec.load(m_s + l_pos + 1          );
-            l_c_RU_Vec.load(m_s + l_pos + m_objSize1d);
-            l_c_LU_Vec.load(m_s + l_pos + m_objSize2d);
+            VecUtils::load(l_c_LL_Vec, m_s + l_pos - m_objSize2d, l_n);
+            VecUtils::load(l_c_RL_Vec, m_s + l_pos - m_objSize1d, l_n);
+            VecUtils::load(l_c_CL_Vec, m_s + l_pos - 1          , l_n);
+            VecUtils::load(l_c_Vec,    m_s + l_pos              , l_n);
+            VecUtils::load(l_c_CU_Vec, m_s + l_pos + 1          , l_n);
+            VecUtils::load(l_c_RU_Vec, m_s + l_pos + m_objSize1d, l_n);
+            VecUtils::load(l_c_LU_Vec, m_s + l_pos + m_objSize2d, l_n);
 
             StateFunc<VecType>::apply(l_c_LL_Vec);
             StateFunc<VecType>::apply(l_c_RL_Vec);
@@ -134,8 +873,8 @@ void CNonlinearStencil<StateFunc, ValueType, VecType>::apply(const ValueType * _
             StateFunc<VecType>::apply(l_c_RU_Vec);
             StateFunc<VecType>::apply(l_c_LU_Vec);
 
-            l_factor_CL_Vec = select(l_pos_C_Vec>0,           m_factor, 0.0);
-            l_factor_CU_Vec = select(l_pos_C_Vec<m_objCols-1,   m_factor, 0.0);
+            l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
 
             l_factor_LL_Vec = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LL_Vec / (l_c_Vec+l_c_LL_Vec+m_epsilon);
             l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RL_Vec / (l_c_Vec+l_c_RL_Vec+m_epsilon);
@@ -144,29 +883,17 @@ void CNonlinearStencil<StateFunc, ValueType, VecType>::apply(const ValueType * _
             l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RU_Vec / (l_c_Vec+l_c_RU_Vec+m_epsilon);
             l_factor_LU_Vec = (1-(l_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LU_Vec / (l_c_Vec+l_c_LU_Vec+m_epsilon);
 
-            l_y_Vec =
-                     ( 1                +
-                        l_factor_LL_Vec +
-                        l_factor_RL_Vec +
-                        l_factor_CL_Vec +
-                        l_factor_CU_Vec +
-                        l_factor_RU_Vec +
-                        l_factor_LU_Vec
-                     )                  * l_x_Vec
-                  - l_factor_LL_Vec     * l_x_LL_Vec
-                  - l_factor_RL_Vec     * l_x_RL_Vec
-                  - l_factor_CL_Vec     * l_x_CL_Vec
-                  - l_factor_CU_Vec     * l_x_CU_Vec
-                  - l_factor_RU_Vec     * l_x_RU_Vec
-                  - l_factor_LU_Vec     * l_x_LU_Vec;
-            l_y_Vec.store(p_y + l_pos);
+            l_d_Vec = 1 + l_factor_LL_Vec + l_factor_RL_Vec + l_factor_CL_Vec + l_factor_CU_Vec + l_factor_RU_Vec + l_factor_LU_Vec;
+            VecUtils::store(l_d_Vec, p_d + l_pos, l_n);
          }
       }
    }
+
+   return true;
 }
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-CNonlinearStencil<StateFunc, ValueType, VecType>::~CNonlinearStencil()
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, bool FaceCentric, std::size_t RowBlock>
+CNonlinearStencil<StateFunc, ValueType, VecType, SplitRegions, FaceCentric, RowBlock>::~CNonlinearStencil()
 {
-
+   CAllocator::deallocate(m_scratch);
 }
@@ -0,0 +1,463 @@
+/*
+ * 2.5D blocked variant of CNonlinearStencil: f(s) is evaluated once per
+ * cell per apply (plus a halo of one row/column around each tile) and no
+ * coefficient arrays are stored.
+ *
+ * Every thread takes its static chunk of levels (the same chunk as the
+ * first touch loops) and splits the rows/cols plane into tiles of
+ * m_tileRows x m_tileCols. For each tile it streams through its levels and
+ * keeps f(s) of the tile (with halo) for the levels l_pos_L-1, l_pos_L and
+ * l_pos_L+1 in three thread-private plane buffers that are rolled from
+ * level to level. The defaults keep the three planes of f(s) and of x of a
+ * tile within ~512 KiB. The buffers are kept by the operator (it can not be
+ * copied) and only zeroed when they are allocated.
+ *
+ * The result is bit-identical to CNonlinearStencil, only the two planes
+ * below the first level of a chunk and the tile halos are evaluated twice.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <omp.h>
+#include "i_nonlinear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+class CNonlinearStencilBlocked : public INonlinearOperator<ValueType>
+{
+ private:
+    using VecUtils = CVecUtils<ValueType, VecType>;
+
+    std::size_t m_objCols;
+    std::size_t m_objRows;
+    std::size_t m_objLevels;
+    std::size_t m_objSize1d;
+    std::size_t m_objSize2d;
+    std::size_t m_objSize3d;
+    const ValueType * m_s;
+    const ValueType m_factor;
+    const ValueType m_epsilon;
+    std::size_t m_tileRows;
+    std::size_t m_tileCols;
+    std::size_t m_tileSize1d;
+    std::size_t m_tileSize2d;
+    mutable ValueType * m_g_tiles;
+    mutable std::size_t m_g_tilesCapacity;
+    mutable std::size_t m_g_tilesThreads;
+
+    void reserveTiles(const std::size_t p_threads) const;
+    void transformTile(ValueType * __restrict__ p_g, const std::size_t p_pos_L, const std::size_t p_pos_R_begin, const std::size_t p_pos_R_end, const std::size_t p_pos_C_begin, const std::size_t p_pos_C_end) const;
+    void applyTile(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_pos_R_begin, const std::size_t p_pos_R_end, const std::size_t p_pos_C_begin, const std::size_t p_pos_C_end) const;
+
+ public:
+    CNonlinearStencilBlocked(
+      const std::size_t p_objCols,
+      const std::size_t p_objRows,
+      const std::size_t p_objLevels,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15),
+      const std::size_t p_tileRows = 32,
+      const std::size_t p_tileCols = 256
+      );
+    CNonlinearStencilBlocked(
+      const CGridLayout & p_layout,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15),
+      const std::size_t p_tileRows = 32,
+      const std::size_t p_tileCols = 256
+      );
+    CNonlinearStencilBlocked(const CNonlinearStencilBlocked &) = delete;
+    CNonlinearStencilBlocked & operator=(const CNonlinearStencilBlocked &) = delete;
+      inline static const std::string IDENTIFER = "nonlinear_stencil_blocked";
+    void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    void setState(const ValueType * __restrict__ p_s);
+    bool diagonal(ValueType * __restrict__ p_d) const;
+    ~CNonlinearStencilBlocked();
+};
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::CNonlinearStencilBlocked(
+   const std::size_t p_objCols,
+   const std::size_t p_objRows,
+   const std::size_t p_objLevels,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon,
+   const std::size_t p_tileRows,
+   const std::size_t p_tileCols
+   ):
+CNonlinearStencilBlocked(CGridLayout(p_objCols, p_objRows, p_objLevels), p_s, p_h, p_tau, p_epsilon, p_tileRows, p_tileCols)
+{
+
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::CNonlinearStencilBlocked(
+   const CGridLayout & p_layout,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon,
+   const std::size_t p_tileRows,
+   const std::size_t p_tileCols
+   ):
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_objSize1d(p_layout.objSize1d()),
+m_objSize2d(p_layout.objSize2d()),
+m_objSize3d(p_layout.objSize3d()),
+m_s(p_s),
+m_factor(p_tau/(p_h*p_h)),
+m_epsilon(p_epsilon),
+m_g_tiles(nullptr),
+m_g_tilesCapacity(0),
+m_g_tilesThreads(0)
+{
+   //
+   // NOTE tiles start at multiples of the vector width, so that only the
+   //      last vector of a row is partial
+   //
+   m_tileRows = p_tileRows < m_objRows ? p_tileRows : m_objRows;
+   m_tileCols = p_tileCols < m_objCols ? p_tileCols : m_objCols;
+   m_tileCols = ((m_tileCols+VecType::size()-1)/VecType::size())*VecType::size();
+
+   //
+   // NOTE one halo row above and below, one vector left and right of a tile
+   //
+   m_tileSize1d = m_tileCols + 2*VecType::size();
+   m_tileSize2d = (m_tileRows + 2) * m_tileSize1d;
+
+   #pragma omp parallel
+   {
+      reserveTiles(omp_get_num_threads());
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+void CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::reserveTiles(const std::size_t p_threads) const
+{
+   //
+   // NOTE called by all threads of a team, the three tile planes of thread t
+   //      are touched (and zeroed) by thread t (static schedule, one slice
+   //      per iteration)
+   //
+   #pragma omp single
+   {
+      CAllocator::reserve(m_g_tiles, m_g_tilesCapacity, p_threads*3*m_tileSize2d);
+      m_g_tilesThreads = p_threads;
+   }
+
+   CAllocator::firstTouch(m_g_tiles, p_threads*3*m_tileSize2d, 3*m_tileSize2d);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+void CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::setState(const ValueType * __restrict__ p_s)
+{
+   m_s = p_s;
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+void CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   //
+   // NOTE every thread reads m_g_tilesThreads before one of them can grow
+   //      the tile planes behind the barrier (all threads take the same
+   //      branch)
+   //
+   std::size_t l_threads = omp_get_num_threads();
+
+   if (l_threads > m_g_tilesThreads)
+   {
+      #pragma omp barrier
+      reserveTiles(l_threads);
+   }
+
+   //
+   // NOTE schedule(static) hands at most one contiguous chunk of levels to
+   //      every thread, the loop only determines its bounds
+   //
+   std::size_t l_pos_L_begin = m_objLevels;
+   std::size_t l_pos_L_end = m_objLevels;
+
+   #pragma omp for schedule(static) nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      if (l_pos_L_begin == m_objLevels)
+      {
+         l_pos_L_begin = l_pos_L;
+      }
+      l_pos_L_end = l_pos_L+1;
+   }
+
+   if (l_pos_L_begin < l_pos_L_end)
+   {
+      //
+      // NOTE zeroed at allocation, cells outside the grid only enter with a
+      //      zero factor
+      //
+      ValueType * l_g_raw = m_g_tiles + omp_get_thread_num()*3*m_tileSize2d;
+
+      ValueType * l_g_LL;
+      ValueType * l_g;
+      ValueType * l_g_LU;
+      ValueType * l_g_tmp;
+
+      for (std::size_t l_pos_R_begin=0; l_pos_R_begin<m_objRows; l_pos_R_begin+=m_tileRows)
+      {
+         std::size_t l_pos_R_end = l_pos_R_begin+m_tileRows < m_objRows ? l_pos_R_begin+m_tileRows : m_objRows;
+
+         for (std::size_t l_pos_C_begin=0; l_pos_C_begin<m_objCols; l_pos_C_begin+=m_tileCols)
+         {
+            std::size_t l_pos_C_end = l_pos_C_begin+m_tileCols < m_objCols ? l_pos_C_begin+m_tileCols : m_objCols;
+
+            l_g_LL = &(l_g_raw[0]);
+            l_g    = &(l_g_raw[m_tileSize2d]);
+            l_g_LU = &(l_g_raw[2*m_tileSize2d]);
+
+            if (l_pos_L_begin > 0)
+            {
+               transformTile(l_g_LL, l_pos_L_begin-1, l_pos_R_begin, l_pos_R_end, l_pos_C_begin, l_pos_C_end);
+            }
+            transformTile(l_g, l_pos_L_begin, l_pos_R_begin, l_pos_R_end, l_pos_C_begin, l_pos_C_end);
+
+            for (std::size_t l_pos_L=l_pos_L_begin; l_pos_L<l_pos_L_end; ++l_pos_L)
+            {
+               if (l_pos_L < m_objLevels-1)
+               {
+                  transformTile(l_g_LU, l_pos_L+1, l_pos_R_begin, l_pos_R_end, l_pos_C_begin, l_pos_C_end);
+               }
+
+               applyTile(p_x, p_y, l_g_LL, l_g, l_g_LU, l_pos_L, l_pos_R_begin, l_pos_R_end, l_pos_C_begin, l_pos_C_end);
+
+               l_g_tmp = l_g_LL;
+               l_g_LL  = l_g;
+               l_g     = l_g_LU;
+               l_g_LU  = l_g_tmp;
+            }
+         }
+      }
+   }
+
+   //
+   // NOTE same semantics as the implicit barrier of "omp for" in the other
+   //      operators, p_y is complete after apply
+   //
+   #pragma omp barrier
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+void CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::transformTile(ValueType * __restrict__ p_g, const std::size_t p_pos_L, const std::size_t p_pos_R_begin, const std::size_t p_pos_R_end, const std::size_t p_pos_C_begin, const std::size_t p_pos_C_end) const
+{
+   //
+   // NOTE tile plus halo, clipped to the grid
+   //
+   std::size_t l_pos_R_first = p_pos_R_begin > 0 ? p_pos_R_begin-1 : 0;
+   std::size_t l_pos_R_last = p_pos_R_end < m_objRows ? p_pos_R_end+1 : m_objRows;
+   std::size_t l_pos_C_first = p_pos_C_begin > 0 ? p_pos_C_begin-1 : 0;
+   std::size_t l_pos_C_last = p_pos_C_end < m_objCols ? p_pos_C_end+1 : m_objCols;
+   std::size_t l_cols = l_pos_C_last - l_pos_C_first;
+   std::size_t l_n;
+
+   VecType l_s_Vec;
+
+   for (std::size_t l_pos_R=l_pos_R_first; l_pos_R<l_pos_R_last; ++l_pos_R)
+   {
+      const ValueType * l_s = m_s + p_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C_first;
+      ValueType * l_g = p_g + (l_pos_R + 1 - p_pos_R_begin) * m_tileSize1d + VecType::size() + l_pos_C_first - p_pos_C_begin;
+
+      for (std::size_t l_pos_C=0; l_pos_C<l_cols; l_pos_C+=VecType::size())
+      {
+         l_n = VecUtils::lanesValid(l_pos_C, l_cols);
+
+         VecUtils::load(l_s_Vec, l_s + l_pos_C, l_n);
+         StateFunc<VecType>::apply(l_s_Vec);
+         VecUtils::store(l_s_Vec, l_g + l_pos_C, l_n);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+void CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::applyTile(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_pos_R_begin, const std::size_t p_pos_R_end, const std::size_t p_pos_C_begin, const std::size_t p_pos_C_end) const
+{
+   std::size_t l_pos;
+   std::size_t l_pos_tile;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_factor_LL_Vec;
+   VecType l_factor_RL_Vec;
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec;
+   VecType l_factor_LU_Vec;
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_RL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_RU_Vec;
+   VecType l_c_LU_Vec;
+
+   for (std::size_t l_pos_R=p_pos_R_begin; l_pos_R<p_pos_R_end; ++l_pos_R)
+   {
+      for (std::size_t l_pos_C=p_pos_C_begin; l_pos_C<p_pos_C_end; l_pos_C+=VecType::size())
+      {
+         l_pos = p_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+         l_pos_tile = (l_pos_R + 1 - p_pos_R_begin) * m_tileSize1d + VecType::size() + l_pos_C - p_pos_C_begin;
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_RL_Vec, p_x + l_pos - m_objSize1d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_Vec,    p_x + l_pos              , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_RU_Vec, p_x + l_pos + m_objSize1d, l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         VecUtils::load(l_c_LL_Vec, p_g_LL + l_pos_tile               , l_n);
+         VecUtils::load(l_c_RL_Vec, p_g    + l_pos_tile - m_tileSize1d, l_n);
+         VecUtils::load(l_c_CL_Vec, p_g    + l_pos_tile - 1           , l_n);
+         VecUtils::load(l_c_Vec,    p_g    + l_pos_tile               , l_n);
+         VecUtils::load(l_c_CU_Vec, p_g    + l_pos_tile + 1           , l_n);
+         VecUtils::load(l_c_RU_Vec, p_g    + l_pos_tile + m_tileSize1d, l_n);
+         VecUtils::load(l_c_LU_Vec, p_g_LU + l_pos_tile               , l_n);
+
+         l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+         l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+         l_factor_LL_Vec = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LL_Vec / (l_c_Vec+l_c_LL_Vec+m_epsilon);
+         l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RL_Vec / (l_c_Vec+l_c_RL_Vec+m_epsilon);
+         l_factor_CL_Vec *=                                                           2 * l_c_Vec * l_c_CL_Vec / (l_c_Vec+l_c_CL_Vec+m_epsilon);
+         l_factor_CU_Vec *=                                                           2 * l_c_Vec * l_c_CU_Vec / (l_c_Vec+l_c_CU_Vec+m_epsilon);
+         l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RU_Vec / (l_c_Vec+l_c_RU_Vec+m_epsilon);
+         l_factor_LU_Vec = (1-(p_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LU_Vec / (l_c_Vec+l_c_LU_Vec+m_epsilon);
+
+         l_y_Vec =
+                  ( 1                +
+                     l_factor_LL_Vec +
+                     l_factor_RL_Vec +
+                     l_factor_CL_Vec +
+                     l_factor_CU_Vec +
+                     l_factor_RU_Vec +
+                     l_factor_LU_Vec
+                  )                  * l_x_Vec
+               - l_factor_LL_Vec     * l_x_LL_Vec
+               - l_factor_RL_Vec     * l_x_RL_Vec
+               - l_factor_CL_Vec     * l_x_CL_Vec
+               - l_factor_CU_Vec     * l_x_CU_Vec
+               - l_factor_RU_Vec     * l_x_RU_Vec
+               - l_factor_LU_Vec     * l_x_LU_Vec;
+         VecUtils::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+bool CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::diagonal(ValueType * __restrict__ p_d) const
+{
+   //
+   // NOTE computed on the fly with the factors of
+   //      CNonlinearStencil::applyMasked, not tiled (once per solve)
+   //
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_factor_LL_Vec;
+   VecType l_factor_RL_Vec;
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec;
+   VecType l_factor_LU_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_RL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_RU_Vec;
+   VecType l_c_LU_Vec;
+
+   VecType l_d_Vec;
+
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+         {
+            l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+            VecUtils::load(l_c_LL_Vec, m_s + l_pos - m_objSize2d, l_n);
+            VecUtils::load(l_c_RL_Vec, m_s + l_pos - m_objSize1d, l_n);
+            VecUtils::load(l_c_CL_Vec, m_s + l_pos - 1          , l_n);
+            VecUtils::load(l_c_Vec,    m_s + l_pos              , l_n);
+            VecUtils::load(l_c_CU_Vec, m_s + l_pos + 1          , l_n);
+            VecUtils::load(l_c_RU_Vec, m_s + l_pos + m_objSize1d, l_n);
+            VecUtils::load(l_c_LU_Vec, m_s + l_pos + m_objSize2d, l_n);
+
+            StateFunc<VecType>::apply(l_c_LL_Vec);
+            StateFunc<VecType>::apply(l_c_RL_Vec);
+            StateFunc<VecType>::apply(l_c_CL_Vec);
+            StateFunc<VecType>::apply(l_c_Vec);
+            StateFunc<VecType>::apply(l_c_CU_Vec);
+            StateFunc<VecType>::apply(l_c_RU_Vec);
+            StateFunc<VecType>::apply(l_c_LU_Vec);
+
+            l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+            l_factor_LL_Vec = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LL_Vec / (l_c_Vec+l_c_LL_Vec+m_epsilon);
+            l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RL_Vec / (l_c_Vec+l_c_RL_Vec+m_epsilon);
+            l_factor_CL_Vec *=                                                           2 * l_c_Vec * l_c_CL_Vec / (l_c_Vec+l_c_CL_Vec+m_epsilon);
+            l_factor_CU_Vec *=                                                           2 * l_c_Vec * l_c_CU_Vec / (l_c_Vec+l_c_CU_Vec+m_epsilon);
+            l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RU_Vec / (l_c_Vec+l_c_RU_Vec+m_epsilon);
+            l_factor_LU_Vec = (1-(l_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LU_Vec / (l_c_Vec+l_c_LU_Vec+m_epsilon);
+
+            l_d_Vec = 1 + l_factor_LL_Vec + l_factor_RL_Vec + l_factor_CL_Vec + l_factor_CU_Vec + l_factor_RU_Vec + l_factor_LU_Vec;
+            VecUtils::store(l_d_Vec, p_d + l_pos, l_n);
+         }
+      }
+   }
+
+   return true;
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
+CNonlinearStencilBlocked<StateFunc, ValueType, VecType>::~CNonlinearStencilBlocked()
+{
+   CAllocator::deallocate(m_g_tiles);
+}
@@ -1,29 +1,136 @@
+/*
+ * SplitRegions = true: setState computes the coefficients of the interior,
+ * the faces, the edges and the corners by separate kernels, see
+ * CLinearStencilNonconstCoeff. apply does not depend on the boundary.
+ *
+ * StorageType = float (with ValueType = double): the coefficients are
+ * computed in double, stored in float and widened in registers by apply,
+ * see CVecStorage. x and y stay double.
+ *
+ * DiagonalFree = true: m_v is not stored, apply rebuilds the diagonal
+ * 1 + sum of the six face coefficients from the already loaded face vectors.
+ * One stream less in apply and in setState, m_objSize3d values less memory.
+ *
+ * AlignedLoads = true: apply issues aligned loads only (the coefficients
+ * of CAllocator are at least cache line aligned), the -1/+1 column
+ * neighbours of x and the CU coefficients are blended from the current and
+ * the neighbouring vector (CVecUtils::shiftLow/shiftHigh), which are rolled
+ * along the row. Requires m_objCols % VecType::size() == 0 (and padded
+ * pitches that are multiples of it) and p_x, p_y aligned to the vector
+ * width. Results are bit-identical.
+ *
+ * RowBlock > 1: unroll-and-jam over rows, RowBlock rows are computed per
+ * column vector. x of the rows in between and the RL coefficients (the RU
+ * coefficients of row r are the RL coefficients of row r+1) are loaded once
+ * and shared between the jammed rows. Remaining rows of a level are
+ * computed one by one. Not combined with AlignedLoads. Results are
+ * bit-identical.
+ *
+ * MemoryPolicy: streaming stores of y and prefetch of the LL/LU planes of
+ * x in both apply kernels, see CMemoryPolicy.
+ *
+ * Interleaved = true: the coefficients are stored in blocks of
+ * VecType::size() cells (one column vector of a row, rows padded to whole
+ * vectors), a block holds [CU, RU, LU, v] one after the other (without v
+ * if DiagonalFree). apply reads the block of the cell, the RU slot of the
+ * block one row below (= RL), the LU slot of the block one level below
+ * (= LL) and blends CL from the CU vectors of the previous and the current
+ * block: 3 coefficient streams instead of 7. A halo of one level of zero
+ * blocks in front covers the lower neighbours of the first level. Not
+ * combined with AlignedLoads and RowBlock > 1. Results are bit-identical.
+ *
+ * The operator owns its coefficient arrays (and the row band buffers of
+ * setState), it can be moved but not copied. rebind() binds it to another
+ * grid, state and parameters: the arrays are kept if the new grid fits into
+ * them (CAllocator::reserve) and only zeroed again if the layout changed,
+ * a stream of cases of the same (or a smaller) grid does not allocate.
+ *
+ */
 
 #pragma once
 
+#include <cassert>
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <omp.h>
 #include "i_nonlinear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_memory_policy.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
 
-template <template<typename ValueType> typename StateFunc, typename ValueType, typename VecType>
+template <template<typename ValueType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions = false, typename StorageType = ValueType, bool DiagonalFree = false, bool AlignedLoads = false, std::size_t RowBlock = 1, typename MemoryPolicy = CMemoryPolicy<>, bool Interleaved = false>
 class CNonlinearStencilPrecalc : public INonlinearOperator<ValueType>
 {
    private:
+      using VecUtils = CVecUtils<ValueType, VecType>;
+      using StorageUtils = CVecStorage<StorageType, ValueType, VecType>;
+
       std::size_t m_objCols;
       std::size_t m_objRows;
       std::size_t m_objLevels;
       std::size_t m_objSize1d;
       std::size_t m_objSize2d;
       std::size_t m_objSize3d;
-      const ValueType m_factor;
-      const ValueType m_epsilon;
-      ValueType * m_v_LL;
-      ValueType * m_v_RL;
-      ValueType * m_v_CL;
-      ValueType * m_v;
-      ValueType * m_v_CU;
-      ValueType * m_v_RU;
-      ValueType * m_v_LU;
+      ValueType m_factor;
+      ValueType m_epsilon;
+      StorageType * m_v_LL;
+      StorageType * m_v_RL;
+      StorageType * m_v_CL;
+      StorageType * m_v;
+      StorageType * m_v_CU;
+      StorageType * m_v_RU;
+      StorageType * m_v_LU;
+
+      //
+      // NOTE Interleaved layout
+      //
+      std::size_t m_vecsPerRow;
+      std::size_t m_blockSize;
+      std::size_t m_blocksPerLevel;
+      StorageType * m_v_blocks_raw;
+      StorageType * m_v_blocks;
+
+      //
+      // NOTE allocated values of the arrays above and of the plane buffers
+      //
+      std::size_t m_capacity_LL;
+      std::size_t m_capacity_RL;
+      std::size_t m_capacity_CL;
+      std::size_t m_capacity_v;
+      std::size_t m_capacity_blocks;
+      ValueType * m_g_bands;
+      std::size_t m_capacity_g_bands;
+
+      inline static constexpr std::size_t SLOT_CU = 0;
+      inline static constexpr std::size_t SLOT_RU = 1;
+      inline static constexpr std::size_t SLOT_LU = 2;
+      inline static constexpr std::size_t SLOT_V  = 3;
+
+      //
+      // NOTE rows of a band of setState
+      //
+      inline static constexpr std::size_t BAND_ROWS = 32;
+
+      void applyAligned(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+      void applyInterleaved(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+      std::size_t blockOffset(const std::size_t p_pos) const;
+      void storeCoefficients(const std::size_t p_pos, const std::size_t p_n, const VecType & p_v_Vec, const VecType & p_v_CU_Vec, const VecType & p_v_RU_Vec, const VecType & p_v_LU_Vec);
+      template <std::size_t Rows>
+      void applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const;
+      void transformBand(const ValueType * __restrict__ p_s, ValueType * __restrict__ p_g, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const;
+      void setStateMasked(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd);
+      void setStateSplit(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd);
+      template <bool HasLL, bool HasLU>
+      void setStateLevel(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd);
+      template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+      void setStateRow(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_pos_R, const std::size_t p_rowBegin);
+      template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+      void setStateVec(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos, const std::size_t p_pos_2d, const std::size_t p_pos_C);
+      void swap(CNonlinearStencilPrecalc & p_other);
+      void release();
+      CNonlinearStencilPrecalc();
 
  public:
     CNonlinearStencilPrecalc(
@@ -35,14 +142,53 @@ class CNonlinearStencilPrecalc : public INonlinearOperator<ValueType>
       const ValueType p_tau = ValueType(1.0),
       const ValueType p_epsilon = ValueType(1e-15)
       );
-      inline static const std::string IDENTIFER = "nonlinear_stencil_precalc";
+    CNonlinearStencilPrecalc(
+      const CGridLayout & p_layout,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    CNonlinearStencilPrecalc(CNonlinearStencilPrecalc && p_other);
+    CNonlinearStencilPrecalc & operator=(CNonlinearStencilPrecalc && p_other);
+    CNonlinearStencilPrecalc(const CNonlinearStencilPrecalc &) = delete;
+    CNonlinearStencilPrecalc & operator=(const CNonlinearStencilPrecalc &) = delete;
+      static_assert(RowBlock >= 1, "RowBlock has to be >= 1");
+      static_assert(RowBlock == 1 || !AlignedLoads, "RowBlock and AlignedLoads are exclusive");
+      static_assert(!Interleaved || (RowBlock == 1 && !AlignedLoads), "Interleaved is exclusive with RowBlock and AlignedLoads");
+      inline static const std::string IDENTIFER =
+         std::string("nonlinear_stencil_precalc")
+         + (SplitRegions ? "_split" : "")
+         + (std::is_same<StorageType, ValueType>::value ? "" : "_float_coeff")
+         + (DiagonalFree ? "_diagonal_free" : "")
+         + (AlignedLoads ? "_aligned" : "")
+         + (RowBlock > 1 ? "_rows_" + std::to_string(RowBlock) : "")
+         + (Interleaved ? "_interleaved" : "")
+         + MemoryPolicy::IDENTIFER;
     void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    bool diagonal(ValueType * __restrict__ p_d) const;
     void setState(const ValueType * __restrict__ p_s);
+    void rebind(
+      const std::size_t p_objCols,
+      const std::size_t p_objRows,
+      const std::size_t p_objLevels,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    void rebind(
+      const CGridLayout & p_layout,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
     ~CNonlinearStencilPrecalc();
 };
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-CNonlinearStencilPrecalc<StateFunc, ValueType, VecType>::CNonlinearStencilPrecalc(
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::CNonlinearStencilPrecalc(
    const std::size_t p_objCols,
    const std::size_t p_objRows,
    const std::size_t p_objLevels,
@@ -51,138 +197,449 @@ CNonlinearStencilPrecalc<StateFunc, ValueType, VecType>::CNonlinearStencilPrecal
    const ValueType p_tau,
    const ValueType p_epsilon
    ):
-m_objCols(p_objCols),
-m_objRows(p_objRows),
-m_objLevels(p_objLevels),
-m_objSize1d(p_objCols),
-m_objSize2d(p_objCols * p_objRows),
-m_objSize3d(p_objCols * p_objRows * p_objLevels),
-m_factor(p_tau/(p_h*p_h)),
-m_epsilon(p_epsilon)
+CNonlinearStencilPrecalc(CGridLayout(p_objCols, p_objRows, p_objLevels), p_s, p_h, p_tau, p_epsilon)
+{
+
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::CNonlinearStencilPrecalc():
+m_objCols(0),
+m_objRows(0),
+m_objLevels(0),
+m_objSize1d(0),
+m_objSize2d(0),
+m_objSize3d(0),
+m_factor(0),
+m_epsilon(0),
+m_v_LL(nullptr),
+m_v_RL(nullptr),
+m_v_CL(nullptr),
+m_v(nullptr),
+m_v_CU(nullptr),
+m_v_RU(nullptr),
+m_v_LU(nullptr),
+m_vecsPerRow(0),
+m_blockSize((DiagonalFree ? 3 : 4) * VecType::size()),
+m_blocksPerLevel(0),
+m_v_blocks_raw(nullptr),
+m_v_blocks(nullptr),
+m_capacity_LL(0),
+m_capacity_RL(0),
+m_capacity_CL(0),
+m_capacity_v(0),
+m_capacity_blocks(0),
+m_g_bands(nullptr),
+m_capacity_g_bands(0)
+{
+
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::CNonlinearStencilPrecalc(
+   const CGridLayout & p_layout,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+CNonlinearStencilPrecalc()
+{
+   rebind(p_layout, p_s, p_h, p_tau, p_epsilon);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::CNonlinearStencilPrecalc(CNonlinearStencilPrecalc && p_other):
+CNonlinearStencilPrecalc()
+{
+   swap(p_other);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved> & CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::operator=(CNonlinearStencilPrecalc && p_other)
 {
    //
-   // NOTE "+1" so that upper vectors can be referenced in a shifted way
+   // NOTE the arrays of this operator are released by p_other
    //
-   m_v_LL = new ValueType[m_objSize3d+m_objSize2d];
-   m_v_RL = new ValueType[m_objSize3d+m_objSize1d];
-   m_v_CL = new ValueType[m_objSize3d+1];
-   m_v    = new ValueType[m_objSize3d];
+   swap(p_other);
+   return *this;
+}
 
-   m_v_CU = &(m_v_CL[1]);
-   m_v_RU = &(m_v_RL[m_objSize1d]);
-   m_v_LU = &(m_v_LL[m_objSize2d]);
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::swap(CNonlinearStencilPrecalc & p_other)
+{
+   std::swap(m_objCols, p_other.m_objCols);
+   std::swap(m_objRows, p_other.m_objRows);
+   std::swap(m_objLevels, p_other.m_objLevels);
+   std::swap(m_objSize1d, p_other.m_objSize1d);
+   std::swap(m_objSize2d, p_other.m_objSize2d);
+   std::swap(m_objSize3d, p_other.m_objSize3d);
+   std::swap(m_factor, p_other.m_factor);
+   std::swap(m_epsilon, p_other.m_epsilon);
+   std::swap(m_v_LL, p_other.m_v_LL);
+   std::swap(m_v_RL, p_other.m_v_RL);
+   std::swap(m_v_CL, p_other.m_v_CL);
+   std::swap(m_v, p_other.m_v);
+   std::swap(m_v_CU, p_other.m_v_CU);
+   std::swap(m_v_RU, p_other.m_v_RU);
+   std::swap(m_v_LU, p_other.m_v_LU);
+   std::swap(m_vecsPerRow, p_other.m_vecsPerRow);
+   std::swap(m_blocksPerLevel, p_other.m_blocksPerLevel);
+   std::swap(m_v_blocks_raw, p_other.m_v_blocks_raw);
+   std::swap(m_v_blocks, p_other.m_v_blocks);
+   std::swap(m_capacity_LL, p_other.m_capacity_LL);
+   std::swap(m_capacity_RL, p_other.m_capacity_RL);
+   std::swap(m_capacity_CL, p_other.m_capacity_CL);
+   std::swap(m_capacity_v, p_other.m_capacity_v);
+   std::swap(m_capacity_blocks, p_other.m_capacity_blocks);
+   std::swap(m_g_bands, p_other.m_g_bands);
+   std::swap(m_capacity_g_bands, p_other.m_capacity_g_bands);
+}
 
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::rebind(
+   const std::size_t p_objCols,
+   const std::size_t p_objRows,
+   const std::size_t p_objLevels,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   )
+{
+   rebind(CGridLayout(p_objCols, p_objRows, p_objLevels), p_s, p_h, p_tau, p_epsilon);
+}
 
-   m_v_CL[0] = ValueType(0);
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::rebind(
+   const CGridLayout & p_layout,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   )
+{
    //
-   // first touch
+   // NOTE with the same layout the halos, the padding cells and the padded
+   //      lanes of the kept arrays are still zero
    //
-   #pragma omp parallel
+   bool l_sameLayout =
+         m_objCols   == p_layout.objCols()
+      && m_objRows   == p_layout.objRows()
+      && m_objLevels == p_layout.objLevels()
+      && m_objSize1d == p_layout.objSize1d()
+      && m_objSize2d == p_layout.objSize2d()
+      && m_objSize3d == p_layout.objSize3d();
+
+   m_objCols = p_layout.objCols();
+   m_objRows = p_layout.objRows();
+   m_objLevels = p_layout.objLevels();
+   m_objSize1d = p_layout.objSize1d();
+   m_objSize2d = p_layout.objSize2d();
+   m_objSize3d = p_layout.objSize3d();
+   m_factor = p_tau/(p_h*p_h);
+   m_epsilon = p_epsilon;
+   m_vecsPerRow = (m_objCols + VecType::size() - 1) / VecType::size();
+   m_blocksPerLevel = m_vecsPerRow * m_objRows;
+
+   if constexpr (AlignedLoads)
    {
-      #pragma omp for
-      for (size_t i = 0; i < m_objSize3d; ++i)
+      assert(m_objCols % VecType::size() == 0);
+      assert(m_objSize1d % VecType::size() == 0);
+      assert(m_objSize2d % VecType::size() == 0);
+   }
+
+   if constexpr (Interleaved)
+   {
+      //
+      // NOTE padded lanes and the halo level stay zero
+      //
+      std::size_t l_sizeHalo = m_blocksPerLevel * m_blockSize;
+      std::size_t l_sizeBlocks = m_objLevels * l_sizeHalo;
+
+      bool l_allocated = CAllocator::reserve(m_v_blocks_raw, m_capacity_blocks, l_sizeHalo+l_sizeBlocks);
+      m_v_blocks = &(m_v_blocks_raw[l_sizeHalo]);
+
+      if (l_allocated || !l_sameLayout)
       {
-         m_v_LU[i] = ValueType(0);
-         m_v_RU[i] = ValueType(0);
-         m_v_CU[i] = ValueType(0);
-         m_v[i]    = ValueType(0);
+         //
+         // first touch
+         //
+         #pragma omp parallel
+         {
+            CAllocator::firstTouch(m_v_blocks, l_sizeBlocks, l_sizeHalo);
+            #pragma omp for
+            for (std::size_t i = 0; i < l_sizeHalo; ++i)
+            {
+               m_v_blocks_raw[i] = StorageType(0);
+            }
+         }
       }
-      #pragma omp for
-      for (size_t i = 0; i < m_objSize1d; ++i)
+
+      setState(p_s);
+      return;
+   }
+
+   //
+   // NOTE "+1" so that upper vectors can be referenced in a shifted way,
+   //      aligned apply reads a whole vector behind the last CL coefficient
+   //
+   bool l_allocated = false;
+   l_allocated |= CAllocator::reserve(m_v_LL, m_capacity_LL, m_objSize3d+m_objSize2d);
+   l_allocated |= CAllocator::reserve(m_v_RL, m_capacity_RL, m_objSize3d+m_objSize1d);
+   l_allocated |= CAllocator::reserve(m_v_CL, m_capacity_CL, m_objSize3d+(AlignedLoads ? VecType::size() : 1));
+   if constexpr (!DiagonalFree)
+   {
+      l_allocated |= CAllocator::reserve(m_v, m_capacity_v, m_objSize3d);
+   }
+
+   m_v_CU = &(m_v_CL[1]);
+   m_v_RU = &(m_v_RL[m_objSize1d]);
+   m_v_LU = &(m_v_LL[m_objSize2d]);
+
+   if (l_allocated || !l_sameLayout)
+   {
+      m_v_CL[0] = StorageType(0);
+      //
+      // first touch
+      //
+      #pragma omp parallel
       {
-         m_v_RL[i] = ValueType(0);
+         CAllocator::firstTouch(m_v_LU, m_objSize3d, m_objSize2d);
+         CAllocator::firstTouch(m_v_RU, m_objSize3d, m_objSize2d);
+         CAllocator::firstTouch(m_v_CU, m_objSize3d, m_objSize2d);
+         if constexpr (!DiagonalFree)
+         {
+            CAllocator::firstTouch(m_v, m_objSize3d, m_objSize2d);
+         }
+         #pragma omp for
+         for (size_t i = 0; i < m_objSize1d; ++i)
+         {
+            m_v_RL[i] = StorageType(0);
+         }
+         #pragma omp for
+         for (size_t i = 0; i < m_objSize2d; ++i)
+         {
+            m_v_LL[i] = StorageType(0);
+         }
       }
-      #pragma omp for
-      for (size_t i = 0; i < m_objSize2d; ++i)
+      if constexpr (AlignedLoads)
       {
-         m_v_LL[i] = ValueType(0);
+         for (size_t i = m_objSize3d+1; i < m_objSize3d+VecType::size(); ++i)
+         {
+            m_v_CL[i] = StorageType(0);
+         }
       }
    }
 
    setState(p_s);
 }
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType>::setState(const ValueType * __restrict__ p_s)
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::setState(const ValueType * __restrict__ p_s)
 {
+   //
+   // NOTE every thread walks its contiguous chunk of levels (the static
+   //      level distribution of apply) band by band: BAND_ROWS rows of all
+   //      its levels, then the next rows. g = f(s) of the band and of the
+   //      levels l_pos_L-1, l_pos_L and l_pos_L+1 is kept in three band
+   //      buffers, which are rolled along the levels. A band buffer holds
+   //      the rows of the band and one halo row on both sides (the RL/RU
+   //      neighbours, zero outside of the grid), 3*(BAND_ROWS+2) rows per
+   //      thread stay in cache. StateFunc is evaluated once per cell but
+   //      for the two halo rows of a band and the first two levels of a
+   //      chunk
+   //
+   //      the buffers are kept by the operator (one slice per thread, the
+   //      number of threads is the one of the following parallel region)
+   //      and only touched again if they were reallocated, every row of a
+   //      band buffer is written before it is read
+   //
+   std::size_t l_bandRows = m_objRows < BAND_ROWS ? m_objRows : BAND_ROWS;
+   std::size_t l_sizeBand = (l_bandRows+2) * m_objSize1d;
+
+   bool l_touch = CAllocator::reserve(m_g_bands, m_capacity_g_bands, omp_get_max_threads()*3*l_sizeBand);
+
    #pragma omp parallel
    {
-      std::size_t l_pos;
-
-      VecType l_pos_C_Vec;
+      if (l_touch)
+      {
+         CAllocator::firstTouch(m_g_bands, omp_get_num_threads()*3*l_sizeBand, 3*l_sizeBand);
+      }
 
-      VecType l_s_LL_Vec;
-      VecType l_s_RL_Vec;
-      VecType l_s_CL_Vec;
-      VecType l_s_Vec;
-      VecType l_s_CU_Vec;
-      VecType l_s_RU_Vec;
-      VecType l_s_LU_Vec;
+      ValueType * l_g_bands = &(m_g_bands[omp_get_thread_num()*3*l_sizeBand]);
+      ValueType * l_g_LL;
+      ValueType * l_g;
+      ValueType * l_g_LU;
+      ValueType * l_g_tmp;
 
-      VecType l_v_LL_Vec;
-      VecType l_v_RL_Vec;
-      VecType l_v_CL_Vec;
-      VecType l_v_Vec;
-      VecType l_v_CU_Vec;
-      VecType l_v_RU_Vec;
-      VecType l_v_LU_Vec;
+      std::size_t l_pos_L_begin = m_objLevels;
+      std::size_t l_pos_L_end = m_objLevels;
 
-      #pragma omp for
+      #pragma omp for schedule(static) nowait
       for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
       {
-         for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+         if (l_pos_L_begin == m_objLevels)
+         {
+            l_pos_L_begin = l_pos_L;
+         }
+         l_pos_L_end = l_pos_L+1;
+      }
+
+      for (std::size_t l_rowBegin=0; l_pos_L_begin<l_pos_L_end && l_rowBegin<m_objRows; l_rowBegin+=l_bandRows)
+      {
+         std::size_t l_rowEnd = l_rowBegin+l_bandRows < m_objRows ? l_rowBegin+l_bandRows : m_objRows;
+
+         l_g_LL = l_g_bands;
+         l_g    = l_g_bands + l_sizeBand;
+         l_g_LU = l_g_bands + 2*l_sizeBand;
+
+         for (std::size_t l_pos_L=l_pos_L_begin; l_pos_L<l_pos_L_end; ++l_pos_L)
          {
-            for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+            if (l_pos_L > l_pos_L_begin)
+            {
+               l_g_tmp = l_g_LL;
+               l_g_LL  = l_g;
+               l_g     = l_g_LU;
+               l_g_LU  = l_g_tmp;
+            }
+            else
             {
-               l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
-
-               //
-               // WORKAROUND hardcoded vector size of 4
-               //
-               l_pos_C_Vec = VecType(l_pos_C, l_pos_C+1, l_pos_C+2, l_pos_C+3);
-
-               l_s_LL_Vec.load(p_s + l_pos - m_objSize2d);
-               l_s_RL_Vec.load(p_s + l_pos - m_objSize1d);
-               l_s_CL_Vec.load(p_s + l_pos - 1          );
-               l_s_Vec.load(   p_s + l_pos              );
-               l_s_CU_Vec.load(p_s + l_pos + 1          );
-               l_s_RU_Vec.load(p_s + l_pos + m_objSize1d);
-               l_s_LU_Vec.load(p_s + l_pos + m_objSize2d);
-
-               StateFunc<VecType>::apply(l_s_LL_Vec);
-               StateFunc<VecType>::apply(l_s_RL_Vec);
-               StateFunc<VecType>::apply(l_s_CL_Vec);
-               StateFunc<VecType>::apply(l_s_Vec);
-               StateFunc<VecType>::apply(l_s_CU_Vec);
-               StateFunc<VecType>::apply(l_s_RU_Vec);
-               StateFunc<VecType>::apply(l_s_LU_Vec);
-
-               l_v_CL_Vec = select(l_pos_C_Vec>0,           m_factor, 0.0);
-               l_v_CU_Vec = select(l_pos_C_Vec<m_objCols-1,   m_factor, 0.0);
-
-               l_v_LL_Vec = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_s_Vec * l_s_LL_Vec / (l_s_Vec+l_s_LL_Vec+m_epsilon);
-               l_v_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_s_Vec * l_s_RL_Vec / (l_s_Vec+l_s_RL_Vec+m_epsilon);
-               l_v_CL_Vec *=                                                           2 * l_s_Vec * l_s_CL_Vec / (l_s_Vec+l_s_CL_Vec+m_epsilon);
-               l_v_CU_Vec *=                                                           2 * l_s_Vec * l_s_CU_Vec / (l_s_Vec+l_s_CU_Vec+m_epsilon);
-               l_v_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_s_Vec * l_s_RU_Vec / (l_s_Vec+l_s_RU_Vec+m_epsilon);
-               l_v_LU_Vec = (1-(l_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_s_Vec * l_s_LU_Vec / (l_s_Vec+l_s_LU_Vec+m_epsilon);
+               if (l_pos_L > 0)
+               {
+                  transformBand(p_s, l_g_LL, l_pos_L-1, l_rowBegin, l_rowEnd);
+               }
+               transformBand(p_s, l_g, l_pos_L, l_rowBegin, l_rowEnd);
+            }
+            if (l_pos_L < m_objLevels-1)
+            {
+               transformBand(p_s, l_g_LU, l_pos_L+1, l_rowBegin, l_rowEnd);
+            }
 
-               l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+            //
+            // NOTE the kernels get the first row of the band
+            //
+            if constexpr (SplitRegions)
+            {
+               setStateSplit(l_g_LL + m_objSize1d, l_g + m_objSize1d, l_g_LU + m_objSize1d, l_pos_L, l_rowBegin, l_rowEnd);
+            }
+            else
+            {
+               setStateMasked(l_g_LL + m_objSize1d, l_g + m_objSize1d, l_g_LU + m_objSize1d, l_pos_L, l_rowBegin, l_rowEnd);
+            }
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::applyAligned(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   assert(reinterpret_cast<std::uintptr_t>(p_x) % sizeof(VecType) == 0);
+   assert(reinterpret_cast<std::uintptr_t>(p_y) % sizeof(VecType) == 0);
+
+   std::size_t l_pos;
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_x_prev_Vec;
+   VecType l_x_next_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_v_LL_Vec;
+   VecType l_v_RL_Vec;
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec;
+   VecType l_v_LU_Vec;
+
+   VecType l_v_CL_next_Vec;
+
+   #pragma omp for nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d;
+
+         //
+         // NOTE the lanes taken from the vectors left of the first and right
+         //      of the last vector of a row have a zero coefficient
+         //
+         VecUtils::loadAligned(l_x_prev_Vec, p_x + l_pos - VecType::size());
+         VecUtils::loadAligned(l_x_Vec,      p_x + l_pos);
+         StorageUtils::loadAligned(l_v_CL_Vec, m_v_CL + l_pos);
+
+         for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+         {
+            l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+
+            MemoryPolicy::prefetch(p_x + l_pos - m_objSize2d);
+            MemoryPolicy::prefetch(p_x + l_pos + m_objSize2d);
 
-               l_v_Vec.store(   m_v    + l_pos);
-               l_v_CU_Vec.store(m_v_CU + l_pos);
-               l_v_RU_Vec.store(m_v_RU + l_pos);
-               l_v_LU_Vec.store(m_v_LU + l_pos);
+            VecUtils::loadAligned(l_x_next_Vec, p_x + l_pos + VecType::size());
+            StorageUtils::loadAligned(l_v_CL_next_Vec, m_v_CL + l_pos + VecType::size());
+
+            l_x_CL_Vec = VecUtils::shiftLow(l_x_prev_Vec, l_x_Vec);
+            l_x_CU_Vec = VecUtils::shiftHigh(l_x_Vec, l_x_next_Vec);
+            l_v_CU_Vec = VecUtils::shiftHigh(l_v_CL_Vec, l_v_CL_next_Vec);
+
+            VecUtils::loadAligned(l_x_LL_Vec, p_x + l_pos - m_objSize2d);
+            VecUtils::loadAligned(l_x_RL_Vec, p_x + l_pos - m_objSize1d);
+            VecUtils::loadAligned(l_x_RU_Vec, p_x + l_pos + m_objSize1d);
+            VecUtils::loadAligned(l_x_LU_Vec, p_x + l_pos + m_objSize2d);
+
+            StorageUtils::loadAligned(l_v_LL_Vec, m_v_LL + l_pos);
+            StorageUtils::loadAligned(l_v_RL_Vec, m_v_RL + l_pos);
+            StorageUtils::loadAligned(l_v_RU_Vec, m_v_RU + l_pos);
+            StorageUtils::loadAligned(l_v_LU_Vec, m_v_LU + l_pos);
+
+            if constexpr (DiagonalFree)
+            {
+               l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+            }
+            else
+            {
+               StorageUtils::loadAligned(l_v_Vec, m_v + l_pos);
             }
+
+            l_y_Vec =
+               l_v_Vec    * l_x_Vec
+            -  l_v_LL_Vec * l_x_LL_Vec
+            -  l_v_RL_Vec * l_x_RL_Vec
+            -  l_v_CL_Vec * l_x_CL_Vec
+            -  l_v_CU_Vec * l_x_CU_Vec
+            -  l_v_RU_Vec * l_x_RU_Vec
+            -  l_v_LU_Vec * l_x_LU_Vec
+            ;
+            MemoryPolicy::storeAligned(l_y_Vec, p_y + l_pos);
+
+            l_x_prev_Vec = l_x_Vec;
+            l_x_Vec      = l_x_next_Vec;
+            l_v_CL_Vec   = l_v_CL_next_Vec;
          }
       }
    }
+
+   MemoryPolicy::fence();
+   #pragma omp barrier
 }
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::applyInterleaved(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
 {
    std::size_t l_pos;
+   std::size_t l_n;
+
+   const StorageType * l_block;
 
    VecType l_x_LL_Vec;
    VecType l_x_RL_Vec;
@@ -202,30 +659,55 @@ void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType>::apply(const ValueT
    VecType l_v_RU_Vec;
    VecType l_v_LU_Vec;
 
-   #pragma omp for
+   VecType l_v_CU_prev_Vec;
+
+   #pragma omp for nowait
    for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
    {
       for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
       {
+         l_block = m_v_blocks + (l_pos_L * m_blocksPerLevel + l_pos_R * m_vecsPerRow) * m_blockSize;
+
+         //
+         // NOTE CL of the first column is zero
+         //
+         l_v_CU_prev_Vec = VecType(0);
+
          for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
          {
             l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            MemoryPolicy::prefetch(p_x + l_pos - m_objSize2d);
+            MemoryPolicy::prefetch(p_x + l_pos + m_objSize2d);
+
+            VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+            VecUtils::load(l_x_RL_Vec, p_x + l_pos - m_objSize1d, l_n);
+            VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+            VecUtils::load(l_x_Vec,    p_x + l_pos              , l_n);
+            VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+            VecUtils::load(l_x_RU_Vec, p_x + l_pos + m_objSize1d, l_n);
+            VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
 
-            l_x_LL_Vec.load(p_x + l_pos - m_objSize2d);
-            l_x_RL_Vec.load(p_x + l_pos - m_objSize1d);
-            l_x_CL_Vec.load(p_x + l_pos - 1          );
-            l_x_Vec.load(   p_x + l_pos              );
-            l_x_CU_Vec.load(p_x + l_pos + 1          );
-            l_x_RU_Vec.load(p_x + l_pos + m_objSize1d);
-            l_x_LU_Vec.load(p_x + l_pos + m_objSize2d);
-
-            l_v_LL_Vec.load(m_v_LL + l_pos);
-            l_v_RL_Vec.load(m_v_RL + l_pos);
-            l_v_CL_Vec.load(m_v_CL + l_pos);
-            l_v_Vec.load(   m_v    + l_pos);
-            l_v_CU_Vec.load(m_v_CU + l_pos);
-            l_v_RU_Vec.load(m_v_RU + l_pos);
-            l_v_LU_Vec.load(m_v_LU + l_pos);
+            //
+            // NOTE blocks are padded, whole vectors are loaded
+            //
+            StorageUtils::load(l_v_CU_Vec, l_block + SLOT_CU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_RU_Vec, l_block + SLOT_RU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_LU_Vec, l_block + SLOT_LU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_RL_Vec, l_block - m_vecsPerRow * m_blockSize + SLOT_RU * VecType::size(), VecType::size());
+            StorageUtils::load(l_v_LL_Vec, l_block - m_blocksPerLevel * m_blockSize + SLOT_LU * VecType::size(), VecType::size());
+
+            l_v_CL_Vec = VecUtils::shiftLow(l_v_CU_prev_Vec, l_v_CU_Vec);
+
+            if constexpr (DiagonalFree)
+            {
+               l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+            }
+            else
+            {
+               StorageUtils::load(l_v_Vec, l_block + SLOT_V * VecType::size(), VecType::size());
+            }
 
             l_y_Vec =
                l_v_Vec    * l_x_Vec
@@ -236,14 +718,523 @@ void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType>::apply(const ValueT
             -  l_v_RU_Vec * l_x_RU_Vec
             -  l_v_LU_Vec * l_x_LU_Vec
             ;
-            l_y_Vec.store(p_y + l_pos);
+            MemoryPolicy::store(l_y_Vec, p_y + l_pos, l_n);
+
+            l_v_CU_prev_Vec = l_v_CU_Vec;
+            l_block += m_blockSize;
          }
       }
    }
+
+   MemoryPolicy::fence();
+   #pragma omp barrier
 }
 
-template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType>
-CNonlinearStencilPrecalc<StateFunc, ValueType, VecType>::~CNonlinearStencilPrecalc()
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::transformBand(const ValueType * __restrict__ p_s, ValueType * __restrict__ p_g, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd) const
 {
+   //
+   // NOTE p_g is the band buffer, its first row is the halo row p_rowBegin-1
+   //
+   std::size_t l_row_first = p_rowBegin > 0 ? p_rowBegin-1 : 0;
+   std::size_t l_row_last = p_rowEnd < m_objRows ? p_rowEnd+1 : m_objRows;
+   std::size_t l_size = (l_row_last-l_row_first) * m_objSize1d;
+   const ValueType * l_s = p_s + p_pos_L * m_objSize2d + l_row_first * m_objSize1d;
+   ValueType * l_g = p_g + (l_row_first+1-p_rowBegin) * m_objSize1d;
+   std::size_t l_n;
+
+   VecType l_s_Vec;
+
+   if (p_rowBegin == 0)
+   {
+      for (std::size_t i = 0; i < m_objSize1d; ++i)
+      {
+         p_g[i] = ValueType(0);
+      }
+   }
+   if (p_rowEnd == m_objRows)
+   {
+      for (std::size_t i = 0; i < m_objSize1d; ++i)
+      {
+         p_g[(p_rowEnd+1-p_rowBegin) * m_objSize1d + i] = ValueType(0);
+      }
+   }
+
+   for (std::size_t l_pos=0; l_pos<l_size; l_pos+=VecType::size())
+   {
+      l_n = VecUtils::lanesValid(l_pos, l_size);
+
+      VecUtils::load(l_s_Vec, l_s + l_pos, l_n);
+      StateFunc<VecType>::apply(l_s_Vec);
+      VecUtils::store(l_s_Vec, l_g + l_pos, l_n);
+   }
+}
 
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::setStateMasked(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd)
+{
+   std::size_t l_pos;
+   std::size_t l_pos_2d;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_g_LL_Vec;
+   VecType l_g_RL_Vec;
+   VecType l_g_CL_Vec;
+   VecType l_g_Vec;
+   VecType l_g_CU_Vec;
+   VecType l_g_RU_Vec;
+   VecType l_g_LU_Vec;
+
+   VecType l_v_LL_Vec;
+   VecType l_v_RL_Vec;
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec(0);
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec;
+   VecType l_v_LU_Vec;
+
+   for (std::size_t l_pos_R=p_rowBegin; l_pos_R<p_rowEnd; ++l_pos_R)
+   {
+      for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+      {
+         l_pos_2d = (l_pos_R-p_rowBegin) * m_objSize1d + l_pos_C;
+         l_pos = p_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+         l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+         l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+         VecUtils::load(l_g_LL_Vec, p_g_LL + l_pos_2d              , l_n);
+         VecUtils::load(l_g_RL_Vec, p_g    + l_pos_2d - m_objSize1d, l_n);
+         VecUtils::load(l_g_CL_Vec, p_g    + l_pos_2d - 1          , l_n);
+         VecUtils::load(l_g_Vec,    p_g    + l_pos_2d              , l_n);
+         VecUtils::load(l_g_CU_Vec, p_g    + l_pos_2d + 1          , l_n);
+         VecUtils::load(l_g_RU_Vec, p_g    + l_pos_2d + m_objSize1d, l_n);
+         VecUtils::load(l_g_LU_Vec, p_g_LU + l_pos_2d              , l_n);
+
+         l_v_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+         l_v_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+         l_v_LL_Vec = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LL_Vec / (l_g_Vec+l_g_LL_Vec+m_epsilon);
+         l_v_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_g_Vec * l_g_RL_Vec / (l_g_Vec+l_g_RL_Vec+m_epsilon);
+         l_v_CL_Vec *=                                                           2 * l_g_Vec * l_g_CL_Vec / (l_g_Vec+l_g_CL_Vec+m_epsilon);
+         l_v_CU_Vec *=                                                           2 * l_g_Vec * l_g_CU_Vec / (l_g_Vec+l_g_CU_Vec+m_epsilon);
+         l_v_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_g_Vec * l_g_RU_Vec / (l_g_Vec+l_g_RU_Vec+m_epsilon);
+         l_v_LU_Vec = (1-(p_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LU_Vec / (l_g_Vec+l_g_LU_Vec+m_epsilon);
+
+         if constexpr (!DiagonalFree)
+         {
+            l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+         }
+
+         storeCoefficients(l_pos, l_n, l_v_Vec, l_v_CU_Vec, l_v_RU_Vec, l_v_LU_Vec);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::setStateSplit(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd)
+{
+   if (p_pos_L == 0)
+   {
+      setStateLevel<false, true>(p_g_LL, p_g, p_g_LU, p_pos_L, p_rowBegin, p_rowEnd);
+   }
+   else if (p_pos_L == m_objLevels-1)
+   {
+      setStateLevel<true, false>(p_g_LL, p_g, p_g_LU, p_pos_L, p_rowBegin, p_rowEnd);
+   }
+   else
+   {
+      setStateLevel<true, true>(p_g_LL, p_g, p_g_LU, p_pos_L, p_rowBegin, p_rowEnd);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+template <bool HasLL, bool HasLU>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::setStateLevel(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_rowBegin, const std::size_t p_rowEnd)
+{
+   std::size_t l_pos_R = p_rowBegin;
+
+   if (l_pos_R == 0)
+   {
+      setStateRow<HasLL, false, true, HasLU>(p_g_LL, p_g, p_g_LU, p_pos_L, 0, p_rowBegin);
+      ++l_pos_R;
+   }
+   for (; l_pos_R<p_rowEnd && l_pos_R<m_objRows-1; ++l_pos_R)
+   {
+      setStateRow<HasLL, true, true, HasLU>(p_g_LL, p_g, p_g_LU, p_pos_L, l_pos_R, p_rowBegin);
+   }
+   if (p_rowEnd == m_objRows)
+   {
+      setStateRow<HasLL, true, false, HasLU>(p_g_LL, p_g, p_g_LU, p_pos_L, m_objRows-1, p_rowBegin);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::setStateRow(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos_L, const std::size_t p_pos_R, const std::size_t p_rowBegin)
+{
+   std::size_t l_pos_row_2d = (p_pos_R-p_rowBegin) * m_objSize1d;
+   std::size_t l_pos_row = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d;
+   std::size_t l_pos_C_last = ((m_objCols-1)/VecType::size())*VecType::size();
+
+   setStateVec<HasLL, HasRL, HasRU, HasLU, true>(p_g_LL, p_g, p_g_LU, l_pos_row, l_pos_row_2d, 0);
+   for (std::size_t l_pos_C=VecType::size(); l_pos_C<l_pos_C_last; l_pos_C+=VecType::size())
+   {
+      setStateVec<HasLL, HasRL, HasRU, HasLU, false>(p_g_LL, p_g, p_g_LU, l_pos_row + l_pos_C, l_pos_row_2d + l_pos_C, l_pos_C);
+   }
+   if (l_pos_C_last > 0)
+   {
+      setStateVec<HasLL, HasRL, HasRU, HasLU, true>(p_g_LL, p_g, p_g_LU, l_pos_row + l_pos_C_last, l_pos_row_2d + l_pos_C_last, l_pos_C_last);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+inline void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::setStateVec(const ValueType * __restrict__ p_g_LL, const ValueType * __restrict__ p_g, const ValueType * __restrict__ p_g_LU, const std::size_t p_pos, const std::size_t p_pos_2d, const std::size_t p_pos_C)
+{
+   std::size_t l_n = ColBoundary ? VecUtils::lanesValid(p_pos_C, m_objCols) : VecType::size();
+
+   VecType l_g_LL_Vec;
+   VecType l_g_RL_Vec;
+   VecType l_g_CL_Vec;
+   VecType l_g_Vec;
+   VecType l_g_CU_Vec;
+   VecType l_g_RU_Vec;
+   VecType l_g_LU_Vec;
+
+   VecType l_v_LL_Vec(0);
+   VecType l_v_RL_Vec(0);
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec(0);
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec(0);
+   VecType l_v_LU_Vec(0);
+
+   VecUtils::load(l_g_CL_Vec, p_g + p_pos_2d - 1, l_n);
+   VecUtils::load(l_g_Vec,    p_g + p_pos_2d    , l_n);
+   VecUtils::load(l_g_CU_Vec, p_g + p_pos_2d + 1, l_n);
+
+   if constexpr (ColBoundary)
+   {
+      VecType l_pos_C_Vec = VecUtils::lanes() + ValueType(p_pos_C);
+
+      l_v_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_v_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+   }
+   else
+   {
+      l_v_CL_Vec = VecType(m_factor);
+      l_v_CU_Vec = VecType(m_factor);
+   }
+
+   if constexpr (HasLL)
+   {
+      VecUtils::load(l_g_LL_Vec, p_g_LL + p_pos_2d, l_n);
+      l_v_LL_Vec = m_factor * 2 * l_g_Vec * l_g_LL_Vec / (l_g_Vec+l_g_LL_Vec+m_epsilon);
+   }
+   if constexpr (HasRL)
+   {
+      VecUtils::load(l_g_RL_Vec, p_g + p_pos_2d - m_objSize1d, l_n);
+      l_v_RL_Vec = m_factor * 2 * l_g_Vec * l_g_RL_Vec / (l_g_Vec+l_g_RL_Vec+m_epsilon);
+   }
+   l_v_CL_Vec *=              2 * l_g_Vec * l_g_CL_Vec / (l_g_Vec+l_g_CL_Vec+m_epsilon);
+   l_v_CU_Vec *=              2 * l_g_Vec * l_g_CU_Vec / (l_g_Vec+l_g_CU_Vec+m_epsilon);
+   if constexpr (HasRU)
+   {
+      VecUtils::load(l_g_RU_Vec, p_g + p_pos_2d + m_objSize1d, l_n);
+      l_v_RU_Vec = m_factor * 2 * l_g_Vec * l_g_RU_Vec / (l_g_Vec+l_g_RU_Vec+m_epsilon);
+   }
+   if constexpr (HasLU)
+   {
+      VecUtils::load(l_g_LU_Vec, p_g_LU + p_pos_2d, l_n);
+      l_v_LU_Vec = m_factor * 2 * l_g_Vec * l_g_LU_Vec / (l_g_Vec+l_g_LU_Vec+m_epsilon);
+   }
+
+   if constexpr (!DiagonalFree)
+   {
+      l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+   }
+
+   storeCoefficients(p_pos, l_n, l_v_Vec, l_v_CU_Vec, l_v_RU_Vec, l_v_LU_Vec);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+inline std::size_t CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::blockOffset(const std::size_t p_pos) const
+{
+   //
+   // NOTE p_pos is the first cell of a column vector, the plane pitch may be
+   //      padded (CGridLayout)
+   //
+   std::size_t l_pos_L = p_pos / m_objSize2d;
+   std::size_t l_pos_R = (p_pos % m_objSize2d) / m_objSize1d;
+   std::size_t l_pos_C = (p_pos % m_objSize2d) % m_objSize1d;
+
+   return l_pos_L * m_blocksPerLevel * m_blockSize + (l_pos_R * m_vecsPerRow + l_pos_C / VecType::size()) * m_blockSize;
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+inline void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::storeCoefficients(const std::size_t p_pos, const std::size_t p_n, const VecType & p_v_Vec, const VecType & p_v_CU_Vec, const VecType & p_v_RU_Vec, const VecType & p_v_LU_Vec)
+{
+   if constexpr (Interleaved)
+   {
+      StorageType * l_block = m_v_blocks + blockOffset(p_pos);
+
+      StorageUtils::store(p_v_CU_Vec, l_block + SLOT_CU * VecType::size(), p_n);
+      StorageUtils::store(p_v_RU_Vec, l_block + SLOT_RU * VecType::size(), p_n);
+      StorageUtils::store(p_v_LU_Vec, l_block + SLOT_LU * VecType::size(), p_n);
+      if constexpr (!DiagonalFree)
+      {
+         StorageUtils::store(p_v_Vec, l_block + SLOT_V * VecType::size(), p_n);
+      }
+   }
+   else
+   {
+      if constexpr (!DiagonalFree)
+      {
+         StorageUtils::store(p_v_Vec, m_v + p_pos, p_n);
+      }
+
+      StorageUtils::store(p_v_CU_Vec, m_v_CU + p_pos, p_n);
+      StorageUtils::store(p_v_RU_Vec, m_v_RU + p_pos, p_n);
+      StorageUtils::store(p_v_LU_Vec, m_v_LU + p_pos, p_n);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   if constexpr (AlignedLoads)
+   {
+      applyAligned(p_x, p_y);
+      return;
+   }
+   if constexpr (Interleaved)
+   {
+      applyInterleaved(p_x, p_y);
+      return;
+   }
+
+   std::size_t l_pos_R;
+
+   #pragma omp for nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (l_pos_R=0; l_pos_R+RowBlock<=m_objRows; l_pos_R+=RowBlock)
+      {
+         applyRows<RowBlock>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+      for (; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         applyRows<1>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+   }
+
+   MemoryPolicy::fence();
+   #pragma omp barrier
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+template <std::size_t Rows>
+inline void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const
+{
+   std::size_t l_pos;
+   std::size_t l_pos_0;
+   std::size_t l_n;
+
+   //
+   // NOTE x of the rows p_pos_R-1, ..., p_pos_R+Rows and the RL
+   //      coefficients of the rows p_pos_R, ..., p_pos_R+Rows,
+   //      the last one is the RU coefficient of the last row
+   //
+   VecType l_x_R_Vec[Rows+2];
+   VecType l_v_R_Vec[Rows+1];
+
+   VecType l_x_LL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_v_LL_Vec;
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_LU_Vec;
+
+   for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+   {
+      l_pos_0 = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + l_pos_C;
+      l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+      for (std::size_t k=0; k<Rows+2; ++k)
+      {
+         VecUtils::load(l_x_R_Vec[k], p_x + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+      }
+      for (std::size_t k=0; k<Rows+1; ++k)
+      {
+         StorageUtils::load(l_v_R_Vec[k], m_v_RL + l_pos_0 + k * m_objSize1d, l_n);
+      }
+
+      for (std::size_t b=0; b<Rows; ++b)
+      {
+         l_pos = l_pos_0 + b * m_objSize1d;
+
+         MemoryPolicy::prefetch(p_x + l_pos - m_objSize2d);
+         MemoryPolicy::prefetch(p_x + l_pos + m_objSize2d);
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         StorageUtils::load(l_v_LL_Vec, m_v_LL + l_pos, l_n);
+         StorageUtils::load(l_v_CL_Vec, m_v_CL + l_pos, l_n);
+         StorageUtils::load(l_v_CU_Vec, m_v_CU + l_pos, l_n);
+         StorageUtils::load(l_v_LU_Vec, m_v_LU + l_pos, l_n);
+
+         if constexpr (DiagonalFree)
+         {
+            l_v_Vec = 1 + l_v_LL_Vec + l_v_R_Vec[b] + l_v_CL_Vec + l_v_CU_Vec + l_v_R_Vec[b+1] + l_v_LU_Vec;
+         }
+         else
+         {
+            StorageUtils::load(l_v_Vec, m_v + l_pos, l_n);
+         }
+
+         l_y_Vec =
+            l_v_Vec        * l_x_R_Vec[b+1]
+         -  l_v_LL_Vec     * l_x_LL_Vec
+         -  l_v_R_Vec[b]   * l_x_R_Vec[b]
+         -  l_v_CL_Vec     * l_x_CL_Vec
+         -  l_v_CU_Vec     * l_x_CU_Vec
+         -  l_v_R_Vec[b+1] * l_x_R_Vec[b+2]
+         -  l_v_LU_Vec     * l_x_LU_Vec
+         ;
+         MemoryPolicy::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+bool CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::diagonal(ValueType * __restrict__ p_d) const
+{
+   //
+   // NOTE the stored diagonal widened to ValueType, DiagonalFree sums it
+   //      from the face coefficients in the order of apply
+   //
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   const StorageType * l_block = nullptr;
+
+   VecType l_v_LL_Vec;
+   VecType l_v_RL_Vec;
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec;
+   VecType l_v_LU_Vec;
+
+   VecType l_v_CU_prev_Vec;
+
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         if constexpr (Interleaved)
+         {
+            l_block = m_v_blocks + (l_pos_L * m_blocksPerLevel + l_pos_R * m_vecsPerRow) * m_blockSize;
+            l_v_CU_prev_Vec = VecType(0);
+         }
+
+         for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+         {
+            l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            if constexpr (Interleaved && DiagonalFree)
+            {
+               StorageUtils::load(l_v_CU_Vec, l_block + SLOT_CU * VecType::size(), VecType::size());
+               StorageUtils::load(l_v_RU_Vec, l_block + SLOT_RU * VecType::size(), VecType::size());
+               StorageUtils::load(l_v_LU_Vec, l_block + SLOT_LU * VecType::size(), VecType::size());
+               StorageUtils::load(l_v_RL_Vec, l_block - m_vecsPerRow * m_blockSize + SLOT_RU * VecType::size(), VecType::size());
+               StorageUtils::load(l_v_LL_Vec, l_block - m_blocksPerLevel * m_blockSize + SLOT_LU * VecType::size(), VecType::size());
+
+               l_v_CL_Vec = VecUtils::shiftLow(l_v_CU_prev_Vec, l_v_CU_Vec);
+               l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+
+               l_v_CU_prev_Vec = l_v_CU_Vec;
+            }
+            else if constexpr (Interleaved)
+            {
+               StorageUtils::load(l_v_Vec, l_block + SLOT_V * VecType::size(), VecType::size());
+            }
+            else if constexpr (DiagonalFree)
+            {
+               StorageUtils::load(l_v_LL_Vec, m_v_LL + l_pos, l_n);
+               StorageUtils::load(l_v_RL_Vec, m_v_RL + l_pos, l_n);
+               StorageUtils::load(l_v_CL_Vec, m_v_CL + l_pos, l_n);
+               StorageUtils::load(l_v_CU_Vec, m_v_CU + l_pos, l_n);
+               StorageUtils::load(l_v_RU_Vec, m_v_RU + l_pos, l_n);
+               StorageUtils::load(l_v_LU_Vec, m_v_LU + l_pos, l_n);
+
+               l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+            }
+            else
+            {
+               StorageUtils::load(l_v_Vec, m_v + l_pos, l_n);
+            }
+
+            if constexpr (Interleaved)
+            {
+               l_block += m_blockSize;
+            }
+
+            VecUtils::store(l_v_Vec, p_d + l_pos, l_n);
+         }
+      }
+   }
+
+   return true;
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+void CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::release()
+{
+   CAllocator::deallocate(m_v_LL);
+   CAllocator::deallocate(m_v_RL);
+   CAllocator::deallocate(m_v_CL);
+   CAllocator::deallocate(m_v);
+   CAllocator::deallocate(m_v_blocks_raw);
+   CAllocator::deallocate(m_g_bands);
+
+   m_v_LL = nullptr;
+   m_v_RL = nullptr;
+   m_v_CL = nullptr;
+   m_v = nullptr;
+   m_v_CU = nullptr;
+   m_v_RU = nullptr;
+   m_v_LU = nullptr;
+   m_v_blocks_raw = nullptr;
+   m_v_blocks = nullptr;
+   m_g_bands = nullptr;
+
+   m_capacity_LL = 0;
+   m_capacity_RL = 0;
+   m_capacity_CL = 0;
+   m_capacity_v = 0;
+   m_capacity_blocks = 0;
+   m_capacity_g_bands = 0;
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions, typename StorageType, bool DiagonalFree, bool AlignedLoads, std::size_t RowBlock, typename MemoryPolicy, bool Interleaved>
+CNonlinearStencilPrecalc<StateFunc, ValueType, VecType, SplitRegions, StorageType, DiagonalFree, AlignedLoads, RowBlock, MemoryPolicy, Interleaved>::~CNonlinearStencilPrecalc()
+{
+   release();
 }
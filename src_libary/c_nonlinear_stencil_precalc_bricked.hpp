@@ -0,0 +1,465 @@
+/*
+ * CNonlinearStencilPrecalc on bricked vectors, see CBrickLayout and
+ * CLinearStencilConstCoeffBricked. p_s of the constructor and setState is
+ * bricked as well.
+ *
+ * The coefficients are stored in the brick layout. Like the row-major
+ * operator only CU, RU, LU and the diagonal are stored, CL/RL/LL of a cell
+ * are CU/RU/LU of the cell below, read from the same or the neighbour brick.
+ * All coefficient arrays have a zero halo brick in front, the neighbours
+ * outside of the grid and all coefficients of padding cells are zero, so
+ * apply needs no boundary handling and writes zero to the padding cells.
+ *
+ * setState evaluates StateFunc once per cell into a bricked buffer (zero
+ * outside of the grid, allocated once by the constructor) and computes the coefficients from it brick by brick
+ * with the expressions of the masked kernel of CNonlinearStencilPrecalc.
+ * Results are bit-identical to CNonlinearStencilPrecalc (SplitRegions =
+ * false).
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <omp.h>
+#include "i_nonlinear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_brick_layout.hpp"
+#include "c_allocator.hpp"
+
+template <template<typename ValueType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+class CNonlinearStencilPrecalcBricked : public INonlinearOperator<ValueType>
+{
+   private:
+      using VecUtils = CVecUtils<ValueType, VecType>;
+      using Layout = CBrickLayout<BrickSize>;
+
+      const Layout & m_layout;
+      std::size_t m_objCols;
+      std::size_t m_objRows;
+      std::size_t m_objLevels;
+      const ValueType m_factor;
+      const ValueType m_epsilon;
+      ValueType * m_v_raw;
+      ValueType * m_v_CU;
+      ValueType * m_v_RU;
+      ValueType * m_v_LU;
+      ValueType * m_v;
+      ValueType * m_g_raw;
+      ValueType * m_g;
+
+      void applyBrick(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_brick) const;
+      void transformBrick(const ValueType * __restrict__ p_s, ValueType * __restrict__ p_g, const std::size_t p_brick) const;
+      void setStateBrick(const ValueType * __restrict__ p_g, const std::size_t p_brick);
+
+ public:
+    CNonlinearStencilPrecalcBricked(
+      const Layout & p_layout,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    CNonlinearStencilPrecalcBricked(const CNonlinearStencilPrecalcBricked &) = delete;
+    CNonlinearStencilPrecalcBricked & operator=(const CNonlinearStencilPrecalcBricked &) = delete;
+      static_assert(BrickSize % VecType::size() == 0, "BrickSize has to be a multiple of the vector width");
+      inline static const std::string IDENTIFER =
+         std::string("nonlinear_stencil_precalc")
+         + Layout::IDENTIFER;
+    void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    bool diagonal(ValueType * __restrict__ p_d) const;
+    void setState(const ValueType * __restrict__ p_s);
+    ~CNonlinearStencilPrecalcBricked();
+};
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::CNonlinearStencilPrecalcBricked(
+   const Layout & p_layout,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+m_layout(p_layout),
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_factor(p_tau/(p_h*p_h)),
+m_epsilon(p_epsilon)
+{
+   //
+   // NOTE CU, RU, LU and the diagonal one after the other, each with a halo
+   //      brick in front, the first touch is done by setState
+   //
+   std::size_t l_sizeArray = Layout::BRICK_CELLS + m_layout.size();
+
+   m_v_raw = CAllocator::allocate<ValueType>(4*l_sizeArray);
+   m_v_CU = &(m_v_raw[0*l_sizeArray+Layout::BRICK_CELLS]);
+   m_v_RU = &(m_v_raw[1*l_sizeArray+Layout::BRICK_CELLS]);
+   m_v_LU = &(m_v_raw[2*l_sizeArray+Layout::BRICK_CELLS]);
+   m_v    = &(m_v_raw[3*l_sizeArray+Layout::BRICK_CELLS]);
+
+   //
+   // NOTE g = f(s) of setState, same layout, first touched by setState
+   //
+   m_g_raw = CAllocator::allocate<ValueType>(l_sizeArray);
+   m_g = &(m_g_raw[Layout::BRICK_CELLS]);
+
+   for (std::size_t k = 0; k < 4; ++k)
+   {
+      for (std::size_t i = 0; i < Layout::BRICK_CELLS; ++i)
+      {
+         m_v_raw[k*l_sizeArray+i] = ValueType(0);
+      }
+   }
+
+   for (std::size_t i = 0; i < Layout::BRICK_CELLS; ++i)
+   {
+      m_g_raw[i] = ValueType(0);
+   }
+
+   setState(p_s);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+void CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::setState(const ValueType * __restrict__ p_s)
+{
+   //
+   // NOTE g = f(s) of all cells, zero outside of the grid and in the halo
+   //
+   #pragma omp parallel
+   {
+      #pragma omp for schedule(static)
+      for (std::size_t l_brick=0; l_brick<m_layout.bricks(); ++l_brick)
+      {
+         transformBrick(p_s, m_g, l_brick);
+      }
+
+      #pragma omp for schedule(static)
+      for (std::size_t l_brick=0; l_brick<m_layout.bricks(); ++l_brick)
+      {
+         setStateBrick(m_g, l_brick);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+void CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::transformBrick(const ValueType * __restrict__ p_s, ValueType * __restrict__ p_g, const std::size_t p_brick) const
+{
+   constexpr std::size_t B = BrickSize;
+   constexpr std::size_t V = VecType::size();
+
+   const ValueType * l_s = p_s + p_brick * Layout::BRICK_CELLS;
+   ValueType * l_g = p_g + p_brick * Layout::BRICK_CELLS;
+
+   std::size_t l_origin_C = m_layout.origin(p_brick, 0);
+   std::size_t l_origin_R = m_layout.origin(p_brick, 1);
+   std::size_t l_origin_L = m_layout.origin(p_brick, 2);
+
+   std::size_t l_row;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_s_Vec;
+
+   for (std::size_t l=0; l<B; ++l)
+   {
+      for (std::size_t r=0; r<B; ++r)
+      {
+         l_row = (l*B + r)*B;
+
+         for (std::size_t j=0; j<B; j+=V)
+         {
+            if (l_origin_L + l >= m_objLevels || l_origin_R + r >= m_objRows)
+            {
+               l_s_Vec = VecType(0);
+            }
+            else
+            {
+               VecUtils::load(l_s_Vec, l_s + l_row + j, V);
+               StateFunc<VecType>::apply(l_s_Vec);
+               l_s_Vec = select(l_lane_Vec + ValueType(l_origin_C + j)<ValueType(m_objCols), l_s_Vec, VecType(0));
+            }
+            VecUtils::store(l_s_Vec, l_g + l_row + j, V);
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+void CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::setStateBrick(const ValueType * __restrict__ p_g, const std::size_t p_brick)
+{
+   constexpr std::size_t B = BrickSize;
+   constexpr std::size_t V = VecType::size();
+
+   std::size_t l_offset = p_brick * Layout::BRICK_CELLS;
+
+   const ValueType * l_g = p_g + l_offset;
+   const ValueType * l_g_nb_CL = p_g + m_layout.neighbour(p_brick, Layout::NB_CL);
+   const ValueType * l_g_nb_CU = p_g + m_layout.neighbour(p_brick, Layout::NB_CU);
+   const ValueType * l_g_nb_RL = p_g + m_layout.neighbour(p_brick, Layout::NB_RL);
+   const ValueType * l_g_nb_RU = p_g + m_layout.neighbour(p_brick, Layout::NB_RU);
+   const ValueType * l_g_nb_LL = p_g + m_layout.neighbour(p_brick, Layout::NB_LL);
+   const ValueType * l_g_nb_LU = p_g + m_layout.neighbour(p_brick, Layout::NB_LU);
+
+   std::size_t l_origin_C = m_layout.origin(p_brick, 0);
+   std::size_t l_origin_R = m_layout.origin(p_brick, 1);
+   std::size_t l_origin_L = m_layout.origin(p_brick, 2);
+
+   std::size_t l_pos_R;
+   std::size_t l_pos_L;
+   std::size_t l_row;
+
+   const ValueType * l_g_row;
+   const ValueType * l_g_RL_row;
+   const ValueType * l_g_RU_row;
+   const ValueType * l_g_LL_row;
+   const ValueType * l_g_LU_row;
+
+   VecType l_pos_C_Vec;
+   VecType l_valid_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_g_LL_Vec;
+   VecType l_g_RL_Vec;
+   VecType l_g_CL_Vec;
+   VecType l_g_Vec;
+   VecType l_g_CU_Vec;
+   VecType l_g_RU_Vec;
+   VecType l_g_LU_Vec;
+
+   VecType l_g_prev_Vec;
+   VecType l_g_next_Vec;
+
+   VecType l_v_LL_Vec;
+   VecType l_v_RL_Vec;
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec;
+   VecType l_v_LU_Vec;
+
+   for (std::size_t l=0; l<B; ++l)
+   {
+      l_pos_L = l_origin_L + l;
+
+      for (std::size_t r=0; r<B; ++r)
+      {
+         l_pos_R = l_origin_R + r;
+         l_row = (l*B + r)*B;
+
+         //
+         // NOTE coefficients of padding cells are zero
+         //
+         if (l_pos_L >= m_objLevels || l_pos_R >= m_objRows)
+         {
+            for (std::size_t j=0; j<B; j+=V)
+            {
+               VecUtils::store(VecType(0), m_v_CU + l_offset + l_row + j, V);
+               VecUtils::store(VecType(0), m_v_RU + l_offset + l_row + j, V);
+               VecUtils::store(VecType(0), m_v_LU + l_offset + l_row + j, V);
+               VecUtils::store(VecType(0), m_v    + l_offset + l_row + j, V);
+            }
+            continue;
+         }
+
+         l_g_row    = l_g + l_row;
+         l_g_RL_row = r > 0   ? l_g_row - B     : l_g_nb_RL + l_row + (B-1)*B;
+         l_g_RU_row = r < B-1 ? l_g_row + B     : l_g_nb_RU + l_row - (B-1)*B;
+         l_g_LL_row = l > 0   ? l_g_row - B*B   : l_g_nb_LL + l_row + (B-1)*B*B;
+         l_g_LU_row = l < B-1 ? l_g_row + B*B   : l_g_nb_LU + l_row - (B-1)*B*B;
+
+         VecUtils::load(l_g_prev_Vec, l_g_nb_CL + l_row + B - V, V);
+         VecUtils::load(l_g_Vec,      l_g_row,                   V);
+
+         for (std::size_t j=0; j<B; j+=V)
+         {
+            VecUtils::load(l_g_next_Vec, j+V < B ? l_g_row + j + V : l_g_nb_CU + l_row, V);
+
+            l_g_CL_Vec = VecUtils::shiftLow(l_g_prev_Vec, l_g_Vec);
+            l_g_CU_Vec = VecUtils::shiftHigh(l_g_Vec, l_g_next_Vec);
+
+            VecUtils::load(l_g_LL_Vec, l_g_LL_row + j, V);
+            VecUtils::load(l_g_RL_Vec, l_g_RL_row + j, V);
+            VecUtils::load(l_g_RU_Vec, l_g_RU_row + j, V);
+            VecUtils::load(l_g_LU_Vec, l_g_LU_row + j, V);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_origin_C + j);
+
+            l_v_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_v_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+            l_v_LL_Vec = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LL_Vec / (l_g_Vec+l_g_LL_Vec+m_epsilon);
+            l_v_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_g_Vec * l_g_RL_Vec / (l_g_Vec+l_g_RL_Vec+m_epsilon);
+            l_v_CL_Vec *=                                                           2 * l_g_Vec * l_g_CL_Vec / (l_g_Vec+l_g_CL_Vec+m_epsilon);
+            l_v_CU_Vec *=                                                           2 * l_g_Vec * l_g_CU_Vec / (l_g_Vec+l_g_CU_Vec+m_epsilon);
+            l_v_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_g_Vec * l_g_RU_Vec / (l_g_Vec+l_g_RU_Vec+m_epsilon);
+            l_v_LU_Vec = (1-(l_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_g_Vec * l_g_LU_Vec / (l_g_Vec+l_g_LU_Vec+m_epsilon);
+
+            l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+
+            if (l_origin_C + j + V > m_objCols)
+            {
+               l_valid_Vec = select(l_pos_C_Vec<ValueType(m_objCols), VecType(1), VecType(0));
+
+               l_v_CU_Vec *= l_valid_Vec;
+               l_v_RU_Vec *= l_valid_Vec;
+               l_v_LU_Vec *= l_valid_Vec;
+               l_v_Vec    *= l_valid_Vec;
+            }
+
+            VecUtils::store(l_v_CU_Vec, m_v_CU + l_offset + l_row + j, V);
+            VecUtils::store(l_v_RU_Vec, m_v_RU + l_offset + l_row + j, V);
+            VecUtils::store(l_v_LU_Vec, m_v_LU + l_offset + l_row + j, V);
+            VecUtils::store(l_v_Vec,    m_v    + l_offset + l_row + j, V);
+
+            l_g_prev_Vec = l_g_Vec;
+            l_g_Vec      = l_g_next_Vec;
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+void CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   #pragma omp for nowait schedule(static)
+   for (std::size_t l_brick=0; l_brick<m_layout.bricks(); ++l_brick)
+   {
+      applyBrick(p_x, p_y, l_brick);
+   }
+
+   #pragma omp barrier
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+inline void CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::applyBrick(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_brick) const
+{
+   constexpr std::size_t B = BrickSize;
+   constexpr std::size_t V = VecType::size();
+
+   std::size_t l_offset = p_brick * Layout::BRICK_CELLS;
+
+   std::ptrdiff_t l_nb_CL = m_layout.neighbour(p_brick, Layout::NB_CL);
+   std::ptrdiff_t l_nb_CU = m_layout.neighbour(p_brick, Layout::NB_CU);
+   std::ptrdiff_t l_nb_RL = m_layout.neighbour(p_brick, Layout::NB_RL);
+   std::ptrdiff_t l_nb_RU = m_layout.neighbour(p_brick, Layout::NB_RU);
+   std::ptrdiff_t l_nb_LL = m_layout.neighbour(p_brick, Layout::NB_LL);
+   std::ptrdiff_t l_nb_LU = m_layout.neighbour(p_brick, Layout::NB_LU);
+
+   //
+   // NOTE offsets of the rows below/above relative to the brick
+   //
+   std::ptrdiff_t l_pos;
+   std::ptrdiff_t l_pos_RL;
+   std::ptrdiff_t l_pos_RU;
+   std::ptrdiff_t l_pos_LL;
+   std::ptrdiff_t l_pos_LU;
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_x_prev_Vec;
+   VecType l_x_next_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_v_LL_Vec;
+   VecType l_v_RL_Vec;
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec;
+   VecType l_v_LU_Vec;
+
+   VecType l_v_CU_prev_Vec;
+
+   for (std::size_t l=0; l<B; ++l)
+   {
+      for (std::size_t r=0; r<B; ++r)
+      {
+         l_pos    = std::ptrdiff_t(l_offset + (l*B + r)*B);
+         l_pos_RL = r > 0   ? l_pos - std::ptrdiff_t(B)   : l_nb_RL + std::ptrdiff_t((l*B + B-1)*B);
+         l_pos_RU = r < B-1 ? l_pos + std::ptrdiff_t(B)   : l_nb_RU + std::ptrdiff_t(l*B*B);
+         l_pos_LL = l > 0   ? l_pos - std::ptrdiff_t(B*B) : l_nb_LL + std::ptrdiff_t(((B-1)*B + r)*B);
+         l_pos_LU = l < B-1 ? l_pos + std::ptrdiff_t(B*B) : l_nb_LU + std::ptrdiff_t(r*B);
+
+         VecUtils::load(l_x_prev_Vec,    p_x    + l_nb_CL + std::ptrdiff_t((l*B + r)*B + B - V), V);
+         VecUtils::load(l_v_CU_prev_Vec, m_v_CU + l_nb_CL + std::ptrdiff_t((l*B + r)*B + B - V), V);
+         VecUtils::load(l_x_Vec,         p_x    + l_pos,                                         V);
+
+         for (std::size_t j=0; j<B; j+=V)
+         {
+            VecUtils::load(l_x_next_Vec, p_x + (j+V < B ? l_pos + std::ptrdiff_t(j+V) : l_nb_CU + std::ptrdiff_t((l*B + r)*B)), V);
+
+            l_x_CL_Vec = VecUtils::shiftLow(l_x_prev_Vec, l_x_Vec);
+            l_x_CU_Vec = VecUtils::shiftHigh(l_x_Vec, l_x_next_Vec);
+
+            VecUtils::load(l_x_LL_Vec, p_x + l_pos_LL + j, V);
+            VecUtils::load(l_x_RL_Vec, p_x + l_pos_RL + j, V);
+            VecUtils::load(l_x_RU_Vec, p_x + l_pos_RU + j, V);
+            VecUtils::load(l_x_LU_Vec, p_x + l_pos_LU + j, V);
+
+            VecUtils::load(l_v_CU_Vec, m_v_CU + l_pos    + j, V);
+            VecUtils::load(l_v_RU_Vec, m_v_RU + l_pos    + j, V);
+            VecUtils::load(l_v_LU_Vec, m_v_LU + l_pos    + j, V);
+            VecUtils::load(l_v_RL_Vec, m_v_RU + l_pos_RL + j, V);
+            VecUtils::load(l_v_LL_Vec, m_v_LU + l_pos_LL + j, V);
+            VecUtils::load(l_v_Vec,    m_v    + l_pos    + j, V);
+
+            l_v_CL_Vec = VecUtils::shiftLow(l_v_CU_prev_Vec, l_v_CU_Vec);
+
+            l_y_Vec =
+               l_v_Vec    * l_x_Vec
+            -  l_v_LL_Vec * l_x_LL_Vec
+            -  l_v_RL_Vec * l_x_RL_Vec
+            -  l_v_CL_Vec * l_x_CL_Vec
+            -  l_v_CU_Vec * l_x_CU_Vec
+            -  l_v_RU_Vec * l_x_RU_Vec
+            -  l_v_LU_Vec * l_x_LU_Vec
+            ;
+            VecUtils::store(l_y_Vec, p_y + l_pos + j, V);
+
+            l_x_prev_Vec    = l_x_Vec;
+            l_x_Vec         = l_x_next_Vec;
+            l_v_CU_prev_Vec = l_v_CU_Vec;
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+bool CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::diagonal(ValueType * __restrict__ p_d) const
+{
+   //
+   // NOTE the stored bricked diagonal, zero for the padding cells
+   //
+   VecType l_v_Vec;
+
+   #pragma omp for schedule(static)
+   for (std::size_t l_brick=0; l_brick<m_layout.bricks(); ++l_brick)
+   {
+      std::size_t l_offset = l_brick * Layout::BRICK_CELLS;
+
+      for (std::size_t i=0; i<Layout::BRICK_CELLS; i+=VecType::size())
+      {
+         VecUtils::load(l_v_Vec, m_v + l_offset + i, VecType::size());
+         VecUtils::store(l_v_Vec, p_d + l_offset + i, VecType::size());
+      }
+   }
+
+   return true;
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t BrickSize>
+CNonlinearStencilPrecalcBricked<StateFunc, ValueType, VecType, BrickSize>::~CNonlinearStencilPrecalcBricked()
+{
+   CAllocator::deallocate(m_v_raw);
+   CAllocator::deallocate(m_g_raw);
+}
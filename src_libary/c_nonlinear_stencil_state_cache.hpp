@@ -0,0 +1,363 @@
+/*
+ * Stores only the transformed state g = f(s) (with a halo of one level on
+ * both sides), apply computes the harmonic means of the faces from g.
+ *
+ * In between CNonlinearStencil (nothing stored, f evaluated for all seven
+ * points) and CNonlinearStencilPrecalc (face coefficients and diagonal
+ * stored): apply streams x, y and g, setState is a single vectorized pass
+ * over s. The result is bit-identical to CNonlinearStencil.
+ *
+ * RowBlock > 1: unroll-and-jam over rows, RowBlock rows are computed per
+ * column vector and share the loaded x and g vectors of the rows in between,
+ * see CLinearStencilNonconstCoeff. Results are bit-identical.
+ *
+ * MemoryPolicy: streaming stores of y and prefetch of the LL/LU planes of
+ * x, see CMemoryPolicy.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <omp.h>
+#include "i_nonlinear_operator.hpp"
+#include "c_vec_utils.hpp"
+#include "c_memory_policy.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock = 1, typename MemoryPolicy = CMemoryPolicy<>>
+class CNonlinearStencilStateCache : public INonlinearOperator<ValueType>
+{
+ private:
+    using VecUtils = CVecUtils<ValueType, VecType>;
+
+    std::size_t m_objCols;
+    std::size_t m_objRows;
+    std::size_t m_objLevels;
+    std::size_t m_objSize1d;
+    std::size_t m_objSize2d;
+    std::size_t m_objSize3d;
+    const ValueType m_factor;
+    const ValueType m_epsilon;
+    ValueType * m_g_raw;
+    ValueType * m_g;
+
+    template <std::size_t Rows>
+    void applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const;
+
+ public:
+    CNonlinearStencilStateCache(
+      const std::size_t p_objCols,
+      const std::size_t p_objRows,
+      const std::size_t p_objLevels,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    CNonlinearStencilStateCache(
+      const CGridLayout & p_layout,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+    CNonlinearStencilStateCache(const CNonlinearStencilStateCache &) = delete;
+    CNonlinearStencilStateCache & operator=(const CNonlinearStencilStateCache &) = delete;
+      static_assert(RowBlock >= 1, "RowBlock has to be >= 1");
+      inline static const std::string IDENTIFER =
+         std::string("nonlinear_stencil_state_cache")
+         + (RowBlock > 1 ? "_rows_" + std::to_string(RowBlock) : "")
+         + MemoryPolicy::IDENTIFER;
+    void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    void setState(const ValueType * __restrict__ p_s);
+    bool diagonal(ValueType * __restrict__ p_d) const;
+    ~CNonlinearStencilStateCache();
+};
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+CNonlinearStencilStateCache<StateFunc, ValueType, VecType, RowBlock, MemoryPolicy>::CNonlinearStencilStateCache(
+   const std::size_t p_objCols,
+   const std::size_t p_objRows,
+   const std::size_t p_objLevels,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+CNonlinearStencilStateCache(CGridLayout(p_objCols, p_objRows, p_objLevels), p_s, p_h, p_tau, p_epsilon)
+{
+
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+CNonlinearStencilStateCache<StateFunc, ValueType, VecType, RowBlock, MemoryPolicy>::CNonlinearStencilStateCache(
+   const CGridLayout & p_layout,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+m_objCols(p_layout.objCols()),
+m_objRows(p_layout.objRows()),
+m_objLevels(p_layout.objLevels()),
+m_objSize1d(p_layout.objSize1d()),
+m_objSize2d(p_layout.objSize2d()),
+m_objSize3d(p_layout.objSize3d()),
+m_factor(p_tau/(p_h*p_h)),
+m_epsilon(p_epsilon)
+{
+   //
+   // NOTE the halo levels are only read with a zero factor
+   //
+   m_g_raw = CAllocator::allocate<ValueType>(m_objSize3d+2*m_objSize2d);
+   m_g = &(m_g_raw[m_objSize2d]);
+
+   //
+   // first touch
+   //
+   #pragma omp parallel
+   {
+      CAllocator::firstTouch(m_g, m_objSize3d, m_objSize2d);
+      #pragma omp for
+      for (std::size_t i = 0; i < m_objSize2d; ++i)
+      {
+         m_g_raw[i] = ValueType(0);
+         m_g_raw[m_objSize3d+m_objSize2d+i] = ValueType(0);
+      }
+   }
+
+   setState(p_s);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+void CNonlinearStencilStateCache<StateFunc, ValueType, VecType, RowBlock, MemoryPolicy>::setState(const ValueType * __restrict__ p_s)
+{
+   #pragma omp parallel
+   {
+      const ValueType * l_s;
+      ValueType * l_g;
+      std::size_t l_n;
+
+      VecType l_s_Vec;
+
+      #pragma omp for
+      for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+      {
+         l_s = p_s + l_pos_L * m_objSize2d;
+         l_g = m_g + l_pos_L * m_objSize2d;
+
+         for (std::size_t l_pos=0; l_pos<m_objSize2d; l_pos+=VecType::size())
+         {
+            l_n = VecUtils::lanesValid(l_pos, m_objSize2d);
+
+            VecUtils::load(l_s_Vec, l_s + l_pos, l_n);
+            StateFunc<VecType>::apply(l_s_Vec);
+            VecUtils::store(l_s_Vec, l_g + l_pos, l_n);
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+void CNonlinearStencilStateCache<StateFunc, ValueType, VecType, RowBlock, MemoryPolicy>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   std::size_t l_pos_R;
+
+   #pragma omp for nowait
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (l_pos_R=0; l_pos_R+RowBlock<=m_objRows; l_pos_R+=RowBlock)
+      {
+         applyRows<RowBlock>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+      for (; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         applyRows<1>(p_x, p_y, l_pos_L, l_pos_R);
+      }
+   }
+
+   MemoryPolicy::fence();
+   #pragma omp barrier
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+template <std::size_t Rows>
+inline void CNonlinearStencilStateCache<StateFunc, ValueType, VecType, RowBlock, MemoryPolicy>::applyRows(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y, const std::size_t p_pos_L, const std::size_t p_pos_R) const
+{
+   std::size_t l_pos;
+   std::size_t l_pos_0;
+   std::size_t l_pos_R;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_factor_LL_Vec;
+   VecType l_factor_RL_Vec;
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec;
+   VecType l_factor_LU_Vec;
+
+   VecType l_mask_CL_Vec;
+   VecType l_mask_CU_Vec;
+
+   //
+   // NOTE x and g of the rows p_pos_R-1, ..., p_pos_R+Rows
+   //
+   VecType l_x_R_Vec[Rows+2];
+   VecType l_c_R_Vec[Rows+2];
+
+   VecType l_x_LL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_LU_Vec;
+
+   for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+   {
+      l_pos_0 = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d + l_pos_C;
+      l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+      l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+      l_mask_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_mask_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+      for (std::size_t k=0; k<Rows+2; ++k)
+      {
+         VecUtils::load(l_x_R_Vec[k], p_x + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+         VecUtils::load(l_c_R_Vec[k], m_g + l_pos_0 + k * m_objSize1d - m_objSize1d, l_n);
+      }
+
+      for (std::size_t b=0; b<Rows; ++b)
+      {
+         l_pos = l_pos_0 + b * m_objSize1d;
+         l_pos_R = p_pos_R + b;
+
+         MemoryPolicy::prefetch(p_x + l_pos - m_objSize2d);
+         MemoryPolicy::prefetch(p_x + l_pos + m_objSize2d);
+
+         VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+         VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+         VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+         VecUtils::load(l_c_LL_Vec, m_g + l_pos - m_objSize2d, l_n);
+         VecUtils::load(l_c_CL_Vec, m_g + l_pos - 1          , l_n);
+         VecUtils::load(l_c_CU_Vec, m_g + l_pos + 1          , l_n);
+         VecUtils::load(l_c_LU_Vec, m_g + l_pos + m_objSize2d, l_n);
+
+         l_factor_CL_Vec = l_mask_CL_Vec;
+         l_factor_CU_Vec = l_mask_CU_Vec;
+
+         l_factor_LL_Vec = (1-((m_objLevels-1-p_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_R_Vec[b+1] * l_c_LL_Vec     / (l_c_R_Vec[b+1]+l_c_LL_Vec    +m_epsilon);
+         l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_R_Vec[b+1] * l_c_R_Vec[b]   / (l_c_R_Vec[b+1]+l_c_R_Vec[b]  +m_epsilon);
+         l_factor_CL_Vec *=                                                           2 * l_c_R_Vec[b+1] * l_c_CL_Vec     / (l_c_R_Vec[b+1]+l_c_CL_Vec    +m_epsilon);
+         l_factor_CU_Vec *=                                                           2 * l_c_R_Vec[b+1] * l_c_CU_Vec     / (l_c_R_Vec[b+1]+l_c_CU_Vec    +m_epsilon);
+         l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_R_Vec[b+1] * l_c_R_Vec[b+2] / (l_c_R_Vec[b+1]+l_c_R_Vec[b+2]+m_epsilon);
+         l_factor_LU_Vec = (1-(p_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_R_Vec[b+1] * l_c_LU_Vec     / (l_c_R_Vec[b+1]+l_c_LU_Vec    +m_epsilon);
+
+         l_y_Vec =
+                  ( 1                +
+                     l_factor_LL_Vec +
+                     l_factor_RL_Vec +
+                     l_factor_CL_Vec +
+                     l_factor_CU_Vec +
+                     l_factor_RU_Vec +
+                     l_factor_LU_Vec
+                  )                  * l_x_R_Vec[b+1]
+               - l_factor_LL_Vec     * l_x_LL_Vec
+               - l_factor_RL_Vec     * l_x_R_Vec[b]
+               - l_factor_CL_Vec     * l_x_CL_Vec
+               - l_factor_CU_Vec     * l_x_CU_Vec
+               - l_factor_RU_Vec     * l_x_R_Vec[b+2]
+               - l_factor_LU_Vec     * l_x_LU_Vec;
+         MemoryPolicy::store(l_y_Vec, p_y + l_pos, l_n);
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+bool CNonlinearStencilStateCache<StateFunc, ValueType, VecType, RowBlock, MemoryPolicy>::diagonal(ValueType * __restrict__ p_d) const
+{
+   //
+   // NOTE computed on the fly from g with the factors of apply
+   //
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   VecType l_pos_C_Vec;
+
+   VecType l_lane_Vec = VecUtils::lanes();
+
+   VecType l_factor_LL_Vec;
+   VecType l_factor_RL_Vec;
+   VecType l_factor_CL_Vec;
+   VecType l_factor_CU_Vec;
+   VecType l_factor_RU_Vec;
+   VecType l_factor_LU_Vec;
+
+   VecType l_c_LL_Vec;
+   VecType l_c_RL_Vec;
+   VecType l_c_CL_Vec;
+   VecType l_c_Vec;
+   VecType l_c_CU_Vec;
+   VecType l_c_RU_Vec;
+   VecType l_c_LU_Vec;
+
+   VecType l_d_Vec;
+
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+         {
+            l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+            VecUtils::load(l_c_LL_Vec, m_g + l_pos - m_objSize2d, l_n);
+            VecUtils::load(l_c_RL_Vec, m_g + l_pos - m_objSize1d, l_n);
+            VecUtils::load(l_c_CL_Vec, m_g + l_pos - 1          , l_n);
+            VecUtils::load(l_c_Vec,    m_g + l_pos              , l_n);
+            VecUtils::load(l_c_CU_Vec, m_g + l_pos + 1          , l_n);
+            VecUtils::load(l_c_RU_Vec, m_g + l_pos + m_objSize1d, l_n);
+            VecUtils::load(l_c_LU_Vec, m_g + l_pos + m_objSize2d, l_n);
+
+            l_factor_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+            l_factor_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+            l_factor_LL_Vec = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LL_Vec / (l_c_Vec+l_c_LL_Vec+m_epsilon);
+            l_factor_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RL_Vec / (l_c_Vec+l_c_RL_Vec+m_epsilon);
+            l_factor_CL_Vec *=                                                           2 * l_c_Vec * l_c_CL_Vec / (l_c_Vec+l_c_CL_Vec+m_epsilon);
+            l_factor_CU_Vec *=                                                           2 * l_c_Vec * l_c_CU_Vec / (l_c_Vec+l_c_CU_Vec+m_epsilon);
+            l_factor_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_c_Vec * l_c_RU_Vec / (l_c_Vec+l_c_RU_Vec+m_epsilon);
+            l_factor_LU_Vec = (1-(l_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_c_Vec * l_c_LU_Vec / (l_c_Vec+l_c_LU_Vec+m_epsilon);
+
+            l_d_Vec = 1 + l_factor_LL_Vec + l_factor_RL_Vec + l_factor_CL_Vec + l_factor_CU_Vec + l_factor_RU_Vec + l_factor_LU_Vec;
+            VecUtils::store(l_d_Vec, p_d + l_pos, l_n);
+         }
+      }
+   }
+
+   return true;
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, std::size_t RowBlock, typename MemoryPolicy>
+CNonlinearStencilStateCache<StateFunc, ValueType, VecType, RowBlock, MemoryPolicy>::~CNonlinearStencilStateCache()
+{
+   CAllocator::deallocate(m_g_raw);
+}
@@ -0,0 +1,365 @@
+/*
+*
+*  CG with Jacobi (diagonal) preconditioner M = diag(A)
+*
+*  the inverse diagonal is taken from p_A.diagonal() at the start of every
+*  solve, operators without a diagonal run unpreconditioned (M = I, same
+*  iterates as CCG). z = M^-1 r is not stored: it is applied within the
+*  x/r update (rho = r * M^-1 r in the same pass as the norm2 of r) and the
+*  p update (p = M^-1 r + beta * p)
+*
+*  4 barriers within the loop as in CCG, the reduction variables are reset
+*  by the master between two barriers, where no thread reads or combines
+*  into them
+*
+*  the stopping criterion is the norm2 of r as in CCG (not r * M^-1 r), so
+*  the iteration counts of both solvers are comparable
+*
+*  p, r, upsilon and the inverse diagonal are kept in a CWorkspace between
+*  the calls, see CCG
+*
+*  with an IPreconditioner (e.g. CMultigrid) z = M^-1 r is computed by the
+*  preconditioner into the slot of the inverse diagonal, r * z is one more
+*  reduction after it (5 barriers + those of the preconditioner). The
+*  preconditioner is not applied to the last residual
+*
+*/
+
+#pragma once
+
+#include <omp.h>
+#include <string>
+#include "i_linear_operator.hpp"
+#include "i_solver.hpp"
+#include "i_preconditioner.hpp"
+#include "c_workspace.hpp"
+
+template <typename ValueType, typename AccumulatorType = double>
+class CPCG: public ISolver<ValueType>
+{
+    private:
+        mutable CWorkspace<ValueType, 4> m_workspace;
+        const IPreconditioner<ValueType> * m_preconditioner;
+
+        std::size_t solvePreconditioned(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const;
+
+    public:
+        inline static const std::string IDENTIFER = "pcg";
+
+        //
+        // NOTE nullptr: Jacobi, p_preconditioner is not owned
+        //
+        CPCG(const IPreconditioner<ValueType> * p_preconditioner = nullptr): m_preconditioner(p_preconditioner) {}
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const;
+        const CWorkspace<ValueType, 4> & workspace() const { return m_workspace; }
+};
+
+template <typename ValueType, typename AccumulatorType>
+std::size_t CPCG<ValueType, AccumulatorType>::operator()(
+    const std::size_t p_size,
+    const ILinearOperator<ValueType> & p_A,
+    const ValueType * __restrict__ p_x_0,
+    const ValueType * __restrict__ p_b,
+    ValueType * __restrict__ p_x_1,
+    const ValueType p_epsilon,
+    const std::size_t p_iterMax,
+    const std::size_t p_bufferSize
+) const
+{
+    if (m_preconditioner != nullptr)
+    {
+        return solvePreconditioned(p_size, p_A, p_x_0, p_b, p_x_1, p_epsilon, p_iterMax, p_bufferSize);
+    }
+
+    std::size_t l_iter;
+    AccumulatorType l_lambda = 0.;
+    AccumulatorType l_rho_0 = 0.;
+    AccumulatorType l_rho_1 = 0.;
+    AccumulatorType l_alpha_0 = 0.;
+    AccumulatorType l_alpha_1 = 0.;
+
+    m_workspace.reserve(p_size, p_bufferSize);
+
+    ValueType * l_p = m_workspace.vector(0);
+    ValueType * l_r = m_workspace.vector(1);
+    ValueType * l_upsilon = m_workspace.vector(2);
+    ValueType * l_dinv = m_workspace.vector(3);
+
+    #pragma omp parallel
+    {
+        std::size_t l_iter_t = 0;
+        bool l_diagonal_t;
+        AccumulatorType l_rho_0_t;
+        AccumulatorType l_rho_1_t;
+        AccumulatorType l_alpha_0_t;
+        ValueType l_lambda_t;
+        ValueType l_beta_t;
+
+        //
+        // NOTE padding cells of a padded grid (CGridLayout) are not written
+        //      by diagonal(), their (stale) inverse diagonal only meets the
+        //      zero padding cells of r
+        //
+        l_diagonal_t = p_A.diagonal(l_dinv);
+
+        p_A.apply(p_x_0,l_r);
+        #pragma omp barrier
+        // --------------------------------------------------------------------
+
+        #pragma omp for reduction(+: l_rho_0, l_alpha_0)
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            l_dinv[i] = l_diagonal_t ? (l_dinv[i] != ValueType(0) ? ValueType(1) / l_dinv[i] : ValueType(0)) : ValueType(1);
+            p_x_1[i] = p_x_0[i];
+            l_r[i] = p_b[i] - l_r[i];
+            l_p[i] = l_dinv[i] * l_r[i];
+            l_rho_0 += AccumulatorType(l_r[i]) * l_p[i];
+            l_alpha_0 += AccumulatorType(l_r[i]) * l_r[i];
+        }
+        // --------------------------------------------------------------------
+
+        l_rho_0_t = l_rho_0;
+        l_alpha_0_t = l_alpha_0;
+
+        while(l_iter_t < p_iterMax)
+        {
+            if(l_alpha_0_t < p_epsilon)
+            {
+                break;
+            }
+
+            p_A.apply(l_p,l_upsilon);
+            #pragma omp barrier
+            // --------------------------------------------------------------------
+
+            //
+            // NOTE all threads have read l_rho_1 and l_alpha_1 of the last
+            //      iteration before the barrier of the p update
+            //
+            #pragma omp master
+            {
+                l_rho_1 = 0.;
+                l_alpha_1 = 0.;
+            }
+
+            //
+            // Note: dot prod
+            //
+            #pragma omp for reduction(+: l_lambda)
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                l_lambda += AccumulatorType(l_upsilon[i]) * l_p[i];
+            }
+            // --------------------------------------------------------------------
+            l_lambda_t = ValueType(l_rho_0_t / l_lambda);
+
+            //
+            // NOTE x/r update, r * M^-1 r and norm2 of r in one pass
+            //
+            #pragma omp for reduction(+: l_rho_1, l_alpha_1)
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                p_x_1[i] = p_x_1[i] + l_lambda_t * l_p[i];
+                l_r[i] = l_r[i] - l_lambda_t * l_upsilon[i];
+                l_rho_1 += AccumulatorType(l_r[i]) * (l_dinv[i] * l_r[i]);
+                l_alpha_1 += AccumulatorType(l_r[i]) * l_r[i];
+            }
+            // --------------------------------------------------------------------
+            l_rho_1_t = l_rho_1;
+            l_alpha_0_t = l_alpha_1;
+
+            #pragma omp master
+            {
+                l_lambda = 0.;
+            }
+
+            l_beta_t = ValueType(l_rho_1_t / l_rho_0_t);
+
+            #pragma omp for
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                l_p[i] = l_dinv[i] * l_r[i] + l_beta_t * l_p[i];
+            }
+            // --------------------------------------------------------------------
+
+            l_rho_0_t = l_rho_1_t;
+            l_iter_t++;
+        }
+
+        #pragma omp master
+        {
+            l_iter = l_iter_t;
+        }
+    }
+
+    return(l_iter);
+}
+
+template <typename ValueType, typename AccumulatorType>
+std::size_t CPCG<ValueType, AccumulatorType>::solvePreconditioned(
+    const std::size_t p_size,
+    const ILinearOperator<ValueType> & p_A,
+    const ValueType * __restrict__ p_x_0,
+    const ValueType * __restrict__ p_b,
+    ValueType * __restrict__ p_x_1,
+    const ValueType p_epsilon,
+    const std::size_t p_iterMax,
+    const std::size_t p_bufferSize
+) const
+{
+    std::size_t l_iter;
+    AccumulatorType l_lambda = 0.;
+    AccumulatorType l_rho_0 = 0.;
+    AccumulatorType l_rho_1 = 0.;
+    AccumulatorType l_alpha_0 = 0.;
+    AccumulatorType l_alpha_1 = 0.;
+
+    m_workspace.reserve(p_size, p_bufferSize);
+    m_preconditioner->reserve(p_size, p_bufferSize);
+
+    ValueType * l_p = m_workspace.vector(0);
+    ValueType * l_r = m_workspace.vector(1);
+    ValueType * l_upsilon = m_workspace.vector(2);
+    ValueType * l_z = m_workspace.vector(3);
+
+    #pragma omp parallel
+    {
+        std::size_t l_iter_t = 0;
+        AccumulatorType l_rho_0_t;
+        AccumulatorType l_rho_1_t;
+        AccumulatorType l_alpha_0_t;
+        ValueType l_lambda_t;
+        ValueType l_beta_t;
+
+        m_preconditioner->setup(p_A);
+
+        p_A.apply(p_x_0,l_r);
+        #pragma omp barrier
+        // --------------------------------------------------------------------
+
+        #pragma omp for reduction(+: l_alpha_0)
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            p_x_1[i] = p_x_0[i];
+            l_r[i] = p_b[i] - l_r[i];
+            l_alpha_0 += AccumulatorType(l_r[i]) * l_r[i];
+        }
+        // --------------------------------------------------------------------
+
+        m_preconditioner->apply(p_A, l_r, l_z);
+
+        #pragma omp for reduction(+: l_rho_0)
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            l_p[i] = l_z[i];
+            l_rho_0 += AccumulatorType(l_r[i]) * l_z[i];
+        }
+        // --------------------------------------------------------------------
+
+        l_rho_0_t = l_rho_0;
+        l_alpha_0_t = l_alpha_0;
+
+        while(l_iter_t < p_iterMax)
+        {
+            if(l_alpha_0_t < p_epsilon)
+            {
+                break;
+            }
+
+            p_A.apply(l_p,l_upsilon);
+            #pragma omp barrier
+            // --------------------------------------------------------------------
+
+            //
+            // NOTE all threads have read l_rho_1 and l_alpha_1 of the last
+            //      iteration before the barrier of the p update
+            //
+            #pragma omp master
+            {
+                l_rho_1 = 0.;
+                l_alpha_1 = 0.;
+            }
+
+            //
+            // Note: dot prod
+            //
+            #pragma omp for reduction(+: l_lambda)
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                l_lambda += AccumulatorType(l_upsilon[i]) * l_p[i];
+            }
+            // --------------------------------------------------------------------
+            l_lambda_t = ValueType(l_rho_0_t / l_lambda);
+
+            #pragma omp for reduction(+: l_alpha_1)
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                p_x_1[i] = p_x_1[i] + l_lambda_t * l_p[i];
+                l_r[i] = l_r[i] - l_lambda_t * l_upsilon[i];
+                l_alpha_1 += AccumulatorType(l_r[i]) * l_r[i];
+            }
+            // --------------------------------------------------------------------
+            l_alpha_0_t = l_alpha_1;
+            l_iter_t++;
+
+            #pragma omp master
+            {
+                l_lambda = 0.;
+            }
+
+            //
+            // NOTE same decision on all threads (l_alpha_1 is complete)
+            //
+            if(l_alpha_0_t < p_epsilon)
+            {
+                break;
+            }
+
+            m_preconditioner->apply(p_A, l_r, l_z);
+
+            #pragma omp for reduction(+: l_rho_1)
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                l_rho_1 += AccumulatorType(l_r[i]) * l_z[i];
+            }
+            // --------------------------------------------------------------------
+            l_rho_1_t = l_rho_1;
+
+            l_beta_t = ValueType(l_rho_1_t / l_rho_0_t);
+
+            #pragma omp for
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                l_p[i] = l_z[i] + l_beta_t * l_p[i];
+            }
+            // --------------------------------------------------------------------
+
+            l_rho_0_t = l_rho_1_t;
+        }
+
+        #pragma omp master
+        {
+            l_iter = l_iter_t;
+        }
+    }
+
+    return(l_iter);
+}
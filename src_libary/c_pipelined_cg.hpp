@@ -0,0 +1,273 @@
+/*
+*
+*  pipelined CG (Ghysels, Vanroose)
+*
+*  the recurrences w = A r, z = A s, s = A p are carried along with r and p,
+*  so q = A w is the only apply of an iteration and all vector updates
+*  and both dot products (gamma = r * r, delta = w * r) are one fused
+*  loop. The dot products of the fused loop are the input of the next
+*  iteration: every thread starts p_A.apply(w, q) right after it has
+*  summed them, the only waits of an iteration are the barrier of apply
+*  and the one after the fused loop (2 barriers, 4 in CCG)
+*
+*  the dot products are not omp reductions: every thread writes its partial
+*  sums to a padded slot of m_partial and sums all slots in the same order
+*  after the barrier (all threads get the same, bitwise identical values).
+*  The slots are used alternately by consecutive iterations, a slot is only
+*  overwritten after the apply barrier, when every thread has read it, so
+*  no master reset and no extra barrier is needed
+*
+*  the recurrences of w, z and s accumulate rounding errors, the recursive
+*  r drifts away from b - A x and the attainable accuracy is worse than
+*  with CCG. Every m_replacement iterations r, w, s and z are replaced by
+*  their definitions (4 applies), 0 disables the replacement
+*
+*  the stopping criterion is the norm2 of r as in CCG, the iteration
+*  counts of both solvers are comparable
+*
+*  r, w, q, z, s and p are kept in a CWorkspace between the calls, see CCG
+*  (6 vectors instead of 3)
+*
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <omp.h>
+#include <string>
+#include "i_linear_operator.hpp"
+#include "i_solver.hpp"
+#include "c_workspace.hpp"
+#include "c_allocator.hpp"
+
+template <typename ValueType, typename AccumulatorType = double>
+class CPipelinedCG: public ISolver<ValueType>
+{
+    private:
+        //
+        // NOTE partial sums of a thread: gamma, delta, padded to 64 bytes,
+        //      m_partial is cache line aligned (CAllocator)
+        //
+        static constexpr std::size_t PARTIAL_STRIDE = 64 / sizeof(AccumulatorType) < 2 ? 2 : 64 / sizeof(AccumulatorType);
+
+        mutable CWorkspace<ValueType, 6> m_workspace;
+        mutable AccumulatorType * m_partial;
+        mutable std::size_t m_partialThreads;
+        const std::size_t m_replacement;
+
+    public:
+        inline static const std::string IDENTIFER = "pipelined_cg";
+
+        CPipelinedCG(const std::size_t p_replacement = 50): m_partial(nullptr), m_partialThreads(0), m_replacement(p_replacement) {}
+        CPipelinedCG(const CPipelinedCG &) = delete;
+        CPipelinedCG & operator=(const CPipelinedCG &) = delete;
+
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const;
+        const CWorkspace<ValueType, 6> & workspace() const { return m_workspace; }
+
+        ~CPipelinedCG() { CAllocator::deallocate(m_partial); }
+};
+
+template <typename ValueType, typename AccumulatorType>
+std::size_t CPipelinedCG<ValueType, AccumulatorType>::operator()(
+    const std::size_t p_size,
+    const ILinearOperator<ValueType> & p_A,
+    const ValueType * __restrict__ p_x_0,
+    const ValueType * __restrict__ p_b,
+    ValueType * __restrict__ p_x_1,
+    const ValueType p_epsilon,
+    const std::size_t p_iterMax,
+    const std::size_t p_bufferSize
+) const
+{
+    std::size_t l_iter;
+
+    m_workspace.reserve(p_size, p_bufferSize);
+
+    //
+    // NOTE 2 slots (even and odd iterations) per thread
+    //
+    std::size_t l_threads = omp_get_max_threads();
+
+    if (l_threads > m_partialThreads)
+    {
+        CAllocator::deallocate(m_partial);
+        m_partial = CAllocator::allocate<AccumulatorType>(2 * l_threads * PARTIAL_STRIDE);
+        m_partialThreads = l_threads;
+    }
+
+    ValueType * l_r = m_workspace.vector(0);
+    ValueType * l_w = m_workspace.vector(1);
+    ValueType * l_q = m_workspace.vector(2);
+    ValueType * l_z = m_workspace.vector(3);
+    ValueType * l_s = m_workspace.vector(4);
+    ValueType * l_p = m_workspace.vector(5);
+    AccumulatorType * l_partial = m_partial;
+
+    #pragma omp parallel
+    {
+        std::size_t l_thread_id = omp_get_thread_num();
+        std::size_t l_threads_t = omp_get_num_threads();
+        std::size_t l_iter_t = 0;
+        std::size_t l_slot_t = 0;
+        AccumulatorType l_gamma_t;
+        AccumulatorType l_delta_t;
+        AccumulatorType l_gamma_0_t = 0.;
+        AccumulatorType l_alpha_0_t = 0.;
+        ValueType l_alpha_t;
+        ValueType l_beta_t;
+
+        p_A.apply(p_x_0,l_r);
+        // --------------------------------------------------------------------
+
+        #pragma omp for
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            p_x_1[i] = p_x_0[i];
+            l_r[i] = p_b[i] - l_r[i];
+            l_z[i] = 0;
+            l_s[i] = 0;
+            l_p[i] = 0;
+        }
+        // --------------------------------------------------------------------
+
+        p_A.apply(l_r,l_w);
+        // --------------------------------------------------------------------
+
+        l_gamma_t = 0.;
+        l_delta_t = 0.;
+
+        #pragma omp for nowait
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            l_gamma_t += AccumulatorType(l_r[i]) * l_r[i];
+            l_delta_t += AccumulatorType(l_w[i]) * l_r[i];
+        }
+        l_partial[(l_slot_t * l_threads_t + l_thread_id) * PARTIAL_STRIDE + 0] = l_gamma_t;
+        l_partial[(l_slot_t * l_threads_t + l_thread_id) * PARTIAL_STRIDE + 1] = l_delta_t;
+
+        #pragma omp barrier
+        // --------------------------------------------------------------------
+
+        while(l_iter_t < p_iterMax)
+        {
+            l_gamma_t = 0.;
+            l_delta_t = 0.;
+
+            for(std::size_t t = 0; t < l_threads_t; ++t)
+            {
+                l_gamma_t += l_partial[(l_slot_t * l_threads_t + t) * PARTIAL_STRIDE + 0];
+                l_delta_t += l_partial[(l_slot_t * l_threads_t + t) * PARTIAL_STRIDE + 1];
+            }
+
+            if(l_gamma_t < p_epsilon)
+            {
+                break;
+            }
+
+            //
+            // NOTE q = A w while the other threads may still sum the partials
+            //      of l_slot_t, the barrier of apply is the last read of it
+            //
+            p_A.apply(l_w,l_q);
+            // --------------------------------------------------------------------
+
+            //
+            // NOTE p * A p = delta - beta * gamma / alpha_0 is not positive
+            //      only if the recurrences have lost too much accuracy (e.g.
+            //      float on a high contrast), the iteration restarts with
+            //      p = r then (all threads take the same branch)
+            //
+            AccumulatorType l_beta = l_iter_t == 0 ? 0. : l_gamma_t / l_gamma_0_t;
+            AccumulatorType l_pAp = l_delta_t - l_beta * l_gamma_t / l_alpha_0_t;
+
+            if(l_iter_t == 0 || !(l_pAp > 0))
+            {
+                l_beta = 0.;
+                l_pAp = l_delta_t;
+            }
+            l_beta_t = ValueType(l_beta);
+            l_alpha_0_t = l_gamma_t / l_pAp;
+            l_alpha_t = ValueType(l_alpha_0_t);
+            l_gamma_0_t = l_gamma_t;
+            l_slot_t = 1 - l_slot_t;
+            l_iter_t++;
+
+            l_gamma_t = 0.;
+            l_delta_t = 0.;
+
+            #pragma omp for nowait
+            for(std::size_t i = 0; i < p_size; ++i)
+            {
+                l_z[i] = l_q[i] + l_beta_t * l_z[i];
+                l_s[i] = l_w[i] + l_beta_t * l_s[i];
+                l_p[i] = l_r[i] + l_beta_t * l_p[i];
+                p_x_1[i] = p_x_1[i] + l_alpha_t * l_p[i];
+                l_r[i] = l_r[i] - l_alpha_t * l_s[i];
+                l_w[i] = l_w[i] - l_alpha_t * l_z[i];
+
+                l_gamma_t += AccumulatorType(l_r[i]) * l_r[i];
+                l_delta_t += AccumulatorType(l_w[i]) * l_r[i];
+            }
+            l_partial[(l_slot_t * l_threads_t + l_thread_id) * PARTIAL_STRIDE + 0] = l_gamma_t;
+            l_partial[(l_slot_t * l_threads_t + l_thread_id) * PARTIAL_STRIDE + 1] = l_delta_t;
+
+            #pragma omp barrier
+            // --------------------------------------------------------------------
+
+            if(m_replacement > 0 && l_iter_t % m_replacement == 0)
+            {
+                //
+                // NOTE residual replacement: r = b - A x, w = A r, s = A p,
+                //      z = A s, gamma and delta of the slot are recomputed.
+                //      alpha and beta of the next iteration keep using the
+                //      recurrences of gamma and delta
+                //
+                p_A.apply(p_x_1,l_q);
+                // --------------------------------------------------------------------
+
+                #pragma omp for
+                for(std::size_t i = 0; i < p_size; ++i)
+                {
+                    l_r[i] = p_b[i] - l_q[i];
+                }
+                // --------------------------------------------------------------------
+
+                p_A.apply(l_r,l_w);
+                p_A.apply(l_p,l_s);
+                p_A.apply(l_s,l_z);
+                // --------------------------------------------------------------------
+
+                l_gamma_t = 0.;
+                l_delta_t = 0.;
+
+                #pragma omp for nowait
+                for(std::size_t i = 0; i < p_size; ++i)
+                {
+                    l_gamma_t += AccumulatorType(l_r[i]) * l_r[i];
+                    l_delta_t += AccumulatorType(l_w[i]) * l_r[i];
+                }
+                l_partial[(l_slot_t * l_threads_t + l_thread_id) * PARTIAL_STRIDE + 0] = l_gamma_t;
+                l_partial[(l_slot_t * l_threads_t + l_thread_id) * PARTIAL_STRIDE + 1] = l_delta_t;
+
+                #pragma omp barrier
+                // --------------------------------------------------------------------
+            }
+        }
+        #pragma omp master
+        {
+            l_iter = l_iter_t;
+        }
+    }
+
+    return(l_iter);
+}
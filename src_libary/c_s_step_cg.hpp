@@ -0,0 +1,590 @@
+/*
+*
+*  s-step (communication avoiding) CG, Steps CG iterations per outer
+*  iteration
+*
+*  an outer iteration computes the Krylov basis Y = [P_0..P_Steps,
+*  R_0..R_Steps-1] of p and r (matrix powers kernel), the Gram matrix
+*  G = Y^T Y (one block of dot products) and then performs Steps CG
+*  iterations on the coordinates of p, r and x in Y (vectors of
+*  2 * Steps + 1 values, computed redundantly by every thread), at last
+*  x, p and r are recovered from Y. A Y_k = Y B e_k gives A p
+*
+*  the basis is a Chebyshev basis on [0, lambda_max] (the monomial basis
+*  A^k p becomes linearly dependent within a few steps), lambda_max <=
+*  2 * max diagonal (Gershgorin, diagonally dominant stencils) is taken
+*  from p_A.diagonal() at the start of every solve. Operators without a
+*  diagonal use the monomial basis, only for small Steps
+*
+*  matrix powers kernel: if p_A provides applyLevels and every thread has
+*  at least 2 * Steps levels, every thread computes all basis vectors of
+*  its levels as a wavefront (basis vector j on level w - j + 1 in front
+*  w), the levels of basis vector j - 1 it reads are still in the cache.
+*  The j levels at both sides of a thread boundary depend on the other
+*  thread, they are computed after a barrier by the thread below the
+*  boundary. Otherwise every basis vector is one p_A.apply
+*
+*  barriers per outer iteration: 2 (matrix powers kernel) + 1 (Gram
+*  matrix) + 1 (recovery), 4 per iteration in CCG. The Gram matrix costs
+*  (Steps + 1) * (2 * Steps + 1) products per cell and outer iteration,
+*  the attainable accuracy decreases with Steps
+*
+*  the dot products are not omp reductions: every thread writes its partial
+*  Gram matrix to a padded slot of m_partial and sums all slots in the same
+*  order after the barrier, see CPipelinedCG
+*
+*  the stopping criterion is the norm2 of r as in CCG (r * G r of the
+*  coordinates), the iteration counts of both solvers are comparable
+*
+*  the basis is kept in a CWorkspace between the calls, see CCG
+*  (2 * Steps + 1 vectors)
+*
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <omp.h>
+#include <string>
+#include "i_linear_operator.hpp"
+#include "i_solver.hpp"
+#include "c_workspace.hpp"
+#include "c_allocator.hpp"
+
+template <typename ValueType, std::size_t Steps, typename AccumulatorType = double>
+class CSStepCG: public ISolver<ValueType>
+{
+    private:
+        static_assert(Steps >= 1, "Steps has to be >= 1");
+
+        static constexpr std::size_t BASIS = 2 * Steps + 1;
+        static constexpr std::size_t SLOT_P = 0;
+        static constexpr std::size_t SLOT_R = Steps + 1;
+
+        //
+        // NOTE upper triangle of G of a thread, padded to 64 bytes,
+        //      m_partial is cache line aligned (CAllocator)
+        //
+        static constexpr std::size_t GRAM = BASIS * (BASIS + 1) / 2;
+        static constexpr std::size_t PARTIAL_STRIDE = ((GRAM * sizeof(AccumulatorType) + 63) / 64) * 64 / sizeof(AccumulatorType);
+
+        //
+        // NOTE cells per block of the Gram matrix and of the recovery, the
+        //      BASIS vectors of a block stay in the L1 cache
+        //
+        static constexpr std::size_t GRAM_BLOCK = 128;
+
+        mutable CWorkspace<ValueType, BASIS> m_workspace;
+        mutable AccumulatorType * m_partial;
+        mutable std::size_t m_partialThreads;
+
+        //
+        // NOTE basis vector p_step of the chain p_slot on the level p_pos_L:
+        //      Y_j = (A Y_j-1 - alpha_j Y_j-1 - beta_j Y_j-2) / gamma_j
+        //
+        void basisLevel(
+            const ILinearOperator<ValueType> & p_A,
+            ValueType * const * p_Y,
+            const std::size_t p_slot,
+            const std::size_t p_step,
+            const std::size_t p_pos_L,
+            const std::size_t p_levelSize,
+            const ValueType * p_alpha,
+            const ValueType * p_beta,
+            const ValueType * p_gammaInv
+        ) const;
+        void combine(
+            ValueType * const * p_Y,
+            const std::size_t p_slot,
+            const std::size_t p_step,
+            const std::size_t p_begin,
+            const std::size_t p_end,
+            const ValueType * p_alpha,
+            const ValueType * p_beta,
+            const ValueType * p_gammaInv
+        ) const;
+
+    public:
+        inline static const std::string IDENTIFER = "s_step_cg_" + std::to_string(Steps);
+
+        CSStepCG(): m_partial(nullptr), m_partialThreads(0) {}
+        CSStepCG(const CSStepCG &) = delete;
+        CSStepCG & operator=(const CSStepCG &) = delete;
+
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const;
+        const CWorkspace<ValueType, BASIS> & workspace() const { return m_workspace; }
+
+        ~CSStepCG() { CAllocator::deallocate(m_partial); }
+};
+
+template <typename ValueType, std::size_t Steps, typename AccumulatorType>
+void CSStepCG<ValueType, Steps, AccumulatorType>::combine(
+    ValueType * const * p_Y,
+    const std::size_t p_slot,
+    const std::size_t p_step,
+    const std::size_t p_begin,
+    const std::size_t p_end,
+    const ValueType * p_alpha,
+    const ValueType * p_beta,
+    const ValueType * p_gammaInv
+) const
+{
+    ValueType * __restrict__ l_y = p_Y[p_slot + p_step];
+    const ValueType * __restrict__ l_y_1 = p_Y[p_slot + p_step - 1];
+    const ValueType l_alpha = p_alpha[p_step];
+    const ValueType l_beta = p_beta[p_step];
+    const ValueType l_gammaInv = p_gammaInv[p_step];
+
+    if(p_step == 1)
+    {
+        for(std::size_t i = p_begin; i < p_end; ++i)
+        {
+            l_y[i] = (l_y[i] - l_alpha * l_y_1[i]) * l_gammaInv;
+        }
+    }
+    else
+    {
+        const ValueType * __restrict__ l_y_2 = p_Y[p_slot + p_step - 2];
+
+        for(std::size_t i = p_begin; i < p_end; ++i)
+        {
+            l_y[i] = (l_y[i] - l_alpha * l_y_1[i] - l_beta * l_y_2[i]) * l_gammaInv;
+        }
+    }
+}
+
+template <typename ValueType, std::size_t Steps, typename AccumulatorType>
+void CSStepCG<ValueType, Steps, AccumulatorType>::basisLevel(
+    const ILinearOperator<ValueType> & p_A,
+    ValueType * const * p_Y,
+    const std::size_t p_slot,
+    const std::size_t p_step,
+    const std::size_t p_pos_L,
+    const std::size_t p_levelSize,
+    const ValueType * p_alpha,
+    const ValueType * p_beta,
+    const ValueType * p_gammaInv
+) const
+{
+    p_A.applyLevels(p_Y[p_slot + p_step - 1], p_Y[p_slot + p_step], p_pos_L, p_pos_L + 1);
+    combine(p_Y, p_slot, p_step, p_pos_L * p_levelSize, (p_pos_L + 1) * p_levelSize, p_alpha, p_beta, p_gammaInv);
+}
+
+template <typename ValueType, std::size_t Steps, typename AccumulatorType>
+std::size_t CSStepCG<ValueType, Steps, AccumulatorType>::operator()(
+    const std::size_t p_size,
+    const ILinearOperator<ValueType> & p_A,
+    const ValueType * __restrict__ p_x_0,
+    const ValueType * __restrict__ p_b,
+    ValueType * __restrict__ p_x_1,
+    const ValueType p_epsilon,
+    const std::size_t p_iterMax,
+    const std::size_t p_bufferSize
+) const
+{
+    std::size_t l_iter;
+
+    m_workspace.reserve(p_size, p_bufferSize);
+
+    std::size_t l_threads = omp_get_max_threads();
+
+    if (l_threads > m_partialThreads)
+    {
+        CAllocator::deallocate(m_partial);
+        m_partial = CAllocator::allocate<AccumulatorType>(l_threads * PARTIAL_STRIDE);
+        m_partialThreads = l_threads;
+    }
+
+    ValueType * l_Y[BASIS];
+
+    for(std::size_t k = 0; k < BASIS; ++k)
+    {
+        l_Y[k] = m_workspace.vector(k);
+    }
+
+    AccumulatorType * l_partial = m_partial;
+
+    //
+    // NOTE the threads are distributed over units of levels (cells if p_A
+    //      has no levels) like a static omp for
+    //
+    std::size_t l_levels = p_A.levels();
+    std::size_t l_unitSize = l_levels > 0 ? p_size / l_levels : 1;
+    std::size_t l_units = l_levels > 0 ? l_levels : p_size;
+
+    #pragma omp parallel
+    {
+        std::size_t l_thread_id = omp_get_thread_num();
+        std::size_t l_threads_t = omp_get_num_threads();
+        std::size_t l_iter_t = 0;
+
+        std::size_t l_chunk = l_units / l_threads_t;
+        std::size_t l_rest = l_units % l_threads_t;
+        std::size_t l_unitBegin = l_thread_id * l_chunk + std::min(l_thread_id, l_rest);
+        std::size_t l_unitEnd = l_unitBegin + l_chunk + (l_thread_id < l_rest ? 1 : 0);
+        std::size_t l_begin = l_unitBegin * l_unitSize;
+        std::size_t l_end = l_unitEnd * l_unitSize;
+
+        bool l_tiled = l_levels > 0 && l_chunk >= 2 * Steps;
+
+        ValueType * l_p = l_Y[SLOT_P];
+        ValueType * l_r = l_Y[SLOT_R];
+
+        AccumulatorType * l_partial_t = l_partial + l_thread_id * PARTIAL_STRIDE;
+
+        p_A.apply(p_x_0,l_r);
+        // --------------------------------------------------------------------
+
+        for(std::size_t i = l_begin; i < l_end; ++i)
+        {
+            p_x_1[i] = p_x_0[i];
+            l_r[i] = p_b[i] - l_r[i];
+            l_p[i] = l_r[i];
+        }
+        // --------------------------------------------------------------------
+
+        //
+        // NOTE lambda_max <= 2 * max diagonal, the diagonal is written to
+        //      the last basis vector of the p chain (overwritten by the
+        //      matrix powers kernel)
+        //
+        AccumulatorType l_lambdaMax = 0.;
+        AccumulatorType l_max_t = 0.;
+
+        if(p_A.diagonal(l_Y[SLOT_P + Steps]))
+        {
+            for(std::size_t i = l_begin; i < l_end; ++i)
+            {
+                l_max_t = std::max(l_max_t, AccumulatorType(l_Y[SLOT_P + Steps][i]));
+            }
+        }
+        l_partial_t[0] = l_max_t;
+
+        #pragma omp barrier
+        // --------------------------------------------------------------------
+
+        for(std::size_t t = 0; t < l_threads_t; ++t)
+        {
+            l_lambdaMax = std::max(l_lambdaMax, 2 * l_partial[t * PARTIAL_STRIDE]);
+        }
+
+        //
+        // NOTE A Y_j = gamma_j+1 Y_j+1 + alpha_j+1 Y_j + beta_j+1 Y_j-1 (index
+        //      of the basis vector computed), Chebyshev on [0, lambda_max]:
+        //      Y_1 = (A - c) Y_0 / c, Y_j+1 = 2 (A - c) Y_j / c - Y_j-1
+        //      with c = lambda_max / 2. Monomial without a diagonal
+        //
+        ValueType l_alpha[Steps + 1];
+        ValueType l_beta[Steps + 1];
+        ValueType l_gamma[Steps + 1];
+        ValueType l_gammaInv[Steps + 1];
+
+        for(std::size_t j = 1; j <= Steps; ++j)
+        {
+            if(l_lambdaMax > 0)
+            {
+                l_alpha[j] = ValueType(l_lambdaMax / 2);
+                l_beta[j] = j == 1 ? 0 : ValueType(l_lambdaMax / 4);
+                l_gamma[j] = j == 1 ? ValueType(l_lambdaMax / 2) : ValueType(l_lambdaMax / 4);
+            }
+            else
+            {
+                l_alpha[j] = 0;
+                l_beta[j] = 0;
+                l_gamma[j] = 1;
+            }
+            l_gammaInv[j] = 1 / l_gamma[j];
+        }
+
+        //
+        // NOTE B e_k: coordinates of A Y_k (k < Steps in both chains)
+        //
+        AccumulatorType l_B[BASIS][BASIS] = {};
+
+        for(std::size_t l_slot : {SLOT_P, SLOT_R})
+        {
+            std::size_t l_length = l_slot == SLOT_P ? Steps : Steps - 1;
+
+            for(std::size_t k = 0; k < l_length; ++k)
+            {
+                l_B[l_slot + k + 1][l_slot + k] = l_gamma[k + 1];
+                l_B[l_slot + k][l_slot + k] = l_alpha[k + 1];
+                if(k > 0)
+                {
+                    l_B[l_slot + k - 1][l_slot + k] = l_beta[k + 1];
+                }
+            }
+        }
+
+        AccumulatorType l_G[BASIS][BASIS];
+        AccumulatorType l_p_c[BASIS];
+        AccumulatorType l_r_c[BASIS];
+        AccumulatorType l_x_c[BASIS];
+        AccumulatorType l_Bp_c[BASIS];
+        bool l_done = false;
+
+        while(!l_done)
+        {
+            //
+            // NOTE matrix powers kernel: P_1..P_Steps, R_1..R_Steps-1
+            //
+            if(l_tiled)
+            {
+                auto l_levelBegin = [&](const std::size_t p_step)
+                {
+                    return l_unitBegin == 0 ? 0 : l_unitBegin + p_step;
+                };
+                auto l_levelEnd = [&](const std::size_t p_step)
+                {
+                    return l_unitEnd == l_levels ? l_levels : l_unitEnd - p_step;
+                };
+
+                for(std::size_t w = l_levelBegin(1); w + 1 < l_levelEnd(1) + Steps; ++w)
+                {
+                    for(std::size_t j = 1; j <= Steps && j <= w + 1; ++j)
+                    {
+                        std::size_t l_pos_L = w + 1 - j;
+
+                        if(l_pos_L >= l_levelBegin(j) && l_pos_L < l_levelEnd(j))
+                        {
+                            basisLevel(p_A, l_Y, SLOT_P, j, l_pos_L, l_unitSize, l_alpha, l_beta, l_gammaInv);
+                            if(j < Steps)
+                            {
+                                basisLevel(p_A, l_Y, SLOT_R, j, l_pos_L, l_unitSize, l_alpha, l_beta, l_gammaInv);
+                            }
+                        }
+                    }
+                }
+                #pragma omp barrier
+                // --------------------------------------------------------------------
+
+                //
+                // NOTE the levels [end - j, end + j) of basis vector j at the
+                //      upper boundary of the thread
+                //
+                if(l_unitEnd < l_levels)
+                {
+                    for(std::size_t j = 1; j <= Steps; ++j)
+                    {
+                        for(std::size_t l_pos_L = l_unitEnd - j; l_pos_L < l_unitEnd + j; ++l_pos_L)
+                        {
+                            basisLevel(p_A, l_Y, SLOT_P, j, l_pos_L, l_unitSize, l_alpha, l_beta, l_gammaInv);
+                            if(j < Steps)
+                            {
+                                basisLevel(p_A, l_Y, SLOT_R, j, l_pos_L, l_unitSize, l_alpha, l_beta, l_gammaInv);
+                            }
+                        }
+                    }
+                }
+                #pragma omp barrier
+                // --------------------------------------------------------------------
+            }
+            else
+            {
+                for(std::size_t j = 1; j <= Steps; ++j)
+                {
+                    p_A.apply(l_Y[SLOT_P + j - 1],l_Y[SLOT_P + j]);
+                    if(j < Steps)
+                    {
+                        p_A.apply(l_Y[SLOT_R + j - 1],l_Y[SLOT_R + j]);
+                    }
+                    // --------------------------------------------------------------------
+
+                    combine(l_Y, SLOT_P, j, l_begin, l_end, l_alpha, l_beta, l_gammaInv);
+                    if(j < Steps)
+                    {
+                        combine(l_Y, SLOT_R, j, l_begin, l_end, l_alpha, l_beta, l_gammaInv);
+                    }
+                    #pragma omp barrier
+                    // --------------------------------------------------------------------
+                }
+            }
+
+            //
+            // NOTE Gram matrix, upper triangle
+            //
+            for(std::size_t k = 0; k < GRAM; ++k)
+            {
+                l_partial_t[k] = 0.;
+            }
+
+            for(std::size_t l_block = l_begin; l_block < l_end; l_block += GRAM_BLOCK)
+            {
+                std::size_t l_blockEnd = std::min(l_block + GRAM_BLOCK, l_end);
+                std::size_t l_index = 0;
+
+                for(std::size_t a = 0; a < BASIS; ++a)
+                {
+                    const ValueType * __restrict__ l_y_a = l_Y[a];
+
+                    for(std::size_t b = a; b < BASIS; ++b)
+                    {
+                        const ValueType * __restrict__ l_y_b = l_Y[b];
+                        AccumulatorType l_sum = 0.;
+
+                        #pragma omp simd reduction(+: l_sum)
+                        for(std::size_t i = l_block; i < l_blockEnd; ++i)
+                        {
+                            l_sum += AccumulatorType(l_y_a[i]) * l_y_b[i];
+                        }
+                        l_partial_t[l_index++] += l_sum;
+                    }
+                }
+            }
+            #pragma omp barrier
+            // --------------------------------------------------------------------
+
+            {
+                std::size_t l_index = 0;
+
+                for(std::size_t a = 0; a < BASIS; ++a)
+                {
+                    for(std::size_t b = a; b < BASIS; ++b)
+                    {
+                        AccumulatorType l_sum = 0.;
+
+                        for(std::size_t t = 0; t < l_threads_t; ++t)
+                        {
+                            l_sum += l_partial[t * PARTIAL_STRIDE + l_index];
+                        }
+                        l_G[a][b] = l_sum;
+                        l_G[b][a] = l_sum;
+                        l_index++;
+                    }
+                }
+            }
+
+            //
+            // NOTE Steps CG iterations on the coordinates, identical on all
+            //      threads
+            //
+            auto l_dotG = [&](const AccumulatorType * p_u, const AccumulatorType * p_v)
+            {
+                AccumulatorType l_sum = 0.;
+
+                for(std::size_t a = 0; a < BASIS; ++a)
+                {
+                    AccumulatorType l_Gv = 0.;
+
+                    for(std::size_t b = 0; b < BASIS; ++b)
+                    {
+                        l_Gv += l_G[a][b] * p_v[b];
+                    }
+                    l_sum += p_u[a] * l_Gv;
+                }
+
+                return l_sum;
+            };
+
+            for(std::size_t k = 0; k < BASIS; ++k)
+            {
+                l_p_c[k] = k == SLOT_P ? 1. : 0.;
+                l_r_c[k] = k == SLOT_R ? 1. : 0.;
+                l_x_c[k] = 0.;
+            }
+
+            AccumulatorType l_alpha_0 = l_dotG(l_r_c, l_r_c);
+
+            for(std::size_t j = 0; j < Steps; ++j)
+            {
+                if(l_alpha_0 < p_epsilon || l_iter_t >= p_iterMax)
+                {
+                    break;
+                }
+
+                for(std::size_t a = 0; a < BASIS; ++a)
+                {
+                    l_Bp_c[a] = 0.;
+
+                    for(std::size_t b = 0; b < BASIS; ++b)
+                    {
+                        l_Bp_c[a] += l_B[a][b] * l_p_c[b];
+                    }
+                }
+
+                AccumulatorType l_lambda = l_alpha_0 / l_dotG(l_p_c, l_Bp_c);
+
+                for(std::size_t k = 0; k < BASIS; ++k)
+                {
+                    l_x_c[k] += l_lambda * l_p_c[k];
+                    l_r_c[k] -= l_lambda * l_Bp_c[k];
+                }
+
+                AccumulatorType l_alpha_1 = l_dotG(l_r_c, l_r_c);
+                AccumulatorType l_beta = l_alpha_1 / l_alpha_0;
+
+                for(std::size_t k = 0; k < BASIS; ++k)
+                {
+                    l_p_c[k] = l_r_c[k] + l_beta * l_p_c[k];
+                }
+
+                l_alpha_0 = l_alpha_1;
+                l_iter_t++;
+            }
+
+            l_done = l_alpha_0 < p_epsilon || l_iter_t >= p_iterMax;
+
+            //
+            // NOTE recovery: x += Y x_c, p = Y p_c and r = Y r_c, blocks of
+            //      GRAM_BLOCK cells are summed up before p and r (basis
+            //      vectors P_0 and R_0) are overwritten
+            //
+            ValueType l_x_v[BASIS];
+            ValueType l_p_v[BASIS];
+            ValueType l_r_v[BASIS];
+
+            for(std::size_t k = 0; k < BASIS; ++k)
+            {
+                l_x_v[k] = ValueType(l_x_c[k]);
+                l_p_v[k] = ValueType(l_p_c[k]);
+                l_r_v[k] = ValueType(l_r_c[k]);
+            }
+
+            for(std::size_t l_block = l_begin; l_block < l_end; l_block += GRAM_BLOCK)
+            {
+                std::size_t l_blockSize = std::min(GRAM_BLOCK, l_end - l_block);
+                ValueType l_x_b[GRAM_BLOCK] = {};
+                ValueType l_p_b[GRAM_BLOCK] = {};
+                ValueType l_r_b[GRAM_BLOCK] = {};
+
+                for(std::size_t k = 0; k < BASIS; ++k)
+                {
+                    const ValueType * __restrict__ l_y = l_Y[k] + l_block;
+
+                    for(std::size_t i = 0; i < l_blockSize; ++i)
+                    {
+                        l_x_b[i] += l_x_v[k] * l_y[i];
+                        l_p_b[i] += l_p_v[k] * l_y[i];
+                        l_r_b[i] += l_r_v[k] * l_y[i];
+                    }
+                }
+
+                for(std::size_t i = 0; i < l_blockSize; ++i)
+                {
+                    p_x_1[l_block + i] += l_x_b[i];
+                    l_p[l_block + i] = l_p_b[i];
+                    l_r[l_block + i] = l_r_b[i];
+                }
+            }
+
+            #pragma omp barrier
+            // --------------------------------------------------------------------
+        }
+        #pragma omp master
+        {
+            l_iter = l_iter_t;
+        }
+    }
+
+    return(l_iter);
+}
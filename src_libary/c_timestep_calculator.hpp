@@ -2,21 +2,32 @@
 *
 * => Work with relative tolerance
 *
+* => residual norms are accumulated in AccumulatorType (double by default)
+*
+* => the iterates and z are kept in a CWorkspace between the calls, they
+*    are allocated and first touched only when p_size or p_bufferSize
+*    changes
+*
 */
 
 #pragma once
 
+#include <iostream>
 #include <omp.h>
 #include <string>
 #include "i_nonlinear_operator.hpp"
 #include "i_solver.hpp"
 #include "i_timestep_calculator.hpp"
+#include "c_workspace.hpp"
 
 #define SWAP_PTR(p_x_new,p_x_old,p_x_tmp) (p_x_tmp=p_x_new, p_x_new=p_x_old, p_x_old=p_x_tmp)
 
-template <typename ValueType>
+template <typename ValueType, typename AccumulatorType = double>
 class C_TimestepCalculator : public ITimestepCalculator<ValueType>
 {
+    private:
+        mutable CWorkspace<ValueType, 3> m_workspace;
+
     public:
         inline static const std::string IDENTIFER = "c_timestep_calculator";
         std::size_t operator()(
@@ -31,10 +42,11 @@ class C_TimestepCalculator : public ITimestepCalculator<ValueType>
             const std::size_t p_iter_step_max,
             const std::size_t p_bufferSize
         ) const;
+        const CWorkspace<ValueType, 3> & workspace() const { return m_workspace; }
 };
 
-template <typename ValueType>
-std::size_t C_TimestepCalculator<ValueType>::operator()(
+template <typename ValueType, typename AccumulatorType>
+std::size_t C_TimestepCalculator<ValueType, AccumulatorType>::operator()(
     const std::size_t p_size,
     const ISolver<ValueType> & p_Solver,
     INonlinearOperator<ValueType> & p_Op,
@@ -47,39 +59,27 @@ std::size_t C_TimestepCalculator<ValueType>::operator()(
     const std::size_t p_bufferSize
 ) const
 {
-    ValueType * l_x_k0_raw;
-    ValueType * l_x_k1_raw;
     ValueType * l_x_k0;
     ValueType * l_x_k1;
     ValueType * l_z;
     ValueType * l_x_tmp;
-    ValueType l_res_0 = ValueType(0);
-    ValueType l_res_k = ValueType(0);
-    ValueType l_tol_rel;
+    AccumulatorType l_res_0 = AccumulatorType(0);
+    AccumulatorType l_res_k = AccumulatorType(0);
+    AccumulatorType l_tol_rel;
     std::size_t l_iter = 0;
     std::size_t l_iter_solver;
 
-    l_x_k0_raw = new ValueType[p_size+2*p_bufferSize];
-    l_x_k1_raw = new ValueType[p_size+2*p_bufferSize];
-    l_z = new ValueType[p_size];
-    l_x_k0 = &(l_x_k0_raw[p_bufferSize]);
-    l_x_k1 = &(l_x_k1_raw[p_bufferSize]);
-
-    #pragma omp parallel for
-    for(std::size_t i = 0; i < p_size; ++i)
-    {
-        l_x_k0[i] = ValueType(0);
-        l_x_k1[i] = ValueType(0);
-        l_z[i] = ValueType(0);
-    }
+    //
+    // NOTE first touch with the level distribution of p_Op.apply on the
+    //      first call (a level is p_bufferSize values), the halos and the
+    //      padding cells stay zero, x_k1 is written by p_Solver and z by
+    //      p_Op.apply before they are read
+    //
+    m_workspace.reserve(p_size, p_bufferSize);
 
-    for (std::size_t i = 0; i < p_bufferSize; ++i)
-    {
-        l_x_k0_raw[i] = 0;
-        l_x_k1_raw[i] = 0;
-        l_x_k0_raw[p_size+p_bufferSize+i] = 0;
-        l_x_k1_raw[p_size+p_bufferSize+i] = 0;
-    }
+    l_x_k0 = m_workspace.vector(0);
+    l_x_k1 = m_workspace.vector(1);
+    l_z = m_workspace.vector(2);
 
     // std::cout << "p_y:" << std::endl;
     // printArray1d(p_y, p_size);
@@ -94,7 +94,7 @@ std::size_t C_TimestepCalculator<ValueType>::operator()(
     #pragma omp parallel for reduction(+: l_res_0)
     for(std::size_t i = 0; i < p_size; ++i)
     {
-        l_res_0 += (l_z[i] - p_y[i]) * (l_z[i] - p_y[i]);
+        l_res_0 += AccumulatorType(l_z[i] - p_y[i]) * (l_z[i] - p_y[i]);
     }
 
     // l_tol_rel = l_res_0 * p_epsilon_step;
@@ -111,7 +111,7 @@ std::size_t C_TimestepCalculator<ValueType>::operator()(
 
         SWAP_PTR(l_x_k0, l_x_k1, l_x_tmp);
 
-        std::cout << C_TimestepCalculator<ValueType>::IDENTIFER
+        std::cout << C_TimestepCalculator<ValueType, AccumulatorType>::IDENTIFER
                   << ": iter: "    << l_iter
                   << " sol_iter: " << l_iter_solver
                   << " tol: " << l_res_k  << ">" << l_tol_rel << std::endl;
@@ -124,7 +124,7 @@ std::size_t C_TimestepCalculator<ValueType>::operator()(
         #pragma omp parallel for reduction(+: l_res_k)
         for(std::size_t i = 0; i < p_size; ++i)
         {
-            l_res_k += (l_z[i] - p_y[i]) * (l_z[i] - p_y[i]);
+            l_res_k += AccumulatorType(l_z[i] - p_y[i]) * (l_z[i] - p_y[i]);
         }
 
         l_iter++;
@@ -136,9 +136,5 @@ std::size_t C_TimestepCalculator<ValueType>::operator()(
         p_x[i] = l_x_k1[i];
     }
 
-    delete [] l_x_k0_raw;
-    delete [] l_x_k1_raw;
-    delete [] l_z;
-
     return(l_iter);
 }
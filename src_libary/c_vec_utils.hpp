@@ -0,0 +1,250 @@
+/*
+ * Helpers that keep the stencil kernels independent of the vector width of
+ * VecType (Vec4d, Vec8d, Vec8f, Vec16f, ...).
+ *
+ * load/store take the number of valid lanes p_n, so that the last vector of
+ * a row with m_objCols % VecType::size() != 0 is loaded/stored partially
+ * (lanes >= p_n are loaded as 0 and are not written).
+ *
+ * loadAligned/storeAligned require p_ptr to be aligned to the vector width,
+ * shiftLow/shiftHigh build the vectors of the -1/+1 column neighbours from
+ * two aligned vectors by a blend, so that no unaligned load is needed.
+ * evenLanes/oddLanes and duplicateLow/duplicateHigh are the blends of the
+ * 2:1 grid transfers (pairs of columns to one and back).
+ *
+ * CVecStorage loads/stores VecType from/to arrays of StorageType. With
+ * StorageType == ValueType it is CVecUtils, with float storage of a double
+ * VecType the values are widened in registers on load (Vec4f -> Vec4d,
+ * Vec8f -> Vec8d) and rounded to float on store.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+template <typename ValueType, typename VecType>
+class CVecUtils
+{
+   public:
+      //
+      // (0, 1, ..., VecType::size()-1)
+      //
+      static inline VecType lanes()
+      {
+         ValueType l_lanes[VecType::size()];
+         for (std::size_t i = 0; i < VecType::size(); ++i)
+         {
+            l_lanes[i] = ValueType(i);
+         }
+         VecType l_lanes_Vec;
+         l_lanes_Vec.load(l_lanes);
+         return l_lanes_Vec;
+      }
+
+      //
+      // number of valid lanes of the vector starting at column p_pos_C
+      //
+      static inline std::size_t lanesValid(const std::size_t p_pos_C, const std::size_t p_objCols)
+      {
+         return (p_objCols - p_pos_C < VecType::size()) ? p_objCols - p_pos_C : VecType::size();
+      }
+
+      static inline void load(VecType & p_v, const ValueType * p_ptr, const std::size_t p_n)
+      {
+         if (p_n == VecType::size())
+         {
+            p_v.load(p_ptr);
+         }
+         else
+         {
+            p_v.load_partial(int(p_n), p_ptr);
+         }
+      }
+
+      static inline void store(const VecType & p_v, ValueType * p_ptr, const std::size_t p_n)
+      {
+         if (p_n == VecType::size())
+         {
+            p_v.store(p_ptr);
+         }
+         else
+         {
+            p_v.store_partial(int(p_n), p_ptr);
+         }
+      }
+
+      static inline void loadAligned(VecType & p_v, const ValueType * p_ptr)
+      {
+         p_v.load_a(p_ptr);
+      }
+
+      static inline void storeAligned(const VecType & p_v, ValueType * p_ptr)
+      {
+         p_v.store_a(p_ptr);
+      }
+
+      //
+      // (p_prev[n-1], p_cur[0], ..., p_cur[n-2]), the vector one lane below p_cur
+      //
+      static inline VecType shiftLow(const VecType & p_prev, const VecType & p_cur)
+      {
+         return shift<VecType::size()-1>(p_prev, p_cur, std::make_index_sequence<VecType::size()>());
+      }
+
+      //
+      // (p_cur[1], ..., p_cur[n-1], p_next[0]), the vector one lane above p_cur
+      //
+      static inline VecType shiftHigh(const VecType & p_cur, const VecType & p_next)
+      {
+         return shift<1>(p_cur, p_next, std::make_index_sequence<VecType::size()>());
+      }
+
+      //
+      // (p_lo[0], p_lo[2], ..., p_hi[0], p_hi[2], ...), the even lanes of the
+      // concatenation (p_lo, p_hi)
+      //
+      static inline VecType evenLanes(const VecType & p_lo, const VecType & p_hi)
+      {
+         return stride<0>(p_lo, p_hi, std::make_index_sequence<VecType::size()>());
+      }
+
+      //
+      // (p_lo[1], p_lo[3], ..., p_hi[1], p_hi[3], ...), the odd lanes of the
+      // concatenation (p_lo, p_hi)
+      //
+      static inline VecType oddLanes(const VecType & p_lo, const VecType & p_hi)
+      {
+         return stride<1>(p_lo, p_hi, std::make_index_sequence<VecType::size()>());
+      }
+
+      //
+      // (p_v[0], p_v[0], p_v[1], p_v[1], ...), every lane of the lower half
+      // of p_v twice
+      //
+      static inline VecType duplicateLow(const VecType & p_v)
+      {
+         return duplicate<0>(p_v, std::make_index_sequence<VecType::size()>());
+      }
+
+      //
+      // every lane of the upper half of p_v twice
+      //
+      static inline VecType duplicateHigh(const VecType & p_v)
+      {
+         return duplicate<int(VecType::size()/2)>(p_v, std::make_index_sequence<VecType::size()>());
+      }
+
+   private:
+      //
+      // lane i of the result is lane Offset+i of the concatenation (p_a, p_b)
+      //
+      template <int Offset, std::size_t... I>
+      static inline VecType shift(const VecType & p_a, const VecType & p_b, std::index_sequence<I...>)
+      {
+         return blend<(Offset+int(I))...>(p_a, p_b);
+      }
+
+      //
+      // lane i of the result is lane Offset+2i of the concatenation (p_a, p_b)
+      //
+      template <int Offset, std::size_t... I>
+      static inline VecType stride(const VecType & p_a, const VecType & p_b, std::index_sequence<I...>)
+      {
+         return blend<(Offset+2*int(I))...>(p_a, p_b);
+      }
+
+      //
+      // lane i of the result is lane Offset+i/2 of p_v
+      //
+      template <int Offset, std::size_t... I>
+      static inline VecType duplicate(const VecType & p_v, std::index_sequence<I...>)
+      {
+         return blend<(Offset+int(I)/2)...>(p_v, p_v);
+      }
+
+      template <int... Index>
+      static inline VecType blend(const VecType & p_a, const VecType & p_b)
+      {
+         if constexpr (VecType::size() == 4)
+         {
+            return blend4<Index...>(p_a, p_b);
+         }
+         else if constexpr (VecType::size() == 8)
+         {
+            return blend8<Index...>(p_a, p_b);
+         }
+         else
+         {
+            static_assert(VecType::size() == 16, "unsupported vector width");
+            return blend16<Index...>(p_a, p_b);
+         }
+      }
+};
+
+template <typename StorageType, typename ValueType, typename VecType>
+class CVecStorage
+{
+   static_assert(std::is_same<StorageType, ValueType>::value, "unsupported storage type");
+
+   public:
+      static inline void load(VecType & p_v, const StorageType * p_ptr, const std::size_t p_n)
+      {
+         CVecUtils<ValueType, VecType>::load(p_v, p_ptr, p_n);
+      }
+
+      static inline void store(const VecType & p_v, StorageType * p_ptr, const std::size_t p_n)
+      {
+         CVecUtils<ValueType, VecType>::store(p_v, p_ptr, p_n);
+      }
+
+      static inline void loadAligned(VecType & p_v, const StorageType * p_ptr)
+      {
+         CVecUtils<ValueType, VecType>::loadAligned(p_v, p_ptr);
+      }
+
+      //
+      // p_v rounded to StorageType (the value a store and load would give)
+      //
+      static inline VecType roundToStorage(const VecType & p_v)
+      {
+         return p_v;
+      }
+};
+
+template <typename VecType>
+class CVecStorage<float, double, VecType>
+{
+   //
+   // NOTE same number of lanes, half the width (Vec4d -> Vec4f, Vec8d -> Vec8f)
+   //
+   using StorageVecType = decltype(to_float(std::declval<VecType>()));
+   using StorageVecUtils = CVecUtils<float, StorageVecType>;
+
+   public:
+      static inline void load(VecType & p_v, const float * p_ptr, const std::size_t p_n)
+      {
+         StorageVecType l_v_Vec;
+         StorageVecUtils::load(l_v_Vec, p_ptr, p_n);
+         p_v = to_double(l_v_Vec);
+      }
+
+      static inline void store(const VecType & p_v, float * p_ptr, const std::size_t p_n)
+      {
+         StorageVecUtils::store(to_float(p_v), p_ptr, p_n);
+      }
+
+      static inline void loadAligned(VecType & p_v, const float * p_ptr)
+      {
+         StorageVecType l_v_Vec;
+         StorageVecUtils::loadAligned(l_v_Vec, p_ptr);
+         p_v = to_double(l_v_Vec);
+      }
+
+      static inline VecType roundToStorage(const VecType & p_v)
+      {
+         return to_double(to_float(p_v));
+      }
+};
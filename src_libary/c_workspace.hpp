@@ -0,0 +1,127 @@
+/*
+ * Persistent work vectors of a solver.
+ *
+ * CWorkspace holds Vectors arrays of p_size values, each with a zero halo of
+ * p_bufferSize values in front and behind (like the vectors of the
+ * drivers). reserve() allocates them (CAllocator) and zeroes them with the
+ * level distribution of the operators (first touch) only if the size
+ * changes, repeated solves of the same problem size reuse the vectors
+ * without any allocation, page fault or initialization.
+ *
+ * The owner has to keep the halos and the padding cells (CGridLayout) of
+ * the vectors zero: the operators never write them, the solvers do not
+ * write the halos.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <omp.h>
+#include "c_allocator.hpp"
+
+template <typename ValueType, std::size_t Vectors>
+class CWorkspace
+{
+   private:
+      std::size_t m_size;
+      std::size_t m_bufferSize;
+      std::size_t m_allocations;
+      ValueType * m_raw[Vectors];
+
+      void release();
+
+   public:
+      CWorkspace();
+      CWorkspace(const CWorkspace &) = delete;
+      CWorkspace & operator=(const CWorkspace &) = delete;
+
+      //
+      // true if the vectors were (re)allocated, their values are zero then
+      //
+      bool reserve(const std::size_t p_size, const std::size_t p_bufferSize);
+
+      //
+      // first value of vector p_vector, the halos are
+      // vector(p_vector)-bufferSize() and vector(p_vector)+size()
+      //
+      ValueType * vector(const std::size_t p_vector) const { return m_raw[p_vector] + m_bufferSize; }
+
+      std::size_t size() const { return m_size; }
+      std::size_t bufferSize() const { return m_bufferSize; }
+
+      //
+      // number of reserve() calls that allocated
+      //
+      std::size_t allocations() const { return m_allocations; }
+
+      ~CWorkspace();
+};
+
+template <typename ValueType, std::size_t Vectors>
+CWorkspace<ValueType, Vectors>::CWorkspace():
+m_size(0),
+m_bufferSize(0),
+m_allocations(0)
+{
+   for (std::size_t k = 0; k < Vectors; ++k)
+   {
+      m_raw[k] = nullptr;
+   }
+}
+
+template <typename ValueType, std::size_t Vectors>
+bool CWorkspace<ValueType, Vectors>::reserve(const std::size_t p_size, const std::size_t p_bufferSize)
+{
+   if (m_raw[0] != nullptr && p_size == m_size && p_bufferSize == m_bufferSize)
+   {
+      return false;
+   }
+
+   release();
+
+   m_size = p_size;
+   m_bufferSize = p_bufferSize;
+   ++m_allocations;
+
+   for (std::size_t k = 0; k < Vectors; ++k)
+   {
+      m_raw[k] = CAllocator::allocate<ValueType>(m_size+2*m_bufferSize);
+   }
+
+   //
+   // first touch
+   //
+   #pragma omp parallel
+   {
+      for (std::size_t k = 0; k < Vectors; ++k)
+      {
+         CAllocator::firstTouch(vector(k), m_size, m_bufferSize);
+
+         #pragma omp for
+         for (std::size_t i = 0; i < m_bufferSize; ++i)
+         {
+            m_raw[k][i] = ValueType(0);
+            m_raw[k][m_size+m_bufferSize+i] = ValueType(0);
+         }
+      }
+   }
+
+   return true;
+}
+
+template <typename ValueType, std::size_t Vectors>
+void CWorkspace<ValueType, Vectors>::release()
+{
+   for (std::size_t k = 0; k < Vectors; ++k)
+   {
+      CAllocator::deallocate(m_raw[k]);
+      m_raw[k] = nullptr;
+   }
+}
+
+template <typename ValueType, std::size_t Vectors>
+CWorkspace<ValueType, Vectors>::~CWorkspace()
+{
+   release();
+}
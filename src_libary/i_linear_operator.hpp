@@ -1,8 +1,35 @@
 #pragma once
 
+#include <cstddef>
+
 template <typename ValueType>
 class ILinearOperator
 {
  public:
     virtual void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const = 0;
+
+    //
+    // NOTE optional: writes the diagonal of the operator to p_d (same layout
+    //      as p_y of apply, padding cells of a CGridLayout are not written)
+    //      and returns true, false if the operator does not provide it.
+    //      Called by all threads of a parallel region like apply, p_d is
+    //      complete on return
+    //
+    virtual bool diagonal(ValueType * __restrict__ /*p_d*/) const { return false; }
+
+    //
+    // NOTE optional: number of levels of the grid (level pitch = p_size of
+    //      the solvers / levels()), 0 if the operator does not provide
+    //      applyLevels
+    //
+    virtual std::size_t levels() const { return 0; }
+
+    //
+    // NOTE optional (levels() > 0): p_y = A p_x on the levels
+    //      [p_levelBegin, p_levelEnd) only, reads the levels
+    //      p_levelBegin - 1 to p_levelEnd of p_x (halos at the grid ends).
+    //      Called by a single thread, no worksharing and no barrier, e.g.
+    //      for the wavefront of a matrix powers kernel (CSStepCG)
+    //
+    virtual void applyLevels(const ValueType * __restrict__ /*p_x*/, ValueType * __restrict__ /*p_y*/, const std::size_t /*p_levelBegin*/, const std::size_t /*p_levelEnd*/) const {}
 };
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include "i_linear_operator.hpp"
+
+template <typename ValueType>
+class IPreconditioner
+{
+ public:
+    //
+    // NOTE called by the solver before its parallel region, work vectors
+    //      of p_size values with halos of p_bufferSize values (CWorkspace)
+    //
+    virtual void reserve(const std::size_t /*p_size*/, const std::size_t /*p_bufferSize*/) const {}
+
+    //
+    // NOTE called by all threads of the parallel region of the solver at the
+    //      start of every solve, e.g. for the diagonal of p_A
+    //
+    virtual void setup(const ILinearOperator<ValueType> & /*p_A*/) const {}
+
+    //
+    // NOTE p_z = M^-1 p_r, called by all threads of a parallel region like
+    //      apply, p_z is complete on return. M^-1 has to be symmetric
+    //      positive definite and must not change during a solve, padding
+    //      cells of p_r are zero and stay zero in p_z
+    //
+    virtual void apply(const ILinearOperator<ValueType> & p_A, const ValueType * __restrict__ p_r, ValueType * __restrict__ p_z) const = 0;
+};
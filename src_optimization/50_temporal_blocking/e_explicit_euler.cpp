@@ -0,0 +1,149 @@
+#include <cstddef>
+#include <cassert>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec4d;
+
+constexpr std::size_t OBJ_COLS =   1024;
+constexpr std::size_t OBJ_ROWS =   1024;
+constexpr std::size_t OBJ_LEVELS = 1024;
+
+//
+// NOTE: C*TAU/(H*H) <= 1/6 for a stable explicit euler
+//
+constexpr VALUE_TYPE C = 0.1;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t STEPS = 16;
+constexpr std::size_t SWEEPS_PER_PASS = 4;
+
+#include "c_explicit_euler.hpp"
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_steps,
+             std::size_t p_sweepsPerPass
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_u_0 = new ValueType[l_objCells];
+    ValueType * l_u_1 = new ValueType[l_objCells];
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < l_objCells; ++i)
+    {
+        l_u_0[i] = i % 100;
+        l_u_1[i] = 0;
+    }
+
+    CExplicitEuler<ValueType,VecType> l_euler(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        p_sweepsPerPass,
+        C,
+        H,
+        TAU
+    );
+
+    double l_tStartApply = omp_get_wtime();
+    l_euler(l_objCells, l_u_0, l_u_1, p_steps, l_objSize2d);
+    double l_tEndApply = omp_get_wtime();
+    double l_tApply = l_tEndApply - l_tStartApply;
+
+    ValueType l_sum_0 = 0;
+    ValueType l_sum_1 = 0;
+    #pragma omp parallel for reduction(+: l_sum_0, l_sum_1)
+    for (std::size_t i = 0; i < l_objCells; ++i)
+    {
+        l_sum_0 += l_u_0[i];
+        l_sum_1 += l_u_1[i];
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //       the boundary is insulating, so the sums have to match
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_euler.IDENTIFER << std::endl;
+    std::cout << "STEPS_IMPL," << p_steps << std::endl;
+    std::cout << "SWEEPS_IMPL," << p_sweepsPerPass << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tApply << std::endl;
+    std::cout << "SUM_INITIAL_IMPL," << l_sum_0 << std::endl;
+    std::cout << "SUM_FINAL_IMPL," << l_sum_1 << std::endl;
+
+    delete [] l_u_0;
+    delete [] l_u_1;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 6)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 6" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_steps = STEPS;
+    std::size_t l_sweepsPerPass = SWEEPS_PER_PASS;
+
+    if (argc == 6)
+    {
+        l_objCols =       atoi(argv[1]);
+        l_objRows =       atoi(argv[2]);
+        l_objLevels =     atoi(argv[3]);
+        l_steps =         atoi(argv[4]);
+        l_sweepsPerPass = atoi(argv[5]);
+    }
+    if (l_sweepsPerPass < 1)
+    {
+        std::cout << "INVALID INPUT: sweeps must be >= 1" << std::endl;
+        return 1;
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_steps,
+        l_sweepsPerPass
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+#!/usr/bin/env bash
+
+#
+# CONFIG
+#
+
+THREADS=128
+
+SWEEPS_MIN=1
+SWEEPS_MAX=8
+
+APPLY_RUNS=1
+
+OBJ_COLS=2048
+OBJ_ROWS=2048
+OBJ_LEVELS=2048
+
+OMP_PLACES=threads
+OMP_PROC_BIND=spread
+
+APP_PATH=${1:-./e_temporal_blocking}
+
+ENABLE_TELEGRAM=true
+
+#
+# ------------------------------
+#
+
+#
+# FUNCTIONS
+#
+
+filename() {
+  echo "$(basename $(readlink -f $1))"
+}
+
+filename_without_extension() {
+  local name=$(filename $0)
+  echo "${name%.*}"
+}
+
+log_console() {
+  echo -e "$BLUE $1 $NORMAL"
+}
+warning_console() {
+  echo -e "$YELLOW > WARNING - $1 $NORMAL"
+}
+
+error_console() {
+  echo ""
+  echo -e "$RED >>> ERROR - $1 $NORMAL" >&2
+}
+
+output() {
+  echo $1 >> $OUTPUT_FILE
+}
+
+log_telegram() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}" >/dev/null
+  fi
+}
+
+log_telegram_silent() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}&disable_notification=true" >/dev/null
+  fi
+}
+
+log_everywhere() {
+  log_console "$1"
+  log_telegram "$1"
+}
+
+log_everywhere_silent() {
+  log_console "$1"
+  log_telegram_silent "$1"
+}
+
+timestamp() {
+  date +%s
+}
+
+elapsedTimeMessage() {
+  local l_elapsed=$(( $2 - $1 ))
+  eval "echo Elapsed time: $(date -ud "@$l_elapsed" +'$((%s/3600/24)) days %H hr %M min %S sec')"
+}
+
+#
+# ------------------------------
+#
+
+#
+# ENVIRONMENT CHECK
+#
+
+if [ -z ${TELEGRAM_BOT_TOKEN} ]; then
+  error_console "TELEGRAM_BOT_TOKEN isn't defined."
+  exit 1
+fi
+if [ -z ${TELEGRAM_CHAT_ID} ]; then
+  error_console "TELEGRAM_CHAT_ID isn't defined."
+  exit 1
+fi
+
+#
+# ------------------------------
+#
+
+#
+# PROPERTIES
+#
+
+APP_ID=$(filename $APP_PATH)
+
+NODE_ID=${NODE_ID:-undefined_node}
+SCRIPT_ID=$(filename_without_extension $0)
+SCRIPT_PATH=$(readlink -f $0)
+
+# Output colors
+NORMAL="\\033[0;39m"
+RED="\\033[1;31m"
+BLUE="\\033[0;34m"
+YELLOW="\\033[0;33m"
+
+OUTPUT_FILE="${SCRIPT_ID}_${APP_ID}.csv"
+
+OBJ_CELLS=$(( $OBJ_COLS * $OBJ_ROWS * $OBJ_LEVELS ))
+
+TIME_BENCHMARK_STARTED=$(timestamp)
+
+log_everywhere_silent "benchmark started ($SCRIPT_PATH)"
+
+#
+# clear file
+#
+> $OUTPUT_FILE
+output "node_id,bench_id,impl_id,impl_id_reference,obj_cols,obj_rows,obj_levels,obj_cells,threads,runs,sweeps,runtime,runtime_reference,speedup,diff_max"
+
+#
+# ------------------------------
+#
+
+#
+# EXECUTION
+#
+
+SWEEP_LIST=($(echo $(seq $SWEEPS_MIN $SWEEPS_MAX)))
+
+for INDEX in ${!SWEEP_LIST[@]}; do
+  SWEEPS=${SWEEP_LIST[$INDEX]}
+
+  CURRENT_CMD="$APP_PATH $OBJ_COLS $OBJ_ROWS $OBJ_LEVELS $SWEEPS $APPLY_RUNS"
+
+  log_everywhere_silent "($(( $INDEX + 1 ))/${#SWEEP_LIST[@]}) \$ $CURRENT_CMD"
+  CURRENT_OUTPUT=$(export OMP_NUM_THREADS=$THREADS && export OMP_PLACES=$OMP_PLACES && export OMP_PROC_BIND=$OMP_PROC_BIND && $CURRENT_CMD)
+
+  #
+  # parse results
+  #
+
+  IMPL_ID=$(echo "$CURRENT_OUTPUT"           | grep "IMPL_ID_IMPL"                 | cut -d ',' -f 2)
+  IMPL_ID_REFERENCE=$(echo "$CURRENT_OUTPUT" | grep "IMPL_ID_REFERENCE_IMPL"       | cut -d ',' -f 2)
+  RUNTIME_APPLY=$(echo "$CURRENT_OUTPUT"     | grep "RUNTIME_APPLY_IMPL"           | cut -d ',' -f 2)
+  RUNTIME_APPLY_REFERENCE=$(echo "$CURRENT_OUTPUT" | grep "RUNTIME_APPLY_REFERENCE_IMPL" | cut -d ',' -f 2)
+  DIFF_MAX=$(echo "$CURRENT_OUTPUT"          | grep "DIFF_MAX_IMPL"                | cut -d ',' -f 2)
+
+  SPEEDUP=$(python3 -c "print($RUNTIME_APPLY_REFERENCE/$RUNTIME_APPLY)")
+
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID,$IMPL_ID_REFERENCE,$OBJ_COLS,$OBJ_ROWS,$OBJ_LEVELS,$OBJ_CELLS,$THREADS,$APPLY_RUNS,$SWEEPS,$RUNTIME_APPLY,$RUNTIME_APPLY_REFERENCE,$SPEEDUP,$DIFF_MAX"
+
+  TIME_CURRENT=$(timestamp)
+  log_everywhere_silent "=> Runtime temporal: $RUNTIME_APPLY sec"
+  log_everywhere_silent "=> Runtime reference: $RUNTIME_APPLY_REFERENCE sec"
+  log_everywhere_silent "=> Speedup: $SPEEDUP"
+  log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+  log_everywhere_silent "------------------"
+
+done
+
+#
+# ------------------------------
+#
+
+#
+# COMPLETED
+#
+
+TIME_CURRENT=$(timestamp)
+log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+log_everywhere "benchmark finished"
+log_everywhere_silent "=================="
+
+exit 0
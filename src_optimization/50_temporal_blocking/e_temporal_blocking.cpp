@@ -0,0 +1,218 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec4d;
+
+constexpr std::size_t OBJ_COLS =   1024;
+constexpr std::size_t OBJ_ROWS =   1024;
+constexpr std::size_t OBJ_LEVELS = 1024;
+
+constexpr VALUE_TYPE C = 0.1;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t SWEEPS = 4;
+constexpr std::size_t RUNS = 1;
+
+#include "c_linear_stencil_const_coeff.hpp"
+#include "c_linear_stencil_const_coeff_temporal.hpp"
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_sweeps,
+             std::size_t p_runs
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_x_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x = &(l_x_raw[l_objSize2d]);
+
+    ValueType * l_y_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_y = &(l_y_raw[l_objSize2d]);
+
+    ValueType * l_y_temporal = new ValueType[l_objCells];
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_x[i] = i % 100;
+            l_y[i] = 0;
+            l_y_temporal[i] = 0;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_x_raw[i] = 0;
+            l_x_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_y_raw[i] = 0;
+            l_y_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    CLinearStencilConstCoeff<ValueType,VecType> l_Op(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        C,
+        H,
+        TAU
+    );
+
+    CLinearStencilConstCoeffTemporal<ValueType,VecType> l_OpTemporal(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        p_sweeps,
+        C,
+        H,
+        TAU
+    );
+
+    //
+    // NOTE: temporal blocking, p_sweeps sweeps within one pass
+    //
+    double l_tStartTemporal = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            l_OpTemporal.apply(l_x,l_y_temporal);
+        }
+    }
+    double l_tEndTemporal = omp_get_wtime();
+    double l_tTemporal = l_tEndTemporal - l_tStartTemporal;
+
+    //
+    // NOTE: reference, p_sweeps independent apply calls (ping-pong)
+    //
+    double l_tStartApply = omp_get_wtime();
+    #pragma omp parallel
+    {
+        ValueType * l_x_t;
+        ValueType * l_y_t;
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            l_x_t = l_x;
+            l_y_t = l_y;
+            for (std::size_t j = 0; j < p_sweeps; ++j)
+            {
+                l_Op.apply(l_x_t,l_y_t);
+                #pragma omp barrier
+                l_x_t = l_y_t;
+                l_y_t = (l_y_t == l_y) ? l_x : l_y;
+            }
+        }
+    }
+    double l_tEndApply = omp_get_wtime();
+    double l_tApply = l_tEndApply - l_tStartApply;
+
+    //
+    // NOTE: the reference overwrites l_x for p_sweeps > 1, so only a single
+    //       run is compared
+    //
+    ValueType * l_y_reference = (p_sweeps % 2 == 1) ? l_y : l_x;
+    ValueType l_diffMax = 0;
+    if (p_runs == 1)
+    {
+        #pragma omp parallel for reduction(max: l_diffMax)
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_diffMax = std::max(l_diffMax, std::abs(l_y_temporal[i] - l_y_reference[i]));
+        }
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_OpTemporal.IDENTIFER << std::endl;
+    std::cout << "IMPL_ID_REFERENCE_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "SWEEPS_IMPL," << p_sweeps << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tTemporal << std::endl;
+    std::cout << "RUNTIME_APPLY_REFERENCE_IMPL," << l_tApply << std::endl;
+    std::cout << "DIFF_MAX_IMPL," << l_diffMax << std::endl;
+
+    delete [] l_x_raw;
+    delete [] l_y_raw;
+    delete [] l_y_temporal;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 5 && argc != 6)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 5 or 6" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_sweeps = SWEEPS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 5)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+        l_sweeps =    atoi(argv[4]);
+    }
+    if (argc == 6)
+    {
+        l_runs =   atoi(argv[5]);
+    }
+    if (l_sweeps < 1)
+    {
+        std::cout << "INVALID INPUT: sweeps must be >= 1" << std::endl;
+        return 1;
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_sweeps,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE_NARROW = Vec4d;
+using VEC_TYPE_WIDE = Vec8d;
+
+//
+// NOTE: OBJ_COLS does not have to be a multiple of the vector width,
+//       the last vector of each row is loaded/stored partially
+//
+constexpr std::size_t OBJ_COLS =   2048;
+constexpr std::size_t OBJ_ROWS =   2048;
+constexpr std::size_t OBJ_LEVELS = 2048;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_state_function_costly_1.hpp"
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStartApply = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEndApply = omp_get_wtime();
+    return l_tEndApply - l_tStartApply;
+}
+
+template <typename ValueType, typename VecTypeNarrow, typename VecTypeWide>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_x_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x = &(l_x_raw[l_objSize2d]);
+
+    ValueType * l_y_narrow = new ValueType[l_objCells];
+    ValueType * l_y_wide = new ValueType[l_objCells];
+
+    ValueType * l_c_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_c = &(l_c_raw[l_objSize2d]);
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_x[i] = i % 100;
+
+            l_y_narrow[i] = 0;
+            l_y_wide[i] = 0;
+            l_c[i] = C + i % 3;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_x_raw[i] = 0;
+            l_x_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_c_raw[i] = 0;
+            l_c_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    CNonlinearStencilPrecalc<CStateFunctionCostly1,ValueType,VecTypeNarrow> l_OpNarrow(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    CNonlinearStencilPrecalc<CStateFunctionCostly1,ValueType,VecTypeWide> l_OpWide(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    double l_tApplyNarrow = measure(l_OpNarrow, l_x, l_y_narrow, p_runs);
+    double l_tApplyWide = measure(l_OpWide, l_x, l_y_wide, p_runs);
+
+    //
+    // NOTE: both widths evaluate the same expression per lane
+    //
+    ValueType l_diffMax = 0;
+    #pragma omp parallel for reduction(max: l_diffMax)
+    for (std::size_t i = 0; i < l_objCells; ++i)
+    {
+        l_diffMax = std::max(l_diffMax, std::abs(l_y_wide[i] - l_y_narrow[i]));
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_OpWide.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "costly_1" << std::endl;
+    std::cout << "LANES_NARROW_IMPL," << VecTypeNarrow::size() << std::endl;
+    std::cout << "LANES_WIDE_IMPL," << VecTypeWide::size() << std::endl;
+    std::cout << "RUNTIME_APPLY_NARROW_IMPL," << l_tApplyNarrow << std::endl;
+    std::cout << "RUNTIME_APPLY_WIDE_IMPL," << l_tApplyWide << std::endl;
+    std::cout << "DIFF_MAX_IMPL," << l_diffMax << std::endl;
+
+    delete [] l_x_raw;
+    delete [] l_y_narrow;
+    delete [] l_y_wide;
+    delete [] l_c_raw;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE_NARROW, VEC_TYPE_WIDE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+#!/usr/bin/env bash
+
+#
+# CONFIG
+#
+
+THREADS=128
+
+APPLY_RUNS=10
+
+OBJ_SIZE_MIN=100
+OBJ_SIZE_MAX=1600
+OBJ_SIZE_STEP=20
+
+OMP_PLACES=threads
+OMP_PROC_BIND=spread
+
+# APP_PATH_DOUBLE=./e_nonlinear_stencil_precalc_mul2_double_256
+# APP_PATH_FLOAT=./e_nonlinear_stencil_precalc_mul2_float_256
+
+# APP_PATH_DOUBLE=./e_nonlinear_stencil_precalc_costly_1_double_512
+# APP_PATH_FLOAT=./e_nonlinear_stencil_precalc_costly_1_float_512
+
+APP_PATH_DOUBLE=./e_nonlinear_stencil_precalc_mul2_double_512
+APP_PATH_FLOAT=./e_nonlinear_stencil_precalc_mul2_float_512
+
+ENABLE_TELEGRAM=true
+
+#
+# ------------------------------
+#
+
+#
+# FUNCTIONS
+#
+
+filename() {
+  echo "$(basename $(readlink -f $1))"
+}
+filename_without_extension() {
+  local name=$(filename $0)
+  echo "${name%.*}"
+}
+
+log_console() {
+  echo -e "$BLUE $1 $NORMAL"
+}
+warning_console() {
+  echo -e "$YELLOW > WARNING - $1 $NORMAL"
+}
+
+error_console() {
+  echo ""
+  echo -e "$RED >>> ERROR - $1 $NORMAL" >&2
+}
+
+output() {
+  echo $1 >> $OUTPUT_FILE
+}
+
+log_telegram() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}" >/dev/null
+  fi
+}
+
+log_telegram_silent() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}&disable_notification=true" >/dev/null
+  fi
+}
+
+log_everywhere() {
+  log_console "$1"
+  log_telegram "$1"
+}
+
+log_everywhere_silent() {
+  log_console "$1"
+  log_telegram_silent "$1"
+}
+
+timestamp() {
+  date +%s
+}
+
+elapsedTimeMessage() {
+  local l_elapsed=$(( $2 - $1 ))
+  eval "echo Elapsed time: $(date -ud "@$l_elapsed" +'$((%s/3600/24)) days %H hr %M min %S sec')"
+}
+
+log_timestap_everywhere() {
+  local log_cmd=${1:-log_everywhere}
+  local time_current=$(timestamp)
+  $log_cmd "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $time_current)"
+}
+
+log_timestap_everywhere_silent() {
+  log_timestap_everywhere log_everywhere_silent
+}
+
+#
+# ------------------------------
+#
+
+#
+# ENVIRONMENT CHECK
+#
+
+if [ -z ${TELEGRAM_BOT_TOKEN} ]; then
+  error_console "TELEGRAM_BOT_TOKEN isn't defined."
+  exit 1
+fi
+if [ -z ${TELEGRAM_CHAT_ID} ]; then
+  error_console "TELEGRAM_CHAT_ID isn't defined."
+  exit 1
+fi
+
+#
+# ------------------------------
+#
+
+#
+# PROPERTIES
+#
+
+NODE_ID=${NODE_ID:-undefined_node}
+SCALE=strong
+SCRIPT_ID=$(filename_without_extension $0)
+REGION_ID_APPLY='apply'
+REGION_ID_OVERALL='overall'
+
+# Output colors
+NORMAL="\\033[0;39m"
+RED="\\033[1;31m"
+BLUE="\\033[0;34m"
+YELLOW="\\033[0;33m"
+
+OUTPUT_FILE="$SCRIPT_ID.csv"
+
+TIME_BENCHMARK_STARTED=$(timestamp)
+
+log_everywhere_silent "benchmark started ($SCRIPT_ID)"
+
+#
+# clear file
+#
+> $OUTPUT_FILE
+output "node_id,bench_id,impl_id,func_id,value_type,lanes,region_id,obj_cols,obj_rows,obj_levels,obj_cells,threads,runs,runtime,runtime_avg,efficiency"
+
+#
+# ------------------------------
+#
+
+#
+# EXECUTION
+#
+
+OBJ_SIZES=($(echo $(seq $OBJ_SIZE_MIN $OBJ_SIZE_STEP $OBJ_SIZE_MAX)))
+RUN_ID=0
+RUN_MAX=$(( ${#OBJ_SIZES[@]} * 2))
+for OBJ_SIZE in ${OBJ_SIZES[@]}; do
+  OBJ_CELLS=$(( $OBJ_SIZE * $OBJ_SIZE * $OBJ_SIZE ))
+
+  #
+  # run double
+  #
+
+  CMD_DOUBLE="$APP_PATH_DOUBLE $OBJ_SIZE $OBJ_SIZE $OBJ_SIZE $APPLY_RUNS"
+  log_timestap_everywhere_silent
+  log_everywhere_silent "($(( $RUN_ID + 1 ))/$RUN_MAX) \$ $CMD_DOUBLE"
+  OUTPUT_DOUBLE=$(export OMP_NUM_THREADS=$THREADS && export OMP_PLACES=$OMP_PLACES && export OMP_PROC_BIND=$OMP_PROC_BIND && $CMD_DOUBLE)
+  RUN_ID=$(( $RUN_ID + 1 ))
+
+  IMPL_ID_DOUBLE=$(echo "$OUTPUT_DOUBLE"         | grep "IMPL_ID_IMPL"         | cut -d ',' -f 2)
+  FUNC_ID_DOUBLE=$(echo "$OUTPUT_DOUBLE"         | grep "FUNC_ID_IMPL"         | cut -d ',' -f 2)
+  VALUE_TYPE_DOUBLE=$(echo "$OUTPUT_DOUBLE"      | grep "VALUE_TYPE_IMPL"      | cut -d ',' -f 2)
+  LANES_DOUBLE=$(echo "$OUTPUT_DOUBLE"           | grep "LANES_IMPL"           | cut -d ',' -f 2)
+  RUNTIME_APPLY_DOUBLE=$(echo "$OUTPUT_DOUBLE"   | grep "RUNTIME_APPLY_IMPL"   | cut -d ',' -f 2)
+  RUNTIME_OVERALL_DOUBLE=$(echo "$OUTPUT_DOUBLE" | grep "RUNTIME_OVERALL_IMPL" | cut -d ',' -f 2)
+  EFFICIENCY_APPLY_DOUBLE="1.0"
+  EFFICIENCY_OVERALL_DOUBLE="1.0"
+  RUNTIME_APPLY_DOUBLE_AVG=$(python3 -c "print($RUNTIME_APPLY_DOUBLE/$APPLY_RUNS)")
+  RUNTIME_OVERALL_DOUBLE_AVG=$(python3 -c "print($RUNTIME_OVERALL_DOUBLE/$APPLY_RUNS)")
+
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID_DOUBLE,$FUNC_ID_DOUBLE,$VALUE_TYPE_DOUBLE,$LANES_DOUBLE,$REGION_ID_APPLY,$OBJ_SIZE,$OBJ_SIZE,$OBJ_SIZE,$OBJ_CELLS,$THREADS,$APPLY_RUNS,$RUNTIME_APPLY_DOUBLE,$RUNTIME_APPLY_DOUBLE_AVG,$EFFICIENCY_APPLY_DOUBLE"
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID_DOUBLE,$FUNC_ID_DOUBLE,$VALUE_TYPE_DOUBLE,$LANES_DOUBLE,$REGION_ID_OVERALL,$OBJ_SIZE,$OBJ_SIZE,$OBJ_SIZE,$OBJ_CELLS,$THREADS,$APPLY_RUNS,$RUNTIME_OVERALL_DOUBLE,$RUNTIME_OVERALL_DOUBLE_AVG,$EFFICIENCY_OVERALL_DOUBLE"
+
+  log_everywhere_silent "=> Runtime overall double: $RUNTIME_OVERALL_DOUBLE sec"
+
+  #
+  # run float
+  #
+
+  CMD_FLOAT="$APP_PATH_FLOAT $OBJ_SIZE $OBJ_SIZE $OBJ_SIZE $APPLY_RUNS"
+  log_timestap_everywhere_silent
+  log_everywhere_silent "($(( $RUN_ID + 1 ))/$RUN_MAX) \$ $CMD_FLOAT"
+  OUTPUT_FLOAT=$(export OMP_NUM_THREADS=$THREADS && export OMP_PLACES=$OMP_PLACES && export OMP_PROC_BIND=$OMP_PROC_BIND && $CMD_FLOAT)
+  RUN_ID=$(( $RUN_ID + 1 ))
+
+  IMPL_ID_FLOAT=$(echo "$OUTPUT_FLOAT"         | grep "IMPL_ID_IMPL"         | cut -d ',' -f 2)
+  FUNC_ID_FLOAT=$(echo "$OUTPUT_FLOAT"         | grep "FUNC_ID_IMPL"         | cut -d ',' -f 2)
+  VALUE_TYPE_FLOAT=$(echo "$OUTPUT_FLOAT"      | grep "VALUE_TYPE_IMPL"      | cut -d ',' -f 2)
+  LANES_FLOAT=$(echo "$OUTPUT_FLOAT"           | grep "LANES_IMPL"           | cut -d ',' -f 2)
+  RUNTIME_APPLY_FLOAT=$(echo "$OUTPUT_FLOAT"   | grep "RUNTIME_APPLY_IMPL"   | cut -d ',' -f 2)
+  RUNTIME_OVERALL_FLOAT=$(echo "$OUTPUT_FLOAT" | grep "RUNTIME_OVERALL_IMPL" | cut -d ',' -f 2)
+  EFFICIENCY_APPLY_FLOAT=$(python3 -c "print($RUNTIME_APPLY_DOUBLE/$RUNTIME_APPLY_FLOAT)")
+  EFFICIENCY_OVERALL_FLOAT=$(python3 -c "print($RUNTIME_OVERALL_DOUBLE/$RUNTIME_OVERALL_FLOAT)")
+  RUNTIME_APPLY_FLOAT_AVG=$(python3 -c "print($RUNTIME_APPLY_FLOAT/$APPLY_RUNS)")
+  RUNTIME_OVERALL_FLOAT_AVG=$(python3 -c "print($RUNTIME_OVERALL_FLOAT/$APPLY_RUNS)")
+
+
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID_FLOAT,$FUNC_ID_FLOAT,$VALUE_TYPE_FLOAT,$LANES_FLOAT,$REGION_ID_APPLY,$OBJ_SIZE,$OBJ_SIZE,$OBJ_SIZE,$OBJ_CELLS,$THREADS,$APPLY_RUNS,$RUNTIME_APPLY_FLOAT,$RUNTIME_APPLY_FLOAT_AVG,$EFFICIENCY_APPLY_FLOAT"
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID_FLOAT,$FUNC_ID_FLOAT,$VALUE_TYPE_FLOAT,$LANES_FLOAT,$REGION_ID_OVERALL,$OBJ_SIZE,$OBJ_SIZE,$OBJ_SIZE,$OBJ_CELLS,$THREADS,$APPLY_RUNS,$RUNTIME_OVERALL_FLOAT,$RUNTIME_OVERALL_FLOAT_AVG,$EFFICIENCY_OVERALL_FLOAT"
+
+  log_everywhere_silent "=> Runtime overall float: $RUNTIME_OVERALL_FLOAT sec"
+  log_everywhere_silent "=> Efficiency overall float: $EFFICIENCY_OVERALL_FLOAT"
+  log_everywhere_silent "------------------"
+
+done
+
+#
+# ------------------------------
+#
+
+#
+# COMPLETED
+#
+
+log_everywhere "benchmark finished"
+log_timestap_everywhere_silent
+log_everywhere_silent "=================="
+
+exit 0
@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+#ifndef VEC_BITS
+#define VEC_BITS 512
+#endif
+
+#if VEC_BITS == 256
+using VEC_TYPE_DOUBLE = Vec4d;
+using VEC_TYPE_FLOAT = Vec8f;
+#else
+using VEC_TYPE_DOUBLE = Vec8d;
+using VEC_TYPE_FLOAT = Vec16f;
+#endif
+
+//
+// NOTE: no multiple of the vector width on purpose
+//
+constexpr std::size_t OBJ_COLS =   253;
+constexpr std::size_t OBJ_ROWS =   256;
+constexpr std::size_t OBJ_LEVELS = 256;
+
+constexpr double C = 1.0;
+constexpr double H = 1.0;
+constexpr double TAU = 0.1;
+
+constexpr std::size_t ITER_SOLVER_MAX = 20;
+constexpr std::size_t ITER_STEP_CALC_MAX = 3;
+
+constexpr double EPSILON_OPERATOR = 1e-30;
+constexpr double EPSILON_SOLVER = 1e-30;
+constexpr double EPSILON_STEP_CALC = 1e-30;
+
+//
+// NOTE: float has ~7 significant digits, the accepted relative error
+//       covers the rounding of the coefficients and of 20 cg iterations
+//
+constexpr double EPSILON_VERIFY_APPLY = 1e-5;
+constexpr double EPSILON_VERIFY_SOLVE = 1e-4;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_state_function_mul2.hpp"
+#include "c_cg.hpp"
+#include "c_timestep_calculator.hpp"
+
+//
+// runs apply and the timestep calculation in ValueType, results are
+// returned in double for the comparison
+//
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             double * p_y,
+             double * p_x
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_b_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_b = &(l_b_raw[l_objSize2d]);
+
+    ValueType * l_y = new ValueType[l_objCells];
+    ValueType * l_x = new ValueType[l_objCells];
+
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_b[i] = ValueType(1 + i % 100);
+            l_y[i] = 0;
+            l_x[i] = 0;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_b_raw[i] = 0;
+            l_b_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    CNonlinearStencilPrecalc<CStateFunctionMul2,ValueType,VecType> l_Op(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_b,
+        ValueType(H),
+        ValueType(TAU),
+        ValueType(EPSILON_OPERATOR)
+    );
+
+    #pragma omp parallel
+    {
+        l_Op.apply(l_b,l_y);
+    }
+
+    CCG<ValueType> l_solver;
+    C_TimestepCalculator<ValueType> l_stepCalc;
+
+    l_stepCalc(
+        l_objCells,
+        l_solver,
+        l_Op,
+        l_b,
+        l_x,
+        ValueType(EPSILON_SOLVER),
+        ValueType(EPSILON_STEP_CALC),
+        ITER_SOLVER_MAX,
+        ITER_STEP_CALC_MAX,
+        l_objSize2d);
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < l_objCells; ++i)
+    {
+        p_y[i] = l_y[i];
+        p_x[i] = l_x[i];
+    }
+
+    delete [] l_b_raw;
+    delete [] l_y;
+    delete [] l_x;
+}
+
+//
+// NOTE: normwise, the stencil cancels large terms, so the error of a single
+//       cell relative to its own value is not meaningful
+//
+double diffRelMax(const double * p_v_0, const double * p_v_1, std::size_t p_size)
+{
+    double l_diffMax = 0;
+    double l_valueMax = 0;
+    #pragma omp parallel for reduction(max: l_diffMax, l_valueMax)
+    for (std::size_t i = 0; i < p_size; ++i)
+    {
+        l_diffMax = std::max(l_diffMax, std::abs(p_v_0[i] - p_v_1[i]));
+        l_valueMax = std::max(l_valueMax, std::abs(p_v_0[i]));
+    }
+    return l_diffMax / l_valueMax;
+}
+
+int main()
+{
+    std::size_t l_objCells = OBJ_COLS * OBJ_ROWS * OBJ_LEVELS;
+
+    double * l_y_double = new double[l_objCells];
+    double * l_x_double = new double[l_objCells];
+    double * l_y_float = new double[l_objCells];
+    double * l_x_float = new double[l_objCells];
+
+    std::cout << std::endl;
+    std::cout << "> double (" << VEC_TYPE_DOUBLE::size() << " lanes)" << std::endl;
+    routine<double, VEC_TYPE_DOUBLE>(OBJ_COLS, OBJ_ROWS, OBJ_LEVELS, l_y_double, l_x_double);
+
+    std::cout << std::endl;
+    std::cout << "> float (" << VEC_TYPE_FLOAT::size() << " lanes)" << std::endl;
+    routine<float, VEC_TYPE_FLOAT>(OBJ_COLS, OBJ_ROWS, OBJ_LEVELS, l_y_float, l_x_float);
+
+    double l_diffApply = diffRelMax(l_y_double, l_y_float, l_objCells);
+    double l_diffSolve = diffRelMax(l_x_double, l_x_float, l_objCells);
+
+    std::cout << std::endl;
+    std::cout << "DIFF_REL_MAX_APPLY_IMPL," << l_diffApply << std::endl;
+    std::cout << "DIFF_REL_MAX_SOLVE_IMPL," << l_diffSolve << std::endl;
+
+    assert(l_diffApply < EPSILON_VERIFY_APPLY);
+    assert(l_diffSolve < EPSILON_VERIFY_SOLVE);
+
+    std::cout << std::endl;
+    std::cout << "> float path verified" << std::endl;
+
+    delete [] l_y_double;
+    delete [] l_x_double;
+    delete [] l_y_float;
+    delete [] l_x_float;
+
+    return 0;
+}
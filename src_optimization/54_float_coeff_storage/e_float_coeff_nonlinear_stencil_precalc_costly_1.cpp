@@ -0,0 +1,273 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+//
+// NOTE: coefficients of the reduced variant, widened to VALUE_TYPE in
+//       registers
+//
+using STORAGE_TYPE = float;
+
+constexpr std::size_t OBJ_COLS =   512;
+constexpr std::size_t OBJ_ROWS =   512;
+constexpr std::size_t OBJ_LEVELS = 512;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+constexpr std::size_t ITER_SOLVER_MAX = 20;
+constexpr std::size_t ITER_STEP_CALC_MAX = 3;
+
+constexpr VALUE_TYPE EPSILON_SOLVER = 1e-30;
+constexpr VALUE_TYPE EPSILON_STEP_CALC = 1e-30;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_state_function_costly_1.hpp"
+#include "c_cg.hpp"
+#include "c_timestep_calculator.hpp"
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStartApply = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEndApply = omp_get_wtime();
+    return l_tEndApply - l_tStartApply;
+}
+
+//
+// NOTE: normwise, the stencil cancels large terms, so the error of a single
+//       cell relative to its own value is not meaningful
+//
+template <typename ValueType>
+ValueType diffRelMax(const ValueType * p_v_0, const ValueType * p_v_1, std::size_t p_size)
+{
+    ValueType l_diffMax = 0;
+    ValueType l_valueMax = 0;
+    #pragma omp parallel for reduction(max: l_diffMax, l_valueMax)
+    for (std::size_t i = 0; i < p_size; ++i)
+    {
+        l_diffMax = std::max(l_diffMax, std::abs(p_v_0[i] - p_v_1[i]));
+        l_valueMax = std::max(l_valueMax, std::abs(p_v_0[i]));
+    }
+    return l_diffMax / l_valueMax;
+}
+
+//
+// NOTE: the time step is computed with the iteration counts fixed, so that
+//       both variants do the same amount of work
+//
+template <typename OperatorType, typename ValueType>
+double solve(OperatorType & p_Op,
+             std::size_t p_objSize2d,
+             std::size_t p_objCells,
+             const ValueType * p_b,
+             ValueType * p_x
+)
+{
+    CCG<ValueType> l_solver;
+    C_TimestepCalculator<ValueType> l_stepCalc;
+
+    double l_tStartSolve = omp_get_wtime();
+    l_stepCalc(
+        p_objCells,
+        l_solver,
+        p_Op,
+        p_b,
+        p_x,
+        EPSILON_SOLVER,
+        EPSILON_STEP_CALC,
+        ITER_SOLVER_MAX,
+        ITER_STEP_CALC_MAX,
+        p_objSize2d);
+    double l_tEndSolve = omp_get_wtime();
+    return l_tEndSolve - l_tStartSolve;
+}
+
+template <typename ValueType, typename VecType, typename StorageType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_x_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x = &(l_x_raw[l_objSize2d]);
+
+    ValueType * l_y_reference = new ValueType[l_objCells];
+    ValueType * l_y_reduced = new ValueType[l_objCells];
+    ValueType * l_x_reference = new ValueType[l_objCells];
+    ValueType * l_x_reduced = new ValueType[l_objCells];
+
+    ValueType * l_c_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_c = &(l_c_raw[l_objSize2d]);
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_x[i] = i % 100;
+
+            l_y_reference[i] = 0;
+            l_y_reduced[i] = 0;
+            l_x_reference[i] = 0;
+            l_x_reduced[i] = 0;
+            l_c[i] = C + i % 3;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_x_raw[i] = 0;
+            l_x_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_c_raw[i] = 0;
+            l_c_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    CNonlinearStencilPrecalc<CStateFunctionCostly1,ValueType,VecType> l_OpReference(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    CNonlinearStencilPrecalc<CStateFunctionCostly1,ValueType,VecType,false,StorageType> l_OpReduced(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    double l_tApplyReference = measure(l_OpReference, l_x, l_y_reference, p_runs);
+    double l_tApplyReduced = measure(l_OpReduced, l_x, l_y_reduced, p_runs);
+
+    ValueType l_diffApply = diffRelMax(l_y_reference, l_y_reduced, l_objCells);
+
+    double l_tSolveReference = solve(l_OpReference, l_objSize2d, l_objCells, l_x, l_x_reference);
+    double l_tSolveReduced = solve(l_OpReduced, l_objSize2d, l_objCells, l_x, l_x_reduced);
+
+    ValueType l_diffSolve = diffRelMax(l_x_reference, l_x_reduced, l_objCells);
+
+    //
+    // NOTE: x, y and the 4 coefficient arrays are streamed once per apply,
+    //       the lower coefficients are shifted views of the upper ones
+    //
+    std::size_t l_bytesReference = l_objCells * (2 * sizeof(ValueType) + 4 * sizeof(ValueType));
+    std::size_t l_bytesReduced = l_objCells * (2 * sizeof(ValueType) + 4 * sizeof(StorageType));
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_OpReduced.IDENTIFER << std::endl;
+    std::cout << "IMPL_ID_REFERENCE_IMPL," << l_OpReference.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "costly_1" << std::endl;
+    std::cout << "LANES_IMPL," << VecType::size() << std::endl;
+    std::cout << "BYTES_APPLY_IMPL," << l_bytesReduced << std::endl;
+    std::cout << "BYTES_APPLY_REFERENCE_IMPL," << l_bytesReference << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tApplyReduced << std::endl;
+    std::cout << "RUNTIME_APPLY_REFERENCE_IMPL," << l_tApplyReference << std::endl;
+    std::cout << "DIFF_REL_MAX_APPLY_IMPL," << l_diffApply << std::endl;
+    std::cout << "RUNTIME_SOLVE_IMPL," << l_tSolveReduced << std::endl;
+    std::cout << "RUNTIME_SOLVE_REFERENCE_IMPL," << l_tSolveReference << std::endl;
+    std::cout << "DIFF_REL_MAX_SOLVE_IMPL," << l_diffSolve << std::endl;
+
+    delete [] l_x_raw;
+    delete [] l_y_reference;
+    delete [] l_y_reduced;
+    delete [] l_x_reference;
+    delete [] l_x_reduced;
+    delete [] l_c_raw;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE, STORAGE_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   2048;
+constexpr std::size_t OBJ_ROWS =   2048;
+constexpr std::size_t OBJ_LEVELS = 2048;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_state_function_costly_1.hpp"
+
+template <typename OperatorType, typename ValueType>
+double measureSetState(OperatorType & p_Op,
+                       const ValueType * p_s,
+                       std::size_t p_runs
+)
+{
+    double l_tStartSetState = omp_get_wtime();
+    for (std::size_t i = 0; i < p_runs; ++i)
+    {
+        p_Op.setState(p_s);
+    }
+    double l_tEndSetState = omp_get_wtime();
+    return l_tEndSetState - l_tStartSetState;
+}
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStartApply = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEndApply = omp_get_wtime();
+    return l_tEndApply - l_tStartApply;
+}
+
+//
+// NOTE: normwise, the stencil cancels large terms, so the error of a single
+//       cell relative to its own value is not meaningful
+//
+template <typename ValueType>
+ValueType diffRelMax(const ValueType * p_v_0, const ValueType * p_v_1, std::size_t p_size)
+{
+    ValueType l_diffMax = 0;
+    ValueType l_valueMax = 0;
+    #pragma omp parallel for reduction(max: l_diffMax, l_valueMax)
+    for (std::size_t i = 0; i < p_size; ++i)
+    {
+        l_diffMax = std::max(l_diffMax, std::abs(p_v_0[i] - p_v_1[i]));
+        l_valueMax = std::max(l_valueMax, std::abs(p_v_0[i]));
+    }
+    return l_diffMax / l_valueMax;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_x_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x = &(l_x_raw[l_objSize2d]);
+
+    ValueType * l_y_reference = new ValueType[l_objCells];
+    ValueType * l_y_diagonal_free = new ValueType[l_objCells];
+
+    ValueType * l_c_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_c = &(l_c_raw[l_objSize2d]);
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_x[i] = i % 100;
+
+            l_y_reference[i] = 0;
+            l_y_diagonal_free[i] = 0;
+            l_c[i] = C + i % 3;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_x_raw[i] = 0;
+            l_x_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_c_raw[i] = 0;
+            l_c_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    CNonlinearStencilPrecalc<CStateFunctionCostly1,ValueType,VecType> l_OpReference(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    CNonlinearStencilPrecalc<CStateFunctionCostly1,ValueType,VecType,false,ValueType,true> l_OpDiagonalFree(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    double l_tApplyReference = measure(l_OpReference, l_x, l_y_reference, p_runs);
+    double l_tApplyDiagonalFree = measure(l_OpDiagonalFree, l_x, l_y_diagonal_free, p_runs);
+
+    ValueType l_diffApply = diffRelMax(l_y_reference, l_y_diagonal_free, l_objCells);
+
+    double l_tSetStateReference = measureSetState(l_OpReference, l_c, p_runs);
+    double l_tSetStateDiagonalFree = measureSetState(l_OpDiagonalFree, l_c, p_runs);
+
+    //
+    // NOTE: x, y and the coefficient arrays are streamed once per apply,
+    //       the lower coefficients are shifted views of the upper ones
+    //
+    std::size_t l_bytesReference = l_objCells * (2 * sizeof(ValueType) + 4 * sizeof(ValueType));
+    std::size_t l_bytesDiagonalFree = l_objCells * (2 * sizeof(ValueType) + 3 * sizeof(ValueType));
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_OpDiagonalFree.IDENTIFER << std::endl;
+    std::cout << "IMPL_ID_REFERENCE_IMPL," << l_OpReference.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "costly_1" << std::endl;
+    std::cout << "LANES_IMPL," << VecType::size() << std::endl;
+    std::cout << "BYTES_APPLY_IMPL," << l_bytesDiagonalFree << std::endl;
+    std::cout << "BYTES_APPLY_REFERENCE_IMPL," << l_bytesReference << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tApplyDiagonalFree << std::endl;
+    std::cout << "RUNTIME_APPLY_REFERENCE_IMPL," << l_tApplyReference << std::endl;
+    std::cout << "DIFF_REL_MAX_APPLY_IMPL," << l_diffApply << std::endl;
+    std::cout << "RUNTIME_SET_STATE_IMPL," << l_tSetStateDiagonalFree << std::endl;
+    std::cout << "RUNTIME_SET_STATE_REFERENCE_IMPL," << l_tSetStateReference << std::endl;
+
+    delete [] l_x_raw;
+    delete [] l_y_reference;
+    delete [] l_y_diagonal_free;
+    delete [] l_c_raw;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_roofline.sh ./e_nonlinear_stencil_precalc_mul2_likwid
+../e_roofline.sh ./e_nonlinear_stencil_precalc_diagonal_free_mul2_likwid
@@ -0,0 +1,419 @@
+/*
+ * Reference for e_set_state_*: CNonlinearStencilPrecalc as of before
+ * setState evaluated StateFunc once per cell, i.e. seven evaluations per
+ * cell (centre and all six neighbours).
+ *
+ * SplitRegions = true: setState computes the coefficients of the interior,
+ * the faces, the edges and the corners by separate kernels, see
+ * CLinearStencilNonconstCoeff. apply does not depend on the boundary.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <omp.h>
+#include "i_nonlinear_operator.hpp"
+#include "c_vec_utils.hpp"
+
+template <template<typename ValueType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions = false>
+class CNonlinearStencilPrecalcReference : public INonlinearOperator<ValueType>
+{
+   private:
+      using VecUtils = CVecUtils<ValueType, VecType>;
+
+      std::size_t m_objCols;
+      std::size_t m_objRows;
+      std::size_t m_objLevels;
+      std::size_t m_objSize1d;
+      std::size_t m_objSize2d;
+      std::size_t m_objSize3d;
+      const ValueType m_factor;
+      const ValueType m_epsilon;
+      ValueType * m_v_LL;
+      ValueType * m_v_RL;
+      ValueType * m_v_CL;
+      ValueType * m_v;
+      ValueType * m_v_CU;
+      ValueType * m_v_RU;
+      ValueType * m_v_LU;
+
+      void setStateMasked(const ValueType * __restrict__ p_s);
+      void setStateSplit(const ValueType * __restrict__ p_s);
+      template <bool HasLL, bool HasLU>
+      void setStateLevel(const ValueType * __restrict__ p_s, const std::size_t p_pos_L);
+      template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+      void setStateRow(const ValueType * __restrict__ p_s, const std::size_t p_pos_L, const std::size_t p_pos_R);
+      template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+      void setStateVec(const ValueType * __restrict__ p_s, const std::size_t p_pos, const std::size_t p_pos_C);
+
+ public:
+    CNonlinearStencilPrecalcReference(
+      const std::size_t p_objCols,
+      const std::size_t p_objRows,
+      const std::size_t p_objLevels,
+      ValueType * p_s,
+      const ValueType p_h = ValueType(1.0),
+      const ValueType p_tau = ValueType(1.0),
+      const ValueType p_epsilon = ValueType(1e-15)
+      );
+      inline static const std::string IDENTIFER = SplitRegions ? "nonlinear_stencil_precalc_reference_split" : "nonlinear_stencil_precalc_reference";
+    void apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const;
+    void setState(const ValueType * __restrict__ p_s);
+    ~CNonlinearStencilPrecalcReference();
+};
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::CNonlinearStencilPrecalcReference(
+   const std::size_t p_objCols,
+   const std::size_t p_objRows,
+   const std::size_t p_objLevels,
+   ValueType * p_s,
+   const ValueType p_h,
+   const ValueType p_tau,
+   const ValueType p_epsilon
+   ):
+m_objCols(p_objCols),
+m_objRows(p_objRows),
+m_objLevels(p_objLevels),
+m_objSize1d(p_objCols),
+m_objSize2d(p_objCols * p_objRows),
+m_objSize3d(p_objCols * p_objRows * p_objLevels),
+m_factor(p_tau/(p_h*p_h)),
+m_epsilon(p_epsilon)
+{
+   //
+   // NOTE "+1" so that upper vectors can be referenced in a shifted way
+   //
+   m_v_LL = new ValueType[m_objSize3d+m_objSize2d];
+   m_v_RL = new ValueType[m_objSize3d+m_objSize1d];
+   m_v_CL = new ValueType[m_objSize3d+1];
+   m_v    = new ValueType[m_objSize3d];
+
+   m_v_CU = &(m_v_CL[1]);
+   m_v_RU = &(m_v_RL[m_objSize1d]);
+   m_v_LU = &(m_v_LL[m_objSize2d]);
+
+
+   m_v_CL[0] = ValueType(0);
+   //
+   // first touch
+   //
+   #pragma omp parallel
+   {
+      #pragma omp for
+      for (size_t i = 0; i < m_objSize3d; ++i)
+      {
+         m_v_LU[i] = ValueType(0);
+         m_v_RU[i] = ValueType(0);
+         m_v_CU[i] = ValueType(0);
+         m_v[i]    = ValueType(0);
+      }
+      #pragma omp for
+      for (size_t i = 0; i < m_objSize1d; ++i)
+      {
+         m_v_RL[i] = ValueType(0);
+      }
+      #pragma omp for
+      for (size_t i = 0; i < m_objSize2d; ++i)
+      {
+         m_v_LL[i] = ValueType(0);
+      }
+   }
+
+   setState(p_s);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+void CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::setState(const ValueType * __restrict__ p_s)
+{
+   if constexpr (SplitRegions)
+   {
+      setStateSplit(p_s);
+   }
+   else
+   {
+      setStateMasked(p_s);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+void CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::setStateMasked(const ValueType * __restrict__ p_s)
+{
+   #pragma omp parallel
+   {
+      std::size_t l_pos;
+      std::size_t l_n;
+
+      VecType l_pos_C_Vec;
+
+      VecType l_lane_Vec = VecUtils::lanes();
+
+      VecType l_s_LL_Vec;
+      VecType l_s_RL_Vec;
+      VecType l_s_CL_Vec;
+      VecType l_s_Vec;
+      VecType l_s_CU_Vec;
+      VecType l_s_RU_Vec;
+      VecType l_s_LU_Vec;
+
+      VecType l_v_LL_Vec;
+      VecType l_v_RL_Vec;
+      VecType l_v_CL_Vec;
+      VecType l_v_Vec;
+      VecType l_v_CU_Vec;
+      VecType l_v_RU_Vec;
+      VecType l_v_LU_Vec;
+
+      #pragma omp for
+      for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+      {
+         for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+         {
+            for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+            {
+               l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+               l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+               l_pos_C_Vec = l_lane_Vec + ValueType(l_pos_C);
+
+               VecUtils::load(l_s_LL_Vec, p_s + l_pos - m_objSize2d, l_n);
+               VecUtils::load(l_s_RL_Vec, p_s + l_pos - m_objSize1d, l_n);
+               VecUtils::load(l_s_CL_Vec, p_s + l_pos - 1          , l_n);
+               VecUtils::load(l_s_Vec,    p_s + l_pos              , l_n);
+               VecUtils::load(l_s_CU_Vec, p_s + l_pos + 1          , l_n);
+               VecUtils::load(l_s_RU_Vec, p_s + l_pos + m_objSize1d, l_n);
+               VecUtils::load(l_s_LU_Vec, p_s + l_pos + m_objSize2d, l_n);
+
+               StateFunc<VecType>::apply(l_s_LL_Vec);
+               StateFunc<VecType>::apply(l_s_RL_Vec);
+               StateFunc<VecType>::apply(l_s_CL_Vec);
+               StateFunc<VecType>::apply(l_s_Vec);
+               StateFunc<VecType>::apply(l_s_CU_Vec);
+               StateFunc<VecType>::apply(l_s_RU_Vec);
+               StateFunc<VecType>::apply(l_s_LU_Vec);
+
+               l_v_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+               l_v_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+
+               l_v_LL_Vec = (1-((m_objLevels-1-l_pos_L)/(m_objLevels-1))) * m_factor * 2 * l_s_Vec * l_s_LL_Vec / (l_s_Vec+l_s_LL_Vec+m_epsilon);
+               l_v_RL_Vec = (1-((m_objRows-1-l_pos_R)  /(m_objRows-1)))   * m_factor * 2 * l_s_Vec * l_s_RL_Vec / (l_s_Vec+l_s_RL_Vec+m_epsilon);
+               l_v_CL_Vec *=                                                           2 * l_s_Vec * l_s_CL_Vec / (l_s_Vec+l_s_CL_Vec+m_epsilon);
+               l_v_CU_Vec *=                                                           2 * l_s_Vec * l_s_CU_Vec / (l_s_Vec+l_s_CU_Vec+m_epsilon);
+               l_v_RU_Vec = (1-(l_pos_R                /(m_objRows-1)))   * m_factor * 2 * l_s_Vec * l_s_RU_Vec / (l_s_Vec+l_s_RU_Vec+m_epsilon);
+               l_v_LU_Vec = (1-(l_pos_L                /(m_objLevels-1))) * m_factor * 2 * l_s_Vec * l_s_LU_Vec / (l_s_Vec+l_s_LU_Vec+m_epsilon);
+
+               l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+
+               VecUtils::store(l_v_Vec,    m_v    + l_pos, l_n);
+               VecUtils::store(l_v_CU_Vec, m_v_CU + l_pos, l_n);
+               VecUtils::store(l_v_RU_Vec, m_v_RU + l_pos, l_n);
+               VecUtils::store(l_v_LU_Vec, m_v_LU + l_pos, l_n);
+            }
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+void CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::setStateSplit(const ValueType * __restrict__ p_s)
+{
+   #pragma omp parallel
+   {
+      #pragma omp for
+      for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+      {
+         if (l_pos_L == 0)
+         {
+            setStateLevel<false, true>(p_s, l_pos_L);
+         }
+         else if (l_pos_L == m_objLevels-1)
+         {
+            setStateLevel<true, false>(p_s, l_pos_L);
+         }
+         else
+         {
+            setStateLevel<true, true>(p_s, l_pos_L);
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+template <bool HasLL, bool HasLU>
+void CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::setStateLevel(const ValueType * __restrict__ p_s, const std::size_t p_pos_L)
+{
+   setStateRow<HasLL, false, true, HasLU>(p_s, p_pos_L, 0);
+   for (std::size_t l_pos_R=1; l_pos_R<m_objRows-1; ++l_pos_R)
+   {
+      setStateRow<HasLL, true, true, HasLU>(p_s, p_pos_L, l_pos_R);
+   }
+   setStateRow<HasLL, true, false, HasLU>(p_s, p_pos_L, m_objRows-1);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU>
+void CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::setStateRow(const ValueType * __restrict__ p_s, const std::size_t p_pos_L, const std::size_t p_pos_R)
+{
+   std::size_t l_pos_row = p_pos_L * m_objSize2d + p_pos_R * m_objSize1d;
+   std::size_t l_pos_C_last = ((m_objCols-1)/VecType::size())*VecType::size();
+
+   setStateVec<HasLL, HasRL, HasRU, HasLU, true>(p_s, l_pos_row, 0);
+   for (std::size_t l_pos_C=VecType::size(); l_pos_C<l_pos_C_last; l_pos_C+=VecType::size())
+   {
+      setStateVec<HasLL, HasRL, HasRU, HasLU, false>(p_s, l_pos_row + l_pos_C, l_pos_C);
+   }
+   if (l_pos_C_last > 0)
+   {
+      setStateVec<HasLL, HasRL, HasRU, HasLU, true>(p_s, l_pos_row + l_pos_C_last, l_pos_C_last);
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+template <bool HasLL, bool HasRL, bool HasRU, bool HasLU, bool ColBoundary>
+inline void CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::setStateVec(const ValueType * __restrict__ p_s, const std::size_t p_pos, const std::size_t p_pos_C)
+{
+   std::size_t l_n = ColBoundary ? VecUtils::lanesValid(p_pos_C, m_objCols) : VecType::size();
+
+   VecType l_s_LL_Vec;
+   VecType l_s_RL_Vec;
+   VecType l_s_CL_Vec;
+   VecType l_s_Vec;
+   VecType l_s_CU_Vec;
+   VecType l_s_RU_Vec;
+   VecType l_s_LU_Vec;
+
+   VecType l_v_LL_Vec(0);
+   VecType l_v_RL_Vec(0);
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec(0);
+   VecType l_v_LU_Vec(0);
+
+   VecUtils::load(l_s_CL_Vec, p_s + p_pos - 1, l_n);
+   VecUtils::load(l_s_Vec,    p_s + p_pos    , l_n);
+   VecUtils::load(l_s_CU_Vec, p_s + p_pos + 1, l_n);
+
+   StateFunc<VecType>::apply(l_s_CL_Vec);
+   StateFunc<VecType>::apply(l_s_Vec);
+   StateFunc<VecType>::apply(l_s_CU_Vec);
+
+   if constexpr (ColBoundary)
+   {
+      VecType l_pos_C_Vec = VecUtils::lanes() + ValueType(p_pos_C);
+
+      l_v_CL_Vec = select(l_pos_C_Vec>ValueType(0),           VecType(m_factor), VecType(0));
+      l_v_CU_Vec = select(l_pos_C_Vec<ValueType(m_objCols-1), VecType(m_factor), VecType(0));
+   }
+   else
+   {
+      l_v_CL_Vec = VecType(m_factor);
+      l_v_CU_Vec = VecType(m_factor);
+   }
+
+   if constexpr (HasLL)
+   {
+      VecUtils::load(l_s_LL_Vec, p_s + p_pos - m_objSize2d, l_n);
+      StateFunc<VecType>::apply(l_s_LL_Vec);
+      l_v_LL_Vec = m_factor * 2 * l_s_Vec * l_s_LL_Vec / (l_s_Vec+l_s_LL_Vec+m_epsilon);
+   }
+   if constexpr (HasRL)
+   {
+      VecUtils::load(l_s_RL_Vec, p_s + p_pos - m_objSize1d, l_n);
+      StateFunc<VecType>::apply(l_s_RL_Vec);
+      l_v_RL_Vec = m_factor * 2 * l_s_Vec * l_s_RL_Vec / (l_s_Vec+l_s_RL_Vec+m_epsilon);
+   }
+   l_v_CL_Vec *=              2 * l_s_Vec * l_s_CL_Vec / (l_s_Vec+l_s_CL_Vec+m_epsilon);
+   l_v_CU_Vec *=              2 * l_s_Vec * l_s_CU_Vec / (l_s_Vec+l_s_CU_Vec+m_epsilon);
+   if constexpr (HasRU)
+   {
+      VecUtils::load(l_s_RU_Vec, p_s + p_pos + m_objSize1d, l_n);
+      StateFunc<VecType>::apply(l_s_RU_Vec);
+      l_v_RU_Vec = m_factor * 2 * l_s_Vec * l_s_RU_Vec / (l_s_Vec+l_s_RU_Vec+m_epsilon);
+   }
+   if constexpr (HasLU)
+   {
+      VecUtils::load(l_s_LU_Vec, p_s + p_pos + m_objSize2d, l_n);
+      StateFunc<VecType>::apply(l_s_LU_Vec);
+      l_v_LU_Vec = m_factor * 2 * l_s_Vec * l_s_LU_Vec / (l_s_Vec+l_s_LU_Vec+m_epsilon);
+   }
+
+   l_v_Vec = 1 + l_v_LL_Vec + l_v_RL_Vec + l_v_CL_Vec + l_v_CU_Vec + l_v_RU_Vec + l_v_LU_Vec;
+
+   VecUtils::store(l_v_Vec,    m_v    + p_pos, l_n);
+   VecUtils::store(l_v_CU_Vec, m_v_CU + p_pos, l_n);
+   VecUtils::store(l_v_RU_Vec, m_v_RU + p_pos, l_n);
+   VecUtils::store(l_v_LU_Vec, m_v_LU + p_pos, l_n);
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+void CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::apply(const ValueType * __restrict__ p_x, ValueType * __restrict__ p_y) const
+{
+   std::size_t l_pos;
+   std::size_t l_n;
+
+   VecType l_x_LL_Vec;
+   VecType l_x_RL_Vec;
+   VecType l_x_CL_Vec;
+   VecType l_x_Vec;
+   VecType l_x_CU_Vec;
+   VecType l_x_RU_Vec;
+   VecType l_x_LU_Vec;
+
+   VecType l_y_Vec;
+
+   VecType l_v_LL_Vec;
+   VecType l_v_RL_Vec;
+   VecType l_v_CL_Vec;
+   VecType l_v_Vec;
+   VecType l_v_CU_Vec;
+   VecType l_v_RU_Vec;
+   VecType l_v_LU_Vec;
+
+   #pragma omp for
+   for (std::size_t l_pos_L=0; l_pos_L<m_objLevels; ++l_pos_L)
+   {
+      for (std::size_t l_pos_R=0; l_pos_R<m_objRows; ++l_pos_R)
+      {
+         for (std::size_t l_pos_C=0; l_pos_C<m_objCols; l_pos_C+=VecType::size())
+         {
+            l_pos = l_pos_L * m_objSize2d + l_pos_R * m_objSize1d + l_pos_C;
+            l_n = VecUtils::lanesValid(l_pos_C, m_objCols);
+
+            VecUtils::load(l_x_LL_Vec, p_x + l_pos - m_objSize2d, l_n);
+            VecUtils::load(l_x_RL_Vec, p_x + l_pos - m_objSize1d, l_n);
+            VecUtils::load(l_x_CL_Vec, p_x + l_pos - 1          , l_n);
+            VecUtils::load(l_x_Vec,    p_x + l_pos              , l_n);
+            VecUtils::load(l_x_CU_Vec, p_x + l_pos + 1          , l_n);
+            VecUtils::load(l_x_RU_Vec, p_x + l_pos + m_objSize1d, l_n);
+            VecUtils::load(l_x_LU_Vec, p_x + l_pos + m_objSize2d, l_n);
+
+            VecUtils::load(l_v_LL_Vec, m_v_LL + l_pos, l_n);
+            VecUtils::load(l_v_RL_Vec, m_v_RL + l_pos, l_n);
+            VecUtils::load(l_v_CL_Vec, m_v_CL + l_pos, l_n);
+            VecUtils::load(l_v_Vec,    m_v    + l_pos, l_n);
+            VecUtils::load(l_v_CU_Vec, m_v_CU + l_pos, l_n);
+            VecUtils::load(l_v_RU_Vec, m_v_RU + l_pos, l_n);
+            VecUtils::load(l_v_LU_Vec, m_v_LU + l_pos, l_n);
+
+            l_y_Vec =
+               l_v_Vec    * l_x_Vec
+            -  l_v_LL_Vec * l_x_LL_Vec
+            -  l_v_RL_Vec * l_x_RL_Vec
+            -  l_v_CL_Vec * l_x_CL_Vec
+            -  l_v_CU_Vec * l_x_CU_Vec
+            -  l_v_RU_Vec * l_x_RU_Vec
+            -  l_v_LU_Vec * l_x_LU_Vec
+            ;
+            VecUtils::store(l_y_Vec, p_y + l_pos, l_n);
+         }
+      }
+   }
+}
+
+template <template<typename VecType> typename StateFunc, typename ValueType, typename VecType, bool SplitRegions>
+CNonlinearStencilPrecalcReference<StateFunc, ValueType, VecType, SplitRegions>::~CNonlinearStencilPrecalcReference()
+{
+
+}
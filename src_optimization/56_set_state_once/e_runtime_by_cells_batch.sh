@@ -0,0 +1,9 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_set_state_mul2
+../e_runtime_by_cells.sh ./e_set_state_pow2
+../e_runtime_by_cells.sh ./e_set_state_pow4_3
+../e_runtime_by_cells.sh ./e_set_state_exp
+../e_runtime_by_cells.sh ./e_set_state_costly_0
+../e_runtime_by_cells.sh ./e_set_state_costly_1
+../e_runtime_by_cells.sh ./e_set_state_costly_2
@@ -0,0 +1,9 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_blocked_mul2
+../e_runtime_by_cells.sh ./e_blocked_pow2
+../e_runtime_by_cells.sh ./e_blocked_pow4_3
+../e_runtime_by_cells.sh ./e_blocked_exp
+../e_runtime_by_cells.sh ./e_blocked_costly_0
+../e_runtime_by_cells.sh ./e_blocked_costly_1
+../e_runtime_by_cells.sh ./e_blocked_costly_2
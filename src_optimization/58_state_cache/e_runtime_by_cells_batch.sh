@@ -0,0 +1,9 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_state_cache_mul2
+../e_runtime_by_cells.sh ./e_state_cache_pow2
+../e_runtime_by_cells.sh ./e_state_cache_pow4_3
+../e_runtime_by_cells.sh ./e_state_cache_exp
+../e_runtime_by_cells.sh ./e_state_cache_costly_0
+../e_runtime_by_cells.sh ./e_state_cache_costly_1
+../e_runtime_by_cells.sh ./e_state_cache_costly_2
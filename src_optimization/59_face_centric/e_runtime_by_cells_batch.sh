@@ -0,0 +1,5 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_face_centric_nonconst_coeff
+../e_runtime_by_cells.sh ./e_face_centric_nonlinear_stencil_mul2
+../e_runtime_by_cells.sh ./e_face_centric_nonlinear_stencil_costly_1
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_aligned_loads_mul2_vec4d
+../e_runtime_by_cells.sh ./e_aligned_loads_mul2_vec8d
@@ -0,0 +1,8 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_unroll_and_jam_const_coeff_rows_2
+../e_runtime_by_cells.sh ./e_unroll_and_jam_const_coeff_rows_3
+../e_runtime_by_cells.sh ./e_unroll_and_jam_const_coeff_rows_4
+../e_runtime_by_cells.sh ./e_unroll_and_jam_nonlinear_stencil_precalc_mul2_rows_2
+../e_runtime_by_cells.sh ./e_unroll_and_jam_nonlinear_stencil_precalc_mul2_rows_3
+../e_runtime_by_cells.sh ./e_unroll_and_jam_nonlinear_stencil_precalc_mul2_rows_4
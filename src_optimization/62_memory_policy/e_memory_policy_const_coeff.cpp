@@ -0,0 +1,255 @@
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+//
+// NOTE: memory policy of the measured operator, set per executable
+//
+#ifndef STREAMING_STORES
+#define STREAMING_STORES 1
+#endif
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 0
+#endif
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+//
+// NOTE: only vectors aligned to the vector width are streamed
+//
+constexpr std::size_t ALIGNMENT = 64;
+
+constexpr std::size_t OBJ_COLS =   1024;
+constexpr std::size_t OBJ_ROWS =   1024;
+constexpr std::size_t OBJ_LEVELS = 1024;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+//
+// NOTE: roofline model of apply, per cell: 7 mul + 6 sub, compulsory
+//       traffic x and y, without the write-allocate of y
+//
+constexpr std::size_t FLOPS_PER_CELL = 13;
+constexpr std::size_t STREAMS_PER_CELL = 2;
+
+#include "c_linear_stencil_const_coeff.hpp"
+
+using MEMORY_POLICY = CMemoryPolicy<STREAMING_STORES, PREFETCH_DISTANCE>;
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStart = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEnd = omp_get_wtime();
+    return l_tEnd - l_tStart;
+}
+
+//
+// NOTE: bandwidth ceiling of the roofline, STREAM triad a = b + s*c
+//       (three streams per value)
+//
+template <typename ValueType>
+double measureStream(ValueType * p_a,
+                     const ValueType * p_b,
+                     const ValueType * p_c,
+                     std::size_t p_size,
+                     std::size_t p_runs
+)
+{
+    double l_tStart = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t r = 0; r < p_runs; ++r)
+        {
+            #pragma omp for
+            for (std::size_t i = 0; i < p_size; ++i)
+            {
+                p_a[i] = p_b[i] + ValueType(3) * p_c[i];
+            }
+        }
+    }
+    double l_tEnd = omp_get_wtime();
+    return 3 * p_size * sizeof(ValueType) * p_runs / (l_tEnd - l_tStart);
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_x_raw = new (std::align_val_t(ALIGNMENT)) ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x = &(l_x_raw[l_objSize2d]);
+
+    ValueType * l_y_reference = new (std::align_val_t(ALIGNMENT)) ValueType[l_objCells];
+    ValueType * l_y_policy = new (std::align_val_t(ALIGNMENT)) ValueType[l_objCells];
+
+    ValueType * l_c_raw = new (std::align_val_t(ALIGNMENT)) ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_c = &(l_c_raw[l_objSize2d]);
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_x[i] = i % 100;
+
+            l_y_reference[i] = 0;
+            l_y_policy[i] = 0;
+            l_c[i] = C + i % 3;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_x_raw[i] = 0;
+            l_x_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_c_raw[i] = 0;
+            l_c_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    CLinearStencilConstCoeff<ValueType,VecType> l_OpReference(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        C,
+        H,
+        TAU
+    );
+
+    CLinearStencilConstCoeff<ValueType,VecType,1,MEMORY_POLICY> l_OpPolicy(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        C,
+        H,
+        TAU
+    );
+
+    double l_tReference = measure(l_OpReference, l_x, l_y_reference, p_runs);
+    double l_tPolicy = measure(l_OpPolicy, l_x, l_y_policy, p_runs);
+
+    //
+    // NOTE: the policy changes how y is written, not what
+    //
+    bool l_identical = std::memcmp(l_y_reference, l_y_policy, l_objCells*sizeof(ValueType)) == 0;
+
+    //
+    // NOTE: a, b, c of the triad reuse the grids
+    //
+    double l_bandwidthStream = measureStream(l_y_reference, l_x, l_c, l_objCells, p_runs);
+
+    double l_bytesMin = double(STREAMS_PER_CELL * l_objCells * sizeof(ValueType));
+    double l_flops = double(FLOPS_PER_CELL * l_objCells);
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_OpPolicy.IDENTIFER << std::endl;
+    std::cout << "IMPL_ID_REFERENCE_IMPL," << l_OpReference.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "none" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "apply" << std::endl;
+    std::cout << "STREAMING_STORES_IMPL," << STREAMING_STORES << std::endl;
+    std::cout << "PREFETCH_DISTANCE_IMPL," << PREFETCH_DISTANCE << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tPolicy << std::endl;
+    std::cout << "RUNTIME_APPLY_REFERENCE_IMPL," << l_tReference << std::endl;
+    std::cout << "BYTES_APPLY_MIN_IMPL," << l_bytesMin << std::endl;
+    std::cout << "ARITHMETIC_INTENSITY_IMPL," << l_flops / l_bytesMin << std::endl;
+    std::cout << "BANDWIDTH_APPLY_IMPL," << l_bytesMin * p_runs / l_tPolicy << std::endl;
+    std::cout << "BANDWIDTH_APPLY_REFERENCE_IMPL," << l_bytesMin * p_runs / l_tReference << std::endl;
+    std::cout << "BANDWIDTH_STREAM_IMPL," << l_bandwidthStream << std::endl;
+    std::cout << "FLOPS_APPLY_IMPL," << l_flops * p_runs / l_tPolicy << std::endl;
+    std::cout << "FLOPS_APPLY_REFERENCE_IMPL," << l_flops * p_runs / l_tReference << std::endl;
+    std::cout << "BIT_IDENTICAL_IMPL," << l_identical << std::endl;
+
+    ::operator delete[](l_x_raw, std::align_val_t(ALIGNMENT));
+    ::operator delete[](l_y_reference, std::align_val_t(ALIGNMENT));
+    ::operator delete[](l_y_policy, std::align_val_t(ALIGNMENT));
+    ::operator delete[](l_c_raw, std::align_val_t(ALIGNMENT));
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,10 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_memory_policy_const_coeff_nt
+../e_runtime_by_cells.sh ./e_memory_policy_const_coeff_prefetch_64
+../e_runtime_by_cells.sh ./e_memory_policy_const_coeff_nt_prefetch_64
+../e_runtime_by_cells.sh ./e_memory_policy_const_coeff_nt_prefetch_256
+../e_runtime_by_cells.sh ./e_memory_policy_nonlinear_stencil_precalc_mul2_nt
+../e_runtime_by_cells.sh ./e_memory_policy_nonlinear_stencil_precalc_mul2_prefetch_64
+../e_runtime_by_cells.sh ./e_memory_policy_nonlinear_stencil_precalc_mul2_nt_prefetch_64
+../e_runtime_by_cells.sh ./e_memory_policy_nonlinear_stencil_precalc_mul2_nt_prefetch_256
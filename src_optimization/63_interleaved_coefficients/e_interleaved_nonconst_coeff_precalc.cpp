@@ -0,0 +1,213 @@
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   2048;
+constexpr std::size_t OBJ_ROWS =   2048;
+constexpr std::size_t OBJ_LEVELS = 2048;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+#include "c_linear_stencil_nonconst_coeff_precalc.hpp"
+
+using OP_REFERENCE = CLinearStencilNonconstCoeffPrecalc<VALUE_TYPE,VEC_TYPE>;
+using OP_INTERLEAVED = CLinearStencilNonconstCoeffPrecalc<VALUE_TYPE,VEC_TYPE,VALUE_TYPE,CMemoryPolicy<>,true>;
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStart = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEnd = omp_get_wtime();
+    return l_tEnd - l_tStart;
+}
+
+//
+// NOTE: the operator only lives during the measurement, so that the
+//       coefficients of both layouts are not allocated at the same time,
+//       p_tSetState is the runtime of the constructor
+//
+template <typename OperatorType, typename ValueType>
+void measureOperator(std::size_t p_objCols,
+                     std::size_t p_objRows,
+                     std::size_t p_objLevels,
+                     ValueType * p_c,
+                     const ValueType * p_x,
+                     ValueType * p_y,
+                     std::size_t p_runs,
+                     double & p_tApply,
+                     double & p_tSetState
+)
+{
+    double l_tStart = omp_get_wtime();
+    OperatorType l_Op(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        p_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    p_tSetState = omp_get_wtime() - l_tStart;
+
+    p_tApply = measure(l_Op, p_x, p_y, p_runs);
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_x_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x = &(l_x_raw[l_objSize2d]);
+
+    ValueType * l_y_reference = new ValueType[l_objCells];
+    ValueType * l_y_interleaved = new ValueType[l_objCells];
+
+    ValueType * l_c_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_c = &(l_c_raw[l_objSize2d]);
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_x[i] = i % 100;
+
+            l_y_reference[i] = 0;
+            l_y_interleaved[i] = 0;
+            l_c[i] = C + i % 3;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_x_raw[i] = 0;
+            l_x_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_c_raw[i] = 0;
+            l_c_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    double l_tReference;
+    double l_tInterleaved;
+    double l_tSetStateReference;
+    double l_tSetStateInterleaved;
+
+    measureOperator<OP_REFERENCE>(p_objCols, p_objRows, p_objLevels, l_c, l_x, l_y_reference, p_runs, l_tReference, l_tSetStateReference);
+    measureOperator<OP_INTERLEAVED>(p_objCols, p_objRows, p_objLevels, l_c, l_x, l_y_interleaved, p_runs, l_tInterleaved, l_tSetStateInterleaved);
+
+    //
+    // NOTE: both layouts hold the same coefficients, results have to match
+    //       bit by bit
+    //
+    bool l_identical = std::memcmp(l_y_reference, l_y_interleaved, l_objCells*sizeof(ValueType)) == 0;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << OP_INTERLEAVED::IDENTIFER << std::endl;
+    std::cout << "IMPL_ID_REFERENCE_IMPL," << OP_REFERENCE::IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "none" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "apply" << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tInterleaved << std::endl;
+    std::cout << "RUNTIME_APPLY_REFERENCE_IMPL," << l_tReference << std::endl;
+    std::cout << "RUNTIME_SET_STATE_IMPL," << l_tSetStateInterleaved << std::endl;
+    std::cout << "RUNTIME_SET_STATE_REFERENCE_IMPL," << l_tSetStateReference << std::endl;
+    std::cout << "BIT_IDENTICAL_IMPL," << l_identical << std::endl;
+
+    delete [] l_x_raw;
+    delete [] l_y_reference;
+    delete [] l_y_interleaved;
+    delete [] l_c_raw;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_shape.sh ./e_interleaved_nonconst_coeff_precalc
+../e_runtime_by_shape.sh ./e_interleaved_nonlinear_stencil_precalc_mul2
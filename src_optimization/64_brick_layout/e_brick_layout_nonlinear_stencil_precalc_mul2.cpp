@@ -0,0 +1,286 @@
+#include <cstddef>
+#include <cassert>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+//
+// NOTE: edge length of the bricks, set per executable
+//
+#ifndef BRICK_SIZE
+#define BRICK_SIZE 8
+#endif
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   1024;
+constexpr std::size_t OBJ_ROWS =   1024;
+constexpr std::size_t OBJ_LEVELS = 1024;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+//
+// NOTE: fixed number of CG iterations on both layouts, the tolerance is out
+//       of reach
+//
+constexpr std::size_t ITER_SOLVER_MAX = 10;
+constexpr VALUE_TYPE EPSILON_SOLVER = 1e-100;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_nonlinear_stencil_precalc_bricked.hpp"
+#include "c_brick_layout.hpp"
+#include "c_state_function_mul2.hpp"
+#include "c_cg.hpp"
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStart = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEnd = omp_get_wtime();
+    return l_tEnd - l_tStart;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    std::size_t l_objSize2d = p_objCols * p_objRows;
+    std::size_t l_objCells = l_objSize2d * p_objLevels;
+
+    ValueType * l_x_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x = &(l_x_raw[l_objSize2d]);
+
+    ValueType * l_y_reference = new ValueType[l_objCells];
+    ValueType * l_y_bricked = new ValueType[l_objCells];
+
+    ValueType * l_c_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_c = &(l_c_raw[l_objSize2d]);
+
+    ValueType * l_x_0_raw = new ValueType[l_objCells+2*l_objSize2d];
+    ValueType * l_x_0 = &(l_x_0_raw[l_objSize2d]);
+
+    CBrickLayout<BRICK_SIZE> l_layout(p_objCols, p_objRows, p_objLevels);
+
+    std::size_t l_brickCells = l_layout.size();
+    std::size_t l_brickBuffer = l_layout.bufferSize();
+
+    ValueType * l_x_brick_raw = new ValueType[l_brickCells+2*l_brickBuffer];
+    ValueType * l_x_brick = &(l_x_brick_raw[l_brickBuffer]);
+    ValueType * l_c_brick_raw = new ValueType[l_brickCells+2*l_brickBuffer];
+    ValueType * l_c_brick = &(l_c_brick_raw[l_brickBuffer]);
+    ValueType * l_x_0_brick_raw = new ValueType[l_brickCells+2*l_brickBuffer];
+    ValueType * l_x_0_brick = &(l_x_0_brick_raw[l_brickBuffer]);
+    ValueType * l_y_brick = new ValueType[l_brickCells];
+
+    //
+    // NOTE: first touch initialization
+    //
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objCells; ++i)
+        {
+            l_x[i] = i % 100;
+
+            l_y_reference[i] = 0;
+            l_y_bricked[i] = 0;
+            l_c[i] = C + i % 3;
+            l_x_0[i] = 0;
+        }
+
+        #pragma omp for
+        for (std::size_t i = 0; i < l_objSize2d; ++i)
+        {
+            l_x_raw[i] = 0;
+            l_x_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_c_raw[i] = 0;
+            l_c_raw[l_objCells+l_objSize2d+i] = 0;
+
+            l_x_0_raw[i] = 0;
+            l_x_0_raw[l_objCells+l_objSize2d+i] = 0;
+        }
+    }
+
+    //
+    // NOTE: toBricks does the first touch of the bricked vectors, the halos
+    //       are zeroed separately
+    //
+    for (std::size_t i = 0; i < l_brickBuffer; ++i)
+    {
+        l_x_brick_raw[i] = 0;
+        l_x_brick_raw[l_brickCells+l_brickBuffer+i] = 0;
+        l_c_brick_raw[i] = 0;
+        l_c_brick_raw[l_brickCells+l_brickBuffer+i] = 0;
+        l_x_0_brick_raw[i] = 0;
+        l_x_0_brick_raw[l_brickCells+l_brickBuffer+i] = 0;
+    }
+
+    double l_tStartConvert = omp_get_wtime();
+    l_layout.toBricks(l_x, l_x_brick);
+    l_layout.toBricks(l_c, l_c_brick);
+    l_layout.toBricks(l_x_0, l_x_0_brick);
+    l_layout.toBricks(l_y_reference, l_y_brick);
+    double l_tConvert = omp_get_wtime() - l_tStartConvert;
+
+    CNonlinearStencilPrecalc<CStateFunctionMul2,ValueType,VecType> l_OpReference(
+        p_objCols,
+        p_objRows,
+        p_objLevels,
+        l_c,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    CNonlinearStencilPrecalcBricked<CStateFunctionMul2,ValueType,VecType,BRICK_SIZE> l_OpBricked(
+        l_layout,
+        l_c_brick,
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    double l_tReference = measure(l_OpReference, l_x, l_y_reference, p_runs);
+    double l_tBricked = measure(l_OpBricked, l_x_brick, l_y_brick, p_runs);
+
+    l_layout.fromBricks(l_y_brick, l_y_bricked);
+
+    //
+    // NOTE: same coefficients and the same neighbour values, results have
+    //       to match bit by bit
+    //
+    bool l_identical = std::memcmp(l_y_reference, l_y_bricked, l_objCells*sizeof(ValueType)) == 0;
+
+    //
+    // NOTE: CG unchanged on both layouts, the dot products are summed in a
+    //       different order, so the solutions differ by rounding only
+    //
+    CCG<ValueType> l_solver;
+
+    double l_tStartSolverReference = omp_get_wtime();
+    std::size_t l_iterReference = l_solver(l_objCells, l_OpReference, l_x_0, l_c, l_y_reference, EPSILON_SOLVER, ITER_SOLVER_MAX, l_objSize2d);
+    double l_tSolverReference = omp_get_wtime() - l_tStartSolverReference;
+
+    double l_tStartSolver = omp_get_wtime();
+    std::size_t l_iter = l_solver(l_brickCells, l_OpBricked, l_x_0_brick, l_c_brick, l_y_brick, EPSILON_SOLVER, ITER_SOLVER_MAX, l_brickBuffer);
+    double l_tSolver = omp_get_wtime() - l_tStartSolver;
+
+    l_layout.fromBricks(l_y_brick, l_y_bricked);
+
+    ValueType l_diffMax = 0;
+    for (std::size_t i = 0; i < l_objCells; ++i)
+    {
+        l_diffMax = std::max(l_diffMax, std::abs(l_y_reference[i] - l_y_bricked[i]));
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_objCells << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_OpBricked.IDENTIFER << std::endl;
+    std::cout << "IMPL_ID_REFERENCE_IMPL," << l_OpReference.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "mul2" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "apply" << std::endl;
+    std::cout << "BRICK_SIZE_IMPL," << BRICK_SIZE << std::endl;
+    std::cout << "BRICK_CELLS_IMPL," << l_brickCells << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tBricked << std::endl;
+    std::cout << "RUNTIME_APPLY_REFERENCE_IMPL," << l_tReference << std::endl;
+    std::cout << "RUNTIME_CONVERT_IMPL," << l_tConvert << std::endl;
+    std::cout << "BIT_IDENTICAL_IMPL," << l_identical << std::endl;
+    std::cout << "RUNTIME_SOLVER_IMPL," << l_tSolver << std::endl;
+    std::cout << "RUNTIME_SOLVER_REFERENCE_IMPL," << l_tSolverReference << std::endl;
+    std::cout << "ITER_SOLVER_IMPL," << l_iter << std::endl;
+    std::cout << "ITER_SOLVER_REFERENCE_IMPL," << l_iterReference << std::endl;
+    std::cout << "DIFF_MAX_SOLVER_IMPL," << l_diffMax << std::endl;
+
+    delete [] l_x_raw;
+    delete [] l_y_reference;
+    delete [] l_y_bricked;
+    delete [] l_c_raw;
+    delete [] l_x_0_raw;
+    delete [] l_x_brick_raw;
+    delete [] l_c_brick_raw;
+    delete [] l_x_0_brick_raw;
+    delete [] l_y_brick;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
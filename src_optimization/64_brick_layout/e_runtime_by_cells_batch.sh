@@ -0,0 +1,6 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_brick_layout_const_coeff_brick_8
+../e_runtime_by_cells.sh ./e_brick_layout_const_coeff_brick_16
+../e_runtime_by_cells.sh ./e_brick_layout_nonlinear_stencil_precalc_mul2_brick_8
+../e_runtime_by_cells.sh ./e_brick_layout_nonlinear_stencil_precalc_mul2_brick_16
@@ -0,0 +1,190 @@
+#include <cstddef>
+#include <cassert>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+//
+// NOTE: padding of the row / plane pitch in values, set per executable,
+//       CGridLayout::padded if not set
+//
+// #define PAD_ROW 8
+// #define PAD_PLANE 8
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+//
+// NOTE: power of two edge length, 16 KiB rows and 32 MiB planes unpadded
+//
+constexpr std::size_t OBJ_COLS =   2048;
+constexpr std::size_t OBJ_ROWS =   2048;
+constexpr std::size_t OBJ_LEVELS = 2048;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+#include "c_linear_stencil_const_coeff.hpp"
+#include "c_grid.hpp"
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStart = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEnd = omp_get_wtime();
+    return l_tEnd - l_tStart;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    CGridLayout l_layoutReference(p_objCols, p_objRows, p_objLevels);
+#if defined(PAD_ROW) && defined(PAD_PLANE)
+    CGridLayout l_layoutPadded(p_objCols, p_objRows, p_objLevels, PAD_ROW, PAD_PLANE);
+#else
+    CGridLayout l_layoutPadded = CGridLayout::padded(p_objCols, p_objRows, p_objLevels, sizeof(ValueType));
+#endif
+
+    //
+    // NOTE: CGrid does the first touch (zero), ghost levels included
+    //
+    CGrid<ValueType> l_x_reference(l_layoutReference);
+    CGrid<ValueType> l_y_reference(l_layoutReference);
+    CGrid<ValueType> l_x_padded(l_layoutPadded);
+    CGrid<ValueType> l_y_padded(l_layoutPadded);
+
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = 0; l_pos_L < p_objLevels; ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_objRows; ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_objCols; ++l_pos_C)
+            {
+                l_x_reference(l_pos_C, l_pos_R, l_pos_L) = l_layoutReference.pos(l_pos_C, l_pos_R, l_pos_L) % 100;
+                l_x_padded(l_pos_C, l_pos_R, l_pos_L) = l_layoutReference.pos(l_pos_C, l_pos_R, l_pos_L) % 100;
+            }
+        }
+    }
+
+    CLinearStencilConstCoeff<ValueType,VecType> l_OpReference(
+        l_layoutReference,
+        C,
+        H,
+        TAU
+    );
+
+    CLinearStencilConstCoeff<ValueType,VecType> l_OpPadded(
+        l_layoutPadded,
+        C,
+        H,
+        TAU
+    );
+
+    double l_tReference = measure(l_OpReference, l_x_reference.data(), l_y_reference.data(), p_runs);
+    double l_tPadded = measure(l_OpPadded, l_x_padded.data(), l_y_padded.data(), p_runs);
+
+    //
+    // NOTE: only the pitches differ, results have to match bit by bit
+    //
+    bool l_identical = true;
+
+    #pragma omp parallel for reduction(&&: l_identical)
+    for (std::size_t l_pos_L = 0; l_pos_L < p_objLevels; ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_objRows; ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_objCols; ++l_pos_C)
+            {
+                l_identical = l_identical && l_y_reference(l_pos_C, l_pos_R, l_pos_L) == l_y_padded(l_pos_C, l_pos_R, l_pos_L);
+            }
+        }
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layoutPadded.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_OpPadded.IDENTIFER << std::endl;
+    std::cout << "IMPL_ID_REFERENCE_IMPL," << l_OpReference.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "none" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "apply" << std::endl;
+    std::cout << "OBJ_SIZE1D_IMPL," << l_layoutPadded.objSize1d() << std::endl;
+    std::cout << "OBJ_SIZE2D_IMPL," << l_layoutPadded.objSize2d() << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tPadded << std::endl;
+    std::cout << "RUNTIME_APPLY_REFERENCE_IMPL," << l_tReference << std::endl;
+    std::cout << "BIT_IDENTICAL_IMPL," << l_identical << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,8 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_padded_grid_const_coeff
+../e_runtime_by_cells.sh ./e_padded_grid_const_coeff_row_8
+../e_runtime_by_cells.sh ./e_padded_grid_const_coeff_plane_8
+../e_runtime_by_cells.sh ./e_padded_grid_nonlinear_stencil_precalc_mul2
+../e_runtime_by_cells.sh ./e_padded_grid_nonlinear_stencil_precalc_mul2_row_8
+../e_runtime_by_cells.sh ./e_padded_grid_nonlinear_stencil_precalc_mul2_plane_8
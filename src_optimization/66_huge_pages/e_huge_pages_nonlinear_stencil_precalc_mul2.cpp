@@ -0,0 +1,205 @@
+#include <cstddef>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+//
+// NOTE: ALLOCATOR_HUGE_PAGES=0 is set per executable (4 KiB pages, same
+//       first touch)
+//
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   1024;
+constexpr std::size_t OBJ_ROWS =   1024;
+constexpr std::size_t OBJ_LEVELS = 1024;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 1;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+//
+// NOTE: fixed number of CG iterations, the tolerance is out of reach
+//
+constexpr std::size_t ITER_SOLVER_MAX = 10;
+constexpr VALUE_TYPE EPSILON_SOLVER = 1e-100;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_grid.hpp"
+#include "c_allocator.hpp"
+#include "c_state_function_mul2.hpp"
+#include "c_cg.hpp"
+
+template <typename OperatorType, typename ValueType>
+double measure(const OperatorType & p_Op,
+               const ValueType * p_x,
+               ValueType * p_y,
+               std::size_t p_runs
+)
+{
+    double l_tStart = omp_get_wtime();
+    #pragma omp parallel
+    {
+        for (std::size_t i = 0; i < p_runs; ++i)
+        {
+            p_Op.apply(p_x,p_y);
+        }
+    }
+    double l_tEnd = omp_get_wtime();
+    return l_tEnd - l_tStart;
+}
+
+//
+// NOTE: transparent huge pages of the process in KiB, -1 if unknown
+//
+long anonHugePages()
+{
+    std::ifstream l_file("/proc/self/smaps_rollup");
+    std::string l_line;
+    while (std::getline(l_file, l_line))
+    {
+        if (l_line.rfind("AnonHugePages:", 0) == 0)
+        {
+            std::istringstream l_stream(l_line.substr(14));
+            long l_kb;
+            l_stream >> l_kb;
+            return l_kb;
+        }
+    }
+    return -1;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    CGridLayout l_layout(p_objCols, p_objRows, p_objLevels);
+
+    //
+    // NOTE: setup = allocation, first touch (page faults) and setState
+    //
+    double l_tStartSetup = omp_get_wtime();
+
+    CGrid<ValueType> l_x(l_layout);
+    CGrid<ValueType> l_y(l_layout);
+    CGrid<ValueType> l_c(l_layout);
+    CGrid<ValueType> l_x_0(l_layout);
+
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = 0; l_pos_L < p_objLevels; ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_objRows; ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_objCols; ++l_pos_C)
+            {
+                l_x(l_pos_C, l_pos_R, l_pos_L) = l_layout.pos(l_pos_C, l_pos_R, l_pos_L) % 100;
+                l_c(l_pos_C, l_pos_R, l_pos_L) = C + l_layout.pos(l_pos_C, l_pos_R, l_pos_L) % 3;
+            }
+        }
+    }
+
+    CNonlinearStencilPrecalc<CStateFunctionMul2,ValueType,VecType> l_Op(
+        l_layout,
+        l_c.data(),
+        H,
+        TAU,
+        EPSILON_STENCIL
+    );
+
+    double l_tSetup = omp_get_wtime() - l_tStartSetup;
+
+    long l_hugePagesKb = anonHugePages();
+
+    double l_tApply = measure(l_Op, l_x.data(), l_y.data(), p_runs);
+
+    //
+    // NOTE: includes the allocation and first touch of the CG vectors
+    //
+    CCG<ValueType> l_solver;
+
+    double l_tStartSolver = omp_get_wtime();
+    std::size_t l_iter = l_solver(l_layout.objSize3d(), l_Op, l_x_0.data(), l_c.data(), l_y.data(), EPSILON_SOLVER, ITER_SOLVER_MAX, l_layout.bufferSize());
+    double l_tSolver = omp_get_wtime() - l_tStartSolver;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layout.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "mul2" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "apply" << std::endl;
+    std::cout << "HUGE_PAGES_IMPL," << CAllocator::HUGE_PAGES << std::endl;
+    std::cout << "ANON_HUGE_PAGES_KB_IMPL," << l_hugePagesKb << std::endl;
+    std::cout << "RUNTIME_SETUP_IMPL," << l_tSetup << std::endl;
+    std::cout << "RUNTIME_APPLY_IMPL," << l_tApply << std::endl;
+    std::cout << "RUNTIME_SOLVER_IMPL," << l_tSolver << std::endl;
+    std::cout << "ITER_SOLVER_IMPL," << l_iter << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
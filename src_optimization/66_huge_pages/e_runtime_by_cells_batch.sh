@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_huge_pages_nonlinear_stencil_precalc_mul2
+../e_runtime_by_cells.sh ./e_huge_pages_nonlinear_stencil_precalc_mul2_no_huge_pages
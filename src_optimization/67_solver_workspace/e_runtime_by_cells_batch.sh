@@ -0,0 +1,3 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_solver_workspace_nonlinear_stencil_precalc_mul2
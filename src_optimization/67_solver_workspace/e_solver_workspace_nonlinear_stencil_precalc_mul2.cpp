@@ -0,0 +1,239 @@
+#include <cstddef>
+#include <cassert>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   512;
+constexpr std::size_t OBJ_ROWS =   512;
+constexpr std::size_t OBJ_LEVELS = 512;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+//
+// NOTE: timesteps per variant, the first one of the persistent workspace
+//       allocates and is reported separately
+//
+constexpr std::size_t RUNS = 4;
+
+constexpr std::size_t ITER_SOLVER_MAX = 5;
+constexpr std::size_t ITER_STEP_CALC_MAX = 5;
+
+//
+// NOTE: the iteration counts are fixed, the tolerances are out of reach
+//
+constexpr VALUE_TYPE EPSILON_OPERATOR = 1e-15;
+constexpr VALUE_TYPE EPSILON_SOLVER = 1e-100;
+constexpr VALUE_TYPE EPSILON_STEP_CALC = 1e-100;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_grid.hpp"
+#include "c_state_function_mul2.hpp"
+#include "c_cg.hpp"
+#include "c_timestep_calculator.hpp"
+
+//
+// NOTE: reference, allocation and first touch of the CG vectors in every
+//       solve (a new workspace per call)
+//
+template <typename ValueType>
+class CCGPerCall : public ISolver<ValueType>
+{
+    public:
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const
+        {
+            CCG<ValueType> l_solver;
+            return l_solver(p_size, p_A, p_x_0, p_b, p_x_1, p_epsilon, p_iterMax, p_bufferSize);
+        }
+};
+
+template <typename ValueType>
+void initialize(CGrid<ValueType> & p_x)
+{
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = 0; l_pos_L < p_x.objLevels(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_x.objRows(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_x.objCols(); ++l_pos_C)
+            {
+                p_x(l_pos_C, l_pos_R, l_pos_L) = 1 + p_x.pos(l_pos_C, l_pos_R, l_pos_L) % 100;
+            }
+        }
+    }
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    CGridLayout l_layout(p_objCols, p_objRows, p_objLevels);
+
+    //
+    // NOTE: x_n and x_n+1, swapped after every timestep
+    //
+    CGrid<ValueType> l_x_a(l_layout);
+    CGrid<ValueType> l_x_b(l_layout);
+
+    initialize(l_x_a);
+
+    CNonlinearStencilPrecalc<CStateFunctionMul2,ValueType,VecType> l_Op(
+        l_layout,
+        l_x_a.data(),
+        H,
+        TAU,
+        EPSILON_OPERATOR
+    );
+
+    std::size_t l_iterStepCalc = 0;
+
+    //
+    // NOTE: persistent workspaces, one solver and one timestep calculator
+    //       for all timesteps
+    //
+    CCG<ValueType> l_solver;
+    C_TimestepCalculator<ValueType> l_stepCalc;
+
+    double l_tFirst = 0;
+    double l_tPersistent = 0;
+
+    for (std::size_t i = 0; i < p_runs; ++i)
+    {
+        ValueType * l_y = i % 2 == 0 ? l_x_a.data() : l_x_b.data();
+        ValueType * l_x = i % 2 == 0 ? l_x_b.data() : l_x_a.data();
+
+        double l_tStart = omp_get_wtime();
+        l_iterStepCalc = l_stepCalc(l_layout.objSize3d(), l_solver, l_Op, l_y, l_x, EPSILON_SOLVER, EPSILON_STEP_CALC, ITER_SOLVER_MAX, ITER_STEP_CALC_MAX, l_layout.bufferSize());
+        double l_t = omp_get_wtime() - l_tStart;
+
+        if (i == 0)
+        {
+            l_tFirst = l_t;
+        }
+        else
+        {
+            l_tPersistent += l_t;
+        }
+    }
+
+    std::size_t l_allocations = l_solver.workspace().allocations() + l_stepCalc.workspace().allocations();
+
+    //
+    // NOTE: reference, a new timestep calculator per timestep and a new CG
+    //       workspace per solve (allocation per call)
+    //
+    initialize(l_x_a);
+
+    CCGPerCall<ValueType> l_solverPerCall;
+
+    double l_tReference = 0;
+
+    for (std::size_t i = 0; i < p_runs; ++i)
+    {
+        ValueType * l_y = i % 2 == 0 ? l_x_a.data() : l_x_b.data();
+        ValueType * l_x = i % 2 == 0 ? l_x_b.data() : l_x_a.data();
+
+        double l_tStart = omp_get_wtime();
+        C_TimestepCalculator<ValueType> l_stepCalcPerCall;
+        l_stepCalcPerCall(l_layout.objSize3d(), l_solverPerCall, l_Op, l_y, l_x, EPSILON_SOLVER, EPSILON_STEP_CALC, ITER_SOLVER_MAX, ITER_STEP_CALC_MAX, l_layout.bufferSize());
+        double l_t = omp_get_wtime() - l_tStart;
+
+        if (i > 0)
+        {
+            l_tReference += l_t;
+        }
+    }
+
+    double l_tTimestep = p_runs > 1 ? l_tPersistent / (p_runs - 1) : 0;
+    double l_tTimestepReference = p_runs > 1 ? l_tReference / (p_runs - 1) : 0;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layout.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "mul2" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "timestep" << std::endl;
+    std::cout << "TIMESTEPS_IMPL," << p_runs << std::endl;
+    std::cout << "ITER_STEP_CALC_IMPL," << l_iterStepCalc << std::endl;
+    std::cout << "ITER_SOLVER_MAX_IMPL," << ITER_SOLVER_MAX << std::endl;
+    std::cout << "ITER_STEP_CALC_MAX_IMPL," << ITER_STEP_CALC_MAX << std::endl;
+    std::cout << "WORKSPACE_ALLOCATIONS_IMPL," << l_allocations << std::endl;
+    std::cout << "RUNTIME_TIMESTEP_FIRST_IMPL," << l_tFirst << std::endl;
+    std::cout << "RUNTIME_TIMESTEP_IMPL," << l_tTimestep << std::endl;
+    std::cout << "RUNTIME_TIMESTEP_REFERENCE_IMPL," << l_tTimestepReference << std::endl;
+    std::cout << "RUNTIME_SAVED_PER_TIMESTEP_IMPL," << l_tTimestepReference - l_tTimestep << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <cstddef>
+#include <cassert>
+#include <iostream>
+#include <omp.h>
+#include <sys/resource.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   512;
+constexpr std::size_t OBJ_ROWS =   512;
+constexpr std::size_t OBJ_LEVELS = 512;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+//
+// NOTE: cases of the stream per variant
+//
+constexpr std::size_t CASES = 8;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_grid.hpp"
+#include "c_state_function_mul2.hpp"
+
+using OPERATOR_TYPE = CNonlinearStencilPrecalc<CStateFunctionMul2,VALUE_TYPE,VEC_TYPE>;
+
+//
+// NOTE: state of case p_case
+//
+template <typename ValueType>
+void initialize(CGrid<ValueType> & p_s, const std::size_t p_case)
+{
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = 0; l_pos_L < p_s.objLevels(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_s.objRows(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_s.objCols(); ++l_pos_C)
+            {
+                p_s(l_pos_C, l_pos_R, l_pos_L) = 1 + (p_s.pos(l_pos_C, l_pos_R, l_pos_L) + p_case) % 100;
+            }
+        }
+    }
+}
+
+//
+// NOTE: peak resident memory of the process in KiB
+//
+long maxResident()
+{
+    struct rusage l_usage;
+    getrusage(RUSAGE_SELF, &l_usage);
+    return l_usage.ru_maxrss;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_cases
+)
+{
+    CGridLayout l_layout(p_objCols, p_objRows, p_objLevels);
+
+    CGrid<ValueType> l_s(l_layout);
+    CGrid<ValueType> l_x(l_layout);
+    CGrid<ValueType> l_y(l_layout);
+
+    //
+    // NOTE: reference, a new operator per case (allocation, first touch and
+    //       release of the coefficient arrays in every case)
+    //
+    double l_tReference = 0;
+
+    for (std::size_t i = 0; i < p_cases; ++i)
+    {
+        initialize(l_s, i);
+
+        double l_tStart = omp_get_wtime();
+        {
+            OPERATOR_TYPE l_Op(l_layout, l_s.data(), H, TAU, EPSILON_STENCIL);
+
+            #pragma omp parallel
+            l_Op.apply(l_x.data(), l_y.data());
+        }
+        l_tReference += omp_get_wtime() - l_tStart;
+    }
+
+    long l_maxResidentReference = maxResident();
+
+    //
+    // NOTE: one operator rebound to every case, allocated once
+    //
+    initialize(l_s, 0);
+    double l_tStartSetup = omp_get_wtime();
+    OPERATOR_TYPE l_Op(l_layout, l_s.data(), H, TAU, EPSILON_STENCIL);
+    double l_tSetup = omp_get_wtime() - l_tStartSetup;
+
+    double l_tRebind = 0;
+
+    for (std::size_t i = 0; i < p_cases; ++i)
+    {
+        initialize(l_s, i);
+
+        double l_tStart = omp_get_wtime();
+        l_Op.rebind(l_layout, l_s.data(), H, TAU, EPSILON_STENCIL);
+
+        #pragma omp parallel
+        l_Op.apply(l_x.data(), l_y.data());
+        l_tRebind += omp_get_wtime() - l_tStart;
+    }
+
+    long l_maxResident = maxResident();
+
+    double l_tCase = l_tRebind / p_cases;
+    double l_tCaseReference = l_tReference / p_cases;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layout.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "mul2" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "rebind" << std::endl;
+    std::cout << "CASES_IMPL," << p_cases << std::endl;
+    std::cout << "MAX_RESIDENT_KB_REFERENCE_IMPL," << l_maxResidentReference << std::endl;
+    std::cout << "MAX_RESIDENT_KB_IMPL," << l_maxResident << std::endl;
+    std::cout << "RUNTIME_SETUP_IMPL," << l_tSetup << std::endl;
+    std::cout << "RUNTIME_CASE_IMPL," << l_tCase << std::endl;
+    std::cout << "RUNTIME_CASE_REFERENCE_IMPL," << l_tCaseReference << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_cases = CASES;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_cases =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_cases
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
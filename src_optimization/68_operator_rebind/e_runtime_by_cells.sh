@@ -0,0 +1,190 @@
+#!/usr/bin/env bash
+
+#
+# CONFIG
+#
+
+THREADS=128
+
+OBJ_SIZE_LIST=(128 256 512 1024)
+
+CASES=4
+
+OMP_PLACES=threads
+OMP_PROC_BIND=spread
+
+APP_PATH=${1:-./e_operator_rebind_nonlinear_stencil_precalc_mul2}
+
+ENABLE_TELEGRAM=true
+
+#
+# ------------------------------
+#
+
+#
+# FUNCTIONS
+#
+
+filename() {
+  echo "$(basename $(readlink -f $1))"
+}
+
+filename_without_extension() {
+  local name=$(filename $0)
+  echo "${name%.*}"
+}
+
+log_console() {
+  echo -e "$BLUE $1 $NORMAL"
+}
+warning_console() {
+  echo -e "$YELLOW > WARNING - $1 $NORMAL"
+}
+
+error_console() {
+  echo ""
+  echo -e "$RED >>> ERROR - $1 $NORMAL" >&2
+}
+
+output() {
+  echo $1 >> $OUTPUT_FILE
+}
+
+log_telegram() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}" >/dev/null
+  fi
+}
+
+log_telegram_silent() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}&disable_notification=true" >/dev/null
+  fi
+}
+
+log_everywhere() {
+  log_console "$1"
+  log_telegram "$1"
+}
+
+log_everywhere_silent() {
+  log_console "$1"
+  log_telegram_silent "$1"
+}
+
+timestamp() {
+  date +%s
+}
+
+elapsedTimeMessage() {
+  local l_elapsed=$(( $2 - $1 ))
+  eval "echo Elapsed time: $(date -ud "@$l_elapsed" +'$((%s/3600/24)) days %H hr %M min %S sec')"
+}
+
+#
+# ------------------------------
+#
+
+#
+# ENVIRONMENT CHECK
+#
+
+if [ -z ${TELEGRAM_BOT_TOKEN} ]; then
+  error_console "TELEGRAM_BOT_TOKEN isn't defined."
+  exit 1
+fi
+if [ -z ${TELEGRAM_CHAT_ID} ]; then
+  error_console "TELEGRAM_CHAT_ID isn't defined."
+  exit 1
+fi
+
+#
+# ------------------------------
+#
+
+#
+# PROPERTIES
+#
+
+APP_ID=$(filename $APP_PATH)
+
+NODE_ID=${NODE_ID:-undefined_node}
+SCRIPT_ID=$(filename_without_extension $0)
+SCRIPT_PATH=$(readlink -f $0)
+
+# Output colors
+NORMAL="\\033[0;39m"
+RED="\\033[1;31m"
+BLUE="\\033[0;34m"
+YELLOW="\\033[0;33m"
+
+OUTPUT_FILE="${SCRIPT_ID}_${APP_ID}.csv"
+
+TIME_BENCHMARK_STARTED=$(timestamp)
+
+log_everywhere_silent "benchmark started ($SCRIPT_PATH)"
+
+#
+# clear file
+#
+> $OUTPUT_FILE
+output "node_id,bench_id,impl_id,func_id,routine,obj_cols,obj_rows,obj_levels,obj_cells,threads,cases,max_resident_kb_reference,max_resident_kb,runtime_setup,runtime_case,runtime_case_reference"
+
+#
+# ------------------------------
+#
+
+#
+# EXECUTION
+#
+
+for INDEX in ${!OBJ_SIZE_LIST[@]}; do
+  OBJ_COLS=${OBJ_SIZE_LIST[$INDEX]}
+  OBJ_ROWS=${OBJ_SIZE_LIST[$INDEX]}
+  OBJ_LEVELS=${OBJ_SIZE_LIST[$INDEX]}
+  OBJ_CELLS=$(( $OBJ_COLS * $OBJ_ROWS * $OBJ_LEVELS ))
+
+  CURRENT_CMD="$APP_PATH $OBJ_COLS $OBJ_ROWS $OBJ_LEVELS $CASES"
+
+  log_everywhere_silent "($(( $INDEX + 1 ))/${#OBJ_SIZE_LIST[@]}) \$ $CURRENT_CMD"
+  CURRENT_OUTPUT=$(export OMP_NUM_THREADS=$THREADS && export OMP_PLACES=$OMP_PLACES && export OMP_PROC_BIND=$OMP_PROC_BIND && $CURRENT_CMD)
+
+  #
+  # parse results
+  #
+
+  IMPL_ID=$(echo "$CURRENT_OUTPUT"                  | grep "IMPL_ID_IMPL"                  | cut -d ',' -f 2)
+  FUNC_ID=$(echo "$CURRENT_OUTPUT"                  | grep "FUNC_ID_IMPL"                  | cut -d ',' -f 2)
+  ROUTINE=$(echo "$CURRENT_OUTPUT"                  | grep "ROUTINE_IMPL"                  | cut -d ',' -f 2)
+  MAX_RESIDENT_KB_REFERENCE=$(echo "$CURRENT_OUTPUT" | grep "MAX_RESIDENT_KB_REFERENCE_IMPL" | cut -d ',' -f 2)
+  MAX_RESIDENT_KB=$(echo "$CURRENT_OUTPUT"          | grep "MAX_RESIDENT_KB_IMPL"          | cut -d ',' -f 2)
+  RUNTIME_SETUP=$(echo "$CURRENT_OUTPUT"            | grep "RUNTIME_SETUP_IMPL"            | cut -d ',' -f 2)
+  RUNTIME_CASE=$(echo "$CURRENT_OUTPUT"             | grep "RUNTIME_CASE_IMPL"             | cut -d ',' -f 2)
+  RUNTIME_CASE_REFERENCE=$(echo "$CURRENT_OUTPUT"   | grep "RUNTIME_CASE_REFERENCE_IMPL"   | cut -d ',' -f 2)
+
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID,$FUNC_ID,$ROUTINE,$OBJ_COLS,$OBJ_ROWS,$OBJ_LEVELS,$OBJ_CELLS,$THREADS,$CASES,$MAX_RESIDENT_KB_REFERENCE,$MAX_RESIDENT_KB,$RUNTIME_SETUP,$RUNTIME_CASE,$RUNTIME_CASE_REFERENCE"
+
+  TIME_CURRENT=$(timestamp)
+  log_everywhere_silent "=> Max resident: $MAX_RESIDENT_KB kB (new operator per case: $MAX_RESIDENT_KB_REFERENCE kB)"
+  log_everywhere_silent "=> Runtime setup: $RUNTIME_SETUP sec"
+  log_everywhere_silent "=> Runtime case (rebind): $RUNTIME_CASE sec"
+  log_everywhere_silent "=> Runtime case (new operator): $RUNTIME_CASE_REFERENCE sec"
+  log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+  log_everywhere_silent "------------------"
+
+done
+
+#
+# ------------------------------
+#
+
+#
+# COMPLETED
+#
+
+TIME_CURRENT=$(timestamp)
+log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+log_everywhere "benchmark finished"
+log_everywhere_silent "=================="
+
+exit 0
@@ -0,0 +1,3 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_operator_rebind_nonlinear_stencil_precalc_mul2
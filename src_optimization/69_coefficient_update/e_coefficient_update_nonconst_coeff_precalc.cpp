@@ -0,0 +1,181 @@
+#include <cstddef>
+#include <cassert>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+//
+// NOTE: INTERLEAVED=1 is set per executable
+//
+#ifndef INTERLEAVED
+#define INTERLEAVED 0
+#endif
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   512;
+constexpr std::size_t OBJ_ROWS =   512;
+constexpr std::size_t OBJ_LEVELS = 512;
+
+constexpr VALUE_TYPE C = 1.0;
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+constexpr std::size_t RUNS = 4;
+
+//
+// NOTE: edge length of the dirty box (in the middle of the grid)
+//
+constexpr std::size_t BOX_SIZE = 32;
+
+constexpr VALUE_TYPE EPSILON_STENCIL = 1e-15;
+
+#include "c_linear_stencil_nonconst_coeff_precalc.hpp"
+#include "c_grid.hpp"
+
+using OPERATOR_TYPE = CLinearStencilNonconstCoeffPrecalc<VALUE_TYPE,VEC_TYPE,VALUE_TYPE,CMemoryPolicy<>,INTERLEAVED>;
+
+template <typename ValueType>
+void initialize(CGrid<ValueType> & p_c, const CGridBox & p_box, const std::size_t p_run)
+{
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = p_box.levelBegin(); l_pos_L < p_box.levelEnd(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = p_box.rowBegin(); l_pos_R < p_box.rowEnd(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = p_box.colBegin(); l_pos_C < p_box.colEnd(); ++l_pos_C)
+            {
+                p_c(l_pos_C, l_pos_R, l_pos_L) = 1 + (p_c.pos(l_pos_C, l_pos_R, l_pos_L) + p_run) % 100;
+            }
+        }
+    }
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs,
+             std::size_t p_boxSize
+)
+{
+    CGridLayout l_layout(p_objCols, p_objRows, p_objLevels);
+    CGridBox l_all(l_layout);
+
+    std::size_t l_boxCols = p_boxSize < p_objCols ? p_boxSize : p_objCols;
+    std::size_t l_boxRows = p_boxSize < p_objRows ? p_boxSize : p_objRows;
+    std::size_t l_boxLevels = p_boxSize < p_objLevels ? p_boxSize : p_objLevels;
+    CGridBox l_box(
+        (p_objCols - l_boxCols) / 2,     (p_objCols + l_boxCols) / 2,
+        (p_objRows - l_boxRows) / 2,     (p_objRows + l_boxRows) / 2,
+        (p_objLevels - l_boxLevels) / 2, (p_objLevels + l_boxLevels) / 2
+    );
+
+    CGrid<ValueType> l_c(l_layout);
+    initialize(l_c, l_all, 0);
+
+    double l_tStartSetup = omp_get_wtime();
+    OPERATOR_TYPE l_Op(l_layout, l_c.data(), H, TAU, EPSILON_STENCIL);
+    double l_tSetup = omp_get_wtime() - l_tStartSetup;
+
+    //
+    // NOTE: full rebuild, p_c changed everywhere
+    //
+    double l_tFull = 0;
+    for (std::size_t i = 1; i <= p_runs; ++i)
+    {
+        initialize(l_c, l_all, i);
+
+        double l_tStart = omp_get_wtime();
+        l_Op.updateCoefficients(l_c.data());
+        l_tFull += omp_get_wtime() - l_tStart;
+    }
+
+    //
+    // NOTE: partial update, p_c changed in the box only
+    //
+    double l_tPartial = 0;
+    for (std::size_t i = 1; i <= p_runs; ++i)
+    {
+        initialize(l_c, l_box, p_runs + i);
+
+        double l_tStart = omp_get_wtime();
+        l_Op.updateCoefficients(l_c.data(), l_box);
+        l_tPartial += omp_get_wtime() - l_tStart;
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layout.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "ROUTINE_IMPL," << "update_coefficients" << std::endl;
+    std::cout << "RUNS_IMPL," << p_runs << std::endl;
+    std::cout << "BOX_CELLS_IMPL," << l_boxCols * l_boxRows * l_boxLevels << std::endl;
+    std::cout << "RUNTIME_SETUP_IMPL," << l_tSetup << std::endl;
+    std::cout << "RUNTIME_FULL_UPDATE_IMPL," << l_tFull / p_runs << std::endl;
+    std::cout << "RUNTIME_PARTIAL_UPDATE_IMPL," << l_tPartial / p_runs << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5 && argc != 6)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5 or 6" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+    std::size_t l_boxSize = BOX_SIZE;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc >= 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    if (argc == 6)
+    {
+        l_boxSize =   atoi(argv[5]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs,
+        l_boxSize
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_coefficient_update_nonconst_coeff_precalc
+../e_runtime_by_cells.sh ./e_coefficient_update_nonconst_coeff_precalc_interleaved
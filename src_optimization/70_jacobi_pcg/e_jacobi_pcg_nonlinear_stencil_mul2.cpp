@@ -0,0 +1,245 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   256;
+constexpr std::size_t OBJ_ROWS =   256;
+constexpr std::size_t OBJ_LEVELS = 256;
+
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+//
+// NOTE: solves per solver, the first one (allocation and first touch of the
+//       workspace) is not timed
+//
+constexpr std::size_t RUNS = 3;
+
+//
+// NOTE: the state is constant on blocks of BLOCK_SIZE^3 cells, the values
+//       of the blocks are spread log-uniformly over [1, CONTRAST]
+//
+constexpr std::size_t BLOCK_SIZE = 16;
+constexpr VALUE_TYPE CONTRAST = 1e4;
+
+constexpr std::size_t ITER_SOLVER_MAX = 100000;
+
+//
+// NOTE: both solvers stop at |r|^2 < EPSILON_SOLVER_REL * |b|^2
+//
+constexpr VALUE_TYPE EPSILON_OPERATOR = 1e-15;
+constexpr VALUE_TYPE EPSILON_SOLVER_REL = 1e-16;
+
+//
+// NOTE: STATE_CACHE=1 uses CNonlinearStencilStateCache, its diagonal is
+//       computed on the fly from f(s) instead of copied from m_v
+//
+#ifndef STATE_CACHE
+#define STATE_CACHE 0
+#endif
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_nonlinear_stencil_state_cache.hpp"
+#include "c_grid.hpp"
+#include "c_state_function_mul2.hpp"
+#include "c_cg.hpp"
+#include "c_pcg.hpp"
+
+template <typename ValueType>
+void initialize(CGrid<ValueType> & p_s, CGrid<ValueType> & p_b, const ValueType p_contrast)
+{
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = 0; l_pos_L < p_s.objLevels(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_s.objRows(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_s.objCols(); ++l_pos_C)
+            {
+                std::size_t l_block =
+                      (l_pos_L / BLOCK_SIZE) * 7919
+                    + (l_pos_R / BLOCK_SIZE) * 104729
+                    + (l_pos_C / BLOCK_SIZE) * 1299709;
+
+                p_s(l_pos_C, l_pos_R, l_pos_L) = std::pow(p_contrast, ValueType(l_block % 101) / 100);
+                p_b(l_pos_C, l_pos_R, l_pos_L) = 1 + p_s.pos(l_pos_C, l_pos_R, l_pos_L) % 100;
+            }
+        }
+    }
+}
+
+template <typename ValueType>
+ValueType norm2(const CGrid<ValueType> & p_x)
+{
+    double l_norm2 = 0;
+
+    #pragma omp parallel for reduction(+: l_norm2)
+    for (std::size_t i = 0; i < p_x.objSize3d(); ++i)
+    {
+        l_norm2 += double(p_x.data()[i]) * p_x.data()[i];
+    }
+
+    return ValueType(l_norm2);
+}
+
+template <typename ValueType, typename Solver, typename Operator>
+std::size_t solve(const Solver & p_solver, const Operator & p_Op, const CGrid<ValueType> & p_b, CGrid<ValueType> & p_x, const ValueType p_epsilon, const std::size_t p_runs, double & p_t)
+{
+    std::size_t l_iter = 0;
+
+    p_t = 0;
+
+    for (std::size_t i = 0; i < p_runs; ++i)
+    {
+        double l_tStart = omp_get_wtime();
+        l_iter = p_solver(p_b.objSize3d(), p_Op, p_b.data(), p_b.data(), p_x.data(), p_epsilon, ITER_SOLVER_MAX, p_b.bufferSize());
+        double l_t = omp_get_wtime() - l_tStart;
+
+        if (i > 0 || p_runs == 1)
+        {
+            p_t += l_t;
+        }
+    }
+
+    p_t /= p_runs > 1 ? p_runs - 1 : 1;
+
+    return l_iter;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs,
+             ValueType p_contrast
+)
+{
+    CGridLayout l_layout(p_objCols, p_objRows, p_objLevels);
+
+    CGrid<ValueType> l_s(l_layout);
+    CGrid<ValueType> l_b(l_layout);
+    CGrid<ValueType> l_x(l_layout);
+    CGrid<ValueType> l_x_reference(l_layout);
+
+    initialize(l_s, l_b, p_contrast);
+
+#if STATE_CACHE
+    CNonlinearStencilStateCache<CStateFunctionMul2,ValueType,VecType> l_Op(
+#else
+    CNonlinearStencilPrecalc<CStateFunctionMul2,ValueType,VecType> l_Op(
+#endif
+        l_layout,
+        l_s.data(),
+        H,
+        TAU,
+        EPSILON_OPERATOR
+    );
+
+    ValueType l_epsilon = EPSILON_SOLVER_REL * norm2(l_b);
+
+    CPCG<ValueType> l_solver;
+    CCG<ValueType> l_solverReference;
+
+    double l_tSolver;
+    double l_tSolverReference;
+
+    std::size_t l_iterSolver = solve(l_solver, l_Op, l_b, l_x, l_epsilon, p_runs, l_tSolver);
+    std::size_t l_iterSolverReference = solve(l_solverReference, l_Op, l_b, l_x_reference, l_epsilon, p_runs, l_tSolverReference);
+
+    //
+    // NOTE: both solutions are within the tolerance, their difference is
+    //       reported as a sanity check
+    //
+    ValueType l_diff = 0;
+
+    #pragma omp parallel for reduction(max: l_diff)
+    for (std::size_t i = 0; i < l_layout.objSize3d(); ++i)
+    {
+        l_diff = std::max(l_diff, std::fabs(l_x.data()[i] - l_x_reference.data()[i]));
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layout.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "mul2" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "solve" << std::endl;
+    std::cout << "SOLVER_ID_IMPL," << l_solver.IDENTIFER << std::endl;
+    std::cout << "SOLVER_ID_REFERENCE_IMPL," << l_solverReference.IDENTIFER << std::endl;
+    std::cout << "RUNS_IMPL," << p_runs << std::endl;
+    std::cout << "CONTRAST_IMPL," << p_contrast << std::endl;
+    std::cout << "ITER_SOLVER_MAX_IMPL," << ITER_SOLVER_MAX << std::endl;
+    std::cout << "ITER_SOLVER_IMPL," << l_iterSolver << std::endl;
+    std::cout << "ITER_SOLVER_REFERENCE_IMPL," << l_iterSolverReference << std::endl;
+    std::cout << "RUNTIME_SOLVER_IMPL," << l_tSolver << std::endl;
+    std::cout << "RUNTIME_SOLVER_REFERENCE_IMPL," << l_tSolverReference << std::endl;
+    std::cout << "MAX_DIFF_IMPL," << l_diff << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5 && argc != 6)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5 or 6" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+    VALUE_TYPE l_contrast = CONTRAST;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc >= 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    if (argc == 6)
+    {
+        l_contrast = atof(argv[5]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs,
+        l_contrast
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_jacobi_pcg_nonlinear_stencil_mul2
+../e_runtime_by_cells.sh ./e_jacobi_pcg_nonlinear_stencil_mul2_state_cache
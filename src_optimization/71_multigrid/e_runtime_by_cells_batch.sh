@@ -0,0 +1,3 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_cells.sh ./e_multigrid_nonconst_coeff_precalc
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_efficiency_by_threads.sh ./e_pipelined_cg_nonconst_coeff_precalc
+../e_efficiency_by_threads.sh ./e_pipelined_cg_nonconst_coeff_precalc_no_replacement
@@ -0,0 +1,218 @@
+#!/usr/bin/env bash
+
+#
+# CONFIG
+#
+
+THREADS=128
+
+OBJ_SIZE_LIST=(128 256 512)
+
+STEPS_LIST=(2 3 4 5 6 7 8)
+
+SOLVER_RUNS=2
+
+CONTRAST=100
+
+OMP_PLACES=threads
+OMP_PROC_BIND=spread
+
+#
+# one executable per s: ${APP_PATH}_${STEPS}
+#
+APP_PATH=${1:-./e_s_step_cg_nonconst_coeff_precalc}
+
+ENABLE_TELEGRAM=true
+
+#
+# ------------------------------
+#
+
+#
+# FUNCTIONS
+#
+
+filename() {
+  echo "$(basename $(readlink -f $1))"
+}
+
+filename_without_extension() {
+  local name=$(filename $0)
+  echo "${name%.*}"
+}
+
+log_console() {
+  echo -e "$BLUE $1 $NORMAL"
+}
+warning_console() {
+  echo -e "$YELLOW > WARNING - $1 $NORMAL"
+}
+
+error_console() {
+  echo ""
+  echo -e "$RED >>> ERROR - $1 $NORMAL" >&2
+}
+
+output() {
+  echo $1 >> $OUTPUT_FILE
+}
+
+log_telegram() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}" >/dev/null
+  fi
+}
+
+log_telegram_silent() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}&disable_notification=true" >/dev/null
+  fi
+}
+
+log_everywhere() {
+  log_console "$1"
+  log_telegram "$1"
+}
+
+log_everywhere_silent() {
+  log_console "$1"
+  log_telegram_silent "$1"
+}
+
+timestamp() {
+  date +%s
+}
+
+elapsedTimeMessage() {
+  local l_elapsed=$(( $2 - $1 ))
+  eval "echo Elapsed time: $(date -ud "@$l_elapsed" +'$((%s/3600/24)) days %H hr %M min %S sec')"
+}
+
+#
+# ------------------------------
+#
+
+#
+# ENVIRONMENT CHECK
+#
+
+if [ -z ${TELEGRAM_BOT_TOKEN} ]; then
+  error_console "TELEGRAM_BOT_TOKEN isn't defined."
+  exit 1
+fi
+if [ -z ${TELEGRAM_CHAT_ID} ]; then
+  error_console "TELEGRAM_CHAT_ID isn't defined."
+  exit 1
+fi
+
+#
+# ------------------------------
+#
+
+#
+# PROPERTIES
+#
+
+APP_ID=$(filename $APP_PATH)
+
+NODE_ID=${NODE_ID:-undefined_node}
+SCRIPT_ID=$(filename_without_extension $0)
+SCRIPT_PATH=$(readlink -f $0)
+
+# Output colors
+NORMAL="\\033[0;39m"
+RED="\\033[1;31m"
+BLUE="\\033[0;34m"
+YELLOW="\\033[0;33m"
+
+OUTPUT_FILE="${SCRIPT_ID}_${APP_ID}.csv"
+
+TIME_BENCHMARK_STARTED=$(timestamp)
+
+log_everywhere_silent "benchmark started ($SCRIPT_PATH)"
+
+BENCH_LIST=()
+
+#
+# ------------------------------
+#
+
+#
+# GENERATE BENCH LIST
+#
+
+for OBJ_SIZE in ${OBJ_SIZE_LIST[@]}; do
+  for STEPS in ${STEPS_LIST[@]}; do
+    BENCH_LIST+=("$OBJ_SIZE,$STEPS")
+  done
+done
+
+#
+# clear file
+#
+> $OUTPUT_FILE
+output "node_id,bench_id,impl_id,func_id,routine,solver_id,solver_id_reference,obj_cols,obj_rows,obj_levels,obj_cells,threads,runs,contrast,s_steps,epsilon,iter_solver,iter_solver_reference,residual_solver,residual_solver_reference,runtime_solver,runtime_solver_reference"
+
+#
+# ------------------------------
+#
+
+#
+# EXECUTION
+#
+
+for INDEX in ${!BENCH_LIST[@]}; do
+  OBJ_COLS=$(echo ${BENCH_LIST[$INDEX]} | cut -d ',' -f 1)
+  OBJ_ROWS=$OBJ_COLS
+  OBJ_LEVELS=$OBJ_COLS
+  OBJ_CELLS=$(( $OBJ_COLS * $OBJ_ROWS * $OBJ_LEVELS ))
+  STEPS=$(echo ${BENCH_LIST[$INDEX]} | cut -d ',' -f 2)
+
+  CURRENT_CMD="${APP_PATH}_${STEPS} $OBJ_COLS $OBJ_ROWS $OBJ_LEVELS $SOLVER_RUNS $CONTRAST"
+
+  log_everywhere_silent "($(( $INDEX + 1 ))/${#BENCH_LIST[@]}) \$ $CURRENT_CMD"
+  CURRENT_OUTPUT=$(export OMP_NUM_THREADS=$THREADS && export OMP_PLACES=$OMP_PLACES && export OMP_PROC_BIND=$OMP_PROC_BIND && $CURRENT_CMD)
+
+  #
+  # parse results
+  #
+
+  IMPL_ID=$(echo "$CURRENT_OUTPUT"                   | grep "IMPL_ID_IMPL"                   | cut -d ',' -f 2)
+  FUNC_ID=$(echo "$CURRENT_OUTPUT"                   | grep "FUNC_ID_IMPL"                   | cut -d ',' -f 2)
+  ROUTINE=$(echo "$CURRENT_OUTPUT"                   | grep "ROUTINE_IMPL"                   | cut -d ',' -f 2)
+  SOLVER_ID=$(echo "$CURRENT_OUTPUT"                 | grep "SOLVER_ID_IMPL"                 | cut -d ',' -f 2)
+  SOLVER_ID_REFERENCE=$(echo "$CURRENT_OUTPUT"       | grep "SOLVER_ID_REFERENCE_IMPL"       | cut -d ',' -f 2)
+  S_STEPS=$(echo "$CURRENT_OUTPUT"                   | grep "S_STEPS_IMPL"                   | cut -d ',' -f 2)
+  EPSILON=$(echo "$CURRENT_OUTPUT"                   | grep "EPSILON_IMPL"                   | cut -d ',' -f 2)
+  ITER_SOLVER=$(echo "$CURRENT_OUTPUT"               | grep "ITER_SOLVER_IMPL"               | cut -d ',' -f 2)
+  ITER_SOLVER_REFERENCE=$(echo "$CURRENT_OUTPUT"     | grep "ITER_SOLVER_REFERENCE_IMPL"     | cut -d ',' -f 2)
+  RESIDUAL_SOLVER=$(echo "$CURRENT_OUTPUT"           | grep "RESIDUAL_SOLVER_IMPL"           | cut -d ',' -f 2)
+  RESIDUAL_SOLVER_REFERENCE=$(echo "$CURRENT_OUTPUT" | grep "RESIDUAL_SOLVER_REFERENCE_IMPL" | cut -d ',' -f 2)
+  RUNTIME_SOLVER=$(echo "$CURRENT_OUTPUT"            | grep "RUNTIME_SOLVER_IMPL"            | cut -d ',' -f 2)
+  RUNTIME_SOLVER_REFERENCE=$(echo "$CURRENT_OUTPUT"  | grep "RUNTIME_SOLVER_REFERENCE_IMPL"  | cut -d ',' -f 2)
+
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID,$FUNC_ID,$ROUTINE,$SOLVER_ID,$SOLVER_ID_REFERENCE,$OBJ_COLS,$OBJ_ROWS,$OBJ_LEVELS,$OBJ_CELLS,$THREADS,$SOLVER_RUNS,$CONTRAST,$S_STEPS,$EPSILON,$ITER_SOLVER,$ITER_SOLVER_REFERENCE,$RESIDUAL_SOLVER,$RESIDUAL_SOLVER_REFERENCE,$RUNTIME_SOLVER,$RUNTIME_SOLVER_REFERENCE"
+
+  TIME_CURRENT=$(timestamp)
+  log_everywhere_silent "=> Iterations $SOLVER_ID: $ITER_SOLVER, $SOLVER_ID_REFERENCE: $ITER_SOLVER_REFERENCE"
+  log_everywhere_silent "=> Residual $SOLVER_ID: $RESIDUAL_SOLVER, $SOLVER_ID_REFERENCE: $RESIDUAL_SOLVER_REFERENCE"
+  log_everywhere_silent "=> Runtime $SOLVER_ID: $RUNTIME_SOLVER sec, $SOLVER_ID_REFERENCE: $RUNTIME_SOLVER_REFERENCE sec"
+  log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+  log_everywhere_silent "------------------"
+
+done
+
+#
+# ------------------------------
+#
+
+#
+# COMPLETED
+#
+
+TIME_CURRENT=$(timestamp)
+log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+log_everywhere "benchmark finished"
+log_everywhere_silent "=================="
+
+exit 0
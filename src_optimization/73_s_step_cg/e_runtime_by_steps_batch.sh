@@ -0,0 +1,3 @@
+#!/usr/bin/env bash
+
+../e_runtime_by_steps.sh ./e_s_step_cg_nonconst_coeff_precalc
@@ -0,0 +1,259 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+constexpr std::size_t OBJ_COLS =   256;
+constexpr std::size_t OBJ_ROWS =   256;
+constexpr std::size_t OBJ_LEVELS = 256;
+
+//
+// NOTE: unit cube, H = 1 / OBJ_COLS, so that the condition number (and the
+//       iterations of CG) grow with the grid size
+//
+constexpr VALUE_TYPE DOMAIN_SIZE = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+//
+// NOTE: solves per solver, the first one (allocation and first touch of the
+//       workspace) is not timed
+//
+constexpr std::size_t RUNS = 2;
+
+//
+// NOTE: the coefficient is constant on blocks of BLOCK_SIZE^3 cells, the
+//       values of the blocks are spread log-uniformly over [1, CONTRAST]
+//
+constexpr std::size_t BLOCK_SIZE = 16;
+constexpr VALUE_TYPE CONTRAST = 1e2;
+
+constexpr std::size_t ITER_SOLVER_MAX = 100000;
+
+//
+// NOTE: both solvers stop at |r|^2 < EPSILON_SOLVER_REL * |b|^2
+//
+constexpr VALUE_TYPE EPSILON_OPERATOR = 1e-15;
+constexpr VALUE_TYPE EPSILON_SOLVER_REL = 1e-12;
+
+//
+// NOTE: CG iterations per outer iteration of the s-step CG
+//
+#ifndef S_STEPS
+#define S_STEPS 4
+#endif
+
+#include "c_linear_stencil_nonconst_coeff_precalc.hpp"
+#include "c_grid.hpp"
+#include "c_cg.hpp"
+#include "c_s_step_cg.hpp"
+
+template <typename ValueType>
+void initialize(CGrid<ValueType> & p_c, CGrid<ValueType> & p_b, const ValueType p_contrast)
+{
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = 0; l_pos_L < p_c.objLevels(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_c.objRows(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_c.objCols(); ++l_pos_C)
+            {
+                std::size_t l_block =
+                      (l_pos_L / BLOCK_SIZE) * 7919
+                    + (l_pos_R / BLOCK_SIZE) * 104729
+                    + (l_pos_C / BLOCK_SIZE) * 1299709;
+
+                p_c(l_pos_C, l_pos_R, l_pos_L) = std::pow(p_contrast, ValueType(l_block % 101) / 100);
+                p_b(l_pos_C, l_pos_R, l_pos_L) = 1 + p_c.pos(l_pos_C, l_pos_R, l_pos_L) % 100;
+            }
+        }
+    }
+}
+
+template <typename ValueType>
+ValueType norm2(const CGrid<ValueType> & p_x)
+{
+    double l_norm2 = 0;
+
+    #pragma omp parallel for reduction(+: l_norm2)
+    for (std::size_t i = 0; i < p_x.objSize3d(); ++i)
+    {
+        l_norm2 += double(p_x.data()[i]) * p_x.data()[i];
+    }
+
+    return ValueType(l_norm2);
+}
+
+//
+// NOTE: |b - A x|^2, the solvers stop at the norm2 of their recursive r
+//
+template <typename ValueType, typename Operator>
+ValueType residual2(const Operator & p_Op, const CGridLayout & p_layout, const CGrid<ValueType> & p_b, const CGrid<ValueType> & p_x)
+{
+    CGrid<ValueType> l_r(p_layout);
+
+    #pragma omp parallel
+    {
+        p_Op.apply(p_x.data(), l_r.data());
+    }
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < p_b.objSize3d(); ++i)
+    {
+        l_r.data()[i] = p_b.data()[i] - l_r.data()[i];
+    }
+
+    return norm2(l_r);
+}
+
+template <typename ValueType, typename Solver, typename Operator>
+std::size_t solve(const Solver & p_solver, const Operator & p_Op, const CGrid<ValueType> & p_b, CGrid<ValueType> & p_x, const ValueType p_epsilon, const std::size_t p_runs, double & p_t)
+{
+    std::size_t l_iter = 0;
+
+    p_t = 0;
+
+    for (std::size_t i = 0; i < p_runs; ++i)
+    {
+        double l_tStart = omp_get_wtime();
+        l_iter = p_solver(p_b.objSize3d(), p_Op, p_b.data(), p_b.data(), p_x.data(), p_epsilon, ITER_SOLVER_MAX, p_b.bufferSize());
+        double l_t = omp_get_wtime() - l_tStart;
+
+        if (i > 0 || p_runs == 1)
+        {
+            p_t += l_t;
+        }
+    }
+
+    p_t /= p_runs > 1 ? p_runs - 1 : 1;
+
+    return l_iter;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs,
+             ValueType p_contrast
+)
+{
+    CGridLayout l_layout(p_objCols, p_objRows, p_objLevels);
+
+    CGrid<ValueType> l_c(l_layout);
+    CGrid<ValueType> l_b(l_layout);
+    CGrid<ValueType> l_x(l_layout);
+
+    initialize(l_c, l_b, p_contrast);
+
+    ValueType l_h = DOMAIN_SIZE / p_objCols;
+
+    CLinearStencilNonconstCoeffPrecalc<ValueType,VecType> l_Op(
+        l_layout,
+        l_c.data(),
+        l_h,
+        TAU,
+        EPSILON_OPERATOR
+    );
+
+    ValueType l_epsilon = EPSILON_SOLVER_REL * norm2(l_b);
+
+    CSStepCG<ValueType, S_STEPS> l_solver;
+    CCG<ValueType> l_solverReference;
+
+    double l_tSolver;
+    double l_tSolverReference;
+
+    std::size_t l_iterSolver = solve(l_solver, l_Op, l_b, l_x, l_epsilon, p_runs, l_tSolver);
+    ValueType l_residualSolver = residual2(l_Op, l_layout, l_b, l_x);
+    std::size_t l_iterSolverReference = solve(l_solverReference, l_Op, l_b, l_x, l_epsilon, p_runs, l_tSolverReference);
+    ValueType l_residualSolverReference = residual2(l_Op, l_layout, l_b, l_x);
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layout.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "none" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "solve" << std::endl;
+    std::cout << "SOLVER_ID_IMPL," << l_solver.IDENTIFER << std::endl;
+    std::cout << "SOLVER_ID_REFERENCE_IMPL," << l_solverReference.IDENTIFER << std::endl;
+    std::cout << "THREADS_IMPL," << omp_get_max_threads() << std::endl;
+    std::cout << "RUNS_IMPL," << p_runs << std::endl;
+    std::cout << "CONTRAST_IMPL," << p_contrast << std::endl;
+    std::cout << "S_STEPS_IMPL," << S_STEPS << std::endl;
+    std::cout << "EPSILON_IMPL," << EPSILON_SOLVER_REL << std::endl;
+    std::cout << "ITER_SOLVER_MAX_IMPL," << ITER_SOLVER_MAX << std::endl;
+    std::cout << "ITER_SOLVER_IMPL," << l_iterSolver << std::endl;
+    std::cout << "ITER_SOLVER_REFERENCE_IMPL," << l_iterSolverReference << std::endl;
+    std::cout << "RUNTIME_SOLVER_IMPL," << l_tSolver << std::endl;
+    std::cout << "RUNTIME_SOLVER_REFERENCE_IMPL," << l_tSolverReference << std::endl;
+    std::cout << "RESIDUAL_SOLVER_IMPL," << std::sqrt(l_residualSolver / norm2(l_b)) << std::endl;
+    std::cout << "RESIDUAL_SOLVER_REFERENCE_IMPL," << std::sqrt(l_residualSolverReference / norm2(l_b)) << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5 && argc != 6)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5 or 6" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+    VALUE_TYPE l_contrast = CONTRAST;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc >= 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    if (argc == 6)
+    {
+        l_contrast = atof(argv[5]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs,
+        l_contrast
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include "vcl/vectorclass.h"
+
+using VALUE_TYPE = double;
+using VEC_TYPE = Vec8d;
+
+//
+// NOTE: small default grid, the barriers and reductions of an iteration
+//       are a noticeable part of its runtime at high thread counts
+//
+constexpr std::size_t OBJ_COLS =   128;
+constexpr std::size_t OBJ_ROWS =   128;
+constexpr std::size_t OBJ_LEVELS = 128;
+
+constexpr VALUE_TYPE H = 1.0;
+constexpr VALUE_TYPE TAU = 1.0;
+
+//
+// NOTE: timesteps per solver, the first one (allocation and first touch of
+//       the workspaces, first estimate of the bounds) is reported separately
+//
+constexpr std::size_t RUNS = 4;
+
+constexpr std::size_t ITER_SOLVER_MAX = 100000;
+constexpr std::size_t ITER_STEP_CALC_MAX = 20;
+
+//
+// NOTE: the inner solves stop at |r|^2 < EPSILON_SOLVER_REL * |y_0|^2, the
+//       fixed point iteration at |A(x) x - y|^2 < EPSILON_STEP_CALC_REL * |y_0|^2
+//
+constexpr VALUE_TYPE EPSILON_OPERATOR = 1e-15;
+constexpr VALUE_TYPE EPSILON_SOLVER_REL = 1e-16;
+constexpr VALUE_TYPE EPSILON_STEP_CALC_REL = 1e-12;
+
+//
+// NOTE: CG steps of an estimate of the Chebyshev bounds (the first solve
+//       is CG up to ESTIMATE_STEPS iterations), |r|^2 is checked every
+//       CHECK_PERIOD Chebyshev iterations
+//
+constexpr std::size_t ESTIMATE_STEPS = 100;
+constexpr std::size_t CHECK_PERIOD = 16;
+
+//
+// NOTE: new estimate of the Chebyshev bounds every REFRESH solves, 0 keeps
+//       the bounds of the first solve (new estimate only on divergence)
+//
+#ifndef REFRESH
+#define REFRESH 0
+#endif
+
+#include "c_nonlinear_stencil_precalc.hpp"
+#include "c_grid.hpp"
+#include "c_state_function_mul2.hpp"
+#include "c_cg.hpp"
+#include "c_chebyshev.hpp"
+#include "c_timestep_calculator.hpp"
+
+//
+// NOTE: counts the calls and the iterations of the inner solves of the
+//       timestep calculator
+//
+template <typename ValueType>
+class CCountingSolver : public ISolver<ValueType>
+{
+    private:
+        const ISolver<ValueType> & m_solver;
+        mutable std::size_t m_calls;
+        mutable std::size_t m_iter;
+
+    public:
+        CCountingSolver(const ISolver<ValueType> & p_solver): m_solver(p_solver), m_calls(0), m_iter(0) {}
+
+        std::size_t operator()(
+            const std::size_t p_size,
+            const ILinearOperator<ValueType> & p_A,
+            const ValueType * __restrict__ p_x_0,
+            const ValueType * __restrict__ p_b,
+            ValueType * __restrict__ p_x_1,
+            const ValueType p_epsilon,
+            const std::size_t p_iterMax,
+            const std::size_t p_bufferSize
+        ) const
+        {
+            std::size_t l_iter = m_solver(p_size, p_A, p_x_0, p_b, p_x_1, p_epsilon, p_iterMax, p_bufferSize);
+            m_calls++;
+            m_iter += l_iter;
+            return l_iter;
+        }
+        std::size_t calls() const { return m_calls; }
+        std::size_t iter() const { return m_iter; }
+};
+
+template <typename ValueType>
+void initialize(CGrid<ValueType> & p_x)
+{
+    #pragma omp parallel for
+    for (std::size_t l_pos_L = 0; l_pos_L < p_x.objLevels(); ++l_pos_L)
+    {
+        for (std::size_t l_pos_R = 0; l_pos_R < p_x.objRows(); ++l_pos_R)
+        {
+            for (std::size_t l_pos_C = 0; l_pos_C < p_x.objCols(); ++l_pos_C)
+            {
+                p_x(l_pos_C, l_pos_R, l_pos_L) = 1 + p_x.pos(l_pos_C, l_pos_R, l_pos_L) % 100;
+            }
+        }
+    }
+}
+
+//
+// NOTE: p_runs timesteps from the initial state, the result is in p_x_a
+//       (p_runs even) or p_x_b (p_runs odd)
+//
+template <typename ValueType, typename OperatorType>
+void timesteps(
+    const CGridLayout & p_layout,
+    OperatorType & p_Op,
+    const ISolver<ValueType> & p_solver,
+    CGrid<ValueType> & p_x_a,
+    CGrid<ValueType> & p_x_b,
+    const ValueType p_epsilonSolver,
+    const ValueType p_epsilonStep,
+    const std::size_t p_runs,
+    double & p_tFirst,
+    double & p_tTimestep
+)
+{
+    C_TimestepCalculator<ValueType> l_stepCalc;
+
+    initialize(p_x_a);
+
+    p_tFirst = 0;
+    p_tTimestep = 0;
+
+    for (std::size_t i = 0; i < p_runs; ++i)
+    {
+        ValueType * l_y = i % 2 == 0 ? p_x_a.data() : p_x_b.data();
+        ValueType * l_x = i % 2 == 0 ? p_x_b.data() : p_x_a.data();
+
+        double l_tStart = omp_get_wtime();
+        l_stepCalc(p_layout.objSize3d(), p_solver, p_Op, l_y, l_x, p_epsilonSolver, p_epsilonStep, ITER_SOLVER_MAX, ITER_STEP_CALC_MAX, p_layout.bufferSize());
+        double l_t = omp_get_wtime() - l_tStart;
+
+        if (i == 0)
+        {
+            p_tFirst = l_t;
+        }
+        else
+        {
+            p_tTimestep += l_t;
+        }
+    }
+
+    p_tTimestep = p_runs > 1 ? p_tTimestep / (p_runs - 1) : 0;
+}
+
+template <typename ValueType, typename VecType>
+void routine(std::size_t p_objCols,
+             std::size_t p_objRows,
+             std::size_t p_objLevels,
+             std::size_t p_runs
+)
+{
+    CGridLayout l_layout(p_objCols, p_objRows, p_objLevels);
+
+    //
+    // NOTE: x_n and x_n+1, swapped after every timestep, the result of the
+    //       reference is copied to l_x_ref
+    //
+    CGrid<ValueType> l_x_a(l_layout);
+    CGrid<ValueType> l_x_b(l_layout);
+    CGrid<ValueType> l_x_ref(l_layout);
+
+    initialize(l_x_a);
+
+    double l_y2 = 0;
+
+    #pragma omp parallel for reduction(+: l_y2)
+    for (std::size_t i = 0; i < l_layout.objSize3d(); ++i)
+    {
+        l_y2 += double(l_x_a.data()[i]) * l_x_a.data()[i];
+    }
+
+    ValueType l_epsilonSolver = ValueType(EPSILON_SOLVER_REL * l_y2);
+    ValueType l_epsilonStep = ValueType(EPSILON_STEP_CALC_REL * l_y2);
+
+    CNonlinearStencilPrecalc<CStateFunctionMul2,ValueType,VecType> l_Op(
+        l_layout,
+        l_x_a.data(),
+        H,
+        TAU,
+        EPSILON_OPERATOR
+    );
+
+    //
+    // NOTE: reference, CG inner solves
+    //
+    CCG<ValueType> l_solverReference;
+    CCountingSolver<ValueType> l_countingReference(l_solverReference);
+
+    double l_tFirstReference;
+    double l_tTimestepReference;
+
+    timesteps(l_layout, l_Op, l_countingReference, l_x_a, l_x_b, l_epsilonSolver, l_epsilonStep, p_runs, l_tFirstReference, l_tTimestepReference);
+
+    CGrid<ValueType> & l_result = p_runs % 2 == 0 ? l_x_a : l_x_b;
+
+    #pragma omp parallel for
+    for (std::size_t i = 0; i < l_layout.objSize3d(); ++i)
+    {
+        l_x_ref.data()[i] = l_result.data()[i];
+    }
+
+    //
+    // NOTE: Chebyshev inner solves, the bounds are cached between the solves
+    //       and the timesteps
+    //
+    CChebyshev<ValueType> l_solver(ESTIMATE_STEPS, CHECK_PERIOD, REFRESH);
+    CCountingSolver<ValueType> l_counting(l_solver);
+
+    double l_tFirst;
+    double l_tTimestep;
+
+    timesteps(l_layout, l_Op, l_counting, l_x_a, l_x_b, l_epsilonSolver, l_epsilonStep, p_runs, l_tFirst, l_tTimestep);
+
+    //
+    // NOTE: max relative difference of the final states
+    //
+    double l_diff = 0;
+
+    #pragma omp parallel for reduction(max: l_diff)
+    for (std::size_t i = 0; i < l_layout.objSize3d(); ++i)
+    {
+        double l_ref = l_x_ref.data()[i];
+        double l_d = l_ref != 0 ? std::abs((l_result.data()[i] - l_ref) / l_ref) : std::abs(l_result.data()[i]);
+
+        l_diff = l_d > l_diff ? l_d : l_diff;
+    }
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "OBJ_COLS_IMPL," << p_objCols << std::endl;
+    std::cout << "OBJ_ROWS_IMPL," << p_objRows << std::endl;
+    std::cout << "OBJ_LEVELS_IMPL," << p_objLevels << std::endl;
+    std::cout << "OBJ_CELLS_IMPL," << l_layout.objCells() << std::endl;
+    std::cout << "IMPL_ID_IMPL," << l_Op.IDENTIFER << std::endl;
+    std::cout << "FUNC_ID_IMPL," << "mul2" << std::endl;
+    std::cout << "ROUTINE_IMPL," << "timestep" << std::endl;
+    std::cout << "SOLVER_ID_IMPL," << l_solver.IDENTIFER << std::endl;
+    std::cout << "SOLVER_ID_REFERENCE_IMPL," << l_solverReference.IDENTIFER << std::endl;
+    std::cout << "THREADS_IMPL," << omp_get_max_threads() << std::endl;
+    std::cout << "TIMESTEPS_IMPL," << p_runs << std::endl;
+    std::cout << "REFRESH_IMPL," << REFRESH << std::endl;
+    std::cout << "EPSILON_SOLVER_REL_IMPL," << EPSILON_SOLVER_REL << std::endl;
+    std::cout << "EPSILON_STEP_CALC_REL_IMPL," << EPSILON_STEP_CALC_REL << std::endl;
+    std::cout << "SOLVES_IMPL," << l_counting.calls() << std::endl;
+    std::cout << "SOLVES_REFERENCE_IMPL," << l_countingReference.calls() << std::endl;
+    std::cout << "ITER_SOLVER_IMPL," << l_counting.iter() << std::endl;
+    std::cout << "ITER_SOLVER_REFERENCE_IMPL," << l_countingReference.iter() << std::endl;
+    std::cout << "ESTIMATES_IMPL," << l_solver.estimates() << std::endl;
+    std::cout << "LAMBDA_MIN_IMPL," << l_solver.lambdaMin() << std::endl;
+    std::cout << "LAMBDA_MAX_IMPL," << l_solver.lambdaMax() << std::endl;
+    std::cout << "RUNTIME_TIMESTEP_FIRST_IMPL," << l_tFirst << std::endl;
+    std::cout << "RUNTIME_TIMESTEP_FIRST_REFERENCE_IMPL," << l_tFirstReference << std::endl;
+    std::cout << "RUNTIME_TIMESTEP_IMPL," << l_tTimestep << std::endl;
+    std::cout << "RUNTIME_TIMESTEP_REFERENCE_IMPL," << l_tTimestepReference << std::endl;
+    std::cout << "DIFF_REFERENCE_IMPL," << l_diff << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::cout << "argc: " << argc << std::endl;
+    std::cout << "argv: [";
+    for (std::size_t i = 0; i < argc; ++i)
+    {
+        std::cout << argv[i];
+        if (i < argc - 1)
+        {
+            std::cout << ", ";
+        }
+    }
+    std::cout << "]" << std::endl;
+
+    if(argc != 1 && argc != 4 && argc != 5)
+    {
+        std::cout << "INVALID INPUT: argc must be 1 or 4 or 5" << std::endl;
+        return 1;
+    }
+
+    std::size_t l_objCols = OBJ_COLS;
+    std::size_t l_objRows = OBJ_ROWS;
+    std::size_t l_objLevels = OBJ_LEVELS;
+    std::size_t l_runs = RUNS;
+
+    if (argc >= 4)
+    {
+        l_objCols =   atoi(argv[1]);
+        l_objRows =   atoi(argv[2]);
+        l_objLevels = atoi(argv[3]);
+    }
+    if (argc == 5)
+    {
+        l_runs =   atoi(argv[4]);
+    }
+    double l_tStartRoutine = omp_get_wtime();
+    routine<VALUE_TYPE, VEC_TYPE>(
+        l_objCols,
+        l_objRows,
+        l_objLevels,
+        l_runs
+    );
+    double l_tEndRoutine = omp_get_wtime();
+    double l_tRoutine = l_tEndRoutine - l_tStartRoutine;
+
+    //
+    // NOTE: output is parsed by bench script
+    //
+    std::cout << "RUNTIME_OVERALL_IMPL," << l_tRoutine << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#!/usr/bin/env bash
+
+#
+# CONFIG
+#
+
+THREADS_MIN=1
+THREADS_MAX=128
+
+OBJ_COLS=128
+OBJ_ROWS=128
+OBJ_LEVELS=128
+
+TIMESTEPS=4
+
+OMP_PLACES=threads
+OMP_PROC_BIND=spread
+
+APP_PATH=${1:-./e_chebyshev_nonlinear_stencil_precalc_mul2}
+
+ENABLE_TELEGRAM=true
+
+#
+# ------------------------------
+#
+
+#
+# FUNCTIONS
+#
+
+filename() {
+  echo "$(basename $(readlink -f $1))"
+}
+
+filename_without_extension() {
+  local name=$(filename $0)
+  echo "${name%.*}"
+}
+
+log_console() {
+  echo -e "$BLUE $1 $NORMAL"
+}
+warning_console() {
+  echo -e "$YELLOW > WARNING - $1 $NORMAL"
+}
+
+error_console() {
+  echo ""
+  echo -e "$RED >>> ERROR - $1 $NORMAL" >&2
+}
+
+output() {
+  echo $1 >> $OUTPUT_FILE
+}
+
+log_telegram() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}" >/dev/null
+  fi
+}
+
+log_telegram_silent() {
+  if [ "${ENABLE_TELEGRAM}" = true ]; then
+    curl -s "https://api.telegram.org/bot${TELEGRAM_BOT_TOKEN}/sendMessage?chat_id=${TELEGRAM_CHAT_ID}&text=${1}&disable_notification=true" >/dev/null
+  fi
+}
+
+log_everywhere() {
+  log_console "$1"
+  log_telegram "$1"
+}
+
+log_everywhere_silent() {
+  log_console "$1"
+  log_telegram_silent "$1"
+}
+
+timestamp() {
+  date +%s
+}
+
+elapsedTimeMessage() {
+  local l_elapsed=$(( $2 - $1 ))
+  eval "echo Elapsed time: $(date -ud "@$l_elapsed" +'$((%s/3600/24)) days %H hr %M min %S sec')"
+}
+
+#
+# ------------------------------
+#
+
+#
+# ENVIRONMENT CHECK
+#
+
+if [ -z ${TELEGRAM_BOT_TOKEN} ]; then
+  error_console "TELEGRAM_BOT_TOKEN isn't defined."
+  exit 1
+fi
+if [ -z ${TELEGRAM_CHAT_ID} ]; then
+  error_console "TELEGRAM_CHAT_ID isn't defined."
+  exit 1
+fi
+
+#
+# ------------------------------
+#
+
+#
+# PROPERTIES
+#
+
+APP_ID=$(filename $APP_PATH)
+
+NODE_ID=${NODE_ID:-undefined_node}
+SCRIPT_ID=$(filename_without_extension $0)
+SCRIPT_PATH=$(readlink -f $0)
+
+# Output colors
+NORMAL="\\033[0;39m"
+RED="\\033[1;31m"
+BLUE="\\033[0;34m"
+YELLOW="\\033[0;33m"
+
+OUTPUT_FILE="${SCRIPT_ID}_${APP_ID}.csv"
+
+TIME_BENCHMARK_STARTED=$(timestamp)
+
+log_everywhere_silent "benchmark started ($SCRIPT_PATH)"
+
+THREAD_LIST=()
+
+#
+# ------------------------------
+#
+
+#
+# GENERATE BENCH LIST STRONG SCALING
+#
+
+THREADS=$THREADS_MIN
+while [ $THREADS -le $THREADS_MAX ]
+do
+  THREAD_LIST+=($THREADS)
+  THREADS=$(( $THREADS * 2 ))
+done
+
+#
+# clear file
+#
+> $OUTPUT_FILE
+output "node_id,bench_id,impl_id,func_id,routine,solver_id,obj_cols,obj_rows,obj_levels,threads,timesteps,refresh,epsilon_solver_rel,solves,iter,estimates,runtime_first,runtime,efficiency"
+
+#
+# ------------------------------
+#
+
+#
+# EXECUTION
+#
+
+for INDEX in ${!THREAD_LIST[@]}; do
+  THREADS=${THREAD_LIST[$INDEX]}
+
+  CURRENT_CMD="$APP_PATH $OBJ_COLS $OBJ_ROWS $OBJ_LEVELS $TIMESTEPS"
+
+  log_everywhere_silent "($(( $INDEX + 1 ))/${#THREAD_LIST[@]}) \$ OMP_NUM_THREADS=$THREADS $CURRENT_CMD"
+  CURRENT_OUTPUT=$(export OMP_NUM_THREADS=$THREADS && export OMP_PLACES=$OMP_PLACES && export OMP_PROC_BIND=$OMP_PROC_BIND && $CURRENT_CMD)
+
+  #
+  # parse results
+  #
+
+  IMPL_ID=$(echo "$CURRENT_OUTPUT"                   | grep "IMPL_ID_IMPL"                   | cut -d ',' -f 2)
+  FUNC_ID=$(echo "$CURRENT_OUTPUT"                   | grep "FUNC_ID_IMPL"                   | cut -d ',' -f 2)
+  ROUTINE=$(echo "$CURRENT_OUTPUT"                   | grep "ROUTINE_IMPL"                   | cut -d ',' -f 2)
+  SOLVER_ID=$(echo "$CURRENT_OUTPUT"                 | grep "SOLVER_ID_IMPL"                 | cut -d ',' -f 2)
+  SOLVER_ID_REFERENCE=$(echo "$CURRENT_OUTPUT"       | grep "SOLVER_ID_REFERENCE_IMPL"       | cut -d ',' -f 2)
+  REFRESH=$(echo "$CURRENT_OUTPUT"                          | grep "REFRESH_IMPL"                          | cut -d ',' -f 2)
+  EPSILON_SOLVER_REL=$(echo "$CURRENT_OUTPUT"               | grep "EPSILON_SOLVER_REL_IMPL"               | cut -d ',' -f 2)
+  SOLVES=$(echo "$CURRENT_OUTPUT"                           | grep "SOLVES_IMPL"                           | cut -d ',' -f 2)
+  SOLVES_REFERENCE=$(echo "$CURRENT_OUTPUT"                 | grep "SOLVES_REFERENCE_IMPL"                 | cut -d ',' -f 2)
+  ITER_SOLVER=$(echo "$CURRENT_OUTPUT"                      | grep "ITER_SOLVER_IMPL"                      | cut -d ',' -f 2)
+  ITER_SOLVER_REFERENCE=$(echo "$CURRENT_OUTPUT"            | grep "ITER_SOLVER_REFERENCE_IMPL"            | cut -d ',' -f 2)
+  ESTIMATES=$(echo "$CURRENT_OUTPUT"                        | grep "ESTIMATES_IMPL"                        | cut -d ',' -f 2)
+  RUNTIME_FIRST_SOLVER=$(echo "$CURRENT_OUTPUT"             | grep "RUNTIME_TIMESTEP_FIRST_IMPL"           | cut -d ',' -f 2)
+  RUNTIME_FIRST_SOLVER_REFERENCE=$(echo "$CURRENT_OUTPUT"   | grep "RUNTIME_TIMESTEP_FIRST_REFERENCE_IMPL" | cut -d ',' -f 2)
+  RUNTIME_SOLVER=$(echo "$CURRENT_OUTPUT"                   | grep "RUNTIME_TIMESTEP_IMPL"                 | cut -d ',' -f 2)
+  RUNTIME_SOLVER_REFERENCE=$(echo "$CURRENT_OUTPUT"         | grep "RUNTIME_TIMESTEP_REFERENCE_IMPL"       | cut -d ',' -f 2)
+
+  if [ $THREADS -eq $THREADS_MIN ]; then
+    RUNTIME_REF_SOLVER=$RUNTIME_SOLVER
+    RUNTIME_REF_SOLVER_REFERENCE=$RUNTIME_SOLVER_REFERENCE
+  fi
+
+  EFFICIENCY_SOLVER=$(python3 -c "print($RUNTIME_REF_SOLVER/($THREADS*$RUNTIME_SOLVER))")
+  EFFICIENCY_SOLVER_REFERENCE=$(python3 -c "print($RUNTIME_REF_SOLVER_REFERENCE/($THREADS*$RUNTIME_SOLVER_REFERENCE))")
+
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID,$FUNC_ID,$ROUTINE,$SOLVER_ID,$OBJ_COLS,$OBJ_ROWS,$OBJ_LEVELS,$THREADS,$TIMESTEPS,$REFRESH,$EPSILON_SOLVER_REL,$SOLVES,$ITER_SOLVER,$ESTIMATES,$RUNTIME_FIRST_SOLVER,$RUNTIME_SOLVER,$EFFICIENCY_SOLVER"
+  output "$NODE_ID,$SCRIPT_ID,$IMPL_ID,$FUNC_ID,$ROUTINE,$SOLVER_ID_REFERENCE,$OBJ_COLS,$OBJ_ROWS,$OBJ_LEVELS,$THREADS,$TIMESTEPS,$REFRESH,$EPSILON_SOLVER_REL,$SOLVES_REFERENCE,$ITER_SOLVER_REFERENCE,0,$RUNTIME_FIRST_SOLVER_REFERENCE,$RUNTIME_SOLVER_REFERENCE,$EFFICIENCY_SOLVER_REFERENCE"
+
+  TIME_CURRENT=$(timestamp)
+  log_everywhere_silent "=> Iterations $SOLVER_ID: $ITER_SOLVER ($ESTIMATES estimates), $SOLVER_ID_REFERENCE: $ITER_SOLVER_REFERENCE"
+  log_everywhere_silent "=> Runtime per timestep $SOLVER_ID: $RUNTIME_SOLVER sec (first $RUNTIME_FIRST_SOLVER sec, efficiency $EFFICIENCY_SOLVER)"
+  log_everywhere_silent "=> Runtime per timestep $SOLVER_ID_REFERENCE: $RUNTIME_SOLVER_REFERENCE sec (first $RUNTIME_FIRST_SOLVER_REFERENCE sec, efficiency $EFFICIENCY_SOLVER_REFERENCE)"
+  log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+  log_everywhere_silent "------------------"
+
+done
+
+#
+# ------------------------------
+#
+
+#
+# COMPLETED
+#
+
+TIME_CURRENT=$(timestamp)
+log_everywhere_silent "$(elapsedTimeMessage $TIME_BENCHMARK_STARTED $TIME_CURRENT)"
+log_everywhere "benchmark finished"
+log_everywhere_silent "=================="
+
+exit 0
@@ -0,0 +1,4 @@
+#!/usr/bin/env bash
+
+../e_efficiency_by_threads.sh ./e_chebyshev_nonlinear_stencil_precalc_mul2
+../e_efficiency_by_threads.sh ./e_chebyshev_nonlinear_stencil_precalc_mul2_refresh